@@ -0,0 +1,149 @@
+/*
+ * Microbenchmark of the batch orbit propagator.
+ *
+ * Propagates synthetic Walker-delta shells of 1k, 10k and 40k satellites with
+ * every kernel the CPU supports and reports satellites per second, plus the
+ * largest position difference of the vector kernels against the scalar one.
+ *
+ * ./ns3 run "satellite-orbit-propagator-benchmark --steps=200"
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/satellite-ephemeris.h"
+#include "ns3/satellite-orbit-propagator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+namespace {
+
+struct Shell
+{
+    std::vector<double> radius;
+    std::vector<double> speed;
+    std::vector<double> angularVelocity;
+    std::vector<double> initialAngle;
+    std::vector<double> cosInclination;
+    std::vector<double> sinInclination;
+    std::vector<double> cosRaan;
+    std::vector<double> sinRaan;
+
+    std::vector<double> x, y, z, vx, vy, vz;
+
+    explicit Shell(uint32_t numSatellites)
+    {
+        uint32_t numPlanes = std::max(1u, static_cast<uint32_t>(std::sqrt(numSatellites)));
+        double altitude = 550e3;
+        double inclination = 53.0 * M_PI / 180.0;
+        for (uint32_t i = 0; i < numSatellites; ++i)
+        {
+            uint32_t plane = i % numPlanes;
+            uint32_t index = i / numPlanes;
+            uint32_t perPlane = (numSatellites + numPlanes - 1) / numPlanes;
+            double r = SatelliteEphemeris::EARTH_RADIUS + altitude;
+            double v = std::sqrt(SatelliteEphemeris::GM_EARTH / r);
+            double raan = 2.0 * M_PI * plane / numPlanes;
+            radius.push_back(r);
+            speed.push_back(v);
+            angularVelocity.push_back(v / r);
+            initialAngle.push_back(2.0 * M_PI * index / perPlane + M_PI * plane / numSatellites);
+            cosInclination.push_back(std::cos(inclination));
+            sinInclination.push_back(std::sin(inclination));
+            cosRaan.push_back(std::cos(raan));
+            sinRaan.push_back(std::sin(raan));
+        }
+        for (auto* column : {&x, &y, &z, &vx, &vy, &vz})
+        {
+            column->assign(numSatellites, 0.0);
+        }
+    }
+
+    SatelliteOrbitPropagator::Elements GetElements() const
+    {
+        return {radius.data(), speed.data(), angularVelocity.data(), initialAngle.data(),
+                cosInclination.data(), sinInclination.data(), cosRaan.data(), sinRaan.data()};
+    }
+
+    SatelliteOrbitPropagator::State GetState()
+    {
+        return {x.data(), y.data(), z.data(), vx.data(), vy.data(), vz.data()};
+    }
+};
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t steps = 200;
+    double stepSeconds = 1.0;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("steps", "Number of propagation time steps per measurement", steps);
+    cmd.AddValue("stepSeconds", "Simulated time between steps in seconds", stepSeconds);
+    cmd.Parse(argc, argv);
+
+    const SatelliteOrbitPropagator::Kernel kernels[] = {SatelliteOrbitPropagator::SCALAR,
+                                                       SatelliteOrbitPropagator::AVX2,
+                                                       SatelliteOrbitPropagator::AVX512};
+
+    std::cout << std::left << std::setw(12) << "satellites" << std::setw(10) << "kernel"
+              << std::right << std::setw(16) << "sats/s" << std::setw(10) << "speedup"
+              << std::setw(16) << "max |dr| (m)" << std::endl;
+
+    for (uint32_t numSatellites : {1000u, 10000u, 40000u})
+    {
+        Shell shell(numSatellites);
+        Shell reference(numSatellites);
+        double scalarRate = 0.0;
+
+        for (SatelliteOrbitPropagator::Kernel kernel : kernels)
+        {
+            if (!SatelliteOrbitPropagator::IsSupported(kernel))
+            {
+                continue;
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            for (uint32_t step = 0; step < steps; ++step)
+            {
+                SatelliteOrbitPropagator::Propagate(kernel, shell.GetElements(), shell.GetState(),
+                                                    0, numSatellites, 86400.0 + step * stepSeconds);
+            }
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            double rate = static_cast<double>(numSatellites) * steps / elapsed.count();
+            if (kernel == SatelliteOrbitPropagator::SCALAR)
+            {
+                scalarRate = rate;
+            }
+
+            // Accuracy at the last step against the scalar kernel
+            double t = 86400.0 + (steps - 1) * stepSeconds;
+            SatelliteOrbitPropagator::Propagate(SatelliteOrbitPropagator::SCALAR, reference.GetElements(),
+                                                reference.GetState(), 0, numSatellites, t);
+            double maxError = 0.0;
+            for (uint32_t i = 0; i < numSatellites; ++i)
+            {
+                double dx = shell.x[i] - reference.x[i];
+                double dy = shell.y[i] - reference.y[i];
+                double dz = shell.z[i] - reference.z[i];
+                maxError = std::max(maxError, std::sqrt(dx * dx + dy * dy + dz * dz));
+            }
+
+            std::cout << std::left << std::setw(12) << numSatellites << std::setw(10)
+                      << SatelliteOrbitPropagator::GetKernelName(kernel) << std::right << std::setw(16)
+                      << std::fixed << std::setprecision(0) << rate << std::setw(9)
+                      << std::setprecision(2) << rate / scalarRate << "x" << std::setw(16)
+                      << std::scientific << std::setprecision(2) << maxError << std::defaultfloat
+                      << std::endl;
+        }
+    }
+
+    return 0;
+}
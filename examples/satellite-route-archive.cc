@@ -0,0 +1,109 @@
+/*
+ * Offline generator of route archives.
+ *
+ * Builds a Walker-delta shell with +Grid inter-satellite links and a list of
+ * ground stations, computes the routes of every epoch of a horizon and writes
+ * them to a route archive. Simulations of the same constellation then replay
+ * the archive instead of computing routes:
+ *
+ *   SatelliteSpRoutingHelper::SetRouteEngineAttribute("RouteArchive", StringValue("routes.bin"));
+ *
+ * The simulation must register satellites plane by plane and then the ground
+ * stations in the given order, as done here; the engine rejects an archive
+ * whose topology fingerprint does not match.
+ *
+ * ./ns3 run "satellite-route-archive --planes=72 --perPlane=22 --horizon=600
+ *            --groundStations=51.5:-0.1,40.7:-74.0 --output=routes.bin"
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/inter-satellite-link-helper.h"
+#include "ns3/satellite-helper.h"
+#include "ns3/satellite-sp-routing-protocol.h"
+#include "ns3/uinteger.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t planes = 24;
+    uint32_t perPlane = 22;
+    double altitude = 550e3;
+    double inclination = 53.0;
+    double start = 0.0;
+    double interval = 1.0;
+    double horizon = 600.0;
+    uint32_t threads = 1;
+    std::string groundStations = "51.5:-0.1,40.7:-74.0";
+    std::string output = "satellite-routes.bin";
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("planes", "Number of orbital planes", planes);
+    cmd.AddValue("perPlane", "Satellites per plane", perPlane);
+    cmd.AddValue("altitude", "Orbital altitude in meters", altitude);
+    cmd.AddValue("inclination", "Orbital inclination in degrees", inclination);
+    cmd.AddValue("start", "Start of the first epoch in seconds", start);
+    cmd.AddValue("interval", "Epoch length in seconds, normally the route update interval", interval);
+    cmd.AddValue("horizon", "Archived time in seconds", horizon);
+    cmd.AddValue("threads", "Route computation threads, 0 for all", threads);
+    cmd.AddValue("groundStations", "Ground stations as lat:lon pairs separated by commas", groundStations);
+    cmd.AddValue("output", "Archive file", output);
+    cmd.Parse(argc, argv);
+
+    SatelliteHelper satelliteHelper;
+    std::vector<NodeContainer> shell = satelliteHelper.CreateShell(altitude, inclination, planes, perPlane);
+    InterSatelliteLinkHelper islHelper;
+    islHelper.Install(shell);
+
+    Ptr<SatelliteRouteEngine> engine = SatelliteSpRoutingProtocol::GetRouteEngine();
+    engine->SetAttribute("NumThreads", UintegerValue(threads));
+    for (const NodeContainer& plane : shell)
+    {
+        for (uint32_t i = 0; i < plane.GetN(); ++i)
+        {
+            engine->AddNode(plane.Get(i));
+        }
+    }
+    std::istringstream stations(groundStations);
+    std::string station;
+    while (std::getline(stations, station, ','))
+    {
+        double latitude = 0.0;
+        double longitude = 0.0;
+        char colon = 0;
+        std::istringstream fields(station);
+        if (!(fields >> latitude >> colon >> longitude) || colon != ':')
+        {
+            std::cerr << "Bad ground station \"" << station << "\", expected lat:lon" << std::endl;
+            return 1;
+        }
+        engine->AddNode(satelliteHelper.CreateGroundStation(latitude, longitude).Get(0));
+    }
+    engine->InitializeTopology();
+
+    uint64_t numEpochs = static_cast<uint64_t>(std::ceil(horizon / interval));
+    std::cout << "Archiving " << numEpochs << " epochs of " << engine->GetNSatellites() << " satellites and "
+              << engine->GetNGroundStations() << " ground stations to " << output << std::endl;
+
+    auto begin = std::chrono::steady_clock::now();
+    if (!engine->WriteArchive(output, Seconds(start), Seconds(interval), numEpochs))
+    {
+        std::cerr << "Cannot write " << output << std::endl;
+        return 1;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+    SatelliteRouteArchive archive;
+    archive.Open(output);
+    std::cout << "Wrote " << archive.GetNTables() << " distinct route tables in " << elapsed.count() << "s"
+              << std::endl;
+    return 0;
+}
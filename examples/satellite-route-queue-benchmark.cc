@@ -0,0 +1,155 @@
+/*
+ * Microbenchmark of the priority queue policies of the route engine.
+ *
+ * Builds +Grid inter-satellite link graphs over synthetic Walker-delta shells
+ * of 1k to 10k satellites and runs single-source shortest path searches from
+ * every satellite with the binary heap (the default), the radix heap and the
+ * Dial bucket queue. Reports searches per second, the speedup over the binary
+ * heap and the share of first hops that differ from it; the integer queues
+ * order by nanosecond delays, so ties may break differently.
+ *
+ * ./ns3 run "satellite-route-queue-benchmark --sources=500"
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/satellite-ephemeris.h"
+#include "ns3/satellite-route-graph.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+namespace {
+
+/// +Grid graph of a Walker-delta shell, with weights at one time.
+struct Shell
+{
+    SatelliteRouteGraph graph;
+
+    Shell(uint32_t numPlanes, uint32_t perPlane)
+    {
+        uint32_t numSatellites = numPlanes * perPlane;
+        std::vector<std::vector<uint32_t>> adjacency(numSatellites);
+        auto link = [&adjacency](uint32_t a, uint32_t b) {
+            if (a != b && std::find(adjacency[a].begin(), adjacency[a].end(), b) == adjacency[a].end())
+            {
+                adjacency[a].push_back(b);
+                adjacency[b].push_back(a);
+            }
+        };
+        for (uint32_t p = 0; p < numPlanes; ++p)
+        {
+            for (uint32_t s = 0; s < perPlane; ++s)
+            {
+                link(p * perPlane + s, p * perPlane + (s + 1) % perPlane);
+                link(p * perPlane + s, ((p + 1) % numPlanes) * perPlane + s);
+            }
+        }
+        graph.Build(adjacency);
+
+        std::vector<double> x(numSatellites);
+        std::vector<double> y(numSatellites);
+        std::vector<double> z(numSatellites);
+        double r = SatelliteEphemeris::EARTH_RADIUS + 550e3;
+        double inclination = 53.0 * M_PI / 180.0;
+        for (uint32_t p = 0; p < numPlanes; ++p)
+        {
+            double raan = 2.0 * M_PI * p / numPlanes;
+            for (uint32_t s = 0; s < perPlane; ++s)
+            {
+                uint32_t i = p * perPlane + s;
+                double u = 2.0 * M_PI * s / perPlane + M_PI * p / numSatellites;
+                double xo = r * std::cos(u);
+                double yo = r * std::sin(u);
+                x[i] = xo * std::cos(raan) - yo * std::cos(inclination) * std::sin(raan);
+                y[i] = xo * std::sin(raan) + yo * std::cos(inclination) * std::cos(raan);
+                z[i] = yo * std::sin(inclination);
+            }
+        }
+        graph.UpdateWeights(x.data(), y.data(), z.data());
+    }
+};
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t sources = 500;
+    uint32_t maxBuckets = 1 << 16;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("sources", "Number of source satellites per measurement", sources);
+    cmd.AddValue("maxBuckets", "Bucket limit of the Dial queue", maxBuckets);
+    cmd.Parse(argc, argv);
+
+    std::cout << std::left << std::setw(12) << "satellites" << std::setw(12) << "queue" << std::right
+              << std::setw(14) << "searches/s" << std::setw(10) << "speedup" << std::setw(14)
+              << "hops differ" << std::endl;
+
+    const std::pair<uint32_t, uint32_t> shells[] = {{32, 32}, {72, 22}, {64, 64}, {100, 100}};
+    for (const auto& shape : shells)
+    {
+        Shell shell(shape.first, shape.second);
+        const uint32_t numSatellites = shell.graph.GetNVertices();
+        const uint32_t numSources = std::min(sources, numSatellites);
+
+        SatelliteShortestPathScratch scratch;
+        scratch.dialQueue.SetMaxBuckets(maxBuckets);
+        std::vector<uint32_t> reference(static_cast<size_t>(numSources) * numSatellites);
+        std::vector<uint32_t> nextHop(static_cast<size_t>(numSources) * numSatellites);
+        double heapRate = 0.0;
+
+        const std::string queues[] = {"BinaryHeap", "RadixHeap", "Dial"};
+        for (const std::string& name : queues)
+        {
+            uint32_t* rows = (name == "BinaryHeap") ? reference.data() : nextHop.data();
+            auto start = std::chrono::steady_clock::now();
+            for (uint32_t i = 0; i < numSources; ++i)
+            {
+                uint32_t src = static_cast<uint64_t>(i) * numSatellites / numSources;
+                uint32_t* row = rows + static_cast<size_t>(i) * numSatellites;
+                if (name == "BinaryHeap")
+                {
+                    ComputeShortestPathFirstHops(shell.graph, src, scratch, row);
+                }
+                else if (name == "RadixHeap")
+                {
+                    ComputeShortestPathFirstHops(shell.graph, src, scratch.radixHeap, scratch.delay,
+                                                 scratch.firstHop, row);
+                }
+                else
+                {
+                    ComputeShortestPathFirstHops(shell.graph, src, scratch.dialQueue, scratch.delay,
+                                                 scratch.firstHop, row);
+                }
+            }
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            double rate = numSources / elapsed.count();
+            if (name == "BinaryHeap")
+            {
+                heapRate = rate;
+            }
+
+            uint64_t differ = 0;
+            for (size_t k = 0; name != "BinaryHeap" && k < nextHop.size(); ++k)
+            {
+                differ += (nextHop[k] != reference[k]);
+            }
+
+            std::cout << std::left << std::setw(12) << numSatellites << std::setw(12) << name
+                      << std::right << std::fixed << std::setw(14) << std::setprecision(0) << rate
+                      << std::setw(9) << std::setprecision(2) << rate / heapRate << "x"
+                      << std::setw(13) << std::setprecision(3) << 100.0 * differ / reference.size()
+                      << "%" << std::defaultfloat << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -55,6 +55,12 @@ GroundSatelliteLinkHelper::SetPropagationDelayModel(Ptr<PropagationDelayModel> d
     m_delay = delay;
 }
 
+void
+GroundSatelliteLinkHelper::SetContactPlan(Ptr<SatelliteContactPlan> plan)
+{
+    m_contactPlan = plan;
+}
+
 NetDeviceContainer
 GroundSatelliteLinkHelper::Install(const NodeContainer& satellites, const NodeContainer& groundStations) const
 {
@@ -80,6 +86,10 @@ GroundSatelliteLinkHelper::Install(const NodeContainer& satellites, const NodeCo
             {
                 channel->SetPropagationDelayModel(m_delay);
             }
+            if (m_contactPlan)
+            {
+                channel->SetContactPlan(m_contactPlan);
+            }
 
             // Ground Station side
             Ptr<GroundSatelliteNetDevice> gsDevice = m_deviceFactory.Create<GroundSatelliteNetDevice>();
@@ -116,4 +126,94 @@ GroundSatelliteLinkHelper::Install(const NodeContainer& satellites, const NodeCo
     return allDevices;
 }
 
-} // namespace ns3 
\ No newline at end of file
+Ptr<GroundSatelliteNetDevice>
+GroundSatelliteLinkHelper::CreateDevice(Ptr<Node> node, Ptr<GroundSatellitePhy>& phy) const
+{
+    Ptr<GroundSatelliteNetDevice> device = m_deviceFactory.Create<GroundSatelliteNetDevice>();
+    device->SetAddress(Mac48Address::Allocate());
+    device->SetQueue(m_queueFactory.Create<Queue<Packet>>());
+    node->AddDevice(device);
+    phy = m_phyFactory.Create<GroundSatellitePhy>();
+    phy->SetDevice(device);
+    phy->SetNode(node);
+    device->SetPhy(phy);
+    device->SetLinkUp(false);
+    return device;
+}
+
+NetDeviceContainer
+GroundSatelliteLinkHelper::InstallWindowed(const NodeContainer& satellites, const NodeContainer& groundStations)
+{
+    NS_ASSERT_MSG(m_contactPlan && m_contactPlan->IsOpen(), "InstallWindowed needs an open contact plan.");
+    NetDeviceContainer allDevices;
+
+    // Size every pool for the busiest instant of its node
+    std::vector<uint32_t> gsPeak;
+    std::vector<uint32_t> satPeak;
+    m_contactPlan->GetPeakContacts(gsPeak, satPeak);
+    m_linkManager = CreateObject<GroundSatelliteLinkManager>();
+    m_linkManager->SetContactPlan(m_contactPlan);
+
+    for (auto gsit = groundStations.Begin(); gsit != groundStations.End(); ++gsit)
+    {
+        Ptr<Node> groundStationNode = *gsit;
+        uint32_t g = m_contactPlan->GetGroundStationIndex(groundStationNode);
+        if (g == SatelliteContactPlan::NOT_IN_PLAN)
+        {
+            NS_LOG_WARN("Ground station " << groundStationNode->GetId() << " is not in the contact plan.");
+            continue;
+        }
+        for (uint32_t i = 0; i < gsPeak[g]; ++i)
+        {
+            // The ground station side owns the channel of the link
+            Ptr<GroundSatelliteChannel> channel = m_channelFactory.Create<GroundSatelliteChannel>();
+            if (m_loss)
+            {
+                channel->SetPropagationLossModel(m_loss);
+            }
+            if (m_delay)
+            {
+                channel->SetPropagationDelayModel(m_delay);
+            }
+
+            Ptr<GroundSatellitePhy> gsPhy;
+            Ptr<GroundSatelliteNetDevice> gsDevice = CreateDevice(groundStationNode, gsPhy);
+            gsPhy->SetChannel(channel);
+            gsDevice->SetChannel(channel);
+            channel->Add(gsPhy);
+            m_linkManager->AddGroundStationDevice(g, gsDevice, gsPhy, channel);
+            allDevices.Add(gsDevice);
+        }
+    }
+
+    for (auto satit = satellites.Begin(); satit != satellites.End(); ++satit)
+    {
+        Ptr<Node> satelliteNode = *satit;
+        uint32_t s = m_contactPlan->GetSatelliteIndex(satelliteNode);
+        if (s == SatelliteContactPlan::NOT_IN_PLAN)
+        {
+            NS_LOG_WARN("Satellite " << satelliteNode->GetId() << " is not in the contact plan.");
+            continue;
+        }
+        for (uint32_t i = 0; i < satPeak[s]; ++i)
+        {
+            Ptr<GroundSatellitePhy> satPhy;
+            Ptr<GroundSatelliteNetDevice> satDevice = CreateDevice(satelliteNode, satPhy);
+            m_linkManager->AddSatelliteDevice(s, satDevice, satPhy);
+            allDevices.Add(satDevice);
+        }
+    }
+
+    NS_LOG_INFO("Installed " << allDevices.GetN() << " windowed ground link devices for "
+                << m_contactPlan->GetNContacts() << " contacts");
+    m_linkManager->Start();
+    return allDevices;
+}
+
+Ptr<GroundSatelliteLinkManager>
+GroundSatelliteLinkHelper::GetLinkManager() const
+{
+    return m_linkManager;
+}
+
+} // namespace ns3
@@ -7,6 +7,8 @@
 #include "ns3/propagation-loss-model.h"
 #include "ns3/propagation-delay-model.h"
 #include "ns3/queue.h"
+#include "ns3/satellite-contact-plan.h"
+#include "ns3/ground-satellite-link-manager.h"
 
 namespace ns3
 {
@@ -55,6 +57,12 @@ public:
      */
     void SetPropagationDelayModel(Ptr<PropagationDelayModel> delay);
 
+    /**
+     * @brief Only carry packets while the satellite is visible according to a contact plan.
+     * @param plan The contact plan, shared by all channels.
+     */
+    void SetContactPlan(Ptr<SatelliteContactPlan> plan);
+
     /**
      * @brief Install the ground-to-satellite communication stack between
      *        a set of satellites and a set of ground stations.
@@ -64,13 +72,44 @@ public:
      */
     NetDeviceContainer Install(const NodeContainer& satellites, const NodeContainer& groundStations) const;
 
+    /**
+     * @brief Install ground-to-satellite links that only exist while the
+     *        satellite is visible according to the contact plan.
+     *
+     * Every node gets as many devices as it has contacts at the same time at
+     * most, with their links down; a GroundSatelliteLinkManager binds and
+     * releases them as satellites rise and set. Nodes that are not in the plan
+     * get no devices. Requires SetContactPlan().
+     *
+     * @param satellites The container of satellite nodes.
+     * @param groundStations The container of ground station nodes.
+     * @return A NetDeviceContainer with all the created devices.
+     */
+    NetDeviceContainer InstallWindowed(const NodeContainer& satellites, const NodeContainer& groundStations);
+
+    /**
+     * @return The manager of the links created by InstallWindowed(), or nullptr.
+     */
+    Ptr<GroundSatelliteLinkManager> GetLinkManager() const;
+
 private:
+    /**
+     * @brief Create a device and its PHY on a node, without a channel and with its link down.
+     * @param node The node.
+     * @param phy Output: the PHY of the device.
+     * @return The device.
+     */
+    Ptr<GroundSatelliteNetDevice> CreateDevice(Ptr<Node> node, Ptr<GroundSatellitePhy>& phy) const;
+
+
     ObjectFactory m_phyFactory;
     ObjectFactory m_deviceFactory;
     ObjectFactory m_channelFactory;
     ObjectFactory m_queueFactory;
     Ptr<PropagationLossModel> m_loss;
     Ptr<PropagationDelayModel> m_delay;
+    Ptr<SatelliteContactPlan> m_contactPlan;
+    Ptr<GroundSatelliteLinkManager> m_linkManager;
 };
 
 } // namespace ns3
@@ -0,0 +1,174 @@
+#include "satellite-address-helper.h"
+#include "ns3/ipv4.h"
+#include "ns3/log.h"
+#include "ns3/loopback-net-device.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE("SatelliteAddressHelper");
+
+SatelliteAddressHelper::SatelliteAddressHelper()
+    : m_shellBits(0),
+      m_planeBits(0),
+      m_satelliteBits(0)
+{
+    SetBase(Ipv4Address("10.0.0.0"), Ipv4Mask("255.0.0.0"));
+    SetLayout(2, 7, 7);
+}
+
+void
+SatelliteAddressHelper::SetBase(Ipv4Address network, Ipv4Mask mask)
+{
+    m_networkBits = 0;
+    for (uint32_t m = mask.Get(); m & 0x80000000u; m <<= 1)
+    {
+        ++m_networkBits;
+    }
+    m_network = network.Get() & mask.Get();
+    if (m_shellBits)
+    {
+        // Keep the layout, the interface field takes up the difference
+        SetLayout(m_shellBits, m_planeBits, m_satelliteBits);
+    }
+}
+
+void
+SatelliteAddressHelper::SetLayout(uint8_t shellBits, uint8_t planeBits, uint8_t satelliteBits)
+{
+    NS_ASSERT_MSG(shellBits >= 1, "The shell field needs at least one bit for the ground station shell.");
+    NS_ASSERT_MSG(m_networkBits + shellBits + planeBits + satelliteBits <= 30,
+                  "Address layout leaves fewer than 2 interface bits.");
+    m_shellBits = shellBits;
+    m_planeBits = planeBits;
+    m_satelliteBits = satelliteBits;
+    m_interfaceBits = 32 - m_networkBits - shellBits - planeBits - satelliteBits;
+}
+
+Ipv4Address
+SatelliteAddressHelper::GetAddress(uint32_t shell, uint32_t plane, uint32_t satellite, uint32_t interface) const
+{
+    NS_ASSERT_MSG(shell < (1u << m_shellBits), "Shell " << shell << " does not fit " << +m_shellBits << " bits.");
+    NS_ASSERT_MSG(plane < (1u << m_planeBits), "Plane " << plane << " does not fit " << +m_planeBits << " bits.");
+    NS_ASSERT_MSG(satellite < (1u << m_satelliteBits),
+                  "Satellite " << satellite << " does not fit " << +m_satelliteBits << " bits.");
+    NS_ASSERT_MSG(interface >= 1 && interface < (1u << m_interfaceBits) - 1,
+                  "Interface " << interface << " does not fit " << +m_interfaceBits << " bits.");
+    uint32_t address = shell;
+    address = (address << m_planeBits) | plane;
+    address = (address << m_satelliteBits) | satellite;
+    address = (address << m_interfaceBits) | interface;
+    return Ipv4Address(m_network | address);
+}
+
+uint8_t
+SatelliteAddressHelper::GetNodePrefixLength() const
+{
+    return 32 - m_interfaceBits;
+}
+
+const std::vector<SatelliteAddressHelper::NodePrefix>&
+SatelliteAddressHelper::GetNodePrefixes() const
+{
+    return m_prefixes;
+}
+
+Ipv4InterfaceContainer
+SatelliteAddressHelper::Assign(uint32_t shell, const std::vector<NodeContainer>& orbitalPlanes)
+{
+    NS_ASSERT_MSG(shell + 1 < (1u << m_shellBits), "Shell " << shell << " is reserved for ground stations.");
+    if (orbitalPlanes.size() > (1u << m_planeBits))
+    {
+        NS_FATAL_ERROR(orbitalPlanes.size() << " planes do not fit " << +m_planeBits << " plane bits.");
+    }
+    for (const NodeContainer& plane : orbitalPlanes)
+    {
+        if (plane.GetN() > (1u << m_satelliteBits))
+        {
+            NS_FATAL_ERROR(plane.GetN() << " satellites per plane do not fit " << +m_satelliteBits
+                           << " satellite bits.");
+        }
+    }
+    Ipv4InterfaceContainer interfaces;
+    for (uint32_t p = 0; p < orbitalPlanes.size(); ++p)
+    {
+        for (uint32_t s = 0; s < orbitalPlanes[p].GetN(); ++s)
+        {
+            interfaces.Add(AssignNode(orbitalPlanes[p].Get(s), shell, p, s));
+        }
+    }
+    NS_LOG_INFO("Addressed shell " << shell << ": " << orbitalPlanes.size() << " planes");
+    return interfaces;
+}
+
+Ipv4InterfaceContainer
+SatelliteAddressHelper::AssignGroundStations(const NodeContainer& groundStations)
+{
+    if (groundStations.GetN() > (1u << (m_planeBits + m_satelliteBits)))
+    {
+        NS_FATAL_ERROR(groundStations.GetN() << " ground stations do not fit the plane and satellite fields.");
+    }
+    uint32_t shell = (1u << m_shellBits) - 1;
+    Ipv4InterfaceContainer interfaces;
+    for (uint32_t i = 0; i < groundStations.GetN(); ++i)
+    {
+        interfaces.Add(AssignNode(groundStations.Get(i), shell, i >> m_satelliteBits, i & ((1u << m_satelliteBits) - 1)));
+    }
+    return interfaces;
+}
+
+Ipv4InterfaceContainer
+SatelliteAddressHelper::AssignNode(Ptr<Node> node, uint32_t shell, uint32_t plane, uint32_t satellite)
+{
+    Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
+    NS_ASSERT_MSG(ipv4, "SatelliteAddressHelper needs an internet stack on node " << node->GetId() << ".");
+    Ipv4Mask mask(0xffffffffu << m_interfaceBits);
+
+    // Interfaces are numbered from 1, and all ones is the broadcast address
+    uint32_t numInterfaces = 0;
+    for (uint32_t i = 0; i < node->GetNDevices(); ++i)
+    {
+        if (!DynamicCast<LoopbackNetDevice>(node->GetDevice(i)))
+        {
+            ++numInterfaces;
+        }
+    }
+    if (numInterfaces + 2 > (1u << m_interfaceBits))
+    {
+        uint8_t neededBits = m_interfaceBits;
+        while ((1u << neededBits) < numInterfaces + 2)
+        {
+            ++neededBits;
+        }
+        NS_FATAL_ERROR("Node " << node->GetId() << " has " << numInterfaces << " interfaces but the address layout "
+                       << "leaves " << +m_interfaceBits << " interface bits; take " << neededBits - m_interfaceBits
+                       << " more bits from the network or the other fields with SetBase() or SetLayout().");
+    }
+
+    Ipv4InterfaceContainer interfaces;
+    uint32_t interface = 1;
+    for (uint32_t i = 0; i < node->GetNDevices(); ++i)
+    {
+        Ptr<NetDevice> dev = node->GetDevice(i);
+        if (DynamicCast<LoopbackNetDevice>(dev))
+        {
+            continue;
+        }
+        int32_t index = ipv4->GetInterfaceForDevice(dev);
+        if (index == -1)
+        {
+            index = ipv4->AddInterface(dev);
+        }
+        ipv4->AddAddress(index, Ipv4InterfaceAddress(GetAddress(shell, plane, satellite, interface++), mask));
+        ipv4->SetMetric(index, 1);
+        ipv4->SetUp(index);
+        interfaces.Add(ipv4, index);
+    }
+
+    Ipv4Address prefix(GetAddress(shell, plane, satellite, 1).Get() & mask.Get());
+    m_prefixes.push_back({prefix, GetNodePrefixLength(), node});
+    return interfaces;
+}
+
+} // namespace ns3
@@ -0,0 +1,110 @@
+#ifndef SATELLITE_ADDRESS_HELPER_H
+#define SATELLITE_ADDRESS_HELPER_H
+
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv4-interface-container.h"
+#include "ns3/node-container.h"
+
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * @ingroup satellite
+ * @brief Assigns IPv4 addresses that follow the constellation layout.
+ *
+ * An address is split into network / shell / plane / satellite / interface
+ * fields, so all interfaces of a satellite share one satellite prefix.
+ * Routing can then map a destination to its satellite with one prefix per
+ * satellite instead of one entry per interface (see
+ * SatelliteSpRoutingHelper::PopulateIpToNodeMap()).
+ *
+ * The last shell value is reserved for ground stations, which are numbered
+ * over the plane and satellite fields.
+ *
+ * The default layout is 10.0.0.0/8 with 2 shell, 7 plane and 7 satellite
+ * bits, leaving 8 bits, i.e. 254 addresses, for the interfaces of a node.
+ * Nodes with more devices, e.g. in a full mesh of more than 253 satellites,
+ * need a wider interface field from SetBase() or SetLayout(); addressing
+ * stops with an error naming the bits that are missing.
+ */
+class SatelliteAddressHelper
+{
+public:
+    SatelliteAddressHelper();
+
+    /**
+     * @brief Set the network all addresses are taken from.
+     * @param network The network address.
+     * @param mask The network mask.
+     */
+    void SetBase(Ipv4Address network, Ipv4Mask mask);
+
+    /**
+     * @brief Set the width of the fields below the network; the interface field gets the rest.
+     * @param shellBits Bits of the shell field.
+     * @param planeBits Bits of the plane field.
+     * @param satelliteBits Bits of the satellite field.
+     */
+    void SetLayout(uint8_t shellBits, uint8_t planeBits, uint8_t satelliteBits);
+
+    /**
+     * @brief Address every interface of every satellite of a shell.
+     *
+     * Interfaces are created for devices that have none yet, and brought up.
+     * @param shell The shell number, below the reserved ground station shell.
+     * @param orbitalPlanes The satellites of every plane, as given to
+     *        InterSatelliteLinkHelper::Install().
+     * @return The addressed interfaces.
+     */
+    Ipv4InterfaceContainer Assign(uint32_t shell, const std::vector<NodeContainer>& orbitalPlanes);
+
+    /**
+     * @brief Address every interface of the ground stations, in the reserved shell.
+     * @param groundStations The ground stations.
+     * @return The addressed interfaces.
+     */
+    Ipv4InterfaceContainer AssignGroundStations(const NodeContainer& groundStations);
+
+    /**
+     * @param shell The shell number.
+     * @param plane The plane number.
+     * @param satellite The satellite number in the plane.
+     * @param interface The interface number, from 1.
+     * @return The address of the interface.
+     */
+    Ipv4Address GetAddress(uint32_t shell, uint32_t plane, uint32_t satellite, uint32_t interface) const;
+
+    /**
+     * @return The prefix length shared by the interfaces of one node.
+     */
+    uint8_t GetNodePrefixLength() const;
+
+    /// One prefix per node addressed so far.
+    struct NodePrefix
+    {
+        Ipv4Address prefix;
+        uint8_t length;
+        Ptr<Node> node;
+    };
+
+    /**
+     * @return The prefix of every node addressed by this helper.
+     */
+    const std::vector<NodePrefix>& GetNodePrefixes() const;
+
+private:
+    Ipv4InterfaceContainer AssignNode(Ptr<Node> node, uint32_t shell, uint32_t plane, uint32_t satellite);
+
+    uint32_t m_network;       //!< Network address bits
+    uint8_t m_networkBits;    //!< Network prefix length
+    uint8_t m_shellBits;
+    uint8_t m_planeBits;
+    uint8_t m_satelliteBits;
+    uint8_t m_interfaceBits;  //!< What the other fields leave
+    std::vector<NodePrefix> m_prefixes;
+};
+
+} // namespace ns3
+
+#endif /* SATELLITE_ADDRESS_HELPER_H */
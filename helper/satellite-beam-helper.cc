@@ -0,0 +1,107 @@
+#include "satellite-beam-helper.h"
+#include "ns3/core-module.h"
+#include "ns3/log.h"
+#include "ns3/mobility-model.h"
+
+#include <limits>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SatelliteBeamHelper");
+
+SatelliteBeamHelper::SatelliteBeamHelper()
+{
+    m_deviceFactory.SetTypeId("ns3::SatelliteBeamNetDevice");
+    m_channelFactory.SetTypeId("ns3::SatelliteBeamChannel");
+
+    // Set a default queue type
+    SetQueue("ns3::DropTailQueue");
+}
+
+void
+SatelliteBeamHelper::SetChannelAttribute(std::string name, const AttributeValue& value)
+{
+    m_channelFactory.Set(name, value);
+}
+
+void
+SatelliteBeamHelper::SetDeviceAttribute(std::string name, const AttributeValue& value)
+{
+    m_deviceFactory.Set(name, value);
+}
+
+template <typename... Ts>
+void
+SatelliteBeamHelper::SetQueue(std::string type, Ts&&... args)
+{
+    QueueBase::AppendItemTypeIfNotPresent(type, "Packet");
+
+    m_queueFactory.SetTypeId(type);
+    m_queueFactory.Set(std::forward<Ts>(args)...);
+}
+
+void
+SatelliteBeamHelper::SetPropagationDelayModel(Ptr<PropagationDelayModel> delay)
+{
+    m_delay = delay;
+}
+
+Ptr<SatelliteBeamNetDevice>
+SatelliteBeamHelper::CreateDevice(Ptr<Node> node) const
+{
+    Ptr<SatelliteBeamNetDevice> device = m_deviceFactory.Create<SatelliteBeamNetDevice>();
+    device->SetAddress(Mac48Address::Allocate());
+    device->SetQueue(m_queueFactory.Create<Queue<Packet>>());
+    node->AddDevice(device);
+    return device;
+}
+
+NetDeviceContainer
+SatelliteBeamHelper::Install(const NodeContainer& satellites, const NodeContainer& groundStations) const
+{
+    NetDeviceContainer allDevices;
+    std::vector<Ptr<SatelliteBeamNetDevice>> beams;
+
+    for (auto satit = satellites.Begin(); satit != satellites.End(); ++satit)
+    {
+        Ptr<SatelliteBeamChannel> channel = m_channelFactory.Create<SatelliteBeamChannel>();
+        if (m_delay)
+        {
+            channel->SetPropagationDelayModel(m_delay);
+        }
+        Ptr<SatelliteBeamNetDevice> device = CreateDevice(*satit);
+        device->SetBeam(channel);
+        beams.push_back(device);
+        allDevices.Add(device);
+    }
+
+    for (auto gsit = groundStations.Begin(); gsit != groundStations.End(); ++gsit)
+    {
+        Ptr<SatelliteBeamNetDevice> terminal = CreateDevice(*gsit);
+        allDevices.Add(terminal);
+
+        // Start in the beam of the nearest satellite
+        Vector position = (*gsit)->GetObject<MobilityModel>()->GetPosition();
+        Ptr<SatelliteBeamNetDevice> nearest;
+        double bestDistance = std::numeric_limits<double>::max();
+        for (const Ptr<SatelliteBeamNetDevice>& beam : beams)
+        {
+            double distance = CalculateDistance(position, beam->GetNode()->GetObject<MobilityModel>()->GetPosition());
+            if (distance < bestDistance)
+            {
+                bestDistance = distance;
+                nearest = beam;
+            }
+        }
+        if (nearest)
+        {
+            terminal->Handover(nearest->GetBeam());
+        }
+    }
+
+    NS_LOG_INFO("Installed " << beams.size() << " beams and " << groundStations.GetN() << " terminals");
+    return allDevices;
+}
+
+} // namespace ns3
@@ -0,0 +1,82 @@
+#ifndef SATELLITE_BEAM_HELPER_H
+#define SATELLITE_BEAM_HELPER_H
+
+#include "ns3/net-device-container.h"
+#include "ns3/node-container.h"
+#include "ns3/object-factory.h"
+#include "ns3/propagation-delay-model.h"
+#include "ns3/queue.h"
+#include "ns3/satellite-beam-channel.h"
+#include "ns3/satellite-beam-net-device.h"
+
+namespace ns3
+{
+
+/**
+ * @ingroup satellite
+ * @brief A helper to give satellites a shared beam and ground stations a terminal.
+ *
+ * An alternative to GroundSatelliteLinkHelper: instead of one point-to-point
+ * link per ground station and satellite pair, every satellite gets one beam
+ * device and every ground station one terminal device, all of which can be
+ * put in a single IP subnet. Terminals start in the beam of the nearest
+ * satellite; SatelliteSpRoutingProtocol then hands them over to the egress
+ * satellite of their ground station as the constellation moves.
+ */
+class SatelliteBeamHelper
+{
+public:
+    SatelliteBeamHelper();
+
+    /**
+     * @brief Set an attribute on the beam channels.
+     * @param name The name of the attribute to set.
+     * @param value The value of the attribute.
+     */
+    void SetChannelAttribute(std::string name, const AttributeValue& value);
+
+    /**
+     * @brief Set an attribute on the devices.
+     * @param name The name of the attribute to set.
+     * @param value The value of the attribute.
+     */
+    void SetDeviceAttribute(std::string name, const AttributeValue& value);
+
+    /**
+     * @brief Set the type of queue to use for the devices created by this helper.
+     * @tparam Ts Argument types
+     * @param type The type of queue
+     * @param args Name and AttributeValue pairs to set on the queue.
+     */
+    template <typename... Ts>
+    void SetQueue(std::string type, Ts&&... args);
+
+    /**
+     * @brief Set the propagation delay model for the beams.
+     * @param delay The propagation delay model.
+     */
+    void SetPropagationDelayModel(Ptr<PropagationDelayModel> delay);
+
+    /**
+     * @brief Install a beam on every satellite and a terminal on every ground station.
+     * @param satellites The container of satellite nodes.
+     * @param groundStations The container of ground station nodes.
+     * @return A NetDeviceContainer with the satellite devices followed by the terminals.
+     */
+    NetDeviceContainer Install(const NodeContainer& satellites, const NodeContainer& groundStations) const;
+
+private:
+    /**
+     * @brief Create a device on a node.
+     */
+    Ptr<SatelliteBeamNetDevice> CreateDevice(Ptr<Node> node) const;
+
+    ObjectFactory m_deviceFactory;
+    ObjectFactory m_channelFactory;
+    ObjectFactory m_queueFactory;
+    Ptr<PropagationDelayModel> m_delay;
+};
+
+} // namespace ns3
+
+#endif /* SATELLITE_BEAM_HELPER_H */
@@ -1,4 +1,5 @@
 #include "satellite-routing-helper.h"
+#include "../model/satellite-route-update-scheduler.h"
 #include "../model/satellite-routing-protocol.h"
 #include "ns3/ipv4-list-routing.h"
 #include "ns3/log.h"
@@ -78,4 +79,10 @@ SatelliteRoutingHelper::AddIpToNodeMapping()
     SatelliteRoutingProtocol::AddIpToNodeMapping(allNodes);
 }
 
+void
+SatelliteRoutingHelper::SetUpdateSchedulerAttribute(std::string name, const AttributeValue& value)
+{
+    SatelliteRouteUpdateScheduler::Get()->SetAttribute(name, value);
+}
+
 } // namespace ns3 
\ No newline at end of file
@@ -1,6 +1,7 @@
 #ifndef SATELLITE_ROUTING_HELPER_H
 #define SATELLITE_ROUTING_HELPER_H
 
+#include "ns3/attribute.h"
 #include "ns3/ipv4-routing-helper.h"
 #include "ns3/node-container.h"
 #include <vector>
@@ -47,6 +48,13 @@ public:
      */
     static void AddIpToNodeMapping();
 
+    /**
+     * @brief Set an attribute on the shared SatelliteRouteUpdateScheduler.
+     * @param name The name of the attribute to set.
+     * @param value The value of the attribute.
+     */
+    static void SetUpdateSchedulerAttribute(std::string name, const AttributeValue& value);
+
 private:
     std::shared_ptr<const std::vector<NodeContainer>> m_orbitalPlanes;
     /**
@@ -1,4 +1,5 @@
 #include "satellite-sp-routing-helper.h"
+#include "../model/satellite-route-update-scheduler.h"
 #include "../model/satellite-sp-routing-protocol.h"
 #include "ns3/ipv4-list-routing.h"
 #include "ns3/log.h"
@@ -62,4 +63,45 @@ SatelliteSpRoutingHelper::PopulateIpToNodeMap()
     SatelliteSpRoutingProtocol::AddIpToNodeMapping();
 }
 
+void
+SatelliteSpRoutingHelper::PopulateIpToNodeMap(const SatelliteAddressHelper& addresses)
+{
+    SatelliteSpRoutingProtocol::ClearIpToNodeMapping();
+    for (const SatelliteAddressHelper::NodePrefix& entry : addresses.GetNodePrefixes())
+    {
+        SatelliteSpRoutingProtocol::AddPrefixToNodeMapping(entry.prefix, entry.length, entry.node);
+    }
+    SatelliteSpRoutingProtocol::AddIpToNodeMapping();
+}
+
+void
+SatelliteSpRoutingHelper::SetOrbitalPlanes(const std::vector<NodeContainer>& orbitalPlanes)
+{
+    SatelliteSpRoutingProtocol::SetOrbitalPlanes(orbitalPlanes);
+}
+
+void
+SatelliteSpRoutingHelper::SetRouteEngineAttribute(std::string name, const AttributeValue& value)
+{
+    SatelliteSpRoutingProtocol::GetRouteEngine()->SetAttribute(name, value);
+}
+
+void
+SatelliteSpRoutingHelper::SetContactPlan(Ptr<SatelliteContactPlan> plan)
+{
+    SatelliteSpRoutingProtocol::GetRouteEngine()->SetContactPlan(plan);
+}
+
+void
+SatelliteSpRoutingHelper::SetUpdateSchedulerAttribute(std::string name, const AttributeValue& value)
+{
+    SatelliteRouteUpdateScheduler::Get()->SetAttribute(name, value);
+}
+
+uint32_t
+SatelliteSpRoutingHelper::GetNActiveSatellites()
+{
+    return SatelliteSpRoutingProtocol::GetNActiveSatellites();
+}
+
 } // namespace ns3
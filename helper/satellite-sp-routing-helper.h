@@ -1,8 +1,13 @@
 #ifndef SATELLITE_SP_ROUTING_HELPER_H
 #define SATELLITE_SP_ROUTING_HELPER_H
 
+#include "ns3/attribute.h"
 #include "ns3/ipv4-routing-helper.h"
 #include "ns3/node-container.h"
+#include "ns3/satellite-address-helper.h"
+#include "ns3/satellite-contact-plan.h"
+
+#include <vector>
 
 namespace ns3 {
 
@@ -36,6 +41,58 @@ public:
      */
     static void PopulateIpToNodeMap();
 
+    /**
+     * @brief Populate the node lookup with the node prefixes of an address helper.
+     *
+     * Addresses under a node prefix need no entry of their own, so the lookup
+     * holds one prefix per satellite, plus the addresses assigned otherwise.
+     * Call after all addresses are assigned, instead of PopulateIpToNodeMap().
+     * @param addresses The helper that addressed the nodes.
+     */
+    static void PopulateIpToNodeMap(const SatelliteAddressHelper& addresses);
+
+    /**
+     * @brief Tell the route engine the orbital planes, enabling its GridRouting mode.
+     *
+     * Call before SatelliteSpRoutingProtocol::InitializeTopology(), with the same
+     * planes given to InterSatelliteLinkHelper::Install().
+     * @param orbitalPlanes A vector of NodeContainers, each representing an orbital plane.
+     */
+    static void SetOrbitalPlanes(const std::vector<NodeContainer>& orbitalPlanes);
+
+    /**
+     * @brief Set an attribute on the constellation-wide SatelliteRouteEngine.
+     * @param name The name of the attribute to set.
+     * @param value The value of the attribute.
+     */
+    static void SetRouteEngineAttribute(std::string name, const AttributeValue& value);
+
+    /**
+     * @brief Let ground stations only use satellites visible in a contact plan.
+     *
+     * Pass the same plan to GroundSatelliteLinkHelper::SetContactPlan() so the
+     * links follow the same windows.
+     * @param plan The contact plan.
+     */
+    static void SetContactPlan(Ptr<SatelliteContactPlan> plan);
+
+    /**
+     * @brief Set an attribute on the shared SatelliteRouteUpdateScheduler.
+     * @param name The name of the attribute to set.
+     * @param value The value of the attribute.
+     */
+    static void SetUpdateSchedulerAttribute(std::string name, const AttributeValue& value);
+
+    /**
+     * @brief Get the number of satellites that computed routes since the last
+     *        PopulateIpToNodeMap().
+     *
+     * With the LazyUpdate attribute of SatelliteSpRoutingProtocol set, satellites
+     * that never handle a packet never compute routes and are not counted.
+     * @return The number of satellites.
+     */
+    static uint32_t GetNActiveSatellites();
+
 private:
     // No member variables needed now
 };
@@ -11,6 +11,8 @@
 #include "ns3/simulator.h"
 #include "ns3/mac48-address.h"
 
+#include <algorithm>
+
 namespace ns3
 {
 
@@ -64,6 +66,13 @@ GroundSatelliteChannel::SetPropagationDelayModel(const Ptr<PropagationDelayModel
     m_delay = delay;
 }
 
+void
+GroundSatelliteChannel::SetContactPlan(Ptr<SatelliteContactPlan> plan)
+{
+    NS_LOG_FUNCTION(this);
+    m_contactPlan = plan;
+}
+
 void
 GroundSatelliteChannel::Add(Ptr<GroundSatellitePhy> phy)
 {
@@ -72,6 +81,15 @@ GroundSatelliteChannel::Add(Ptr<GroundSatellitePhy> phy)
     m_phyList.push_back(phy);
 }
 
+void
+GroundSatelliteChannel::Remove(Ptr<GroundSatellitePhy> phy)
+{
+    NS_LOG_FUNCTION(this << phy);
+    auto it = std::find(m_phyList.begin(), m_phyList.end(), phy);
+    NS_ASSERT_MSG(it != m_phyList.end(), "PHY is not attached to this GroundSatelliteChannel.");
+    m_phyList.erase(it);
+}
+
 std::size_t
 GroundSatelliteChannel::GetNDevices() const
 {
@@ -96,11 +114,30 @@ GroundSatelliteChannel::Send(Ptr<GroundSatellitePhy> sender,
                              double txPowerDbm) const
 {
     NS_LOG_FUNCTION(this << sender << packet << txPowerDbm);
-    NS_ASSERT_MSG(m_phyList.size() == 2, "GroundSatelliteChannel should have exactly two PHY devices for P2P communication.");
+    NS_ASSERT_MSG(m_phyList.size() <= 2, "GroundSatelliteChannel should have at most two PHY devices for P2P communication.");
+    if (m_phyList.size() < 2)
+    {
+        // An on-demand link that is not bound to a satellite
+        NS_LOG_LOGIC("Channel has no peer, dropping packet");
+        return;
+    }
 
     // Find the receiver PHY
     Ptr<GroundSatellitePhy> receiver = (m_phyList[0] == sender) ? m_phyList[1] : m_phyList[0];
 
+    if (m_contactPlan)
+    {
+        // Either end may be the ground station
+        Ptr<Node> a = sender->GetNode();
+        Ptr<Node> b = receiver->GetNode();
+        Time now = Simulator::Now();
+        if (!m_contactPlan->IsInContact(a, b, now) && !m_contactPlan->IsInContact(b, a, now))
+        {
+            NS_LOG_LOGIC("Nodes " << a->GetId() << " and " << b->GetId() << " are not in contact, dropping packet");
+            return;
+        }
+    }
+
     double rxPowerDbm = txPowerDbm;
     if (m_loss)
     {
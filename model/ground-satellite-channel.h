@@ -4,6 +4,7 @@
 #include "ns3/channel.h"
 #include "ns3/pointer.h"
 #include "ns3/address.h"
+#include "satellite-contact-plan.h"
 
 namespace ns3
 {
@@ -47,6 +48,15 @@ public:
      */
     void Add(Ptr<GroundSatellitePhy> phy);
 
+    /**
+     * @brief Detach a GroundSatellitePhy object from this channel.
+     * @param phy The GroundSatellitePhy to remove.
+     *
+     * Used by GroundSatelliteLinkManager to release an on-demand link; a
+     * channel with a single PHY drops what it is given to send.
+     */
+    void Remove(Ptr<GroundSatellitePhy> phy);
+
     /**
      * @brief Set the propagation loss model for this channel.
      * @param loss The propagation loss model.
@@ -59,6 +69,12 @@ public:
      */
     void SetPropagationDelayModel(const Ptr<PropagationDelayModel> delay);
 
+    /**
+     * @brief Drop packets sent while the two ends are not in contact.
+     * @param plan The contact plan, or nullptr to always deliver.
+     */
+    void SetContactPlan(Ptr<SatelliteContactPlan> plan);
+
     /**
      * @brief Send a packet over the channel.
      * @param sender The sending PHY object.
@@ -88,6 +104,7 @@ private:
 
     Ptr<PropagationLossModel> m_loss;   //!< The propagation loss model.
     Ptr<PropagationDelayModel> m_delay; //!< The propagation delay model.
+    Ptr<SatelliteContactPlan> m_contactPlan; //!< Visibility windows, may be null.
 };
 
 } // namespace ns3
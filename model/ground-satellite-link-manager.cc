@@ -0,0 +1,242 @@
+#include "ground-satellite-link-manager.h"
+#include "ground-satellite-channel.h"
+#include "ground-satellite-net-device.h"
+#include "ground-satellite-phy.h"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("GroundSatelliteLinkManager");
+
+NS_OBJECT_ENSURE_REGISTERED(GroundSatelliteLinkManager);
+
+TypeId
+GroundSatelliteLinkManager::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::GroundSatelliteLinkManager")
+                            .SetParent<Object>()
+                            .SetGroupName("Satellite")
+                            .AddConstructor<GroundSatelliteLinkManager>()
+                            .AddTraceSource("ActiveLinks",
+                                            "The number of ground-to-satellite links currently bound.",
+                                            MakeTraceSourceAccessor(&GroundSatelliteLinkManager::m_activeLinks),
+                                            "ns3::TracedValueCallback::Uint32");
+    return tid;
+}
+
+GroundSatelliteLinkManager::GroundSatelliteLinkManager()
+    : m_activeLinks(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+GroundSatelliteLinkManager::~GroundSatelliteLinkManager()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+GroundSatelliteLinkManager::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_groundStationSlots.clear();
+    m_satelliteSlots.clear();
+    m_plan = nullptr;
+    Object::DoDispose();
+}
+
+void
+GroundSatelliteLinkManager::SetContactPlan(Ptr<SatelliteContactPlan> plan)
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT_MSG(plan && plan->IsOpen(), "GroundSatelliteLinkManager needs an open contact plan.");
+    m_plan = plan;
+    m_groundStationSlots.assign(plan->GetNGroundStations(), {});
+    m_satelliteSlots.assign(plan->GetNSatellites(), {});
+    m_nextContact.assign(plan->GetNGroundStations(), 0);
+}
+
+Ptr<SatelliteContactPlan>
+GroundSatelliteLinkManager::GetContactPlan() const
+{
+    return m_plan;
+}
+
+void
+GroundSatelliteLinkManager::AddGroundStationDevice(uint32_t groundStation,
+                                                   Ptr<GroundSatelliteNetDevice> device,
+                                                   Ptr<GroundSatellitePhy> phy,
+                                                   Ptr<GroundSatelliteChannel> channel)
+{
+    NS_LOG_FUNCTION(this << groundStation << device);
+    NS_ASSERT_MSG(groundStation < m_groundStationSlots.size(), "Ground station " << groundStation << " not in the plan.");
+    m_groundStationSlots[groundStation].push_back({device, phy, channel, UNBOUND, 0, 0});
+}
+
+void
+GroundSatelliteLinkManager::AddSatelliteDevice(uint32_t satellite,
+                                               Ptr<GroundSatelliteNetDevice> device,
+                                               Ptr<GroundSatellitePhy> phy)
+{
+    NS_LOG_FUNCTION(this << satellite << device);
+    NS_ASSERT_MSG(satellite < m_satelliteSlots.size(), "Satellite " << satellite << " not in the plan.");
+    m_satelliteSlots[satellite].push_back({device, phy, false});
+}
+
+uint32_t
+GroundSatelliteLinkManager::GetNActiveLinks() const
+{
+    return m_activeLinks;
+}
+
+void
+GroundSatelliteLinkManager::Start()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT_MSG(m_plan, "GroundSatelliteLinkManager has no contact plan.");
+    int64_t now = Simulator::Now().GetNanoSeconds();
+    for (uint32_t g = 0; g < m_groundStationSlots.size(); ++g)
+    {
+        // Bind the contacts in progress and skip the past ones
+        uint32_t last = m_plan->GetFirstContact(g + 1);
+        uint32_t next = m_plan->GetFirstContact(g);
+        for (; next < last && m_plan->GetContact(next).start <= now; ++next)
+        {
+            if (now < m_plan->GetContact(next).end)
+            {
+                Bind(next);
+            }
+        }
+        m_nextContact[g] = next;
+        if (next < last)
+        {
+            Simulator::Schedule(NanoSeconds(m_plan->GetContact(next).start - now),
+                                &GroundSatelliteLinkManager::StartContacts,
+                                this,
+                                g);
+        }
+    }
+    NS_LOG_INFO("Bound " << m_activeLinks << " ground links at " << Simulator::Now().GetSeconds() << "s");
+}
+
+void
+GroundSatelliteLinkManager::StartContacts(uint32_t groundStation)
+{
+    NS_LOG_FUNCTION(this << groundStation);
+    UnbindEnded(groundStation);
+
+    int64_t now = Simulator::Now().GetNanoSeconds();
+    uint32_t last = m_plan->GetFirstContact(groundStation + 1);
+    uint32_t& next = m_nextContact[groundStation];
+    while (next < last && m_plan->GetContact(next).start <= now)
+    {
+        Bind(next++);
+    }
+    if (next < last)
+    {
+        Simulator::Schedule(NanoSeconds(m_plan->GetContact(next).start - now),
+                            &GroundSatelliteLinkManager::StartContacts,
+                            this,
+                            groundStation);
+    }
+}
+
+void
+GroundSatelliteLinkManager::Bind(uint32_t contact)
+{
+    const SatelliteContact& c = m_plan->GetContact(contact);
+    NS_LOG_FUNCTION(this << contact << c.groundStation << c.satellite);
+    int64_t now = Simulator::Now().GetNanoSeconds();
+
+    std::vector<GroundStationSlot>& gsSlots = m_groundStationSlots[c.groundStation];
+    uint32_t gsSlot = 0;
+    while (gsSlot < gsSlots.size() && gsSlots[gsSlot].satellite != UNBOUND)
+    {
+        ++gsSlot;
+    }
+
+    // A satellite device may still be bound to a contact of another ground
+    // station that ends now and was not released yet
+    std::vector<SatelliteSlot>& satSlots = m_satelliteSlots[c.satellite];
+    uint32_t satSlot = 0;
+    while (satSlot < satSlots.size() && satSlots[satSlot].bound)
+    {
+        ++satSlot;
+    }
+    if (satSlot == satSlots.size())
+    {
+        for (uint32_t g = 0; g < m_groundStationSlots.size() && satSlot == satSlots.size(); ++g)
+        {
+            for (uint32_t i = 0; i < m_groundStationSlots[g].size(); ++i)
+            {
+                const GroundStationSlot& other = m_groundStationSlots[g][i];
+                if (other.satellite == c.satellite && other.end <= now)
+                {
+                    satSlot = other.slot;
+                    Unbind(g, i);
+                    break;
+                }
+            }
+        }
+    }
+
+    if (gsSlot == gsSlots.size() || satSlot == satSlots.size())
+    {
+        NS_LOG_WARN("No free ground link device for ground station " << c.groundStation << " and satellite "
+                    << c.satellite << "; the pools are smaller than the contact plan needs.");
+        return;
+    }
+
+    GroundStationSlot& gs = gsSlots[gsSlot];
+    SatelliteSlot& sat = satSlots[satSlot];
+    gs.channel->Add(sat.phy);
+    sat.phy->SetChannel(gs.channel);
+    sat.device->SetChannel(gs.channel);
+    gs.satellite = c.satellite;
+    gs.slot = satSlot;
+    gs.end = c.end;
+    sat.bound = true;
+    ++m_activeLinks;
+
+    gs.device->SetLinkUp(true);
+    sat.device->SetLinkUp(true);
+    Simulator::Schedule(NanoSeconds(c.end - now), &GroundSatelliteLinkManager::UnbindEnded, this, c.groundStation);
+}
+
+void
+GroundSatelliteLinkManager::Unbind(uint32_t groundStation, uint32_t slot)
+{
+    NS_LOG_FUNCTION(this << groundStation << slot);
+    GroundStationSlot& gs = m_groundStationSlots[groundStation][slot];
+    NS_ASSERT_MSG(gs.satellite != UNBOUND, "Ground link device is not bound.");
+    SatelliteSlot& sat = m_satelliteSlots[gs.satellite][gs.slot];
+
+    gs.device->SetLinkUp(false);
+    sat.device->SetLinkUp(false);
+    gs.channel->Remove(sat.phy);
+    sat.phy->SetChannel(nullptr);
+    sat.device->SetChannel(nullptr);
+    gs.satellite = UNBOUND;
+    sat.bound = false;
+    --m_activeLinks;
+}
+
+void
+GroundSatelliteLinkManager::UnbindEnded(uint32_t groundStation)
+{
+    NS_LOG_FUNCTION(this << groundStation);
+    int64_t now = Simulator::Now().GetNanoSeconds();
+    std::vector<GroundStationSlot>& slots = m_groundStationSlots[groundStation];
+    for (uint32_t i = 0; i < slots.size(); ++i)
+    {
+        if (slots[i].satellite != UNBOUND && slots[i].end <= now)
+        {
+            Unbind(groundStation, i);
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,150 @@
+#ifndef GROUND_SATELLITE_LINK_MANAGER_H
+#define GROUND_SATELLITE_LINK_MANAGER_H
+
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/traced-value.h"
+#include "satellite-contact-plan.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace ns3
+{
+
+class GroundSatelliteChannel;
+class GroundSatelliteNetDevice;
+class GroundSatellitePhy;
+
+/**
+ * @ingroup satellite
+ * @brief Binds pooled ground-to-satellite devices to the pairs in contact.
+ *
+ * Instead of a link for every ground station and satellite pair, every node
+ * gets as many ground link devices as it ever has contacts at the same time
+ * in the contact plan. When a satellite rises above the elevation mask of a
+ * ground station the manager takes a free device of each, attaches them to
+ * one channel and brings both links up; when it sets, it takes the links down
+ * and returns the devices to their pools. Memory therefore scales with the
+ * pairs in view rather than with the ground stations times the satellites.
+ *
+ * Devices are recycled rather than created and destroyed because ns-3 nodes
+ * cannot remove devices, and because IP interfaces and addresses are assigned
+ * once, before the simulation starts.
+ *
+ * Only the next contact of every ground station and the end of every bound
+ * link are scheduled at any time.
+ */
+class GroundSatelliteLinkManager : public Object
+{
+public:
+    /**
+     * @brief Get the type ID.
+     * @return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    GroundSatelliteLinkManager();
+    ~GroundSatelliteLinkManager() override;
+
+    /**
+     * @brief Set the contact plan driving the links, sizing the pools.
+     * @param plan An open contact plan.
+     */
+    void SetContactPlan(Ptr<SatelliteContactPlan> plan);
+    Ptr<SatelliteContactPlan> GetContactPlan() const;
+
+    /**
+     * @brief Add a ground station device to the pool of its ground station.
+     * @param groundStation The ground station number in the plan.
+     * @param device The device, with its link down.
+     * @param phy Its PHY, attached to channel.
+     * @param channel A channel owned by the device, with only phy attached.
+     */
+    void AddGroundStationDevice(uint32_t groundStation,
+                                Ptr<GroundSatelliteNetDevice> device,
+                                Ptr<GroundSatellitePhy> phy,
+                                Ptr<GroundSatelliteChannel> channel);
+
+    /**
+     * @brief Add a satellite device to the pool of its satellite.
+     * @param satellite The satellite number in the plan.
+     * @param device The device, with its link down and no channel.
+     * @param phy Its PHY.
+     */
+    void AddSatelliteDevice(uint32_t satellite, Ptr<GroundSatelliteNetDevice> device, Ptr<GroundSatellitePhy> phy);
+
+    /**
+     * @brief Bind the contacts in progress and schedule the following ones.
+     *
+     * Called once, after all devices were added.
+     */
+    void Start();
+
+    /**
+     * @return The number of links currently bound.
+     */
+    uint32_t GetNActiveLinks() const;
+
+protected:
+    void DoDispose() override;
+
+private:
+    static constexpr uint32_t UNBOUND = 0xffffffff;
+
+    /// A ground station device and the channel it owns.
+    struct GroundStationSlot
+    {
+        Ptr<GroundSatelliteNetDevice> device;
+        Ptr<GroundSatellitePhy> phy;
+        Ptr<GroundSatelliteChannel> channel;
+        uint32_t satellite; //!< Bound satellite number, or UNBOUND
+        uint32_t slot;      //!< Bound slot in the pool of the satellite
+        int64_t end;        //!< End of the bound contact, in nanoseconds
+    };
+
+    /// A satellite device.
+    struct SatelliteSlot
+    {
+        Ptr<GroundSatelliteNetDevice> device;
+        Ptr<GroundSatellitePhy> phy;
+        bool bound;
+    };
+
+    /**
+     * @brief Bind the contacts of a ground station starting now and schedule
+     *        its next contact.
+     * @param groundStation The ground station number in the plan.
+     */
+    void StartContacts(uint32_t groundStation);
+
+    /**
+     * @brief Bind the devices of a contact in progress and schedule its end.
+     * @param contact The contact number in the plan.
+     */
+    void Bind(uint32_t contact);
+
+    /**
+     * @brief Release a ground station device and the satellite device bound to it.
+     * @param groundStation The ground station number in the plan.
+     * @param slot The slot in the pool of the ground station.
+     */
+    void Unbind(uint32_t groundStation, uint32_t slot);
+
+    /**
+     * @brief Release the links of a ground station whose contacts ended by now.
+     *
+     * Ends and starts at the same instant run in no particular order.
+     */
+    void UnbindEnded(uint32_t groundStation);
+
+    Ptr<SatelliteContactPlan> m_plan;
+    std::vector<std::vector<GroundStationSlot>> m_groundStationSlots; //!< By ground station number
+    std::vector<std::vector<SatelliteSlot>> m_satelliteSlots;         //!< By satellite number
+    std::vector<uint32_t> m_nextContact; //!< Next contact to bind, by ground station number
+    TracedValue<uint32_t> m_activeLinks;
+};
+
+} // namespace ns3
+
+#endif /* GROUND_SATELLITE_LINK_MANAGER_H */
@@ -191,7 +191,12 @@ bool
 GroundSatelliteNetDevice::Send(Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber)
 {
     NS_LOG_FUNCTION(this << packet << dest << protocolNumber);
-    
+    if (!m_linkUp || !m_channel)
+    {
+        NS_LOG_LOGIC("Link is down, dropping packet");
+        return false;
+    }
+
     GroundSatelliteMacHeader macHeader;
     macHeader.SetSource(m_address);
     macHeader.SetProtocol(protocolNumber);
@@ -279,6 +284,22 @@ GroundSatelliteNetDevice::SetQueue(Ptr<Queue<Packet>> queue)
     m_queue = queue;
 }
 
+void
+GroundSatelliteNetDevice::SetLinkUp(bool linkUp)
+{
+    NS_LOG_FUNCTION(this << linkUp);
+    if (m_linkUp == linkUp)
+    {
+        return;
+    }
+    m_linkUp = linkUp;
+    if (!linkUp && m_queue)
+    {
+        m_queue->Flush();
+    }
+    m_linkChangeCallback();
+}
+
 void
 GroundSatelliteNetDevice::TxMachine()
 {
@@ -309,6 +330,12 @@ void
 GroundSatelliteNetDevice::Receive(Ptr<Packet> packet, const Address& sender)
 {
     NS_LOG_FUNCTION(this << packet << sender);
+    if (!m_linkUp)
+    {
+        // Sent before the link was released
+        NS_LOG_LOGIC("Link is down, dropping packet");
+        return;
+    }
 
     GroundSatelliteMacHeader macHeader;
     packet->RemoveHeader(macHeader);
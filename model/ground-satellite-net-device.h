@@ -59,6 +59,16 @@ public:
     void SetChannel(Ptr<GroundSatelliteChannel> channel);
     void Receive(Ptr<Packet> packet, const Address& sender);
     void SetQueue(Ptr<Queue<Packet>> queue);
+
+    /**
+     * @brief Bring the link up or down and notify the link change callbacks.
+     *
+     * A device whose link is down drops what it is given to send or receives,
+     * and taking the link down drops its queue.
+     *
+     * @param linkUp The new state.
+     */
+    void SetLinkUp(bool linkUp);
     void TxMachine(void);
     void TxComplete(void);
 
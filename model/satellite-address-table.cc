@@ -0,0 +1,95 @@
+#include "satellite-address-table.h"
+
+namespace ns3 {
+
+namespace {
+    constexpr uint32_t INITIAL_CAPACITY = 64;
+}
+
+SatelliteAddressTable::SatelliteAddressTable()
+    : m_entries(INITIAL_CAPACITY),
+      m_mask(INITIAL_CAPACITY - 1),
+      m_size(0)
+{
+}
+
+uint32_t
+SatelliteAddressTable::Slot(uint32_t key) const
+{
+    // Fibonacci hashing; consecutive addresses of one subnet spread over the table
+    return (key * 2654435769u) & m_mask;
+}
+
+void
+SatelliteAddressTable::Insert(Ipv4Address address, Ptr<Node> node)
+{
+    if (2 * (m_size + 1) > m_entries.size())
+    {
+        Grow();
+    }
+
+    uint32_t key = address.Get();
+    for (uint32_t i = Slot(key);; i = (i + 1) & m_mask)
+    {
+        Entry& entry = m_entries[i];
+        if (!entry.node)
+        {
+            entry.key = key;
+            entry.node = node;
+            ++m_size;
+            return;
+        }
+        if (entry.key == key)
+        {
+            entry.node = node;
+            return;
+        }
+    }
+}
+
+Ptr<Node>
+SatelliteAddressTable::Find(Ipv4Address address) const
+{
+    uint32_t key = address.Get();
+    for (uint32_t i = Slot(key);; i = (i + 1) & m_mask)
+    {
+        const Entry& entry = m_entries[i];
+        if (!entry.node || entry.key == key)
+        {
+            return entry.node;
+        }
+    }
+}
+
+void
+SatelliteAddressTable::Clear()
+{
+    m_entries.assign(INITIAL_CAPACITY, Entry());
+    m_mask = INITIAL_CAPACITY - 1;
+    m_size = 0;
+}
+
+uint32_t
+SatelliteAddressTable::GetSize() const
+{
+    return m_size;
+}
+
+void
+SatelliteAddressTable::Grow()
+{
+    std::vector<Entry> old;
+    old.swap(m_entries);
+    m_entries.resize(2 * old.size());
+    m_mask = m_entries.size() - 1;
+    m_size = 0;
+    for (const Entry& entry : old)
+    {
+        if (entry.node)
+        {
+            Insert(Ipv4Address(entry.key), entry.node);
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,64 @@
+#ifndef SATELLITE_ADDRESS_TABLE_H
+#define SATELLITE_ADDRESS_TABLE_H
+
+#include "ns3/ipv4-address.h"
+#include "ns3/node.h"
+#include <cstdint>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * @ingroup satellite
+ * @brief Flat open-addressing hash from Ipv4Address to Node.
+ *
+ * Linear probing over a power-of-two array of (address, node) slots kept at
+ * most half full. A lookup hashes the 32-bit address and usually touches one
+ * cache line, instead of walking a red-black tree.
+ */
+class SatelliteAddressTable
+{
+public:
+    SatelliteAddressTable();
+
+    /**
+     * @brief Insert or overwrite a mapping.
+     * @param address The address.
+     * @param node The node owning it.
+     */
+    void Insert(Ipv4Address address, Ptr<Node> node);
+
+    /**
+     * @param address The address.
+     * @return The node owning the address, or nullptr.
+     */
+    Ptr<Node> Find(Ipv4Address address) const;
+
+    /**
+     * @brief Remove every mapping.
+     */
+    void Clear();
+
+    /**
+     * @return The number of mappings.
+     */
+    uint32_t GetSize() const;
+
+private:
+    uint32_t Slot(uint32_t key) const;
+    void Grow();
+
+    struct Entry
+    {
+        uint32_t key;
+        Ptr<Node> node; //!< nullptr marks an empty slot
+    };
+
+    std::vector<Entry> m_entries;
+    uint32_t m_mask;
+    uint32_t m_size;
+};
+
+} // namespace ns3
+
+#endif /* SATELLITE_ADDRESS_TABLE_H */
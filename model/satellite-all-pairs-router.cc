@@ -0,0 +1,177 @@
+#include "satellite-all-pairs-router.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE("SatelliteAllPairsRouter");
+
+SatelliteAllPairsRouter::SatelliteAllPairsRouter()
+    : m_numThreads(1),
+      m_queueType(BINARY_HEAP),
+      m_incrementalRepair(false),
+      m_repairTolerance(0.0),
+      m_numVertices(0),
+      m_treesValid(false),
+      m_lastRepaired(0)
+{
+}
+
+void
+SatelliteAllPairsRouter::SetNThreads(uint32_t numThreads)
+{
+    m_numThreads = numThreads;
+}
+
+void
+SatelliteAllPairsRouter::SetQueueType(QueueType queueType)
+{
+    m_queueType = queueType;
+}
+
+void
+SatelliteAllPairsRouter::SetIncrementalRepair(bool repair, double tolerance)
+{
+    m_incrementalRepair = repair;
+    m_repairTolerance = tolerance;
+}
+
+void
+SatelliteAllPairsRouter::Compute(const SatelliteRouteGraph& graph)
+{
+    uint32_t numVertices = graph.GetNVertices();
+    uint32_t numThreads = m_numThreads ? m_numThreads : std::max(1u, std::thread::hardware_concurrency());
+    if (m_scratch.size() < numThreads)
+    {
+        m_scratch.resize(numThreads);
+    }
+    m_repaired.assign(numThreads, 0);
+
+    size_t tableSize = static_cast<size_t>(numVertices) * numVertices;
+    m_numVertices = numVertices;
+    m_nextHop.resize(tableSize);
+    if (!m_incrementalRepair)
+    {
+        m_treesValid = false;
+    }
+    else if (m_parent.size() != tableSize)
+    {
+        m_dist.resize(tableSize);
+        m_parent.resize(tableSize);
+        m_parentEdge.resize(tableSize);
+        m_treesValid = false;
+    }
+
+    if (numThreads <= 1)
+    {
+        for (uint32_t src = 0; src < numVertices; ++src)
+        {
+            ComputeSource(graph, src, 0);
+        }
+    }
+    else
+    {
+        if (!m_pool || m_pool->GetNThreads() != numThreads)
+        {
+            NS_LOG_INFO("Starting route worker pool with " << numThreads << " threads.");
+            m_pool = std::make_unique<SatelliteWorkerPool>(numThreads);
+        }
+        m_pool->ParallelFor(numVertices, [this, &graph](uint32_t src, uint32_t worker) {
+            ComputeSource(graph, src, worker);
+        });
+    }
+
+    if (m_incrementalRepair && m_treesValid)
+    {
+        m_lastRepaired = 0;
+        for (uint64_t repaired : m_repaired)
+        {
+            m_lastRepaired += repaired;
+        }
+    }
+    else
+    {
+        m_lastRepaired = tableSize;
+    }
+    m_treesValid = m_incrementalRepair;
+    NS_LOG_DEBUG("Epoch repaired " << m_lastRepaired << " of " << tableSize << " tree vertices");
+}
+
+void
+SatelliteAllPairsRouter::ComputeSource(const SatelliteRouteGraph& graph, uint32_t src, uint32_t worker)
+{
+    size_t row = static_cast<size_t>(src) * m_numVertices;
+    SatelliteShortestPathScratch& scratch = m_scratch[worker];
+    if (!m_incrementalRepair)
+    {
+        switch (m_queueType)
+        {
+        case RADIX_HEAP:
+            ComputeShortestPathFirstHops(graph, src, scratch.radixHeap, scratch.delay, scratch.firstHop, &m_nextHop[row]);
+            break;
+        case DIAL:
+            ComputeShortestPathFirstHops(graph, src, scratch.dialQueue, scratch.delay, scratch.firstHop, &m_nextHop[row]);
+            break;
+        default:
+            ComputeShortestPathFirstHops(graph, src, scratch, &m_nextHop[row]);
+            break;
+        }
+    }
+    else if (!m_treesValid)
+    {
+        ComputeShortestPathTree(graph,
+                                src,
+                                scratch,
+                                &m_dist[row],
+                                &m_parent[row],
+                                &m_parentEdge[row],
+                                &m_nextHop[row]);
+    }
+    else
+    {
+        m_repaired[worker] += RepairShortestPathTree(graph,
+                                                     src,
+                                                     m_repairTolerance,
+                                                     scratch,
+                                                     &m_dist[row],
+                                                     &m_parent[row],
+                                                     &m_parentEdge[row],
+                                                     &m_nextHop[row]);
+    }
+}
+
+void
+SatelliteAllPairsRouter::Clear()
+{
+    m_nextHop.clear();
+    m_dist.clear();
+    m_parent.clear();
+    m_parentEdge.clear();
+    m_treesValid = false;
+}
+
+const std::vector<uint32_t>&
+SatelliteAllPairsRouter::GetMatrix() const
+{
+    return m_nextHop;
+}
+
+uint64_t
+SatelliteAllPairsRouter::GetLastRepairedVertices() const
+{
+    return m_lastRepaired;
+}
+
+uint32_t
+SatelliteAllPairsRouter::GetNextHop(uint32_t src, uint32_t dst)
+{
+    if (m_nextHop.empty())
+    {
+        return SatelliteRouteGraph::INVALID_INDEX;
+    }
+    return m_nextHop[static_cast<size_t>(src) * m_numVertices + dst];
+}
+
+} // namespace ns3
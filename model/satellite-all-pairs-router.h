@@ -0,0 +1,100 @@
+#ifndef SATELLITE_ALL_PAIRS_ROUTER_H
+#define SATELLITE_ALL_PAIRS_ROUTER_H
+
+#include "satellite-next-hop-provider.h"
+#include "satellite-route-graph.h"
+#include "satellite-worker-pool.h"
+#include <memory>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * @ingroup satellite
+ * @brief Dense next-hop matrix from one shortest path search per source.
+ *
+ * The single-source searches are independent and only read the graph, so with
+ * more than one thread they are spread over a worker pool while the caller
+ * waits. The result does not depend on the number of threads.
+ *
+ * With incremental repair every shortest path tree is kept between epochs and
+ * only repaired for the new link weights, see RepairShortestPathTree().
+ */
+class SatelliteAllPairsRouter : public SatelliteNextHopProvider
+{
+public:
+    /// Priority queue of the searches, see satellite-priority-queue.h.
+    enum QueueType
+    {
+        BINARY_HEAP, //!< Binary heap on distances in meters
+        RADIX_HEAP,  //!< Radix heap on link delays in integer nanoseconds
+        DIAL         //!< Dial bucket queue on link delays
+    };
+
+    SatelliteAllPairsRouter();
+
+    /**
+     * @param numThreads Threads of the next Compute(). 1 searches on the
+     *        calling thread only, 0 uses all hardware threads.
+     */
+    void SetNThreads(uint32_t numThreads);
+
+    /**
+     * @param queueType Priority queue of full searches.
+     */
+    void SetQueueType(QueueType queueType);
+
+    /**
+     * @brief Keep the trees between epochs and repair them instead of searching again.
+     * @param repair Whether to repair. Needs three N x N tables.
+     * @param tolerance Ignored path improvements, in meters.
+     */
+    void SetIncrementalRepair(bool repair, double tolerance);
+
+    /**
+     * @brief Search from every vertex and fill the matrix.
+     * @param graph The graph, with weights of the current epoch.
+     */
+    void Compute(const SatelliteRouteGraph& graph);
+
+    /**
+     * @brief Drop the matrix and the kept trees.
+     */
+    void Clear();
+
+    /**
+     * @return The N x N next-hop matrix, row = source, or an empty one if
+     *         nothing was computed since the last Clear().
+     */
+    const std::vector<uint32_t>& GetMatrix() const;
+
+    /**
+     * @return The number of (source, vertex) pairs the last Compute() repaired,
+     *         or N x N after a full computation.
+     */
+    uint64_t GetLastRepairedVertices() const;
+
+    uint32_t GetNextHop(uint32_t src, uint32_t dst) override;
+
+private:
+    void ComputeSource(const SatelliteRouteGraph& graph, uint32_t src, uint32_t worker);
+
+    uint32_t m_numThreads;
+    QueueType m_queueType;
+    bool m_incrementalRepair;
+    double m_repairTolerance;
+    uint32_t m_numVertices;                              //!< Row length of the matrix
+    std::vector<uint32_t> m_nextHop;                     //!< N x N next hops, row = source
+    std::vector<double> m_dist;                          //!< N x N tree distances, with incremental repair
+    std::vector<uint32_t> m_parent;                      //!< N x N tree parents, with incremental repair
+    std::vector<uint32_t> m_parentEdge;                  //!< N x N tree edges, with incremental repair
+    bool m_treesValid;                                   //!< Whether m_parent holds the previous epoch's trees
+    std::vector<SatelliteShortestPathScratch> m_scratch; //!< Search buffers, by worker
+    std::vector<uint64_t> m_repaired;                    //!< Repaired vertices of the running Compute(), by worker
+    uint64_t m_lastRepaired;
+    std::unique_ptr<SatelliteWorkerPool> m_pool;         //!< Worker pool, created on first parallel Compute()
+};
+
+} // namespace ns3
+
+#endif /* SATELLITE_ALL_PAIRS_ROUTER_H */
@@ -0,0 +1,109 @@
+#include "satellite-archive-router.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE("SatelliteArchiveRouter");
+
+SatelliteArchiveRouter::SatelliteArchiveRouter()
+    : m_graph(nullptr),
+      m_table(SatelliteRouteGraph::INVALID_INDEX),
+      m_change(0)
+{
+}
+
+bool
+SatelliteArchiveRouter::Open(const std::string& path, const SatelliteRouteGraph& graph)
+{
+    Deselect();
+    m_graph = &graph;
+    return m_archive.Open(path);
+}
+
+void
+SatelliteArchiveRouter::Close()
+{
+    Deselect();
+    m_archive.Close();
+}
+
+const SatelliteRouteArchive&
+SatelliteArchiveRouter::GetArchive() const
+{
+    return m_archive;
+}
+
+bool
+SatelliteArchiveRouter::Select(Time t)
+{
+    uint64_t epoch = m_archive.IsOpen() ? m_archive.FindEpoch(t) : SatelliteRouteArchive::INVALID_EPOCH;
+    if (epoch == SatelliteRouteArchive::INVALID_EPOCH)
+    {
+        NS_LOG_DEBUG("Time " << t.GetSeconds() << "s is outside the route archive");
+        Deselect();
+        return false;
+    }
+
+    uint32_t table = m_archive.GetTable(epoch);
+    if (table != m_table || epoch >= m_change)
+    {
+        // The routes hold until the archive switches to another table
+        m_change = epoch + 1;
+        while (m_change < m_archive.GetNEpochs() && m_archive.GetTable(m_change) == table)
+        {
+            ++m_change;
+        }
+    }
+    m_table = table;
+    m_epochStart = m_archive.GetStart() + m_archive.GetInterval() * static_cast<int64_t>(epoch);
+    NS_LOG_DEBUG("Replaying archive table " << table << " at time " << t.GetSeconds() << "s");
+    return true;
+}
+
+void
+SatelliteArchiveRouter::Deselect()
+{
+    m_table = SatelliteRouteGraph::INVALID_INDEX;
+}
+
+uint32_t
+SatelliteArchiveRouter::GetTable() const
+{
+    return m_table;
+}
+
+Time
+SatelliteArchiveRouter::GetEpochStart() const
+{
+    return m_epochStart;
+}
+
+Time
+SatelliteArchiveRouter::GetNextChange() const
+{
+    if (m_change >= m_archive.GetNEpochs())
+    {
+        return Time::Max();
+    }
+    return m_archive.GetStart() + m_archive.GetInterval() * static_cast<int64_t>(m_change);
+}
+
+uint32_t
+SatelliteArchiveRouter::GetEgress(uint32_t groundStation) const
+{
+    return m_archive.GetEgress(m_table, groundStation);
+}
+
+uint32_t
+SatelliteArchiveRouter::GetNextHop(uint32_t src, uint32_t dst)
+{
+    if (m_table == SatelliteRouteGraph::INVALID_INDEX)
+    {
+        return SatelliteRouteGraph::INVALID_INDEX;
+    }
+    uint8_t slot = m_archive.GetNextHopSlot(m_table, src, dst);
+    return (slot != SatelliteRouteArchive::NO_ROUTE) ? m_graph->GetTargets()[m_graph->GetOffsets()[src] + slot]
+                                                      : SatelliteRouteGraph::INVALID_INDEX;
+}
+
+} // namespace ns3
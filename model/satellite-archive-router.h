@@ -0,0 +1,85 @@
+#ifndef SATELLITE_ARCHIVE_ROUTER_H
+#define SATELLITE_ARCHIVE_ROUTER_H
+
+#include "satellite-next-hop-provider.h"
+#include "satellite-route-archive.h"
+#include "satellite-route-graph.h"
+#include "ns3/nstime.h"
+#include <string>
+
+namespace ns3 {
+
+/**
+ * @ingroup satellite
+ * @brief Next hops and egress satellites replayed from a route archive.
+ *
+ * Select() picks the route table of the archived epoch a time falls in and
+ * finds where the archive next switches to another table; next hops are then
+ * plain loads from the mapped table.
+ */
+class SatelliteArchiveRouter : public SatelliteNextHopProvider
+{
+public:
+    SatelliteArchiveRouter();
+
+    /**
+     * @brief Map an archive, closing any previous one.
+     * @param path The archive file.
+     * @param graph The link graph the archive slots refer to. Kept by reference.
+     * @return Whether the file is a well-formed archive.
+     */
+    bool Open(const std::string& path, const SatelliteRouteGraph& graph);
+    void Close();
+
+    /**
+     * @return The mapped archive.
+     */
+    const SatelliteRouteArchive& GetArchive() const;
+
+    /**
+     * @brief Select the route table of the archived epoch a time falls in.
+     * @param t A simulation time.
+     * @return Whether the archive covers t; nothing is selected otherwise.
+     */
+    bool Select(Time t);
+
+    /**
+     * @brief Select no table; GetNextHop() finds nothing until the next Select().
+     */
+    void Deselect();
+
+    /**
+     * @return The selected table, or INVALID_INDEX.
+     */
+    uint32_t GetTable() const;
+
+    /**
+     * @return The archived start time of the selected epoch.
+     */
+    Time GetEpochStart() const;
+
+    /**
+     * @return The start of the first archived epoch after the selected one with
+     *         another table, or Time::Max() if none does.
+     */
+    Time GetNextChange() const;
+
+    /**
+     * @param groundStation A ground station index.
+     * @return The egress satellite of the ground station in the selected table.
+     */
+    uint32_t GetEgress(uint32_t groundStation) const;
+
+    uint32_t GetNextHop(uint32_t src, uint32_t dst) override;
+
+private:
+    SatelliteRouteArchive m_archive;
+    const SatelliteRouteGraph* m_graph;
+    uint32_t m_table;  //!< Selected table, or INVALID_INDEX
+    uint64_t m_change; //!< First archived epoch after the selected table's run
+    Time m_epochStart; //!< Archived time of the selected epoch
+};
+
+} // namespace ns3
+
+#endif /* SATELLITE_ARCHIVE_ROUTER_H */
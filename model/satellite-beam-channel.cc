@@ -0,0 +1,178 @@
+#include "satellite-beam-channel.h"
+#include "satellite-beam-net-device.h"
+
+#include "ns3/ethernet-header.h"
+#include "ns3/log.h"
+#include "ns3/mobility-model.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/pointer.h"
+#include "ns3/propagation-delay-model.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SatelliteBeamChannel");
+
+NS_OBJECT_ENSURE_REGISTERED(SatelliteBeamChannel);
+
+TypeId
+SatelliteBeamChannel::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::SatelliteBeamChannel")
+            .SetParent<Channel>()
+            .SetGroupName("Satellite")
+            .AddConstructor<SatelliteBeamChannel>()
+            .AddAttribute("DownlinkDataRate",
+                          "Capacity of the beam from the satellite to its terminals, shared by all of them.",
+                          DataRateValue(DataRate("100Mbps")),
+                          MakeDataRateAccessor(&SatelliteBeamChannel::m_downlinkDataRate),
+                          MakeDataRateChecker())
+            .AddAttribute("UplinkDataRate",
+                          "Capacity of the beam from the terminals to the satellite, shared by all of them.",
+                          DataRateValue(DataRate("20Mbps")),
+                          MakeDataRateAccessor(&SatelliteBeamChannel::m_uplinkDataRate),
+                          MakeDataRateChecker())
+            .AddAttribute("PropagationDelayModel",
+                          "A pointer to the propagation delay model attached to this channel.",
+                          PointerValue(),
+                          MakePointerAccessor(&SatelliteBeamChannel::m_delay),
+                          MakePointerChecker<PropagationDelayModel>());
+    return tid;
+}
+
+SatelliteBeamChannel::SatelliteBeamChannel()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+SatelliteBeamChannel::~SatelliteBeamChannel()
+{
+    NS_LOG_FUNCTION(this);
+    m_terminals.clear();
+}
+
+std::size_t
+SatelliteBeamChannel::GetNDevices() const
+{
+    return (m_satellite ? 1 : 0) + m_terminals.size();
+}
+
+Ptr<NetDevice>
+SatelliteBeamChannel::GetDevice(std::size_t i) const
+{
+    if (m_satellite)
+    {
+        if (i == 0)
+        {
+            return m_satellite;
+        }
+        --i;
+    }
+    NS_ASSERT_MSG(i < m_terminals.size(), "Beam device " << i << " out of range.");
+    return m_terminals[i];
+}
+
+void
+SatelliteBeamChannel::SetSatellite(Ptr<SatelliteBeamNetDevice> device)
+{
+    NS_LOG_FUNCTION(this << device);
+    m_satellite = device;
+}
+
+Ptr<SatelliteBeamNetDevice>
+SatelliteBeamChannel::GetSatellite() const
+{
+    return m_satellite;
+}
+
+void
+SatelliteBeamChannel::Attach(Ptr<SatelliteBeamNetDevice> device)
+{
+    NS_LOG_FUNCTION(this << device);
+    NS_ASSERT_MSG(std::find(m_terminals.begin(), m_terminals.end(), device) == m_terminals.end(),
+                  "Terminal is already in this beam.");
+    m_terminals.push_back(device);
+}
+
+void
+SatelliteBeamChannel::Detach(Ptr<SatelliteBeamNetDevice> device)
+{
+    NS_LOG_FUNCTION(this << device);
+    auto it = std::find(m_terminals.begin(), m_terminals.end(), device);
+    NS_ASSERT_MSG(it != m_terminals.end(), "Terminal is not in this beam.");
+    // Order does not matter; swap with the last one
+    *it = m_terminals.back();
+    m_terminals.pop_back();
+}
+
+uint32_t
+SatelliteBeamChannel::GetNTerminals() const
+{
+    return m_terminals.size();
+}
+
+void
+SatelliteBeamChannel::SetPropagationDelayModel(Ptr<PropagationDelayModel> delay)
+{
+    NS_LOG_FUNCTION(this << delay);
+    m_delay = delay;
+}
+
+Time
+SatelliteBeamChannel::Transmit(Ptr<SatelliteBeamNetDevice> sender, Ptr<const Packet> packet)
+{
+    NS_LOG_FUNCTION(this << sender << packet);
+    NS_ASSERT_MSG(m_satellite, "SatelliteBeamChannel has no satellite.");
+    bool downlink = (sender == m_satellite);
+
+    // Wait for the shared direction, then occupy it for the frame
+    Time now = Simulator::Now();
+    Time& free = downlink ? m_downlinkFree : m_uplinkFree;
+    const DataRate& rate = downlink ? m_downlinkDataRate : m_uplinkDataRate;
+    free = std::max(free, now) + rate.CalculateBytesTxTime(packet->GetSize());
+    Time txTime = free - now;
+
+    if (!downlink)
+    {
+        Deliver(sender, m_satellite, packet, txTime);
+        return txTime;
+    }
+
+    EthernetHeader header(false);
+    packet->PeekHeader(header);
+    Mac48Address destination = header.GetDestination();
+    for (const Ptr<SatelliteBeamNetDevice>& terminal : m_terminals)
+    {
+        if (destination.IsGroup() || Mac48Address::ConvertFrom(terminal->GetAddress()) == destination)
+        {
+            Deliver(sender, terminal, packet, txTime);
+        }
+    }
+    return txTime;
+}
+
+void
+SatelliteBeamChannel::Deliver(Ptr<SatelliteBeamNetDevice> sender,
+                              Ptr<SatelliteBeamNetDevice> receiver,
+                              Ptr<const Packet> packet,
+                              Time txTime) const
+{
+    Time delay = txTime;
+    if (m_delay)
+    {
+        delay += m_delay->GetDelay(sender->GetNode()->GetObject<MobilityModel>(),
+                                   receiver->GetNode()->GetObject<MobilityModel>());
+    }
+    Simulator::ScheduleWithContext(receiver->GetNode()->GetId(),
+                                   delay,
+                                   &SatelliteBeamNetDevice::Receive,
+                                   receiver,
+                                   packet->Copy());
+}
+
+} // namespace ns3
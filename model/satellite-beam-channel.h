@@ -0,0 +1,112 @@
+#ifndef SATELLITE_BEAM_CHANNEL_H
+#define SATELLITE_BEAM_CHANNEL_H
+
+#include "ns3/channel.h"
+#include "ns3/data-rate.h"
+#include "ns3/nstime.h"
+
+#include <vector>
+
+namespace ns3
+{
+
+class Packet;
+class PropagationDelayModel;
+class SatelliteBeamNetDevice;
+
+/**
+ * @ingroup satellite
+ * @brief The beam of one satellite, shared by all the ground terminals it serves.
+ *
+ * Unlike the point-to-point GroundSatelliteChannel, a beam channel connects
+ * one satellite device with any number of ground terminal devices, addressed
+ * by MAC. Downlink frames from the satellite reach the terminal they are
+ * addressed to, or every terminal if broadcast; uplink frames from a terminal
+ * reach the satellite.
+ *
+ * Each direction is one shared medium: frames are serialized at the
+ * DownlinkDataRate or UplinkDataRate of the beam, first come first served, so
+ * the terminals of a beam share its capacity.
+ *
+ * Terminals join and leave the beam with SatelliteBeamNetDevice::Handover().
+ */
+class SatelliteBeamChannel : public Channel
+{
+public:
+    /**
+     * @brief Get the type ID.
+     * @return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    SatelliteBeamChannel();
+    ~SatelliteBeamChannel() override;
+
+    // Inherited from Channel. Device 0 is the satellite, followed by the
+    // terminals currently in the beam.
+    std::size_t GetNDevices() const override;
+    Ptr<NetDevice> GetDevice(std::size_t i) const override;
+
+    /**
+     * @brief Set the satellite device transmitting the beam.
+     * @param device The satellite device.
+     */
+    void SetSatellite(Ptr<SatelliteBeamNetDevice> device);
+    Ptr<SatelliteBeamNetDevice> GetSatellite() const;
+
+    /**
+     * @brief Add a ground terminal to the beam.
+     * @param device The terminal device.
+     */
+    void Attach(Ptr<SatelliteBeamNetDevice> device);
+
+    /**
+     * @brief Remove a ground terminal from the beam.
+     * @param device The terminal device.
+     */
+    void Detach(Ptr<SatelliteBeamNetDevice> device);
+
+    /**
+     * @return The number of ground terminals in the beam.
+     */
+    uint32_t GetNTerminals() const;
+
+    /**
+     * @brief Set the propagation delay model of the beam.
+     * @param delay The propagation delay model.
+     */
+    void SetPropagationDelayModel(Ptr<PropagationDelayModel> delay);
+
+    /**
+     * @brief Transmit a frame on the beam.
+     *
+     * The frame starts when the direction it takes is free, and is delivered
+     * after its transmission and the propagation delay.
+     *
+     * @param sender The transmitting device, the satellite or a terminal in the beam.
+     * @param packet The frame, starting with an EthernetHeader.
+     * @return The time from now until the frame is sent.
+     */
+    Time Transmit(Ptr<SatelliteBeamNetDevice> sender, Ptr<const Packet> packet);
+
+private:
+    /**
+     * @brief Schedule the delivery of a frame to one receiver.
+     */
+    void Deliver(Ptr<SatelliteBeamNetDevice> sender,
+                 Ptr<SatelliteBeamNetDevice> receiver,
+                 Ptr<const Packet> packet,
+                 Time txTime) const;
+
+    Ptr<SatelliteBeamNetDevice> m_satellite;                //!< The satellite, device 0
+    std::vector<Ptr<SatelliteBeamNetDevice>> m_terminals;   //!< Terminals in the beam
+    Ptr<PropagationDelayModel> m_delay;                     //!< May be null
+    DataRate m_downlinkDataRate;
+    DataRate m_uplinkDataRate;
+    Time m_downlinkFree; //!< When the downlink finishes its last frame
+    Time m_uplinkFree;   //!< When the uplink finishes its last frame
+};
+
+} // namespace ns3
+
+#endif /* SATELLITE_BEAM_CHANNEL_H */
@@ -0,0 +1,383 @@
+#include "satellite-beam-net-device.h"
+#include "satellite-beam-channel.h"
+
+#include "ns3/ethernet-header.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SatelliteBeamNetDevice");
+
+NS_OBJECT_ENSURE_REGISTERED(SatelliteBeamNetDevice);
+
+TypeId
+SatelliteBeamNetDevice::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::SatelliteBeamNetDevice")
+            .SetParent<NetDevice>()
+            .SetGroupName("Satellite")
+            .AddConstructor<SatelliteBeamNetDevice>()
+            .AddTraceSource("MacTx",
+                            "Trace source indicating a packet has been transmitted.",
+                            MakeTraceSourceAccessor(&SatelliteBeamNetDevice::m_macTxTrace),
+                            "ns3::Packet::TracedCallback")
+            .AddTraceSource("MacRx",
+                            "Trace source indicating a packet has been received.",
+                            MakeTraceSourceAccessor(&SatelliteBeamNetDevice::m_macRxTrace),
+                            "ns3::Packet::TracedCallback")
+            .AddTraceSource("Handover",
+                            "A ground terminal moved to the beam of another satellite.",
+                            MakeTraceSourceAccessor(&SatelliteBeamNetDevice::m_handoverTrace),
+                            "ns3::SatelliteBeamNetDevice::HandoverTracedCallback");
+    return tid;
+}
+
+SatelliteBeamNetDevice::SatelliteBeamNetDevice()
+    : m_beam(nullptr),
+      m_isSatellite(false),
+      m_node(nullptr),
+      m_ifIndex(0),
+      m_mtu(1500),
+      m_txBusy(false)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+SatelliteBeamNetDevice::~SatelliteBeamNetDevice()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+SatelliteBeamNetDevice::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_beam = nullptr;
+    m_node = nullptr;
+    m_queue = nullptr;
+    NetDevice::DoDispose();
+}
+
+void
+SatelliteBeamNetDevice::SetIfIndex(const uint32_t index)
+{
+    NS_LOG_FUNCTION(this << index);
+    m_ifIndex = index;
+}
+
+uint32_t
+SatelliteBeamNetDevice::GetIfIndex() const
+{
+    return m_ifIndex;
+}
+
+Ptr<Channel>
+SatelliteBeamNetDevice::GetChannel() const
+{
+    return m_beam;
+}
+
+void
+SatelliteBeamNetDevice::SetAddress(Address address)
+{
+    NS_LOG_FUNCTION(this << address);
+    m_address = Mac48Address::ConvertFrom(address);
+}
+
+Address
+SatelliteBeamNetDevice::GetAddress() const
+{
+    return m_address;
+}
+
+bool
+SatelliteBeamNetDevice::SetMtu(const uint16_t mtu)
+{
+    NS_LOG_FUNCTION(this << mtu);
+    m_mtu = mtu;
+    return true;
+}
+
+uint16_t
+SatelliteBeamNetDevice::GetMtu() const
+{
+    return m_mtu;
+}
+
+bool
+SatelliteBeamNetDevice::IsLinkUp() const
+{
+    // A terminal is up while some satellite serves it
+    return m_beam != nullptr;
+}
+
+void
+SatelliteBeamNetDevice::AddLinkChangeCallback(Callback<void> callback)
+{
+    NS_LOG_FUNCTION(this << &callback);
+    m_linkChangeCallback.ConnectWithoutContext(callback);
+}
+
+bool
+SatelliteBeamNetDevice::IsBroadcast() const
+{
+    return true;
+}
+
+Address
+SatelliteBeamNetDevice::GetBroadcast() const
+{
+    return Mac48Address::GetBroadcast();
+}
+
+bool
+SatelliteBeamNetDevice::IsMulticast() const
+{
+    return true;
+}
+
+Address
+SatelliteBeamNetDevice::GetMulticast(Ipv4Address multicastGroup) const
+{
+    return Mac48Address::GetMulticast(multicastGroup);
+}
+
+Address
+SatelliteBeamNetDevice::GetMulticast(Ipv6Address multicastGroup) const
+{
+    return Mac48Address::GetMulticast(multicastGroup);
+}
+
+bool
+SatelliteBeamNetDevice::IsBridge() const
+{
+    return false;
+}
+
+bool
+SatelliteBeamNetDevice::IsPointToPoint() const
+{
+    return false;
+}
+
+bool
+SatelliteBeamNetDevice::Send(Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber)
+{
+    NS_LOG_FUNCTION(this << packet << dest << protocolNumber);
+    if (!m_beam)
+    {
+        NS_LOG_LOGIC("Terminal is not in a beam, dropping packet");
+        return false;
+    }
+
+    EthernetHeader header(false);
+    header.SetSource(m_address);
+    header.SetDestination(Mac48Address::ConvertFrom(dest));
+    header.SetLengthType(protocolNumber);
+    packet->AddHeader(header);
+
+    if (m_queue->Enqueue(packet))
+    {
+        TxMachine();
+        return true;
+    }
+    return false;
+}
+
+bool
+SatelliteBeamNetDevice::SendFrom(Ptr<Packet> packet,
+                                 const Address& source,
+                                 const Address& dest,
+                                 uint16_t protocolNumber)
+{
+    NS_LOG_FUNCTION(this << packet << source << dest << protocolNumber);
+    return false;
+}
+
+Ptr<Node>
+SatelliteBeamNetDevice::GetNode() const
+{
+    return m_node;
+}
+
+void
+SatelliteBeamNetDevice::SetNode(Ptr<Node> node)
+{
+    NS_LOG_FUNCTION(this << node);
+    m_node = node;
+}
+
+bool
+SatelliteBeamNetDevice::NeedsArp() const
+{
+    return true;
+}
+
+void
+SatelliteBeamNetDevice::SetReceiveCallback(ReceiveCallback cb)
+{
+    m_rxCallback = cb;
+}
+
+void
+SatelliteBeamNetDevice::SetPromiscReceiveCallback(PromiscReceiveCallback cb)
+{
+    m_promiscRxCallback = cb;
+}
+
+bool
+SatelliteBeamNetDevice::SupportsSendFrom() const
+{
+    return false;
+}
+
+void
+SatelliteBeamNetDevice::SetQueue(Ptr<Queue<Packet>> queue)
+{
+    NS_LOG_FUNCTION(this << queue);
+    m_queue = queue;
+}
+
+void
+SatelliteBeamNetDevice::SetBeam(Ptr<SatelliteBeamChannel> beam)
+{
+    NS_LOG_FUNCTION(this << beam);
+    m_beam = beam;
+    m_isSatellite = true;
+    beam->SetSatellite(this);
+}
+
+Ptr<SatelliteBeamChannel>
+SatelliteBeamNetDevice::GetBeam() const
+{
+    return m_beam;
+}
+
+bool
+SatelliteBeamNetDevice::IsSatellite() const
+{
+    return m_isSatellite;
+}
+
+void
+SatelliteBeamNetDevice::Handover(Ptr<SatelliteBeamChannel> beam)
+{
+    NS_LOG_FUNCTION(this << beam);
+    NS_ASSERT_MSG(!m_isSatellite, "Only ground terminals hand over.");
+    if (beam == m_beam)
+    {
+        return;
+    }
+
+    bool wasUp = (m_beam != nullptr);
+    if (m_beam)
+    {
+        m_beam->Detach(this);
+    }
+    m_beam = beam;
+    if (m_beam)
+    {
+        m_beam->Attach(this);
+    }
+    Ptr<Node> satellite = m_beam ? m_beam->GetSatellite()->GetNode() : nullptr;
+    NS_LOG_INFO("Terminal on node " << m_node->GetId() << " handed over to satellite "
+                << (satellite ? static_cast<int64_t>(satellite->GetId()) : -1));
+    m_handoverTrace(satellite);
+
+    if (wasUp != (m_beam != nullptr))
+    {
+        m_linkChangeCallback();
+    }
+    if (m_beam)
+    {
+        TxMachine();
+    }
+}
+
+void
+SatelliteBeamNetDevice::TxMachine()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_txBusy || !m_beam)
+    {
+        return;
+    }
+
+    Ptr<Packet> packet = m_queue->Dequeue();
+    if (packet)
+    {
+        m_txBusy = true;
+        m_macTxTrace(packet);
+        Time txTime = m_beam->Transmit(this, packet);
+        Simulator::Schedule(txTime, &SatelliteBeamNetDevice::TxComplete, this);
+    }
+}
+
+void
+SatelliteBeamNetDevice::TxComplete()
+{
+    NS_LOG_FUNCTION(this);
+    m_txBusy = false;
+    TxMachine();
+}
+
+void
+SatelliteBeamNetDevice::Receive(Ptr<Packet> packet)
+{
+    NS_LOG_FUNCTION(this << packet);
+    EthernetHeader header(false);
+    packet->RemoveHeader(header);
+    Mac48Address destination = header.GetDestination();
+
+    PacketType packetType;
+    if (destination.IsBroadcast())
+    {
+        packetType = PACKET_BROADCAST;
+    }
+    else if (destination.IsGroup())
+    {
+        packetType = PACKET_MULTICAST;
+    }
+    else if (destination == m_address)
+    {
+        packetType = PACKET_HOST;
+    }
+    else
+    {
+        packetType = PACKET_OTHERHOST;
+    }
+
+    if (!m_promiscRxCallback.IsNull())
+    {
+        m_promiscRxCallback(this, packet, header.GetLengthType(), header.GetSource(), destination, packetType);
+    }
+    if (packetType != PACKET_OTHERHOST)
+    {
+        m_macRxTrace(packet);
+        if (!m_rxCallback.IsNull())
+        {
+            m_rxCallback(this, packet, header.GetLengthType(), header.GetSource());
+        }
+    }
+}
+
+Ptr<SatelliteBeamNetDevice>
+SatelliteBeamNetDevice::GetBeamDevice(Ptr<Node> node)
+{
+    for (uint32_t i = 0; i < node->GetNDevices(); ++i)
+    {
+        Ptr<SatelliteBeamNetDevice> device = DynamicCast<SatelliteBeamNetDevice>(node->GetDevice(i));
+        if (device)
+        {
+            return device;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace ns3
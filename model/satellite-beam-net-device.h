@@ -0,0 +1,133 @@
+#ifndef SATELLITE_BEAM_NET_DEVICE_H
+#define SATELLITE_BEAM_NET_DEVICE_H
+
+#include "ns3/mac48-address.h"
+#include "ns3/net-device.h"
+#include "ns3/queue.h"
+#include "ns3/traced-callback.h"
+
+namespace ns3
+{
+
+class Node;
+class Packet;
+class SatelliteBeamChannel;
+
+/**
+ * @ingroup satellite
+ * @brief A satellite beam or ground terminal device on a SatelliteBeamChannel.
+ *
+ * Every satellite has one such device transmitting its beam, and every ground
+ * station one terminal, in the beam of one satellite at a time. A ground
+ * station therefore has one interface for the whole constellation instead of
+ * one per satellite. Frames carry an EthernetHeader and the device resolves
+ * IP addresses with ARP, like any broadcast medium.
+ */
+class SatelliteBeamNetDevice : public NetDevice
+{
+public:
+    static TypeId GetTypeId();
+    SatelliteBeamNetDevice();
+    ~SatelliteBeamNetDevice() override;
+
+    // Inherited from NetDevice
+    void SetIfIndex(uint32_t index) override;
+    uint32_t GetIfIndex() const override;
+    Ptr<Channel> GetChannel() const override;
+    void SetAddress(Address address) override;
+    Address GetAddress() const override;
+    bool SetMtu(uint16_t mtu) override;
+    uint16_t GetMtu() const override;
+    bool IsLinkUp() const override;
+    void AddLinkChangeCallback(Callback<void> callback) override;
+    bool IsBroadcast() const override;
+    Address GetBroadcast() const override;
+    bool IsMulticast() const override;
+    Address GetMulticast(Ipv4Address multicastGroup) const override;
+    Address GetMulticast(Ipv6Address multicastGroup) const override;
+    bool IsBridge() const override;
+    bool IsPointToPoint() const override;
+    bool Send(Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber) override;
+    bool SendFrom(Ptr<Packet> packet,
+                  const Address& source,
+                  const Address& dest,
+                  uint16_t protocolNumber) override;
+    Ptr<Node> GetNode() const override;
+    void SetNode(Ptr<Node> node) override;
+    bool NeedsArp() const override;
+    void SetReceiveCallback(ReceiveCallback cb) override;
+    void SetPromiscReceiveCallback(PromiscReceiveCallback cb) override;
+    bool SupportsSendFrom() const override;
+
+    // Public methods specific to SatelliteBeamNetDevice
+    void SetQueue(Ptr<Queue<Packet>> queue);
+
+    /**
+     * @brief Make this device the satellite end of a beam.
+     * @param beam The beam channel, owned by this device.
+     */
+    void SetBeam(Ptr<SatelliteBeamChannel> beam);
+
+    /**
+     * @return The beam this device transmits or is served by, or nullptr.
+     */
+    Ptr<SatelliteBeamChannel> GetBeam() const;
+
+    /**
+     * @return Whether this device is the satellite end of its beam.
+     */
+    bool IsSatellite() const;
+
+    /**
+     * @brief Move a ground terminal to the beam of another satellite.
+     *
+     * Queued frames stay queued and are sent on the new beam. Does nothing if
+     * the terminal is already in the beam.
+     *
+     * @param beam The new beam, or nullptr to leave the current one.
+     */
+    void Handover(Ptr<SatelliteBeamChannel> beam);
+
+    /**
+     * @brief Receive a frame from the channel.
+     * @param packet The frame, starting with an EthernetHeader.
+     */
+    void Receive(Ptr<Packet> packet);
+
+    /**
+     * @param node A node.
+     * @return The first SatelliteBeamNetDevice of the node, or nullptr.
+     */
+    static Ptr<SatelliteBeamNetDevice> GetBeamDevice(Ptr<Node> node);
+
+    /**
+     * TracedCallback signature for handovers.
+     * @param [in] satellite The node of the new serving satellite, or nullptr.
+     */
+    typedef void (*HandoverTracedCallback)(Ptr<Node> satellite);
+
+private:
+    void DoDispose() override;
+    void TxMachine();
+    void TxComplete();
+
+    Ptr<SatelliteBeamChannel> m_beam;
+    bool m_isSatellite;
+    Ptr<Node> m_node;
+    uint32_t m_ifIndex;
+    Mac48Address m_address;
+    uint16_t m_mtu;
+    ReceiveCallback m_rxCallback;
+    PromiscReceiveCallback m_promiscRxCallback;
+    TracedCallback<> m_linkChangeCallback;
+    Ptr<Queue<Packet>> m_queue;
+    bool m_txBusy; //!< True while a frame is being transmitted
+
+    TracedCallback<Ptr<const Packet>> m_macTxTrace;
+    TracedCallback<Ptr<const Packet>> m_macRxTrace;
+    TracedCallback<Ptr<Node>> m_handoverTrace;
+};
+
+} // namespace ns3
+
+#endif /* SATELLITE_BEAM_NET_DEVICE_H */
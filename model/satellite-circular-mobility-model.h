@@ -13,6 +13,9 @@ namespace ns3 {
  * This mobility model calculates the position of a satellite over time based on
  * a simple circular orbit defined by altitude, speed, and inclination.
  * It does not use RAAN or Argument of Perigee for simplification.
+ *
+ * The orbital state lives in the shared SatelliteEphemeris store; this model
+ * only keeps its slot index and forwards position and velocity queries.
  */
 class SatelliteCircularMobilityModel : public MobilityModel
 {
@@ -22,6 +25,11 @@ public:
     SatelliteCircularMobilityModel ();
     virtual ~SatelliteCircularMobilityModel ();
 
+    /**
+     * \return The slot of this satellite in SatelliteEphemeris::Get().
+     */
+    uint32_t GetEphemerisSlot (void) const;
+
 private:
     // Implemented from MobilityModel
     virtual Vector DoGetPosition (void) const;
@@ -29,6 +37,17 @@ private:
     virtual Vector DoGetVelocity (void) const;
     virtual int64_t DoAssignStreams (int64_t stream);
 
+    void SetAltitude (double altitude);
+    double GetAltitude (void) const;
+    void SetInclination (double inclinationDegrees);
+    double GetInclination (void) const;
+    void SetRaan (double raanDegrees);
+    double GetRaan (void) const;
+    void SetInitialAngle (double initialAngleDegrees);
+    double GetInitialAngle (void) const;
+    void UpdateEphemeris (void);
+
+    uint32_t m_slot;              //!< Slot in the shared ephemeris store
     double m_altitude;            //!< Orbital altitude in meters
     double m_inclinationDegrees;  //!< Orbital inclination in degrees
     double m_raanDegrees;         //!< Right Ascension of the Ascending Node in degrees
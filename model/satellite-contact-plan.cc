@@ -0,0 +1,540 @@
+#include "satellite-contact-plan.h"
+#include "satellite-spatial-index.h"
+#include "ns3/log.h"
+#include "ns3/mobility-model.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE("SatelliteContactPlan");
+
+namespace {
+
+const char PLAN_MAGIC[8] = {'S', 'A', 'T', 'C', 'N', 'T', 'C', 'T'};
+
+size_t
+RoundUp(size_t n, size_t alignment)
+{
+    return (n + alignment - 1) / alignment * alignment;
+}
+
+/// Byte offsets of the sections of a contact plan file.
+struct Layout
+{
+    size_t groundStationIds;
+    size_t satelliteIds;
+    size_t offsets;
+    size_t maxDuration;
+    size_t contacts;
+    size_t pairOrder;
+    size_t size;
+
+    Layout(uint32_t numGroundStations, uint32_t numSatellites, uint32_t numContacts)
+    {
+        groundStationIds = RoundUp(sizeof(SatelliteContactPlanHeader), 64);
+        satelliteIds = groundStationIds + RoundUp(sizeof(uint32_t) * numGroundStations, 8);
+        offsets = satelliteIds + RoundUp(sizeof(uint32_t) * numSatellites, 8);
+        maxDuration = offsets + RoundUp(sizeof(uint32_t) * (numGroundStations + 1), 8);
+        contacts = maxDuration + sizeof(int64_t) * numGroundStations;
+        pairOrder = contacts + sizeof(SatelliteContact) * numContacts;
+        size = pairOrder + RoundUp(sizeof(uint32_t) * numContacts, 8);
+    }
+};
+
+void
+WritePadded(std::ofstream& file, const void* data, size_t bytes, size_t paddedBytes)
+{
+    static const char zeros[64] = {};
+    file.write(static_cast<const char*>(data), bytes);
+    file.write(zeros, paddedBytes - bytes);
+}
+
+} // namespace
+
+SatelliteContactPlan::SatelliteContactPlan()
+    : m_base(nullptr),
+      m_size(0),
+      m_header(),
+      m_groundStationId(nullptr),
+      m_satelliteId(nullptr),
+      m_offset(nullptr),
+      m_maxDuration(nullptr),
+      m_contacts(nullptr),
+      m_pairOrder(nullptr)
+{
+}
+
+SatelliteContactPlan::~SatelliteContactPlan()
+{
+    Close();
+}
+
+bool
+SatelliteContactPlan::Generate(const std::string& path,
+                               const NodeContainer& groundStations,
+                               const NodeContainer& satellites,
+                               Time start,
+                               Time end,
+                               Time step,
+                               double minElevationDegrees)
+{
+    NS_ASSERT_MSG(step.IsStrictlyPositive() && end > start, "Contact plans need a positive step and horizon.");
+    const uint32_t numGroundStations = groundStations.GetN();
+    const uint32_t numSatellites = satellites.GetN();
+    const double sinMask = std::sin(minElevationDegrees * M_PI / 180.0);
+    const double cosMask = std::cos(minElevationDegrees * M_PI / 180.0);
+
+    std::vector<Ptr<Node>> satelliteNodes(satellites.Begin(), satellites.End());
+    SatelliteSpatialIndex index;
+    index.SetSatellites(satelliteNodes);
+
+    std::vector<Vector> position(numGroundStations);
+    std::vector<double> radius(numGroundStations);
+    for (uint32_t g = 0; g < numGroundStations; ++g)
+    {
+        position[g] = groundStations.Get(g)->GetObject<MobilityModel>()->GetPosition();
+        radius[g] = std::sqrt(position[g].x * position[g].x + position[g].y * position[g].y +
+                              position[g].z * position[g].z);
+        NS_ASSERT_MSG(radius[g] > 0, "Ground station " << groundStations.Get(g)->GetId() << " is at the origin.");
+    }
+
+    // Windows still open are extended at every sample that sees them; the
+    // first sample that does not closes them.
+    const uint32_t NOT_OPEN = 0xffffffff;
+    std::vector<std::vector<SatelliteContact>> contacts(numGroundStations);
+    std::vector<uint32_t> open(static_cast<size_t>(numGroundStations) * numSatellites, NOT_OPEN);
+    std::vector<std::vector<uint32_t>> openSatellites(numGroundStations);
+    std::vector<uint32_t> nearby;
+    double maxOrbitRadius = 0.0;
+
+    for (int64_t k = 0; start + step * k < end; ++k)
+    {
+        Time t = start + step * k;
+        Time next = std::min(t + step, end);
+        index.Update(t);
+        if (k == 0)
+        {
+            for (uint32_t s = 0; s < numSatellites; ++s)
+            {
+                Vector q = index.GetPosition(s);
+                maxOrbitRadius = std::max(maxOrbitRadius, std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z));
+            }
+        }
+
+        for (uint32_t g = 0; g < numGroundStations; ++g)
+        {
+            const Vector& p = position[g];
+            double r = radius[g];
+            if (maxOrbitRadius <= r)
+            {
+                continue;
+            }
+
+            // Slant range of the highest orbit at the elevation mask; nothing
+            // farther away can be visible
+            double maxRange = std::sqrt(maxOrbitRadius * maxOrbitRadius - r * r * cosMask * cosMask) - r * sinMask;
+            index.FindWithinRange(p, maxRange + 1.0, nearby);
+            for (uint32_t s : nearby)
+            {
+                Vector q = index.GetPosition(s);
+                double dx = q.x - p.x;
+                double dy = q.y - p.y;
+                double dz = q.z - p.z;
+                double range = std::sqrt(dx * dx + dy * dy + dz * dz);
+                if ((dx * p.x + dy * p.y + dz * p.z) / r < sinMask * range)
+                {
+                    continue;
+                }
+
+                uint32_t& slot = open[static_cast<size_t>(g) * numSatellites + s];
+                if (slot == NOT_OPEN)
+                {
+                    slot = contacts[g].size();
+                    contacts[g].push_back({t.GetNanoSeconds(), 0, range, range, g, s});
+                    openSatellites[g].push_back(s);
+                }
+                SatelliteContact& contact = contacts[g][slot];
+                contact.end = next.GetNanoSeconds();
+                contact.minRange = std::min(contact.minRange, range);
+                contact.maxRange = std::max(contact.maxRange, range);
+            }
+
+            std::vector<uint32_t>& stillOpen = openSatellites[g];
+            for (uint32_t i = 0; i < stillOpen.size();)
+            {
+                uint32_t& slot = open[static_cast<size_t>(g) * numSatellites + stillOpen[i]];
+                if (contacts[g][slot].end != next.GetNanoSeconds())
+                {
+                    slot = NOT_OPEN;
+                    stillOpen[i] = stillOpen.back();
+                    stillOpen.pop_back();
+                }
+                else
+                {
+                    ++i;
+                }
+            }
+        }
+    }
+
+    std::vector<uint32_t> offsets(numGroundStations + 1, 0);
+    std::vector<int64_t> maxDuration(numGroundStations, 0);
+    std::vector<uint32_t> pairOrder;
+    for (uint32_t g = 0; g < numGroundStations; ++g)
+    {
+        offsets[g + 1] = offsets[g] + contacts[g].size();
+        for (uint32_t i = 0; i < contacts[g].size(); ++i)
+        {
+            maxDuration[g] = std::max(maxDuration[g], contacts[g][i].end - contacts[g][i].start);
+            pairOrder.push_back(offsets[g] + i);
+        }
+        const std::vector<SatelliteContact>& own = contacts[g];
+        uint32_t first = offsets[g];
+        std::sort(pairOrder.begin() + first, pairOrder.end(), [&own, first](uint32_t a, uint32_t b) {
+            const SatelliteContact& ca = own[a - first];
+            const SatelliteContact& cb = own[b - first];
+            return ca.satellite < cb.satellite || (ca.satellite == cb.satellite && ca.start < cb.start);
+        });
+    }
+    uint32_t numContacts = offsets[numGroundStations];
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        NS_LOG_WARN("Cannot create contact plan " << path);
+        return false;
+    }
+    SatelliteContactPlanHeader header = SatelliteContactPlanHeader();
+    std::memcpy(header.magic, PLAN_MAGIC, sizeof(PLAN_MAGIC));
+    header.version = VERSION;
+    header.numGroundStations = numGroundStations;
+    header.numSatellites = numSatellites;
+    header.numContacts = numContacts;
+    header.start = start.GetNanoSeconds();
+    header.end = end.GetNanoSeconds();
+    header.step = step.GetNanoSeconds();
+    header.minElevation = minElevationDegrees;
+
+    std::vector<uint32_t> groundStationIds;
+    for (uint32_t g = 0; g < numGroundStations; ++g)
+    {
+        groundStationIds.push_back(groundStations.Get(g)->GetId());
+    }
+    std::vector<uint32_t> satelliteIds;
+    for (uint32_t s = 0; s < numSatellites; ++s)
+    {
+        satelliteIds.push_back(satellites.Get(s)->GetId());
+    }
+
+    Layout layout(numGroundStations, numSatellites, numContacts);
+    WritePadded(file, &header, sizeof(header), layout.groundStationIds);
+    WritePadded(file, groundStationIds.data(), sizeof(uint32_t) * numGroundStations,
+                layout.satelliteIds - layout.groundStationIds);
+    WritePadded(file, satelliteIds.data(), sizeof(uint32_t) * numSatellites, layout.offsets - layout.satelliteIds);
+    WritePadded(file, offsets.data(), sizeof(uint32_t) * offsets.size(), layout.maxDuration - layout.offsets);
+    file.write(reinterpret_cast<const char*>(maxDuration.data()), sizeof(int64_t) * numGroundStations);
+    for (const std::vector<SatelliteContact>& own : contacts)
+    {
+        file.write(reinterpret_cast<const char*>(own.data()), sizeof(SatelliteContact) * own.size());
+    }
+    WritePadded(file, pairOrder.data(), sizeof(uint32_t) * numContacts, layout.size - layout.pairOrder);
+    file.close();
+
+    NS_LOG_INFO("Wrote " << numContacts << " contacts of " << numGroundStations << " ground stations and "
+                << numSatellites << " satellites to " << path);
+    return !file.fail();
+}
+
+bool
+SatelliteContactPlan::Open(const std::string& path)
+{
+    Close();
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        NS_LOG_WARN("Cannot open contact plan " << path << ": " << std::strerror(errno));
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(SatelliteContactPlanHeader))
+    {
+        NS_LOG_WARN("Contact plan " << path << " is truncated.");
+        close(fd);
+        return false;
+    }
+    size_t size = st.st_size;
+    void* base = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // The mapping keeps the file open
+    if (base == MAP_FAILED)
+    {
+        NS_LOG_WARN("Cannot map contact plan " << path << ": " << std::strerror(errno));
+        return false;
+    }
+
+    SatelliteContactPlanHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    Layout layout(header.numGroundStations, header.numSatellites, header.numContacts);
+    if (std::memcmp(header.magic, PLAN_MAGIC, sizeof(PLAN_MAGIC)) != 0 || header.version != VERSION ||
+        size != layout.size)
+    {
+        NS_LOG_WARN("Contact plan " << path << " is not a version " << VERSION << " plan or is damaged.");
+        munmap(base, size);
+        return false;
+    }
+
+    m_base = static_cast<const uint8_t*>(base);
+    m_size = size;
+    m_header = header;
+    m_groundStationId = reinterpret_cast<const uint32_t*>(m_base + layout.groundStationIds);
+    m_satelliteId = reinterpret_cast<const uint32_t*>(m_base + layout.satelliteIds);
+    m_offset = reinterpret_cast<const uint32_t*>(m_base + layout.offsets);
+    m_maxDuration = reinterpret_cast<const int64_t*>(m_base + layout.maxDuration);
+    m_contacts = reinterpret_cast<const SatelliteContact*>(m_base + layout.contacts);
+    m_pairOrder = reinterpret_cast<const uint32_t*>(m_base + layout.pairOrder);
+
+    auto buildIndex = [](const uint32_t* ids, uint32_t n, std::vector<uint32_t>& byNodeId) {
+        uint32_t maxId = 0;
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            maxId = std::max(maxId, ids[i]);
+        }
+        byNodeId.assign(n ? maxId + 1 : 0, NOT_IN_PLAN);
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            byNodeId[ids[i]] = i;
+        }
+    };
+    buildIndex(m_groundStationId, header.numGroundStations, m_groundStationByNodeId);
+    buildIndex(m_satelliteId, header.numSatellites, m_satelliteByNodeId);
+
+    NS_LOG_INFO("Mapped contact plan " << path << ": " << header.numContacts << " contacts from "
+                << GetStart().GetSeconds() << "s to " << GetEnd().GetSeconds() << "s");
+    return true;
+}
+
+void
+SatelliteContactPlan::Close()
+{
+    if (m_base)
+    {
+        munmap(const_cast<uint8_t*>(m_base), m_size);
+    }
+    m_base = nullptr;
+    m_size = 0;
+    m_header = SatelliteContactPlanHeader();
+    m_groundStationId = nullptr;
+    m_satelliteId = nullptr;
+    m_offset = nullptr;
+    m_maxDuration = nullptr;
+    m_contacts = nullptr;
+    m_pairOrder = nullptr;
+    m_groundStationByNodeId.clear();
+    m_satelliteByNodeId.clear();
+}
+
+bool
+SatelliteContactPlan::IsOpen() const
+{
+    return m_base != nullptr;
+}
+
+uint32_t
+SatelliteContactPlan::GetNGroundStations() const
+{
+    return m_header.numGroundStations;
+}
+
+uint32_t
+SatelliteContactPlan::GetNSatellites() const
+{
+    return m_header.numSatellites;
+}
+
+uint32_t
+SatelliteContactPlan::GetNContacts() const
+{
+    return m_header.numContacts;
+}
+
+Time
+SatelliteContactPlan::GetStart() const
+{
+    return NanoSeconds(m_header.start);
+}
+
+Time
+SatelliteContactPlan::GetEnd() const
+{
+    return NanoSeconds(m_header.end);
+}
+
+Time
+SatelliteContactPlan::GetStep() const
+{
+    return NanoSeconds(m_header.step);
+}
+
+double
+SatelliteContactPlan::GetMinElevation() const
+{
+    return m_header.minElevation;
+}
+
+const SatelliteContact&
+SatelliteContactPlan::GetContact(uint32_t i) const
+{
+    NS_ASSERT_MSG(i < m_header.numContacts, "Contact " << i << " out of range.");
+    return m_contacts[i];
+}
+
+uint32_t
+SatelliteContactPlan::GetGroundStationId(uint32_t groundStation) const
+{
+    NS_ASSERT_MSG(groundStation < m_header.numGroundStations, "Ground station " << groundStation << " out of range.");
+    return m_groundStationId[groundStation];
+}
+
+uint32_t
+SatelliteContactPlan::GetSatelliteId(uint32_t satellite) const
+{
+    NS_ASSERT_MSG(satellite < m_header.numSatellites, "Satellite " << satellite << " out of range.");
+    return m_satelliteId[satellite];
+}
+
+uint32_t
+SatelliteContactPlan::GetGroundStationIndex(Ptr<Node> node) const
+{
+    uint32_t id = node->GetId();
+    return (id < m_groundStationByNodeId.size()) ? m_groundStationByNodeId[id] : NOT_IN_PLAN;
+}
+
+uint32_t
+SatelliteContactPlan::GetSatelliteIndex(Ptr<Node> node) const
+{
+    uint32_t id = node->GetId();
+    return (id < m_satelliteByNodeId.size()) ? m_satelliteByNodeId[id] : NOT_IN_PLAN;
+}
+
+uint32_t
+SatelliteContactPlan::GetFirstContact(uint32_t groundStation) const
+{
+    NS_ASSERT_MSG(groundStation <= m_header.numGroundStations, "Ground station " << groundStation << " out of range.");
+    return m_offset[groundStation];
+}
+
+void
+SatelliteContactPlan::GetPeakContacts(std::vector<uint32_t>& groundStation, std::vector<uint32_t>& satellite) const
+{
+    groundStation.assign(m_header.numGroundStations, 0);
+    satellite.assign(m_header.numSatellites, 0);
+
+    // Sweep the contact edges in time order, ends before starts at equal times
+    std::vector<std::pair<int64_t, int32_t>> edges; // (time, +/-(contact + 1))
+    edges.reserve(2 * static_cast<size_t>(m_header.numContacts));
+    for (uint32_t i = 0; i < m_header.numContacts; ++i)
+    {
+        edges.emplace_back(m_contacts[i].start, static_cast<int32_t>(i + 1));
+        edges.emplace_back(m_contacts[i].end, -static_cast<int32_t>(i + 1));
+    }
+    std::sort(edges.begin(), edges.end());
+
+    std::vector<uint32_t> gsCount(m_header.numGroundStations, 0);
+    std::vector<uint32_t> satCount(m_header.numSatellites, 0);
+    for (const auto& edge : edges)
+    {
+        const SatelliteContact& c = m_contacts[std::abs(edge.second) - 1];
+        if (edge.second < 0)
+        {
+            --gsCount[c.groundStation];
+            --satCount[c.satellite];
+            continue;
+        }
+        groundStation[c.groundStation] = std::max(groundStation[c.groundStation], ++gsCount[c.groundStation]);
+        satellite[c.satellite] = std::max(satellite[c.satellite], ++satCount[c.satellite]);
+    }
+}
+
+const SatelliteContact*
+SatelliteContactPlan::FindNextContact(Ptr<Node> groundStation, Ptr<Node> satellite, Time t) const
+{
+    uint32_t g = GetGroundStationIndex(groundStation);
+    uint32_t s = GetSatelliteIndex(satellite);
+    if (g == NOT_IN_PLAN || s == NOT_IN_PLAN)
+    {
+        return nullptr;
+    }
+
+    // Last contact of the pair starting at or before t, in the pair order
+    int64_t now = t.GetNanoSeconds();
+    const uint32_t* first = m_pairOrder + m_offset[g];
+    const uint32_t* last = m_pairOrder + m_offset[g + 1];
+    const uint32_t* it = std::upper_bound(first, last, now, [this, s](int64_t key, uint32_t i) {
+        const SatelliteContact& c = m_contacts[i];
+        return s < c.satellite || (s == c.satellite && key < c.start);
+    });
+    if (it != first)
+    {
+        const SatelliteContact& c = m_contacts[*(it - 1)];
+        if (c.satellite == s && now < c.end)
+        {
+            return &c;
+        }
+    }
+    return (it != last && m_contacts[*it].satellite == s) ? &m_contacts[*it] : nullptr;
+}
+
+const SatelliteContact*
+SatelliteContactPlan::FindContact(Ptr<Node> groundStation, Ptr<Node> satellite, Time t) const
+{
+    const SatelliteContact* contact = FindNextContact(groundStation, satellite, t);
+    return (contact && contact->start <= t.GetNanoSeconds()) ? contact : nullptr;
+}
+
+bool
+SatelliteContactPlan::IsInContact(Ptr<Node> groundStation, Ptr<Node> satellite, Time t) const
+{
+    return FindContact(groundStation, satellite, t) != nullptr;
+}
+
+void
+SatelliteContactPlan::GetVisibleSatellites(Ptr<Node> groundStation, Time t, std::vector<uint32_t>& satelliteIds) const
+{
+    satelliteIds.clear();
+    uint32_t g = GetGroundStationIndex(groundStation);
+    if (g == NOT_IN_PLAN)
+    {
+        return;
+    }
+
+    // Contacts in progress started at most one longest contact ago; walk back
+    // from the last one started
+    int64_t now = t.GetNanoSeconds();
+    const SatelliteContact* first = m_contacts + m_offset[g];
+    const SatelliteContact* it = std::upper_bound(first, m_contacts + m_offset[g + 1], now,
+                                                  [](int64_t key, const SatelliteContact& c) { return key < c.start; });
+    while (it != first)
+    {
+        --it;
+        if (it->start + m_maxDuration[g] <= now)
+        {
+            break;
+        }
+        if (now < it->end)
+        {
+            satelliteIds.push_back(m_satelliteId[it->satellite]);
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,213 @@
+#ifndef SATELLITE_CONTACT_PLAN_H
+#define SATELLITE_CONTACT_PLAN_H
+
+#include "ns3/node-container.h"
+#include "ns3/node.h"
+#include "ns3/nstime.h"
+#include "ns3/simple-ref-count.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/*
+ * Contact plan file layout, native byte order, every section 8-byte aligned:
+ *
+ *   SatelliteContactPlanHeader, padded to 64 bytes
+ *   numGroundStations uint32 ground station node ids
+ *   numSatellites uint32 satellite node ids
+ *   numGroundStations + 1 uint32 offsets: the contacts of ground station g are
+ *     [offset[g], offset[g + 1])
+ *   numGroundStations int64 longest contact of every ground station, in nanoseconds
+ *   numContacts SatelliteContact records, by ground station and then start time
+ *   numContacts uint32 record numbers, by ground station, satellite and start time
+ */
+
+/// Fixed-size head of a contact plan file.
+struct SatelliteContactPlanHeader
+{
+    char magic[8];              //!< "SATCNTCT"
+    uint32_t version;
+    uint32_t numGroundStations;
+    uint32_t numSatellites;
+    uint32_t numContacts;
+    int64_t start;              //!< Start of the horizon, in nanoseconds
+    int64_t end;                //!< End of the horizon, in nanoseconds
+    int64_t step;               //!< Sampling step, in nanoseconds
+    double minElevation;        //!< Elevation mask, in degrees
+};
+
+/// One visibility window between a ground station and a satellite.
+struct SatelliteContact
+{
+    int64_t start;              //!< First sample with the satellite visible, in nanoseconds
+    int64_t end;                //!< First sample with it no longer visible, in nanoseconds
+    double minRange;            //!< Shortest sampled range, in meters
+    double maxRange;            //!< Longest sampled range, in meters
+    uint32_t groundStation;     //!< Ground station number in the plan
+    uint32_t satellite;         //!< Satellite number in the plan
+};
+
+/**
+ * @ingroup satellite
+ * @brief Visibility windows between ground stations and satellites, read from a memory-mapped file.
+ *
+ * Circular orbits and fixed ground stations make visibility a pure function of
+ * time, so Generate() samples the geometry of a whole horizon once and writes
+ * every window in which a satellite is above the elevation mask of a ground
+ * station. Visibility is sampled every step and held until the next sample, so
+ * window edges are exact to the step.
+ *
+ * Simulations then map the file once and answer "is this pair in contact" and
+ * "which satellites does this ground station see" with binary searches instead
+ * of geometry. The mapping is read-only and shared between processes.
+ *
+ * Nodes are identified by node id, so the plan has to be generated for the
+ * same node creation order as the simulation that reads it. Inter-satellite
+ * links in this model are permanent and are not part of the plan.
+ */
+class SatelliteContactPlan : public SimpleRefCount<SatelliteContactPlan>
+{
+public:
+    static constexpr uint32_t VERSION = 1;
+    /// Returned for nodes that are not in the plan.
+    static constexpr uint32_t NOT_IN_PLAN = 0xffffffff;
+
+    SatelliteContactPlan();
+    ~SatelliteContactPlan();
+
+    SatelliteContactPlan(const SatelliteContactPlan&) = delete;
+    SatelliteContactPlan& operator=(const SatelliteContactPlan&) = delete;
+
+    /**
+     * @brief Compute the contacts of a horizon and write them to a file.
+     * @param path The contact plan file, overwritten.
+     * @param groundStations Ground station nodes, with a fixed MobilityModel.
+     * @param satellites Satellite nodes, with a SatelliteCircularMobilityModel.
+     * @param start Start of the horizon.
+     * @param end End of the horizon.
+     * @param step Sampling step.
+     * @param minElevationDegrees Elevation mask in degrees.
+     * @return Whether the file was written.
+     */
+    static bool Generate(const std::string& path,
+                         const NodeContainer& groundStations,
+                         const NodeContainer& satellites,
+                         Time start,
+                         Time end,
+                         Time step,
+                         double minElevationDegrees);
+
+    /**
+     * @brief Map a contact plan file, closing any previous one.
+     * @param path The file.
+     * @return Whether the file exists and is a well-formed plan.
+     */
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const;
+
+    uint32_t GetNGroundStations() const;
+    uint32_t GetNSatellites() const;
+    uint32_t GetNContacts() const;
+    Time GetStart() const;
+    Time GetEnd() const;
+    Time GetStep() const;
+    double GetMinElevation() const;
+
+    /**
+     * @param i A contact number.
+     * @return The contact.
+     */
+    const SatelliteContact& GetContact(uint32_t i) const;
+
+    /**
+     * @param groundStation A ground station number in the plan.
+     * @return Its node id.
+     */
+    uint32_t GetGroundStationId(uint32_t groundStation) const;
+
+    /**
+     * @param satellite A satellite number in the plan.
+     * @return Its node id.
+     */
+    uint32_t GetSatelliteId(uint32_t satellite) const;
+
+    /**
+     * @param node A node.
+     * @return Its ground station number in the plan, or NOT_IN_PLAN.
+     */
+    uint32_t GetGroundStationIndex(Ptr<Node> node) const;
+
+    /**
+     * @param node A node.
+     * @return Its satellite number in the plan, or NOT_IN_PLAN.
+     */
+    uint32_t GetSatelliteIndex(Ptr<Node> node) const;
+
+    /**
+     * @param groundStation A ground station number, or the number of ground stations.
+     * @return The number of its first contact; the contacts of ground station g
+     *         are [GetFirstContact(g), GetFirstContact(g + 1)), by start time.
+     */
+    uint32_t GetFirstContact(uint32_t groundStation) const;
+
+    /**
+     * @brief Count the most contacts every node is in at the same time.
+     *
+     * A contact ending at the time another one starts does not overlap it.
+     *
+     * @param groundStation Output: the peak, by ground station number.
+     * @param satellite Output: the peak, by satellite number.
+     */
+    void GetPeakContacts(std::vector<uint32_t>& groundStation, std::vector<uint32_t>& satellite) const;
+
+    /**
+     * @param groundStation A ground station node.
+     * @param satellite A satellite node.
+     * @param t A time.
+     * @return The contact of the pair in progress at t, or nullptr if the
+     *         satellite is not visible or a node is not in the plan.
+     */
+    const SatelliteContact* FindContact(Ptr<Node> groundStation, Ptr<Node> satellite, Time t) const;
+
+    /**
+     * @param groundStation A ground station node.
+     * @param satellite A satellite node.
+     * @param t A time.
+     * @return The contact of the pair in progress at t or else the next one to
+     *         start, or nullptr if there is none before the end of the horizon.
+     */
+    const SatelliteContact* FindNextContact(Ptr<Node> groundStation, Ptr<Node> satellite, Time t) const;
+
+    /**
+     * @return Whether the satellite is visible from the ground station at t.
+     */
+    bool IsInContact(Ptr<Node> groundStation, Ptr<Node> satellite, Time t) const;
+
+    /**
+     * @brief Collect the satellites a ground station sees at a time.
+     * @param groundStation A ground station node.
+     * @param t A time.
+     * @param satelliteIds Output, cleared first: node ids, in no particular order.
+     */
+    void GetVisibleSatellites(Ptr<Node> groundStation, Time t, std::vector<uint32_t>& satelliteIds) const;
+
+private:
+    const uint8_t* m_base;                   //!< Start of the mapping, or nullptr
+    size_t m_size;                           //!< Bytes mapped
+    SatelliteContactPlanHeader m_header;
+    const uint32_t* m_groundStationId;       //!< Node id, by ground station number
+    const uint32_t* m_satelliteId;           //!< Node id, by satellite number
+    const uint32_t* m_offset;                //!< First contact, by ground station number
+    const int64_t* m_maxDuration;            //!< Longest contact, by ground station number
+    const SatelliteContact* m_contacts;      //!< By ground station and start
+    const uint32_t* m_pairOrder;             //!< Contacts by ground station, satellite and start
+    std::vector<uint32_t> m_groundStationByNodeId; //!< Ground station number, by node id
+    std::vector<uint32_t> m_satelliteByNodeId;     //!< Satellite number, by node id
+};
+
+} // namespace ns3
+
+#endif /* SATELLITE_CONTACT_PLAN_H */
@@ -0,0 +1,199 @@
+#include "satellite-ephemeris.h"
+#include "ns3/log.h"
+
+#include <cmath>
+#include <limits>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE("SatelliteEphemeris");
+
+namespace {
+    // Stamp of a slot that has not been propagated since its elements changed
+    constexpr int64_t STALE = std::numeric_limits<int64_t>::min();
+}
+
+SatelliteEphemeris&
+SatelliteEphemeris::Get()
+{
+    // Never destroyed: mobility models may release their slots during static
+    // destruction, after a function-local instance would already be gone.
+    static SatelliteEphemeris* ephemeris = new SatelliteEphemeris();
+    return *ephemeris;
+}
+
+SatelliteEphemeris::SatelliteEphemeris()
+    : m_batchStamp(STALE),
+      m_batchValid(false)
+{
+}
+
+uint32_t
+SatelliteEphemeris::Register()
+{
+    uint32_t slot;
+    if (!m_freeSlots.empty())
+    {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    else
+    {
+        slot = m_radius.size();
+        for (auto* column : {&m_radius, &m_speed, &m_angularVelocity, &m_initialAngle,
+                             &m_cosInclination, &m_sinInclination, &m_cosRaan, &m_sinRaan,
+                             &m_x, &m_y, &m_z, &m_vx, &m_vy, &m_vz,
+                             &m_batchX, &m_batchY, &m_batchZ, &m_batchVx, &m_batchVy, &m_batchVz})
+        {
+            column->push_back(0.0);
+        }
+        m_stamp.push_back(STALE);
+    }
+    SetElements(slot, 0.0, 0.0, 0.0, 0.0);
+    return slot;
+}
+
+void
+SatelliteEphemeris::Unregister(uint32_t slot)
+{
+    NS_ASSERT_MSG(slot < m_radius.size(), "Ephemeris slot " << slot << " out of range.");
+    m_freeSlots.push_back(slot);
+}
+
+void
+SatelliteEphemeris::SetElements(uint32_t slot,
+                                double altitude,
+                                double inclinationDegrees,
+                                double raanDegrees,
+                                double initialAngleDegrees)
+{
+    NS_ASSERT_MSG(slot < m_radius.size(), "Ephemeris slot " << slot << " out of range.");
+
+    double radius = EARTH_RADIUS + altitude;
+    double speed = std::sqrt(GM_EARTH / radius);
+    double inclinationRad = inclinationDegrees * M_PI / 180.0;
+    double raanRad = raanDegrees * M_PI / 180.0;
+
+    m_radius[slot] = radius;
+    m_speed[slot] = speed;
+    m_angularVelocity[slot] = speed / radius;
+    m_initialAngle[slot] = initialAngleDegrees * M_PI / 180.0;
+    m_cosInclination[slot] = std::cos(inclinationRad);
+    m_sinInclination[slot] = std::sin(inclinationRad);
+    m_cosRaan[slot] = std::cos(raanRad);
+    m_sinRaan[slot] = std::sin(raanRad);
+
+    m_stamp[slot] = STALE;
+    m_batchValid = false;
+}
+
+SatelliteOrbitPropagator::Elements
+SatelliteEphemeris::GetElements() const
+{
+    return {m_radius.data(), m_speed.data(), m_angularVelocity.data(), m_initialAngle.data(),
+            m_cosInclination.data(), m_sinInclination.data(), m_cosRaan.data(), m_sinRaan.data()};
+}
+
+SatelliteOrbitPropagator::State
+SatelliteEphemeris::GetState()
+{
+    return {m_x.data(), m_y.data(), m_z.data(), m_vx.data(), m_vy.data(), m_vz.data()};
+}
+
+SatelliteOrbitPropagator::State
+SatelliteEphemeris::GetBatchState()
+{
+    return {m_batchX.data(), m_batchY.data(), m_batchZ.data(),
+            m_batchVx.data(), m_batchVy.data(), m_batchVz.data()};
+}
+
+void
+SatelliteEphemeris::PropagateSlot(uint32_t i, double t)
+{
+    // Always the scalar kernel, so a single query gives the same result as
+    // the original per-model computation.
+    SatelliteOrbitPropagator::Propagate(SatelliteOrbitPropagator::SCALAR, GetElements(), GetState(), i, i + 1, t);
+}
+
+void
+SatelliteEphemeris::Refresh(Time now)
+{
+    int64_t stamp = now.GetTimeStep();
+    if (m_batchValid && m_batchStamp == stamp)
+    {
+        return;
+    }
+
+    uint32_t numSlots = m_radius.size();
+    SatelliteOrbitPropagator::Propagate(GetElements(), GetBatchState(), 0, numSlots, now.GetSeconds());
+    m_batchStamp = stamp;
+    m_batchValid = true;
+}
+
+Vector
+SatelliteEphemeris::GetPosition(uint32_t slot, Time now)
+{
+    int64_t stamp = now.GetTimeStep();
+    if (m_stamp[slot] != stamp)
+    {
+        PropagateSlot(slot, now.GetSeconds());
+        m_stamp[slot] = stamp;
+    }
+    return Vector(m_x[slot], m_y[slot], m_z[slot]);
+}
+
+Vector
+SatelliteEphemeris::GetVelocity(uint32_t slot, Time now)
+{
+    int64_t stamp = now.GetTimeStep();
+    if (m_stamp[slot] != stamp)
+    {
+        PropagateSlot(slot, now.GetSeconds());
+        m_stamp[slot] = stamp;
+    }
+    return Vector(m_vx[slot], m_vy[slot], m_vz[slot]);
+}
+
+uint32_t
+SatelliteEphemeris::GetNSlots() const
+{
+    return m_radius.size();
+}
+
+const double*
+SatelliteEphemeris::GetX() const
+{
+    return m_batchX.data();
+}
+
+const double*
+SatelliteEphemeris::GetY() const
+{
+    return m_batchY.data();
+}
+
+const double*
+SatelliteEphemeris::GetZ() const
+{
+    return m_batchZ.data();
+}
+
+const double*
+SatelliteEphemeris::GetVx() const
+{
+    return m_batchVx.data();
+}
+
+const double*
+SatelliteEphemeris::GetVy() const
+{
+    return m_batchVy.data();
+}
+
+const double*
+SatelliteEphemeris::GetVz() const
+{
+    return m_batchVz.data();
+}
+
+} // namespace ns3
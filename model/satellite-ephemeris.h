@@ -0,0 +1,147 @@
+#ifndef SATELLITE_EPHEMERIS_H
+#define SATELLITE_EPHEMERIS_H
+
+#include "satellite-orbit-propagator.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include <cstdint>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * @ingroup satellite
+ * @brief Constellation-level store of circular-orbit elements and propagated state.
+ *
+ * Every SatelliteCircularMobilityModel owns one slot. Orbital elements are kept
+ * as structure-of-arrays with the radius, angular velocity and the inclination
+ * and RAAN sines/cosines precomputed when the attributes are set, so
+ * propagation only evaluates one sin/cos pair per satellite.
+ *
+ * Single position or velocity queries propagate only the queried slot with the
+ * scalar kernel, and at most once per simulation time. Batch consumers
+ * (routing, spatial indexing) call Refresh() to propagate the whole store with
+ * the kernel selected in SatelliteOrbitPropagator and then read GetX() /
+ * GetY() / GetZ() directly. The batch state is kept apart from the per-slot
+ * state, so mobility models return the same positions whether or not a batch
+ * refresh happened at the same time, and whichever kernel it used.
+ */
+class SatelliteEphemeris
+{
+public:
+    /// Mean Earth radius used by the orbit model, in meters.
+    static constexpr double EARTH_RADIUS = 6371e3;
+    /// Standard gravitational parameter for Earth in m^3/s^2.
+    static constexpr double GM_EARTH = 3.986004418e14;
+
+    /**
+     * @return The process-wide ephemeris store.
+     */
+    static SatelliteEphemeris& Get();
+
+    /**
+     * @brief Allocate a slot for a new satellite.
+     * @return The slot index.
+     */
+    uint32_t Register();
+
+    /**
+     * @brief Release a slot.
+     * @param slot The slot index.
+     */
+    void Unregister(uint32_t slot);
+
+    /**
+     * @brief Set the orbital elements of a slot.
+     * @param slot The slot index.
+     * @param altitude Orbital altitude in meters.
+     * @param inclinationDegrees Inclination in degrees.
+     * @param raanDegrees Right Ascension of the Ascending Node in degrees.
+     * @param initialAngleDegrees Angle in the orbit at time zero, in degrees.
+     */
+    void SetElements(uint32_t slot,
+                     double altitude,
+                     double inclinationDegrees,
+                     double raanDegrees,
+                     double initialAngleDegrees);
+
+    /**
+     * @brief Propagate every slot to the given time, unless already done.
+     * @param now The simulation time.
+     */
+    void Refresh(Time now);
+
+    /**
+     * @brief Position of one slot at the given time.
+     * @param slot The slot index.
+     * @param now The simulation time.
+     * @return The position in meters.
+     */
+    Vector GetPosition(uint32_t slot, Time now);
+
+    /**
+     * @brief Velocity of one slot at the given time.
+     * @param slot The slot index.
+     * @param now The simulation time.
+     * @return The velocity in m/s.
+     */
+    Vector GetVelocity(uint32_t slot, Time now);
+
+    /**
+     * @return The number of slots, including released ones.
+     */
+    uint32_t GetNSlots() const;
+
+    /// Batch propagated state by slot, valid after Refresh().
+    const double* GetX() const;
+    const double* GetY() const;
+    const double* GetZ() const;
+    const double* GetVx() const;
+    const double* GetVy() const;
+    const double* GetVz() const;
+
+    /// Orbital elements by slot, e.g. to predict events of circular orbits.
+    SatelliteOrbitPropagator::Elements GetElements() const;
+
+private:
+    SatelliteEphemeris();
+
+    SatelliteOrbitPropagator::State GetState();
+    SatelliteOrbitPropagator::State GetBatchState();
+    void PropagateSlot(uint32_t slot, double t);
+
+    // Orbital elements, by slot
+    std::vector<double> m_radius;
+    std::vector<double> m_speed;
+    std::vector<double> m_angularVelocity;
+    std::vector<double> m_initialAngle;
+    std::vector<double> m_cosInclination;
+    std::vector<double> m_sinInclination;
+    std::vector<double> m_cosRaan;
+    std::vector<double> m_sinRaan;
+
+    // Propagated state, by slot
+    std::vector<double> m_x;
+    std::vector<double> m_y;
+    std::vector<double> m_z;
+    std::vector<double> m_vx;
+    std::vector<double> m_vy;
+    std::vector<double> m_vz;
+    std::vector<int64_t> m_stamp; //!< Time step each slot was last propagated to
+
+    // Batch propagated state, by slot, written only by Refresh()
+    std::vector<double> m_batchX;
+    std::vector<double> m_batchY;
+    std::vector<double> m_batchZ;
+    std::vector<double> m_batchVx;
+    std::vector<double> m_batchVy;
+    std::vector<double> m_batchVz;
+
+    std::vector<uint32_t> m_freeSlots;
+    int64_t m_batchStamp;         //!< Time step of the last full Refresh()
+    bool m_batchValid;            //!< Whether every slot is propagated to m_batchStamp
+};
+
+} // namespace ns3
+
+#endif /* SATELLITE_EPHEMERIS_H */
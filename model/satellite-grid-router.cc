@@ -0,0 +1,138 @@
+#include "satellite-grid-router.h"
+
+#include <algorithm>
+
+namespace ns3 {
+
+SatelliteGridRouter::SatelliteGridRouter()
+    : m_graph(nullptr),
+      m_numPlanes(0),
+      m_satsPerPlane(0)
+{
+}
+
+bool
+SatelliteGridRouter::Build(const SatelliteRouteGraph& graph, const std::vector<std::vector<uint32_t>>& planes)
+{
+    m_graph = nullptr;
+    m_numPlanes = planes.size();
+    m_satsPerPlane = planes.empty() ? 0 : planes[0].size();
+    m_plane.assign(graph.GetNVertices(), INVALID_INDEX);
+    m_slot.assign(graph.GetNVertices(), INVALID_INDEX);
+    m_edge.assign(4 * static_cast<size_t>(graph.GetNVertices()), INVALID_INDEX);
+    if (m_numPlanes == 0 || m_satsPerPlane == 0)
+    {
+        return false;
+    }
+
+    for (uint32_t p = 0; p < m_numPlanes; ++p)
+    {
+        if (planes[p].size() != m_satsPerPlane)
+        {
+            return false;
+        }
+        for (uint32_t s = 0; s < m_satsPerPlane; ++s)
+        {
+            uint32_t v = planes[p][s];
+            if (v >= graph.GetNVertices())
+            {
+                return false;
+            }
+            m_plane[v] = p;
+            m_slot[v] = s;
+        }
+    }
+
+    for (uint32_t p = 0; p < m_numPlanes; ++p)
+    {
+        for (uint32_t s = 0; s < m_satsPerPlane; ++s)
+        {
+            uint32_t v = planes[p][s];
+            uint32_t neighbour[4] = {planes[p][(s + 1) % m_satsPerPlane],
+                                     planes[p][(s + m_satsPerPlane - 1) % m_satsPerPlane],
+                                     planes[(p + 1) % m_numPlanes][s],
+                                     planes[(p + m_numPlanes - 1) % m_numPlanes][s]};
+            for (uint32_t d = 0; d < 4; ++d)
+            {
+                uint32_t e = graph.FindEdge(v, neighbour[d]);
+                if (e == INVALID_INDEX && neighbour[d] != v)
+                {
+                    return false;
+                }
+                m_edge[4 * static_cast<size_t>(v) + d] = e;
+            }
+        }
+    }
+
+    m_graph = &graph;
+    return true;
+}
+
+bool
+SatelliteGridRouter::IsValid() const
+{
+    return m_graph != nullptr;
+}
+
+uint32_t
+SatelliteGridRouter::GetNextHop(uint32_t src, uint32_t dst)
+{
+    if (src == dst || m_plane[src] == INVALID_INDEX || m_plane[dst] == INVALID_INDEX)
+    {
+        return INVALID_INDEX;
+    }
+
+    // Offsets towards the destination going "forward" round each ring; the
+    // shorter way round decides the direction, both if they are equally long.
+    uint32_t dp = (m_plane[dst] + m_numPlanes - m_plane[src]) % m_numPlanes;
+    uint32_t ds = (m_slot[dst] + m_satsPerPlane - m_slot[src]) % m_satsPerPlane;
+
+    uint32_t candidates[4];
+    uint32_t n = 0;
+    if (ds != 0)
+    {
+        if (2 * ds <= m_satsPerPlane) candidates[n++] = NEXT_IN_PLANE;
+        if (2 * ds >= m_satsPerPlane) candidates[n++] = PREV_IN_PLANE;
+    }
+    if (dp != 0)
+    {
+        if (2 * dp <= m_numPlanes) candidates[n++] = NEXT_PLANE;
+        if (2 * dp >= m_numPlanes) candidates[n++] = PREV_PLANE;
+    }
+
+    // Take the shortest of the minimum-hop links; in-plane links win ties
+    const uint32_t* edge = &m_edge[4 * static_cast<size_t>(src)];
+    const double* weights = m_graph->GetWeights().data();
+    uint32_t best = edge[candidates[0]];
+    for (uint32_t i = 1; i < n; ++i)
+    {
+        uint32_t e = edge[candidates[i]];
+        if (weights[e] < weights[best])
+        {
+            best = e;
+        }
+    }
+    return m_graph->GetTargets()[best];
+}
+
+uint32_t
+SatelliteGridRouter::GetHopCount(uint32_t src, uint32_t dst) const
+{
+    uint32_t dp = (m_plane[dst] + m_numPlanes - m_plane[src]) % m_numPlanes;
+    uint32_t ds = (m_slot[dst] + m_satsPerPlane - m_slot[src]) % m_satsPerPlane;
+    return std::min(dp, m_numPlanes - dp) + std::min(ds, m_satsPerPlane - ds);
+}
+
+uint32_t
+SatelliteGridRouter::GetNPlanes() const
+{
+    return m_numPlanes;
+}
+
+uint32_t
+SatelliteGridRouter::GetSatellitesPerPlane() const
+{
+    return m_satsPerPlane;
+}
+
+} // namespace ns3
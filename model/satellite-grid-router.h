@@ -0,0 +1,86 @@
+#ifndef SATELLITE_GRID_ROUTER_H
+#define SATELLITE_GRID_ROUTER_H
+
+#include "satellite-next-hop-provider.h"
+#include "satellite-route-graph.h"
+#include <cstdint>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * @ingroup satellite
+ * @brief Closed-form next hops on a +Grid inter-satellite link torus.
+ *
+ * InterSatelliteLinkHelper links every satellite to its ring neighbours in the
+ * plane and to the satellite with the same index in the next plane, with both
+ * dimensions wrapping around. On that torus a minimum-hop path only ever moves
+ * towards the destination along the shorter way round in each dimension, so
+ * the next hop follows from the (plane, index) coordinates of source and
+ * destination alone. Among the (at most four) minimum-hop moves the router
+ * takes the currently shortest link, which keeps paths close to minimum delay
+ * without any search or per-destination state.
+ *
+ * Failed links are not considered; the owner has to fall back to a graph
+ * search while any link of the grid is down.
+ */
+class SatelliteGridRouter : public SatelliteNextHopProvider
+{
+public:
+    static constexpr uint32_t INVALID_INDEX = SatelliteRouteGraph::INVALID_INDEX;
+
+    SatelliteGridRouter();
+
+    /**
+     * @brief Learn the grid and check that the graph really is a +Grid torus.
+     * @param graph The link graph. Kept by reference for the current link lengths.
+     * @param planes Vertex of every satellite, by plane then index in the plane.
+     * @return Whether every plane has the same size and every grid link exists.
+     *         Otherwise the router stays invalid.
+     */
+    bool Build(const SatelliteRouteGraph& graph, const std::vector<std::vector<uint32_t>>& planes);
+
+    /**
+     * @return Whether Build() succeeded.
+     */
+    bool IsValid() const;
+
+    /**
+     * @param src The source vertex.
+     * @param dst The destination vertex.
+     * @return The neighbour of src to forward to, or INVALID_INDEX if src == dst
+     *         or either is not on the grid.
+     */
+    uint32_t GetNextHop(uint32_t src, uint32_t dst) override;
+
+    /**
+     * @param src The source vertex.
+     * @param dst The destination vertex.
+     * @return The minimum number of hops between them on the grid.
+     */
+    uint32_t GetHopCount(uint32_t src, uint32_t dst) const;
+
+    uint32_t GetNPlanes() const;
+    uint32_t GetSatellitesPerPlane() const;
+
+private:
+    /// Link directions, also the layout of m_edge
+    enum Direction
+    {
+        NEXT_IN_PLANE = 0,
+        PREV_IN_PLANE = 1,
+        NEXT_PLANE = 2,
+        PREV_PLANE = 3
+    };
+
+    const SatelliteRouteGraph* m_graph;
+    uint32_t m_numPlanes;
+    uint32_t m_satsPerPlane;
+    std::vector<uint32_t> m_plane;  //!< Plane, by vertex
+    std::vector<uint32_t> m_slot;   //!< Index in the plane, by vertex
+    std::vector<uint32_t> m_edge;   //!< Four edge indices per vertex, by Direction
+};
+
+} // namespace ns3
+
+#endif /* SATELLITE_GRID_ROUTER_H */
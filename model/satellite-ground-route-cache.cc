@@ -0,0 +1,81 @@
+#include "satellite-ground-route-cache.h"
+#include "satellite-route-engine.h"
+
+namespace ns3 {
+
+SatelliteGroundRouteCache::SatelliteGroundRouteCache()
+    : m_uplinkEngineEpoch(0),
+      m_uplinkSatellite(SatelliteRouteEngine::INVALID_INDEX),
+      m_pathEpoch(0)
+{
+}
+
+void
+SatelliteGroundRouteCache::Clear()
+{
+    m_uplink = nullptr;
+    m_sourceRoutes.clear();
+    m_labels.clear();
+}
+
+Ptr<Ipv4Route>
+SatelliteGroundRouteCache::GetUplink(Time epoch, uint64_t engineEpoch) const
+{
+    if (m_uplinkEpoch != epoch || m_uplinkEngineEpoch != engineEpoch)
+    {
+        return nullptr;
+    }
+    return m_uplink;
+}
+
+uint32_t
+SatelliteGroundRouteCache::GetUplinkSatellite() const
+{
+    return m_uplinkSatellite;
+}
+
+void
+SatelliteGroundRouteCache::SetUplink(Time epoch, uint64_t engineEpoch, Ptr<Ipv4Route> route, uint32_t satellite)
+{
+    m_uplink = route;
+    m_uplinkEpoch = epoch;
+    m_uplinkEngineEpoch = engineEpoch;
+    m_uplinkSatellite = satellite;
+}
+
+void
+SatelliteGroundRouteCache::SetPathEpoch(uint64_t engineEpoch)
+{
+    if (m_pathEpoch != engineEpoch)
+    {
+        m_sourceRoutes.clear();
+        m_labels.clear();
+        m_pathEpoch = engineEpoch;
+    }
+}
+
+SatelliteSourceRouteTag&
+SatelliteGroundRouteCache::GetSourceRoute(uint32_t dst)
+{
+    return m_sourceRoutes[dst];
+}
+
+bool
+SatelliteGroundRouteCache::FindLabel(uint32_t dst, uint32_t ingress, uint32_t& label) const
+{
+    auto it = m_labels.find(dst);
+    if (it == m_labels.end() || it->second.first != ingress)
+    {
+        return false;
+    }
+    label = it->second.second;
+    return true;
+}
+
+void
+SatelliteGroundRouteCache::SetLabel(uint32_t dst, uint32_t ingress, uint32_t label)
+{
+    m_labels.insert_or_assign(dst, std::make_pair(ingress, label));
+}
+
+} // namespace ns3
@@ -0,0 +1,95 @@
+#ifndef SATELLITE_GROUND_ROUTE_CACHE_H
+#define SATELLITE_GROUND_ROUTE_CACHE_H
+
+#include "ns3/ipv4-route.h"
+#include "ns3/nstime.h"
+#include "satellite-source-route-tag.h"
+#include <unordered_map>
+#include <utility>
+
+namespace ns3 {
+
+/**
+ * @ingroup satellite
+ * @brief What a ground station decides once per epoch rather than per packet.
+ *
+ * The uplink only changes with the scheduler epoch or when the engine
+ * recomputes routes, e.g. after a link failure, so it is kept for both.
+ * With SourceRouting or LabelSwitching, the path or label to each destination
+ * ground station is kept for the engine epoch number and for the ingress
+ * satellite it was built from.
+ */
+class SatelliteGroundRouteCache
+{
+public:
+    SatelliteGroundRouteCache();
+
+    /**
+     * @brief Drop everything, e.g. when a ground link changes peer.
+     */
+    void Clear();
+
+    /**
+     * @param epoch The current scheduler epoch.
+     * @param engineEpoch The current engine epoch number.
+     * @return The uplink chosen for both, or nullptr.
+     */
+    Ptr<Ipv4Route> GetUplink(Time epoch, uint64_t engineEpoch) const;
+
+    /**
+     * @return The satellite index the cached uplink leads to.
+     */
+    uint32_t GetUplinkSatellite() const;
+
+    /**
+     * @brief Keep the uplink chosen for an epoch.
+     * @param epoch The scheduler epoch.
+     * @param engineEpoch The engine epoch number.
+     * @param route The uplink.
+     * @param satellite The satellite index it leads to.
+     */
+    void SetUplink(Time epoch, uint64_t engineEpoch, Ptr<Ipv4Route> route, uint32_t satellite);
+
+    /**
+     * @brief Drop the paths and labels if they were kept for another engine epoch.
+     * @param engineEpoch The current engine epoch number.
+     */
+    void SetPathEpoch(uint64_t engineEpoch);
+
+    /**
+     * @param dst A destination ground station index.
+     * @return The source route to it, empty if none was built yet.
+     */
+    SatelliteSourceRouteTag& GetSourceRoute(uint32_t dst);
+
+    /**
+     * @param dst A destination ground station index.
+     * @param ingress The satellite index the packet is uplinked to.
+     * @param label Output, the label.
+     * @return Whether a label was kept for the destination and ingress.
+     */
+    bool FindLabel(uint32_t dst, uint32_t ingress, uint32_t& label) const;
+
+    /**
+     * @brief Keep the label to a destination ground station for an ingress satellite.
+     * @param dst A destination ground station index.
+     * @param ingress The satellite index the packet is uplinked to.
+     * @param label The label.
+     */
+    void SetLabel(uint32_t dst, uint32_t ingress, uint32_t label);
+
+private:
+    Ptr<Ipv4Route> m_uplink;
+    Time m_uplinkEpoch;
+    uint64_t m_uplinkEngineEpoch; //!< Engine epoch number m_uplink was chosen in
+    uint32_t m_uplinkSatellite;   //!< Satellite index m_uplink leads to
+    // Path or label to each destination ground station, by ground station
+    // index, for the engine epoch number m_pathEpoch
+    std::unordered_map<uint32_t, SatelliteSourceRouteTag> m_sourceRoutes;
+    std::unordered_map<uint32_t, std::pair<uint32_t, uint32_t>> m_labels; //!< (ingress, label)
+    uint64_t m_pathEpoch;
+};
+
+} // namespace ns3
+
+#endif /* SATELLITE_GROUND_ROUTE_CACHE_H */
@@ -0,0 +1,55 @@
+#include "satellite-label-table.h"
+
+namespace ns3 {
+
+SatelliteLabelTable::SatelliteLabelTable()
+    : m_epoch(0)
+{
+}
+
+void
+SatelliteLabelTable::Clear()
+{
+    m_route.clear();
+    m_nextHop.clear();
+}
+
+uint32_t
+SatelliteLabelTable::Update(Ptr<SatelliteRouteEngine> engine, uint32_t self, SatelliteLinkRoutes& links)
+{
+    uint32_t numLabels = engine->GetNLabels();
+    m_route.resize(numLabels, nullptr);
+    m_nextHop.resize(numLabels, SatelliteRouteEngine::INVALID_INDEX);
+
+    uint32_t changed = 0;
+    for (uint32_t label = 0; label < numLabels; ++label)
+    {
+        std::pair<uint32_t, uint32_t> path = engine->GetLabelPath(label);
+        uint32_t next = (path.first == self) ? DOWNLINK : engine->GetNextHop(self, path.first);
+        if (next == m_nextHop[label])
+        {
+            continue;
+        }
+        m_nextHop[label] = next;
+        ++changed;
+        // Beam downlinks hand the terminal over per packet and stay on the
+        // regular path
+        m_route[label] = (next == DOWNLINK) ? links.GetDownlinkRoute(path.second) : links.GetNeighbourRoute(next);
+    }
+    m_epoch = engine->GetEpochNumber();
+    return changed;
+}
+
+bool
+SatelliteLabelTable::IsCurrent(uint32_t label, uint64_t engineEpoch) const
+{
+    return label < m_route.size() && m_epoch == engineEpoch;
+}
+
+Ptr<Ipv4Route>
+SatelliteLabelTable::GetRoute(uint32_t label) const
+{
+    return m_route[label];
+}
+
+} // namespace ns3
@@ -0,0 +1,64 @@
+#ifndef SATELLITE_LABEL_TABLE_H
+#define SATELLITE_LABEL_TABLE_H
+
+#include "ns3/ipv4-route.h"
+#include "satellite-link-routes.h"
+#include "satellite-route-engine.h"
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * @ingroup satellite
+ * @brief Route of one satellite for every label, with LabelSwitching.
+ *
+ * A label names an (egress satellite, destination ground station) path. The
+ * table holds the route out of this satellite for each of them: to the next
+ * hop towards the egress, or down to the ground station at the egress. It is
+ * kept for an engine epoch number, and Update() rewrites only the entries
+ * whose next hop changed.
+ */
+class SatelliteLabelTable
+{
+public:
+    /// Next hop of the labels this satellite is the egress of.
+    static constexpr uint32_t DOWNLINK = SatelliteRouteEngine::INVALID_INDEX - 1;
+
+    SatelliteLabelTable();
+
+    /**
+     * @brief Drop every entry, e.g. when the downlink routes it holds are dropped.
+     */
+    void Clear();
+
+    /**
+     * @brief Bring the table up to the current engine epoch.
+     * @param engine The route engine.
+     * @param self The satellite index of this satellite.
+     * @param links The link routes of this satellite.
+     * @return The number of entries that changed.
+     */
+    uint32_t Update(Ptr<SatelliteRouteEngine> engine, uint32_t self, SatelliteLinkRoutes& links);
+
+    /**
+     * @param label A label.
+     * @param engineEpoch The current engine epoch number.
+     * @return Whether the table holds the label for that epoch.
+     */
+    bool IsCurrent(uint32_t label, uint64_t engineEpoch) const;
+
+    /**
+     * @param label A label held by the table.
+     * @return Its route, or nullptr if this satellite has no way to forward it.
+     */
+    Ptr<Ipv4Route> GetRoute(uint32_t label) const;
+
+private:
+    std::vector<Ptr<Ipv4Route>> m_route;
+    std::vector<uint32_t> m_nextHop; //!< Satellite index, or DOWNLINK at the egress
+    uint64_t m_epoch;                //!< Engine epoch number of the table
+};
+
+} // namespace ns3
+
+#endif /* SATELLITE_LABEL_TABLE_H */
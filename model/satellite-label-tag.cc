@@ -0,0 +1,74 @@
+#include "satellite-label-tag.h"
+
+#include "ns3/log.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SatelliteLabelTag");
+
+NS_OBJECT_ENSURE_REGISTERED(SatelliteLabelTag);
+
+SatelliteLabelTag::SatelliteLabelTag()
+    : m_label(0)
+{
+}
+
+SatelliteLabelTag::SatelliteLabelTag(uint32_t label)
+    : m_label(label)
+{
+}
+
+TypeId
+SatelliteLabelTag::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::SatelliteLabelTag")
+                            .SetParent<Tag>()
+                            .SetGroupName("Satellite")
+                            .AddConstructor<SatelliteLabelTag>();
+    return tid;
+}
+
+TypeId
+SatelliteLabelTag::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+uint32_t
+SatelliteLabelTag::GetSerializedSize() const
+{
+    return sizeof(m_label);
+}
+
+void
+SatelliteLabelTag::Serialize(TagBuffer i) const
+{
+    i.WriteU32(m_label);
+}
+
+void
+SatelliteLabelTag::Deserialize(TagBuffer i)
+{
+    m_label = i.ReadU32();
+}
+
+void
+SatelliteLabelTag::Print(std::ostream& os) const
+{
+    os << "SatelliteLabelTag(Label=" << m_label << ")";
+}
+
+void
+SatelliteLabelTag::SetLabel(uint32_t label)
+{
+    m_label = label;
+}
+
+uint32_t
+SatelliteLabelTag::GetLabel() const
+{
+    return m_label;
+}
+
+} // namespace ns3
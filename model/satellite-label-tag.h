@@ -0,0 +1,44 @@
+#ifndef SATELLITE_LABEL_TAG_H
+#define SATELLITE_LABEL_TAG_H
+
+#include "ns3/tag.h"
+
+namespace ns3
+{
+
+/**
+ * @ingroup satellite
+ * @brief The label of the path a packet follows through the constellation.
+ *
+ * With LabelSwitching, the sending ground station pushes the label of the
+ * (egress satellite, destination ground station) pair its packet is bound
+ * for, as allocated by SatelliteRouteEngine::GetLabel(). Every satellite
+ * forwards labelled packets with one index into its label table.
+ */
+class SatelliteLabelTag : public Tag
+{
+public:
+    SatelliteLabelTag();
+
+    /**
+     * @param label The label.
+     */
+    explicit SatelliteLabelTag(uint32_t label);
+
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+    uint32_t GetSerializedSize() const override;
+    void Serialize(TagBuffer i) const override;
+    void Deserialize(TagBuffer i) override;
+    void Print(std::ostream& os) const override;
+
+    void SetLabel(uint32_t label);
+    uint32_t GetLabel() const;
+
+private:
+    uint32_t m_label;
+};
+
+} // namespace ns3
+
+#endif /* SATELLITE_LABEL_TAG_H */
@@ -0,0 +1,208 @@
+#include "satellite-link-routes.h"
+#include "ns3/channel.h"
+
+namespace ns3 {
+
+SatelliteLinkRoutes::SatelliteLinkRoutes()
+    : m_neighboursBuilt(false),
+      m_beamChecked(false)
+{
+}
+
+void
+SatelliteLinkRoutes::Setup(Ptr<Ipv4> ipv4, Ptr<SatelliteRouteEngine> engine)
+{
+    m_ipv4 = ipv4;
+    m_engine = engine;
+}
+
+void
+SatelliteLinkRoutes::ClearGroundLinks()
+{
+    m_uplinkDevice.clear();
+    m_uplinkRoute.clear();
+    m_downlinkRoute.clear();
+}
+
+template <typename F>
+void
+SatelliteLinkRoutes::ForEachLink(F f) const
+{
+    for (uint32_t i = 1; i < m_ipv4->GetNInterfaces(); ++i)
+    {
+        Ptr<NetDevice> dev = m_ipv4->GetNetDevice(i);
+        Ptr<Channel> ch = dev->GetChannel();
+        if (ch && dev->IsPointToPoint() && ch->GetNDevices() == 2)
+        {
+            Ptr<NetDevice> peerDev = (ch->GetDevice(0) == dev) ? ch->GetDevice(1) : ch->GetDevice(0);
+            if (peerDev)
+            {
+                f(dev, peerDev->GetNode());
+            }
+        }
+    }
+}
+
+void
+SatelliteLinkRoutes::BuildUplinks()
+{
+    m_uplinkDevice.assign(m_engine->GetNSatellites(), nullptr);
+    m_uplinkRoute.assign(m_engine->GetNSatellites(), nullptr);
+    ForEachLink([this](Ptr<NetDevice> dev, Ptr<Node> peer) {
+        uint32_t satIndex = m_engine->GetSatelliteIndex(peer);
+        if (satIndex != SatelliteRouteEngine::INVALID_INDEX)
+        {
+            m_uplinkDevice[satIndex] = dev;
+            m_uplinkRoute[satIndex] = CreateRouteVia(dev);
+        }
+    });
+}
+
+void
+SatelliteLinkRoutes::BuildDownlinks()
+{
+    m_downlinkRoute.assign(m_engine->GetNGroundStations(), nullptr);
+    ForEachLink([this](Ptr<NetDevice> dev, Ptr<Node> peer) {
+        uint32_t gsIndex = m_engine->GetGroundStationIndex(peer);
+        if (gsIndex != SatelliteRouteEngine::INVALID_INDEX)
+        {
+            m_downlinkRoute[gsIndex] = CreateRouteVia(dev);
+        }
+    });
+}
+
+void
+SatelliteLinkRoutes::BuildNeighbours()
+{
+    m_neighbourRoute.clear();
+    ForEachLink([this](Ptr<NetDevice> dev, Ptr<Node> peer) {
+        uint32_t satIndex = m_engine->GetSatelliteIndex(peer);
+        if (satIndex != SatelliteRouteEngine::INVALID_INDEX)
+        {
+            m_neighbourRoute.push_back({satIndex, CreateRouteVia(dev)});
+        }
+    });
+    m_neighboursBuilt = true;
+}
+
+Ptr<NetDevice>
+SatelliteLinkRoutes::GetUplinkDevice(uint32_t satellite)
+{
+    if (m_uplinkDevice.size() != m_engine->GetNSatellites())
+    {
+        BuildUplinks();
+    }
+    return (satellite < m_uplinkDevice.size()) ? m_uplinkDevice[satellite] : nullptr;
+}
+
+Ptr<Ipv4Route>
+SatelliteLinkRoutes::GetUplinkRoute(uint32_t satellite)
+{
+    if (m_uplinkRoute.size() != m_engine->GetNSatellites())
+    {
+        BuildUplinks();
+    }
+    return (satellite < m_uplinkRoute.size()) ? m_uplinkRoute[satellite] : nullptr;
+}
+
+Ptr<Ipv4Route>
+SatelliteLinkRoutes::GetDownlinkRoute(uint32_t groundStation)
+{
+    if (m_downlinkRoute.size() != m_engine->GetNGroundStations())
+    {
+        BuildDownlinks();
+    }
+    return (groundStation < m_downlinkRoute.size()) ? m_downlinkRoute[groundStation] : nullptr;
+}
+
+Ptr<Ipv4Route>
+SatelliteLinkRoutes::GetNeighbourRoute(uint32_t satellite)
+{
+    if (!m_neighboursBuilt)
+    {
+        BuildNeighbours();
+    }
+    // A satellite has a handful of neighbours, a linear search beats a map
+    for (const auto& neighbour : m_neighbourRoute)
+    {
+        if (neighbour.first == satellite)
+        {
+            return neighbour.second;
+        }
+    }
+    return nullptr;
+}
+
+bool
+SatelliteLinkRoutes::HasBeamDevice()
+{
+    if (!m_beamChecked)
+    {
+        m_beamDevice = SatelliteBeamNetDevice::GetBeamDevice(m_ipv4->GetObject<Node>());
+        m_beamChecked = true;
+    }
+    return m_beamDevice != nullptr;
+}
+
+Ptr<Ipv4Route>
+SatelliteLinkRoutes::GetBeamRoute(uint32_t peerIndex, Ptr<Node> peer, uint32_t numPeers)
+{
+    if (!HasBeamDevice())
+    {
+        return nullptr;
+    }
+    if (m_beamRoute.size() != numPeers)
+    {
+        m_beamPeer.assign(numPeers, nullptr);
+        m_beamRoute.assign(numPeers, nullptr);
+    }
+    if (!m_beamRoute[peerIndex])
+    {
+        Ptr<SatelliteBeamNetDevice> peerDev = SatelliteBeamNetDevice::GetBeamDevice(peer);
+        Ptr<Ipv4> peerIpv4 = peer->GetObject<Ipv4>();
+        int32_t peerInterface = (peerDev && peerIpv4) ? peerIpv4->GetInterfaceForDevice(peerDev) : -1;
+        if (peerInterface < 0)
+        {
+            return nullptr;
+        }
+        Ipv4Address gateway = peerIpv4->GetAddress(peerInterface, 0).GetLocal();
+
+        Ptr<Ipv4Route> route = Create<Ipv4Route>();
+        route->SetDestination(gateway);
+        route->SetSource(m_ipv4->GetAddress(m_ipv4->GetInterfaceForDevice(m_beamDevice), 0).GetLocal());
+        route->SetGateway(gateway);
+        route->SetOutputDevice(m_beamDevice);
+        m_beamPeer[peerIndex] = peerDev;
+        m_beamRoute[peerIndex] = route;
+    }
+
+    // Put the ground terminal in the beam of the satellite; both ends agree on
+    // the egress satellite, so this only moves it when the egress changes
+    if (m_beamDevice->IsSatellite())
+    {
+        m_beamPeer[peerIndex]->Handover(m_beamDevice->GetBeam());
+    }
+    else
+    {
+        m_beamDevice->Handover(m_beamPeer[peerIndex]->GetBeam());
+    }
+    return m_beamRoute[peerIndex];
+}
+
+Ptr<Ipv4Route>
+SatelliteLinkRoutes::CreateRouteVia(Ptr<NetDevice> dev) const
+{
+    Ptr<Channel> ch = dev->GetChannel();
+    Ptr<NetDevice> peerDev = (ch->GetDevice(0) == dev) ? ch->GetDevice(1) : ch->GetDevice(0);
+    Ptr<Ipv4> peerIpv4 = peerDev->GetNode()->GetObject<Ipv4>();
+    Ipv4Address gateway = peerIpv4->GetAddress(peerIpv4->GetInterfaceForDevice(peerDev), 0).GetLocal();
+
+    Ptr<Ipv4Route> route = Create<Ipv4Route>();
+    route->SetDestination(gateway);
+    route->SetSource(m_ipv4->GetAddress(m_ipv4->GetInterfaceForDevice(dev), 0).GetLocal());
+    route->SetGateway(gateway);
+    route->SetOutputDevice(dev);
+    return route;
+}
+
+} // namespace ns3
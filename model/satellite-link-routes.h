@@ -0,0 +1,124 @@
+#ifndef SATELLITE_LINK_ROUTES_H
+#define SATELLITE_LINK_ROUTES_H
+
+#include "ns3/ipv4.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "satellite-beam-net-device.h"
+#include "satellite-route-engine.h"
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * @ingroup satellite
+ * @brief Routes of one node over its own links, by peer index.
+ *
+ * A satellite reaches its inter-satellite link neighbours and the ground
+ * stations it has a link to; a ground station reaches the satellites it has a
+ * link to. Each route object is built on first use and then shared by every
+ * destination forwarded over that link. Ground links bound on demand change
+ * peers during the simulation, so ClearGroundLinks() drops their routes and
+ * they are rebuilt on the next use.
+ *
+ * Nodes with a shared beam device (SatelliteBeamHelper) reach their peers
+ * through the beam instead; GetBeamRoute() also hands the ground terminal over
+ * to the right satellite.
+ */
+class SatelliteLinkRoutes
+{
+public:
+    SatelliteLinkRoutes();
+
+    /**
+     * @param ipv4 The IPv4 stack of the node.
+     * @param engine The route engine, for peer indices.
+     */
+    void Setup(Ptr<Ipv4> ipv4, Ptr<SatelliteRouteEngine> engine);
+
+    /**
+     * @brief Drop the uplink and downlink routes.
+     */
+    void ClearGroundLinks();
+
+    /**
+     * @param satellite A satellite index.
+     * @return The device of this ground station linked to the satellite, or nullptr.
+     */
+    Ptr<NetDevice> GetUplinkDevice(uint32_t satellite);
+
+    /**
+     * @param satellite A satellite index.
+     * @return The route of this ground station to the satellite, or nullptr.
+     */
+    Ptr<Ipv4Route> GetUplinkRoute(uint32_t satellite);
+
+    /**
+     * @param groundStation A ground station index.
+     * @return The route of this satellite to the ground station, or nullptr.
+     */
+    Ptr<Ipv4Route> GetDownlinkRoute(uint32_t groundStation);
+
+    /**
+     * @param satellite A satellite index.
+     * @return The route of this satellite to an inter-satellite link neighbour, or nullptr.
+     */
+    Ptr<Ipv4Route> GetNeighbourRoute(uint32_t satellite);
+
+    /**
+     * @return Whether this node has a shared beam device.
+     */
+    bool HasBeamDevice();
+
+    /**
+     * @brief Route to a peer in a shared beam, handing the ground terminal over
+     *        to the satellite end if needed.
+     * @param peerIndex The peer: a satellite index on ground stations, a
+     *        ground station index on satellites.
+     * @param peer The peer node.
+     * @param numPeers Number of possible peers.
+     * @return The route, or nullptr if either end has no beam device.
+     */
+    Ptr<Ipv4Route> GetBeamRoute(uint32_t peerIndex, Ptr<Node> peer, uint32_t numPeers);
+
+    /**
+     * @param dev A point-to-point device of this node.
+     * @return A route to the other end of the link.
+     */
+    Ptr<Ipv4Route> CreateRouteVia(Ptr<NetDevice> dev) const;
+
+private:
+    /**
+     * @brief Call a function with the peer node of every point-to-point link.
+     */
+    template <typename F>
+    void ForEachLink(F f) const;
+
+    void BuildUplinks();
+    void BuildDownlinks();
+    void BuildNeighbours();
+
+    Ptr<Ipv4> m_ipv4;
+    Ptr<SatelliteRouteEngine> m_engine;
+    // Ground stations only: device and route towards each satellite, by satellite index
+    std::vector<Ptr<NetDevice>> m_uplinkDevice;
+    std::vector<Ptr<Ipv4Route>> m_uplinkRoute;
+    // Satellites only: route to each ground station, by ground station index
+    std::vector<Ptr<Ipv4Route>> m_downlinkRoute;
+    // Satellites only: route to each inter-satellite link neighbour
+    std::vector<std::pair<uint32_t, Ptr<Ipv4Route>>> m_neighbourRoute;
+    bool m_neighboursBuilt;
+    // Shared beam device of this node, found on first use
+    Ptr<SatelliteBeamNetDevice> m_beamDevice;
+    bool m_beamChecked;
+    // Beam device and route of each peer, by satellite index on ground stations
+    // and by ground station index on satellites
+    std::vector<Ptr<SatelliteBeamNetDevice>> m_beamPeer;
+    std::vector<Ptr<Ipv4Route>> m_beamRoute;
+};
+
+} // namespace ns3
+
+#endif /* SATELLITE_LINK_ROUTES_H */
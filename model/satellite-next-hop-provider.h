@@ -0,0 +1,32 @@
+#ifndef SATELLITE_NEXT_HOP_PROVIDER_H
+#define SATELLITE_NEXT_HOP_PROVIDER_H
+
+#include <cstdint>
+
+namespace ns3 {
+
+/**
+ * @ingroup satellite
+ * @brief Source of first hops between satellites for the current epoch.
+ *
+ * SatelliteRouteEngine keeps one provider per routing mode (all-pairs search,
+ * +Grid closed form, on-demand search, archive replay), brings the one the
+ * epoch uses up to date, and forwards every next-hop query to it.
+ */
+class SatelliteNextHopProvider
+{
+public:
+    virtual ~SatelliteNextHopProvider() = default;
+
+    /**
+     * @param src The source satellite index.
+     * @param dst The destination satellite index.
+     * @return The satellite index of the next hop, or INVALID_INDEX if src == dst
+     *         or dst is unreachable.
+     */
+    virtual uint32_t GetNextHop(uint32_t src, uint32_t dst) = 0;
+};
+
+} // namespace ns3
+
+#endif /* SATELLITE_NEXT_HOP_PROVIDER_H */
@@ -0,0 +1,77 @@
+#include "satellite-on-demand-router.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE("SatelliteOnDemandRouter");
+
+SatelliteOnDemandRouter::SatelliteOnDemandRouter()
+    : m_graph(nullptr),
+      m_x(nullptr),
+      m_y(nullptr),
+      m_z(nullptr),
+      m_numSearches(0)
+{
+}
+
+void
+SatelliteOnDemandRouter::Reset(const SatelliteRouteGraph& graph, const double* x, const double* y, const double* z)
+{
+    m_graph = &graph;
+    m_x = x;
+    m_y = y;
+    m_z = z;
+    m_nextHop.clear();
+    m_numSearches = 0;
+}
+
+void
+SatelliteOnDemandRouter::Clear()
+{
+    m_graph = nullptr;
+    m_nextHop.clear();
+    m_numSearches = 0;
+}
+
+uint32_t
+SatelliteOnDemandRouter::GetNSearches() const
+{
+    return m_numSearches;
+}
+
+uint32_t
+SatelliteOnDemandRouter::GetNextHop(uint32_t src, uint32_t dst)
+{
+    // No next hop to oneself, as in the all-pairs table
+    if (!m_graph || src == dst)
+    {
+        return SatelliteRouteGraph::INVALID_INDEX;
+    }
+
+    const uint64_t numVertices = m_graph->GetNVertices();
+    auto it = m_nextHop.find(src * numVertices + dst);
+    if (it != m_nextHop.end())
+    {
+        return it->second;
+    }
+
+    uint32_t settled = FindShortestPath(*m_graph, m_x, m_y, m_z, src, dst, m_scratch, m_path);
+    ++m_numSearches;
+    NS_LOG_LOGIC("On-demand search " << src << " -> " << dst << " settled " << settled << " vertices");
+    if (m_path.size() < 2)
+    {
+        m_nextHop[src * numVertices + dst] = SatelliteRouteGraph::INVALID_INDEX;
+        return SatelliteRouteGraph::INVALID_INDEX;
+    }
+
+    // Every part of a shortest path is a shortest path, and links work both
+    // ways, so one search answers the pair for every hop in both directions.
+    for (uint32_t i = 0; i + 1 < m_path.size(); ++i)
+    {
+        m_nextHop[m_path[i] * numVertices + dst] = m_path[i + 1];
+        m_nextHop[m_path[i + 1] * numVertices + src] = m_path[i];
+    }
+    return m_path[1];
+}
+
+} // namespace ns3
@@ -0,0 +1,58 @@
+#ifndef SATELLITE_ON_DEMAND_ROUTER_H
+#define SATELLITE_ON_DEMAND_ROUTER_H
+
+#include "satellite-next-hop-provider.h"
+#include "satellite-route-graph.h"
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * @ingroup satellite
+ * @brief Next hops resolved per (source, destination) pair when first asked for.
+ *
+ * A pair is resolved with a bidirectional A* search (FindShortestPath()) and
+ * every hop of the resulting path is memoized in both directions until the
+ * next epoch, so satellites that carry no traffic cost nothing.
+ */
+class SatelliteOnDemandRouter : public SatelliteNextHopProvider
+{
+public:
+    SatelliteOnDemandRouter();
+
+    /**
+     * @brief Start an epoch and forget the memoized pairs.
+     * @param graph The graph, with weights of the epoch. Kept by reference.
+     * @param x Vertex x of the epoch, for the A* bound. Kept by pointer, as are y and z.
+     * @param y Vertex y.
+     * @param z Vertex z.
+     */
+    void Reset(const SatelliteRouteGraph& graph, const double* x, const double* y, const double* z);
+
+    /**
+     * @brief Forget the epoch; GetNextHop() finds nothing until the next Reset().
+     */
+    void Clear();
+
+    /**
+     * @return The number of searches since the last Reset().
+     */
+    uint32_t GetNSearches() const;
+
+    uint32_t GetNextHop(uint32_t src, uint32_t dst) override;
+
+private:
+    const SatelliteRouteGraph* m_graph;
+    const double* m_x;
+    const double* m_y;
+    const double* m_z;
+    std::unordered_map<uint64_t, uint32_t> m_nextHop; //!< Memoized next hops, key src * N + dst
+    SatellitePairSearchScratch m_scratch;             //!< Buffers of the search
+    std::vector<uint32_t> m_path;                     //!< Last found path
+    uint32_t m_numSearches;
+};
+
+} // namespace ns3
+
+#endif /* SATELLITE_ON_DEMAND_ROUTER_H */
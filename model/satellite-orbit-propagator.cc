@@ -0,0 +1,371 @@
+#include "satellite-orbit-propagator.h"
+#include "ns3/enum.h"
+#include "ns3/global-value.h"
+
+#include <cmath>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SATELLITE_PROPAGATOR_X86 1
+#include <immintrin.h>
+#endif
+
+namespace ns3 {
+
+namespace {
+
+GlobalValue g_orbitKernel("SatelliteOrbitKernel",
+                          "Kernel of batch orbit propagation, read on first use unless "
+                          "SatelliteOrbitPropagator::SetKernel() was called. Auto picks the "
+                          "best one the CPU supports; an unsupported kernel falls back to Scalar.",
+                          EnumValue(SatelliteOrbitPropagator::AUTO),
+                          MakeEnumChecker(SatelliteOrbitPropagator::AUTO, "Auto",
+                                          SatelliteOrbitPropagator::SCALAR, "Scalar",
+                                          SatelliteOrbitPropagator::AVX2, "Avx2",
+                                          SatelliteOrbitPropagator::AVX512, "Avx512"));
+
+SatelliteOrbitPropagator::Kernel g_kernel = SatelliteOrbitPropagator::AUTO;
+bool g_kernelSelected = false; //!< Whether g_kernel was set, by SetKernel() or from g_orbitKernel
+
+void
+PropagateScalar(const SatelliteOrbitPropagator::Elements& e,
+                const SatelliteOrbitPropagator::State& s,
+                uint32_t begin,
+                uint32_t end,
+                double t)
+{
+    for (uint32_t i = begin; i < end; ++i)
+    {
+        double currentAngle = e.initialAngle[i] + e.angularVelocity[i] * t;
+        double cosAngle = std::cos(currentAngle);
+        double sinAngle = std::sin(currentAngle);
+
+        // Position and velocity in the 2D orbital plane
+        double x_orbital = e.radius[i] * cosAngle;
+        double y_orbital = e.radius[i] * sinAngle;
+        double vx_orbital = -e.speed[i] * sinAngle;
+        double vy_orbital = e.speed[i] * cosAngle;
+
+        // Rotate by inclination and RAAN (argument of perigee is 0)
+        s.x[i] = x_orbital * e.cosRaan[i] - y_orbital * e.cosInclination[i] * e.sinRaan[i];
+        s.y[i] = x_orbital * e.sinRaan[i] + y_orbital * e.cosInclination[i] * e.cosRaan[i];
+        s.z[i] = y_orbital * e.sinInclination[i];
+        s.vx[i] = vx_orbital * e.cosRaan[i] - vy_orbital * e.cosInclination[i] * e.sinRaan[i];
+        s.vy[i] = vx_orbital * e.sinRaan[i] + vy_orbital * e.cosInclination[i] * e.cosRaan[i];
+        s.vz[i] = vy_orbital * e.sinInclination[i];
+    }
+}
+
+#ifdef SATELLITE_PROPAGATOR_X86
+
+// sin/cos for the vector kernels: reduce to r in [-pi/4, pi/4] around the
+// nearest multiple of pi/2 (three-part Cody-Waite split of pi/2, exact for the
+// quadrant counts an orbit reaches), evaluate the Cephes minimax polynomials,
+// then swap and negate by quadrant.
+constexpr double TWO_OVER_PI = 0.63661977236758134308;
+constexpr double PIO2_1 = 1.5707962512969970703125;
+constexpr double PIO2_2 = 7.5497894158615963534e-8;
+constexpr double PIO2_3 = 5.3903028581581190529e-15;
+
+constexpr double SIN_C0 = 1.58962301576546568060e-10;
+constexpr double SIN_C1 = -2.50507477628578072866e-8;
+constexpr double SIN_C2 = 2.75573136213857245213e-6;
+constexpr double SIN_C3 = -1.98412698295895385996e-4;
+constexpr double SIN_C4 = 8.33333333332211858878e-3;
+constexpr double SIN_C5 = -1.66666666666666307295e-1;
+
+constexpr double COS_C0 = -1.13596475577881948265e-11;
+constexpr double COS_C1 = 2.08757008419747316778e-9;
+constexpr double COS_C2 = -2.75573141792967388112e-7;
+constexpr double COS_C3 = 2.48015872888517045348e-5;
+constexpr double COS_C4 = -1.38888888888730564116e-3;
+constexpr double COS_C5 = 4.16666666666665929218e-2;
+
+__attribute__((target("avx2,fma"))) inline void
+SinCosAvx2(__m256d x, __m256d* sinOut, __m256d* cosOut)
+{
+    __m256d j = _mm256_round_pd(_mm256_mul_pd(x, _mm256_set1_pd(TWO_OVER_PI)),
+                                _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256d r = _mm256_fnmadd_pd(j, _mm256_set1_pd(PIO2_1), x);
+    r = _mm256_fnmadd_pd(j, _mm256_set1_pd(PIO2_2), r);
+    r = _mm256_fnmadd_pd(j, _mm256_set1_pd(PIO2_3), r);
+    __m256d zz = _mm256_mul_pd(r, r);
+
+    __m256d ps = _mm256_set1_pd(SIN_C0);
+    ps = _mm256_fmadd_pd(ps, zz, _mm256_set1_pd(SIN_C1));
+    ps = _mm256_fmadd_pd(ps, zz, _mm256_set1_pd(SIN_C2));
+    ps = _mm256_fmadd_pd(ps, zz, _mm256_set1_pd(SIN_C3));
+    ps = _mm256_fmadd_pd(ps, zz, _mm256_set1_pd(SIN_C4));
+    ps = _mm256_fmadd_pd(ps, zz, _mm256_set1_pd(SIN_C5));
+    __m256d s = _mm256_fmadd_pd(_mm256_mul_pd(r, zz), ps, r);
+
+    __m256d pc = _mm256_set1_pd(COS_C0);
+    pc = _mm256_fmadd_pd(pc, zz, _mm256_set1_pd(COS_C1));
+    pc = _mm256_fmadd_pd(pc, zz, _mm256_set1_pd(COS_C2));
+    pc = _mm256_fmadd_pd(pc, zz, _mm256_set1_pd(COS_C3));
+    pc = _mm256_fmadd_pd(pc, zz, _mm256_set1_pd(COS_C4));
+    pc = _mm256_fmadd_pd(pc, zz, _mm256_set1_pd(COS_C5));
+    __m256d c = _mm256_fmadd_pd(_mm256_mul_pd(zz, zz), pc,
+                                _mm256_fnmadd_pd(_mm256_set1_pd(0.5), zz, _mm256_set1_pd(1.0)));
+
+    // Quadrant q = j mod 4: odd quadrants swap sin and cos, q in {2, 3}
+    // negates sin, q in {1, 2} negates cos.
+    __m256d q = _mm256_fnmadd_pd(_mm256_floor_pd(_mm256_mul_pd(j, _mm256_set1_pd(0.25))),
+                                 _mm256_set1_pd(4.0), j);
+    __m256d odd = _mm256_cmp_pd(_mm256_fnmadd_pd(_mm256_floor_pd(_mm256_mul_pd(q, _mm256_set1_pd(0.5))),
+                                                 _mm256_set1_pd(2.0), q),
+                                _mm256_set1_pd(1.0), _CMP_EQ_OQ);
+    __m256d upper = _mm256_cmp_pd(q, _mm256_set1_pd(2.0), _CMP_GE_OQ);
+    __m256d signBit = _mm256_set1_pd(-0.0);
+
+    __m256d sinv = _mm256_blendv_pd(s, c, odd);
+    __m256d cosv = _mm256_blendv_pd(c, s, odd);
+    *sinOut = _mm256_xor_pd(sinv, _mm256_and_pd(upper, signBit));
+    *cosOut = _mm256_xor_pd(cosv, _mm256_and_pd(_mm256_xor_pd(odd, upper), signBit));
+}
+
+__attribute__((target("avx2,fma"))) void
+PropagateAvx2(const SatelliteOrbitPropagator::Elements& e,
+              const SatelliteOrbitPropagator::State& s,
+              uint32_t begin,
+              uint32_t end,
+              double t)
+{
+    const __m256d vt = _mm256_set1_pd(t);
+    uint32_t i = begin;
+    for (; i + 4 <= end; i += 4)
+    {
+        __m256d angle = _mm256_fmadd_pd(_mm256_loadu_pd(e.angularVelocity + i), vt,
+                                        _mm256_loadu_pd(e.initialAngle + i));
+        __m256d sinAngle;
+        __m256d cosAngle;
+        SinCosAvx2(angle, &sinAngle, &cosAngle);
+
+        __m256d radius = _mm256_loadu_pd(e.radius + i);
+        __m256d speed = _mm256_loadu_pd(e.speed + i);
+        __m256d cosInc = _mm256_loadu_pd(e.cosInclination + i);
+        __m256d sinInc = _mm256_loadu_pd(e.sinInclination + i);
+        __m256d cosRaan = _mm256_loadu_pd(e.cosRaan + i);
+        __m256d sinRaan = _mm256_loadu_pd(e.sinRaan + i);
+
+        __m256d xo = _mm256_mul_pd(radius, cosAngle);
+        __m256d yo = _mm256_mul_pd(radius, sinAngle);
+        __m256d vxo = _mm256_mul_pd(_mm256_sub_pd(_mm256_setzero_pd(), speed), sinAngle);
+        __m256d vyo = _mm256_mul_pd(speed, cosAngle);
+        __m256d yoInc = _mm256_mul_pd(yo, cosInc);
+        __m256d vyoInc = _mm256_mul_pd(vyo, cosInc);
+
+        _mm256_storeu_pd(s.x + i, _mm256_fmsub_pd(xo, cosRaan, _mm256_mul_pd(yoInc, sinRaan)));
+        _mm256_storeu_pd(s.y + i, _mm256_fmadd_pd(xo, sinRaan, _mm256_mul_pd(yoInc, cosRaan)));
+        _mm256_storeu_pd(s.z + i, _mm256_mul_pd(yo, sinInc));
+        _mm256_storeu_pd(s.vx + i, _mm256_fmsub_pd(vxo, cosRaan, _mm256_mul_pd(vyoInc, sinRaan)));
+        _mm256_storeu_pd(s.vy + i, _mm256_fmadd_pd(vxo, sinRaan, _mm256_mul_pd(vyoInc, cosRaan)));
+        _mm256_storeu_pd(s.vz + i, _mm256_mul_pd(vyo, sinInc));
+    }
+    PropagateScalar(e, s, i, end, t);
+}
+
+// Full-mask form with an explicit source: the plain _mm512_roundscale_pd
+// draws -Wmaybe-uninitialized from some GCC headers.
+template <int Mode>
+__attribute__((target("avx512f"))) inline __m512d
+RoundAvx512(__m512d x)
+{
+    return _mm512_mask_roundscale_pd(x, 0xff, x, Mode | _MM_FROUND_NO_EXC);
+}
+
+__attribute__((target("avx512f"))) inline void
+SinCosAvx512(__m512d x, __m512d* sinOut, __m512d* cosOut)
+{
+    __m512d j = RoundAvx512<_MM_FROUND_TO_NEAREST_INT>(_mm512_mul_pd(x, _mm512_set1_pd(TWO_OVER_PI)));
+    __m512d r = _mm512_fnmadd_pd(j, _mm512_set1_pd(PIO2_1), x);
+    r = _mm512_fnmadd_pd(j, _mm512_set1_pd(PIO2_2), r);
+    r = _mm512_fnmadd_pd(j, _mm512_set1_pd(PIO2_3), r);
+    __m512d zz = _mm512_mul_pd(r, r);
+
+    __m512d ps = _mm512_set1_pd(SIN_C0);
+    ps = _mm512_fmadd_pd(ps, zz, _mm512_set1_pd(SIN_C1));
+    ps = _mm512_fmadd_pd(ps, zz, _mm512_set1_pd(SIN_C2));
+    ps = _mm512_fmadd_pd(ps, zz, _mm512_set1_pd(SIN_C3));
+    ps = _mm512_fmadd_pd(ps, zz, _mm512_set1_pd(SIN_C4));
+    ps = _mm512_fmadd_pd(ps, zz, _mm512_set1_pd(SIN_C5));
+    __m512d s = _mm512_fmadd_pd(_mm512_mul_pd(r, zz), ps, r);
+
+    __m512d pc = _mm512_set1_pd(COS_C0);
+    pc = _mm512_fmadd_pd(pc, zz, _mm512_set1_pd(COS_C1));
+    pc = _mm512_fmadd_pd(pc, zz, _mm512_set1_pd(COS_C2));
+    pc = _mm512_fmadd_pd(pc, zz, _mm512_set1_pd(COS_C3));
+    pc = _mm512_fmadd_pd(pc, zz, _mm512_set1_pd(COS_C4));
+    pc = _mm512_fmadd_pd(pc, zz, _mm512_set1_pd(COS_C5));
+    __m512d c = _mm512_fmadd_pd(_mm512_mul_pd(zz, zz), pc,
+                                _mm512_fnmadd_pd(_mm512_set1_pd(0.5), zz, _mm512_set1_pd(1.0)));
+
+    __m512d q = _mm512_fnmadd_pd(RoundAvx512<_MM_FROUND_TO_NEG_INF>(_mm512_mul_pd(j, _mm512_set1_pd(0.25))),
+                                 _mm512_set1_pd(4.0), j);
+    __m512d half = RoundAvx512<_MM_FROUND_TO_NEG_INF>(_mm512_mul_pd(q, _mm512_set1_pd(0.5)));
+    __mmask8 odd = _mm512_cmp_pd_mask(_mm512_fnmadd_pd(half, _mm512_set1_pd(2.0), q),
+                                      _mm512_set1_pd(1.0), _CMP_EQ_OQ);
+    __mmask8 upper = _mm512_cmp_pd_mask(q, _mm512_set1_pd(2.0), _CMP_GE_OQ);
+    __m512d zero = _mm512_setzero_pd();
+
+    __m512d sinv = _mm512_mask_blend_pd(odd, s, c);
+    __m512d cosv = _mm512_mask_blend_pd(odd, c, s);
+    *sinOut = _mm512_mask_sub_pd(sinv, upper, zero, sinv);
+    *cosOut = _mm512_mask_sub_pd(cosv, odd ^ upper, zero, cosv);
+}
+
+__attribute__((target("avx512f"))) void
+PropagateAvx512(const SatelliteOrbitPropagator::Elements& e,
+                const SatelliteOrbitPropagator::State& s,
+                uint32_t begin,
+                uint32_t end,
+                double t)
+{
+    const __m512d vt = _mm512_set1_pd(t);
+    uint32_t i = begin;
+    for (; i + 8 <= end; i += 8)
+    {
+        __m512d angle = _mm512_fmadd_pd(_mm512_loadu_pd(e.angularVelocity + i), vt,
+                                        _mm512_loadu_pd(e.initialAngle + i));
+        __m512d sinAngle;
+        __m512d cosAngle;
+        SinCosAvx512(angle, &sinAngle, &cosAngle);
+
+        __m512d radius = _mm512_loadu_pd(e.radius + i);
+        __m512d speed = _mm512_loadu_pd(e.speed + i);
+        __m512d cosInc = _mm512_loadu_pd(e.cosInclination + i);
+        __m512d sinInc = _mm512_loadu_pd(e.sinInclination + i);
+        __m512d cosRaan = _mm512_loadu_pd(e.cosRaan + i);
+        __m512d sinRaan = _mm512_loadu_pd(e.sinRaan + i);
+
+        __m512d xo = _mm512_mul_pd(radius, cosAngle);
+        __m512d yo = _mm512_mul_pd(radius, sinAngle);
+        __m512d vxo = _mm512_mul_pd(_mm512_sub_pd(_mm512_setzero_pd(), speed), sinAngle);
+        __m512d vyo = _mm512_mul_pd(speed, cosAngle);
+        __m512d yoInc = _mm512_mul_pd(yo, cosInc);
+        __m512d vyoInc = _mm512_mul_pd(vyo, cosInc);
+
+        _mm512_storeu_pd(s.x + i, _mm512_fmsub_pd(xo, cosRaan, _mm512_mul_pd(yoInc, sinRaan)));
+        _mm512_storeu_pd(s.y + i, _mm512_fmadd_pd(xo, sinRaan, _mm512_mul_pd(yoInc, cosRaan)));
+        _mm512_storeu_pd(s.z + i, _mm512_mul_pd(yo, sinInc));
+        _mm512_storeu_pd(s.vx + i, _mm512_fmsub_pd(vxo, cosRaan, _mm512_mul_pd(vyoInc, sinRaan)));
+        _mm512_storeu_pd(s.vy + i, _mm512_fmadd_pd(vxo, sinRaan, _mm512_mul_pd(vyoInc, cosRaan)));
+        _mm512_storeu_pd(s.vz + i, _mm512_mul_pd(vyo, sinInc));
+    }
+    PropagateScalar(e, s, i, end, t);
+}
+
+#endif /* SATELLITE_PROPAGATOR_X86 */
+
+SatelliteOrbitPropagator::Kernel
+DetectKernel()
+{
+    if (SatelliteOrbitPropagator::IsSupported(SatelliteOrbitPropagator::AVX512))
+    {
+        return SatelliteOrbitPropagator::AVX512;
+    }
+    if (SatelliteOrbitPropagator::IsSupported(SatelliteOrbitPropagator::AVX2))
+    {
+        return SatelliteOrbitPropagator::AVX2;
+    }
+    return SatelliteOrbitPropagator::SCALAR;
+}
+
+} // namespace
+
+void
+SatelliteOrbitPropagator::Propagate(const Elements& elements,
+                                    const State& state,
+                                    uint32_t begin,
+                                    uint32_t end,
+                                    double t)
+{
+    Propagate(GetKernel(), elements, state, begin, end, t);
+}
+
+void
+SatelliteOrbitPropagator::Propagate(Kernel kernel,
+                                    const Elements& elements,
+                                    const State& state,
+                                    uint32_t begin,
+                                    uint32_t end,
+                                    double t)
+{
+    switch (kernel)
+    {
+#ifdef SATELLITE_PROPAGATOR_X86
+    case AVX512:
+        PropagateAvx512(elements, state, begin, end, t);
+        break;
+    case AVX2:
+        PropagateAvx2(elements, state, begin, end, t);
+        break;
+#endif
+    case AUTO:
+        Propagate(GetKernel(), elements, state, begin, end, t);
+        break;
+    default:
+        PropagateScalar(elements, state, begin, end, t);
+        break;
+    }
+}
+
+void
+SatelliteOrbitPropagator::SetKernel(Kernel kernel)
+{
+    g_kernel = IsSupported(kernel) ? kernel : SCALAR;
+    g_kernelSelected = true;
+}
+
+SatelliteOrbitPropagator::Kernel
+SatelliteOrbitPropagator::GetKernel()
+{
+    if (!g_kernelSelected)
+    {
+        EnumValue<Kernel> kernel;
+        g_orbitKernel.GetValue(kernel);
+        SetKernel(kernel.Get());
+    }
+    if (g_kernel == AUTO)
+    {
+        g_kernel = DetectKernel();
+    }
+    return g_kernel;
+}
+
+bool
+SatelliteOrbitPropagator::IsSupported(Kernel kernel)
+{
+    switch (kernel)
+    {
+    case AUTO:
+    case SCALAR:
+        return true;
+#ifdef SATELLITE_PROPAGATOR_X86
+    case AVX2:
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    case AVX512:
+        return __builtin_cpu_supports("avx512f");
+#endif
+    default:
+        return false;
+    }
+}
+
+std::string
+SatelliteOrbitPropagator::GetKernelName(Kernel kernel)
+{
+    switch (kernel)
+    {
+    case AUTO:
+        return "auto";
+    case SCALAR:
+        return "scalar";
+    case AVX2:
+        return "avx2";
+    case AVX512:
+        return "avx512";
+    }
+    return "unknown";
+}
+
+} // namespace ns3
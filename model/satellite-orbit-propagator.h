@@ -0,0 +1,111 @@
+#ifndef SATELLITE_ORBIT_PROPAGATOR_H
+#define SATELLITE_ORBIT_PROPAGATOR_H
+
+#include <cstdint>
+#include <string>
+
+namespace ns3 {
+
+/**
+ * @ingroup satellite
+ * @brief Batch propagator for circular orbits stored as structure-of-arrays.
+ *
+ * Propagates positions and velocities of many satellites for one time. Besides
+ * the scalar reference kernel there are AVX2/FMA and AVX-512 kernels that
+ * evaluate the sin/cos of the orbital angle with a vector polynomial.
+ *
+ * Propagate() uses the best kernel the CPU supports, unless the
+ * SatelliteOrbitKernel global value or SetKernel() selects another one. The
+ * vector kernels agree with the scalar kernel to within a few ulp but are not
+ * bit-identical, so single satellite queries, which mobility models answer,
+ * always use the scalar kernel; only batch consumers see the difference.
+ */
+class SatelliteOrbitPropagator
+{
+public:
+    /// Orbital elements, by satellite. Angles in radians.
+    struct Elements
+    {
+        const double* radius;
+        const double* speed;
+        const double* angularVelocity;
+        const double* initialAngle;
+        const double* cosInclination;
+        const double* sinInclination;
+        const double* cosRaan;
+        const double* sinRaan;
+    };
+
+    /// Propagated state, by satellite.
+    struct State
+    {
+        double* x;
+        double* y;
+        double* z;
+        double* vx;
+        double* vy;
+        double* vz;
+    };
+
+    /// Available propagation kernels.
+    enum Kernel
+    {
+        AUTO,   //!< Best kernel supported by the CPU, detected on first use
+        SCALAR, //!< Portable scalar code, bit-identical to the single satellite path
+        AVX2,   //!< 4-wide AVX2 + FMA
+        AVX512  //!< 8-wide AVX-512F
+    };
+
+    /**
+     * @brief Propagate satellites [begin, end) to time t with the selected kernel.
+     * @param elements Orbital elements.
+     * @param state Output state.
+     * @param begin First satellite.
+     * @param end One past the last satellite.
+     * @param t Time in seconds.
+     */
+    static void Propagate(const Elements& elements, const State& state, uint32_t begin, uint32_t end, double t);
+
+    /**
+     * @brief Propagate satellites [begin, end) to time t with a specific kernel.
+     *
+     * The kernel must be supported, see IsSupported().
+     */
+    static void Propagate(Kernel kernel,
+                          const Elements& elements,
+                          const State& state,
+                          uint32_t begin,
+                          uint32_t end,
+                          double t);
+
+    /**
+     * @brief Select the kernel used by Propagate(), overriding the
+     *        SatelliteOrbitKernel global value.
+     *
+     * AUTO selects the best kernel the CPU supports; an unsupported kernel
+     * falls back to SCALAR.
+     * @param kernel The kernel.
+     */
+    static void SetKernel(Kernel kernel);
+
+    /**
+     * @return The kernel Propagate() uses, never AUTO.
+     */
+    static Kernel GetKernel();
+
+    /**
+     * @param kernel A kernel.
+     * @return Whether the kernel was compiled in and the CPU supports it.
+     */
+    static bool IsSupported(Kernel kernel);
+
+    /**
+     * @param kernel A kernel.
+     * @return A printable kernel name.
+     */
+    static std::string GetKernelName(Kernel kernel);
+};
+
+} // namespace ns3
+
+#endif /* SATELLITE_ORBIT_PROPAGATOR_H */
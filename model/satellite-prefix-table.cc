@@ -0,0 +1,105 @@
+#include "satellite-prefix-table.h"
+
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE("SatellitePrefixTable");
+
+namespace {
+    constexpr uint32_t STRIDE = 8;
+    constexpr uint32_t BLOCK_SIZE = 1u << STRIDE;
+}
+
+SatellitePrefixTable::SatellitePrefixTable()
+    : m_entries(BLOCK_SIZE, Entry{0, 0, 0})
+{
+}
+
+void
+SatellitePrefixTable::Insert(Ipv4Address prefix, uint8_t length, Ptr<Node> node)
+{
+    NS_ASSERT_MSG(length <= 32, "Prefix length " << +length << " out of range.");
+    m_nodes.push_back(node);
+    uint32_t value = m_nodes.size();
+    uint32_t key = length ? prefix.Get() & (0xffffffffu << (32 - length)) : 0;
+
+    uint32_t block = 0;
+    for (uint32_t end = STRIDE;; end += STRIDE)
+    {
+        uint32_t byte = (key >> (32 - end)) & (BLOCK_SIZE - 1);
+        if (length <= end)
+        {
+            // The prefix ends within this byte and covers a run of entries
+            uint32_t count = 1u << (end - length);
+            Fill(block, byte & ~(count - 1), count, value, length);
+            return;
+        }
+
+        uint32_t index = block * BLOCK_SIZE + byte;
+        if (!m_entries[index].child)
+        {
+            // The new block starts out with the prefix covering its parent entry
+            Entry inherited{0, m_entries[index].value, m_entries[index].length};
+            uint32_t child = m_entries.size() / BLOCK_SIZE;
+            m_entries.resize(m_entries.size() + BLOCK_SIZE, inherited);
+            m_entries[index].child = child;
+        }
+        block = m_entries[index].child;
+    }
+}
+
+void
+SatellitePrefixTable::Fill(uint32_t block, uint32_t first, uint32_t count, uint32_t value, uint8_t length)
+{
+    for (uint32_t i = block * BLOCK_SIZE + first; i < block * BLOCK_SIZE + first + count; ++i)
+    {
+        // Longer prefixes below keep their entries
+        if (m_entries[i].child)
+        {
+            Fill(m_entries[i].child, 0, BLOCK_SIZE, value, length);
+        }
+        if (m_entries[i].length <= length)
+        {
+            m_entries[i].value = value;
+            m_entries[i].length = length;
+        }
+    }
+}
+
+Ptr<Node>
+SatellitePrefixTable::Find(Ipv4Address address) const
+{
+    uint32_t key = address.Get();
+    uint32_t block = 0;
+    for (uint32_t end = STRIDE;; end += STRIDE)
+    {
+        const Entry& entry = m_entries[block * BLOCK_SIZE + ((key >> (32 - end)) & (BLOCK_SIZE - 1))];
+        if (!entry.child)
+        {
+            return entry.value ? m_nodes[entry.value - 1] : nullptr;
+        }
+        block = entry.child;
+    }
+}
+
+void
+SatellitePrefixTable::Clear()
+{
+    m_entries.assign(BLOCK_SIZE, Entry{0, 0, 0});
+    m_nodes.clear();
+}
+
+uint32_t
+SatellitePrefixTable::GetSize() const
+{
+    return m_nodes.size();
+}
+
+uint32_t
+SatellitePrefixTable::GetNBlocks() const
+{
+    return m_entries.size() / BLOCK_SIZE;
+}
+
+} // namespace ns3
@@ -0,0 +1,74 @@
+#ifndef SATELLITE_PREFIX_TABLE_H
+#define SATELLITE_PREFIX_TABLE_H
+
+#include "ns3/ipv4-address.h"
+#include "ns3/node.h"
+#include <cstdint>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * @ingroup satellite
+ * @brief Longest prefix match from Ipv4Address to Node.
+ *
+ * A multibit trie with a stride of 8 bits: every trie node is a block of 256
+ * entries, one per value of the next address byte, so a lookup reads at most
+ * four entries. Prefixes whose length is not a multiple of 8 are expanded
+ * over the entries they cover, and every entry carries the longest prefix
+ * covering it, so the lookup keeps no backtracking state.
+ *
+ * With hierarchical addresses (SatelliteAddressHelper) one prefix per
+ * satellite covers all of its interfaces.
+ */
+class SatellitePrefixTable
+{
+public:
+    SatellitePrefixTable();
+
+    /**
+     * @brief Insert or overwrite a prefix.
+     * @param prefix The prefix; bits beyond the length are ignored.
+     * @param length The prefix length, 0 to 32.
+     * @param node The node the prefix belongs to.
+     */
+    void Insert(Ipv4Address prefix, uint8_t length, Ptr<Node> node);
+
+    /**
+     * @param address The address.
+     * @return The node of the longest prefix covering the address, or nullptr.
+     */
+    Ptr<Node> Find(Ipv4Address address) const;
+
+    /**
+     * @brief Remove every prefix.
+     */
+    void Clear();
+
+    /**
+     * @return The number of inserted prefixes.
+     */
+    uint32_t GetSize() const;
+
+    /**
+     * @return The number of 256-entry blocks of the trie, root included.
+     */
+    uint32_t GetNBlocks() const;
+
+private:
+    void Fill(uint32_t block, uint32_t first, uint32_t count, uint32_t value, uint8_t length);
+
+    struct Entry
+    {
+        uint32_t child;  //!< Block of the next byte, 0 for none (block 0 is the root)
+        uint32_t value;  //!< Index into m_nodes plus one, 0 for no prefix
+        uint8_t length;  //!< Length of the prefix the value comes from
+    };
+
+    std::vector<Entry> m_entries; //!< Blocks of 256 entries
+    std::vector<Ptr<Node>> m_nodes;
+};
+
+} // namespace ns3
+
+#endif /* SATELLITE_PREFIX_TABLE_H */
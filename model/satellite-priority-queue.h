@@ -0,0 +1,293 @@
+#ifndef SATELLITE_PRIORITY_QUEUE_H
+#define SATELLITE_PRIORITY_QUEUE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace ns3 {
+
+/*
+ * Priority queue policies for the shortest path searches of the route engine.
+ *
+ * Every policy queues vertices by key and offers the same small interface:
+ *
+ *   Key                 key type, double or integer
+ *   INFINITE_KEY        key of an unreachable vertex; edges with this weight are skipped
+ *   Reset(n, maxEdge)   empty the queue for a graph of n vertices
+ *   Empty()             whether no vertex is queued
+ *   Update(v, key)      insert v, or lower its key if it is queued
+ *   Pop(key)            remove and return a vertex with the smallest key
+ *
+ * Keys passed to Update() must never be smaller than the last popped key, which
+ * holds for Dijkstra with non-negative weights. The members are defined here so
+ * that they inline into the search loop. The binary heap policy needs no class
+ * of its own: it is the std::push_heap loop of ComputeShortestPathFirstHops().
+ */
+
+/**
+ * @ingroup satellite
+ * @brief Radix heap over 64-bit integer keys.
+ *
+ * Bucket i holds the vertices whose key first differs from the last popped key
+ * in bit i - 1. Pop() only scans and redistributes the lowest non-empty bucket,
+ * so a vertex moves down at most 64 times in total, and every queued vertex
+ * knows its bucket slot, so a key decrease moves it instead of leaving a stale
+ * entry behind.
+ */
+class SatelliteRadixHeap
+{
+public:
+    typedef uint64_t Key;
+    static constexpr Key INFINITE_KEY = std::numeric_limits<uint64_t>::max();
+
+    void Reset(uint32_t numVertices, Key /* maxEdge */)
+    {
+        for (auto& bucket : m_bucket)
+        {
+            bucket.clear();
+        }
+        m_key.assign(numVertices, INFINITE_KEY);
+        m_where.assign(numVertices, NOT_QUEUED);
+        m_last = 0;
+        m_size = 0;
+    }
+
+    bool Empty() const
+    {
+        return m_size == 0;
+    }
+
+    void Update(uint32_t v, Key key)
+    {
+        if (m_where[v] != NOT_QUEUED)
+        {
+            Unlink(v);
+        }
+        else
+        {
+            ++m_size;
+        }
+        m_key[v] = key;
+        Link(v);
+    }
+
+    uint32_t Pop(Key& key)
+    {
+        if (m_bucket[0].empty())
+        {
+            uint32_t i = 1;
+            while (m_bucket[i].empty())
+            {
+                ++i;
+            }
+            // The new minimum becomes the reference; everything in bucket i
+            // lands in a lower bucket relative to it.
+            Key minKey = INFINITE_KEY;
+            for (uint32_t v : m_bucket[i])
+            {
+                minKey = std::min(minKey, m_key[v]);
+            }
+            m_last = minKey;
+            m_scratch.clear();
+            m_scratch.swap(m_bucket[i]);
+            for (uint32_t v : m_scratch)
+            {
+                Link(v);
+            }
+        }
+        uint32_t v = m_bucket[0].back();
+        m_bucket[0].pop_back();
+        m_where[v] = NOT_QUEUED;
+        --m_size;
+        key = m_key[v];
+        return v;
+    }
+
+private:
+    static constexpr uint64_t NOT_QUEUED = std::numeric_limits<uint64_t>::max();
+
+    uint32_t BucketOf(Key key) const
+    {
+        Key diff = key ^ m_last;
+        return diff ? 64 - __builtin_clzll(diff) : 0;
+    }
+
+    void Link(uint32_t v)
+    {
+        uint32_t b = BucketOf(m_key[v]);
+        m_where[v] = (static_cast<uint64_t>(b) << 32) | m_bucket[b].size();
+        m_bucket[b].push_back(v);
+    }
+
+    void Unlink(uint32_t v)
+    {
+        auto& bucket = m_bucket[m_where[v] >> 32];
+        uint32_t slot = m_where[v] & 0xffffffff;
+        uint32_t last = bucket.back();
+        bucket[slot] = last;
+        m_where[last] = (m_where[v] & ~0xffffffffULL) | slot;
+        bucket.pop_back();
+    }
+
+    std::vector<uint32_t> m_bucket[65];
+    std::vector<uint32_t> m_scratch; //!< Spare storage swapped in for a drained bucket
+    std::vector<Key> m_key;          //!< Current key, by vertex
+    std::vector<uint64_t> m_where;   //!< Bucket << 32 | slot, by vertex
+    Key m_last;                      //!< Last popped key
+    uint32_t m_size;
+};
+
+/**
+ * @ingroup satellite
+ * @brief Dial's bucket queue over integer keys, as a circular array of buckets.
+ *
+ * With Dijkstra all queued keys lie within one maximum edge weight of the last
+ * popped key, so that many buckets suffice. To bound memory, keys are grouped
+ * into buckets of 2^shift units, with the shift chosen so that at most
+ * SetMaxBuckets() buckets are used. Within a bucket vertices come out in no
+ * particular order, so a vertex may be popped before its key is final. The
+ * search loop is label-correcting: a later improvement queues the vertex
+ * again, into the current or a later bucket, and it is scanned once more.
+ * Distances therefore stay exact; coarser buckets only cost repeated scans.
+ *
+ * Link delays are large compared to the number of satellites, so most buckets
+ * are empty; an occupancy bitmap lets Pop() skip 64 of them per word.
+ */
+class SatelliteDialQueue
+{
+public:
+    typedef uint64_t Key;
+    static constexpr Key INFINITE_KEY = std::numeric_limits<uint64_t>::max();
+
+    SatelliteDialQueue()
+        : m_maxBuckets(1 << 16),
+          m_shift(0),
+          m_cursor(0),
+          m_size(0)
+    {
+    }
+
+    /**
+     * @param maxBuckets Upper bound on the number of buckets.
+     */
+    void SetMaxBuckets(uint32_t maxBuckets)
+    {
+        m_maxBuckets = std::max(2u, maxBuckets);
+    }
+
+    /**
+     * @return The key width of one bucket is 2^shift.
+     */
+    uint32_t GetShift() const
+    {
+        return m_shift;
+    }
+
+    void Reset(uint32_t numVertices, Key maxEdge)
+    {
+        m_shift = 0;
+        while ((maxEdge >> m_shift) + 2 > m_maxBuckets)
+        {
+            ++m_shift;
+        }
+        uint32_t numBuckets = (maxEdge >> m_shift) + 2;
+        if (m_bucket.size() != numBuckets)
+        {
+            m_bucket.assign(numBuckets, std::vector<uint32_t>());
+            m_occupied.assign((numBuckets + 63) / 64, 0);
+        }
+        else if (m_size)
+        {
+            for (auto& bucket : m_bucket)
+            {
+                bucket.clear();
+            }
+            std::fill(m_occupied.begin(), m_occupied.end(), 0);
+        }
+        m_key.assign(numVertices, INFINITE_KEY);
+        m_where.assign(numVertices, NOT_QUEUED);
+        m_cursor = 0;
+        m_size = 0;
+    }
+
+    bool Empty() const
+    {
+        return m_size == 0;
+    }
+
+    void Update(uint32_t v, Key key)
+    {
+        if (m_where[v] != NOT_QUEUED)
+        {
+            Unlink(v);
+        }
+        else
+        {
+            ++m_size;
+        }
+        m_key[v] = key;
+        uint32_t b = (key >> m_shift) % m_bucket.size();
+        m_where[v] = (static_cast<uint64_t>(b) << 32) | m_bucket[b].size();
+        m_bucket[b].push_back(v);
+        m_occupied[b / 64] |= 1ULL << (b % 64);
+    }
+
+    uint32_t Pop(Key& key)
+    {
+        if (m_bucket[m_cursor].empty())
+        {
+            // Next occupied bucket at or after the cursor, wrapping around
+            uint32_t word = m_cursor / 64;
+            uint64_t bits = m_occupied[word] & (~0ULL << (m_cursor % 64));
+            while (!bits)
+            {
+                word = (word + 1 == m_occupied.size()) ? 0 : word + 1;
+                bits = m_occupied[word];
+            }
+            m_cursor = word * 64 + __builtin_ctzll(bits);
+        }
+        uint32_t v = m_bucket[m_cursor].back();
+        m_bucket[m_cursor].pop_back();
+        if (m_bucket[m_cursor].empty())
+        {
+            m_occupied[m_cursor / 64] &= ~(1ULL << (m_cursor % 64));
+        }
+        m_where[v] = NOT_QUEUED;
+        --m_size;
+        key = m_key[v];
+        return v;
+    }
+
+private:
+    static constexpr uint64_t NOT_QUEUED = std::numeric_limits<uint64_t>::max();
+
+    void Unlink(uint32_t v)
+    {
+        uint32_t b = m_where[v] >> 32;
+        auto& bucket = m_bucket[b];
+        uint32_t slot = m_where[v] & 0xffffffff;
+        uint32_t last = bucket.back();
+        bucket[slot] = last;
+        m_where[last] = (m_where[v] & ~0xffffffffULL) | slot;
+        bucket.pop_back();
+        if (bucket.empty())
+        {
+            m_occupied[b / 64] &= ~(1ULL << (b % 64));
+        }
+    }
+
+    std::vector<std::vector<uint32_t>> m_bucket;
+    std::vector<uint64_t> m_occupied; //!< One bit per bucket, set if it is not empty
+    std::vector<Key> m_key;        //!< Current key, by vertex
+    std::vector<uint64_t> m_where; //!< Bucket << 32 | slot, by vertex
+    uint32_t m_maxBuckets;
+    uint32_t m_shift;
+    uint32_t m_cursor;             //!< Bucket of the last popped key
+    uint32_t m_size;
+};
+
+} // namespace ns3
+
+#endif /* SATELLITE_PRIORITY_QUEUE_H */
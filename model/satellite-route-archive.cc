@@ -0,0 +1,280 @@
+#include "satellite-route-archive.h"
+#include "ns3/log.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE("SatelliteRouteArchive");
+
+namespace {
+
+const char ARCHIVE_MAGIC[8] = {'S', 'A', 'T', 'R', 'O', 'U', 'T', 'E'};
+
+size_t
+RoundUp(size_t n, size_t alignment)
+{
+    return (n + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+SatelliteRouteArchive::SatelliteRouteArchive()
+    : m_base(nullptr),
+      m_size(0),
+      m_header(),
+      m_tables(nullptr),
+      m_epochTable(nullptr),
+      m_tableSize(0),
+      m_numSatellites(0)
+{
+}
+
+SatelliteRouteArchive::~SatelliteRouteArchive()
+{
+    Close();
+}
+
+size_t
+SatelliteRouteArchive::GetTableSize(uint32_t numSatellites, uint32_t numGroundStations)
+{
+    size_t slots = RoundUp(static_cast<size_t>(numSatellites) * numSatellites, sizeof(uint32_t));
+    return RoundUp(slots + sizeof(uint32_t) * numGroundStations, sizeof(uint64_t));
+}
+
+size_t
+SatelliteRouteArchive::GetTablesOffset()
+{
+    return RoundUp(sizeof(SatelliteRouteArchiveHeader), 64);
+}
+
+bool
+SatelliteRouteArchive::Open(const std::string& path)
+{
+    Close();
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        NS_LOG_WARN("Cannot open route archive " << path << ": " << std::strerror(errno));
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < GetTablesOffset())
+    {
+        NS_LOG_WARN("Route archive " << path << " is truncated.");
+        close(fd);
+        return false;
+    }
+    size_t size = st.st_size;
+    void* base = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // The mapping keeps the file open
+    if (base == MAP_FAILED)
+    {
+        NS_LOG_WARN("Cannot map route archive " << path << ": " << std::strerror(errno));
+        return false;
+    }
+
+    SatelliteRouteArchiveHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    size_t tableSize = GetTableSize(header.numSatellites, header.numGroundStations);
+    size_t expected = GetTablesOffset() + tableSize * header.numTables + sizeof(uint32_t) * header.numEpochs;
+    if (std::memcmp(header.magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) != 0 || header.version != VERSION ||
+        header.interval <= 0 || size != expected)
+    {
+        NS_LOG_WARN("Route archive " << path << " is not a version " << VERSION << " archive or is damaged.");
+        munmap(base, size);
+        return false;
+    }
+
+    m_base = static_cast<const uint8_t*>(base);
+    m_size = size;
+    m_header = header;
+    m_tables = m_base + GetTablesOffset();
+    m_epochTable = reinterpret_cast<const uint32_t*>(m_tables + tableSize * header.numTables);
+    m_tableSize = tableSize;
+    m_numSatellites = header.numSatellites;
+    NS_LOG_INFO("Mapped route archive " << path << ": " << header.numEpochs << " epochs, "
+                << header.numTables << " tables, " << size << " bytes");
+    return true;
+}
+
+void
+SatelliteRouteArchive::Close()
+{
+    if (m_base)
+    {
+        munmap(const_cast<uint8_t*>(m_base), m_size);
+    }
+    m_base = nullptr;
+    m_size = 0;
+    m_header = SatelliteRouteArchiveHeader();
+    m_tables = nullptr;
+    m_epochTable = nullptr;
+    m_tableSize = 0;
+    m_numSatellites = 0;
+}
+
+bool
+SatelliteRouteArchive::IsOpen() const
+{
+    return m_base != nullptr;
+}
+
+uint32_t
+SatelliteRouteArchive::GetNSatellites() const
+{
+    return m_header.numSatellites;
+}
+
+uint32_t
+SatelliteRouteArchive::GetNGroundStations() const
+{
+    return m_header.numGroundStations;
+}
+
+uint32_t
+SatelliteRouteArchive::GetNTables() const
+{
+    return m_header.numTables;
+}
+
+uint64_t
+SatelliteRouteArchive::GetNEpochs() const
+{
+    return m_header.numEpochs;
+}
+
+Time
+SatelliteRouteArchive::GetStart() const
+{
+    return NanoSeconds(m_header.start);
+}
+
+Time
+SatelliteRouteArchive::GetInterval() const
+{
+    return NanoSeconds(m_header.interval);
+}
+
+uint64_t
+SatelliteRouteArchive::GetFingerprint() const
+{
+    return m_header.fingerprint;
+}
+
+uint64_t
+SatelliteRouteArchive::FindEpoch(Time t) const
+{
+    int64_t offset = t.GetNanoSeconds() - m_header.start;
+    if (!m_base || offset < 0)
+    {
+        return INVALID_EPOCH;
+    }
+    uint64_t epoch = offset / m_header.interval;
+    return (epoch < m_header.numEpochs) ? epoch : INVALID_EPOCH;
+}
+
+uint32_t
+SatelliteRouteArchive::GetTable(uint64_t epoch) const
+{
+    NS_ASSERT_MSG(epoch < m_header.numEpochs, "Archive epoch " << epoch << " out of range.");
+    uint32_t table = m_epochTable[epoch];
+    NS_ASSERT_MSG(table < m_header.numTables, "Archive epoch " << epoch << " refers to a missing table.");
+    return table;
+}
+
+uint32_t
+SatelliteRouteArchive::GetEgress(uint32_t table, uint32_t groundStation) const
+{
+    NS_ASSERT_MSG(groundStation < m_header.numGroundStations, "Ground station index " << groundStation << " out of range.");
+    const uint8_t* egress = m_tables + static_cast<size_t>(table) * m_tableSize +
+                            RoundUp(static_cast<size_t>(m_numSatellites) * m_numSatellites, sizeof(uint32_t));
+    return reinterpret_cast<const uint32_t*>(egress)[groundStation];
+}
+
+SatelliteRouteArchiveWriter::SatelliteRouteArchiveWriter()
+    : m_header()
+{
+}
+
+bool
+SatelliteRouteArchiveWriter::Open(const std::string& path,
+                                  uint32_t numSatellites,
+                                  uint32_t numGroundStations,
+                                  Time start,
+                                  Time interval,
+                                  uint64_t fingerprint)
+{
+    NS_ASSERT_MSG(interval.IsStrictlyPositive(), "Archive epochs must have a positive length.");
+    m_file.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_file)
+    {
+        NS_LOG_WARN("Cannot create route archive " << path);
+        return false;
+    }
+
+    m_header = SatelliteRouteArchiveHeader();
+    std::memcpy(m_header.magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+    m_header.version = SatelliteRouteArchive::VERSION;
+    m_header.numSatellites = numSatellites;
+    m_header.numGroundStations = numGroundStations;
+    m_header.start = start.GetNanoSeconds();
+    m_header.interval = interval.GetNanoSeconds();
+    m_header.fingerprint = fingerprint;
+    m_table.clear();
+    m_epochTable.clear();
+
+    // Provisional header; the counts are only known in Close()
+    std::vector<char> head(SatelliteRouteArchive::GetTablesOffset(), 0);
+    m_file.write(head.data(), head.size());
+    return static_cast<bool>(m_file);
+}
+
+void
+SatelliteRouteArchiveWriter::AddEpoch(const uint8_t* slots, const uint32_t* egress)
+{
+    NS_ASSERT_MSG(m_file.is_open(), "Route archive writer is not open.");
+    size_t numSlots = static_cast<size_t>(m_header.numSatellites) * m_header.numSatellites;
+    std::vector<uint8_t> table(SatelliteRouteArchive::GetTableSize(m_header.numSatellites, m_header.numGroundStations), 0);
+    std::memcpy(table.data(), slots, numSlots);
+    std::memcpy(table.data() + RoundUp(numSlots, sizeof(uint32_t)), egress, sizeof(uint32_t) * m_header.numGroundStations);
+
+    if (m_header.numTables == 0 || table != m_table)
+    {
+        m_file.write(reinterpret_cast<const char*>(table.data()), table.size());
+        m_table.swap(table);
+        ++m_header.numTables;
+    }
+    m_epochTable.push_back(m_header.numTables - 1);
+}
+
+bool
+SatelliteRouteArchiveWriter::Close()
+{
+    if (!m_file.is_open())
+    {
+        return false;
+    }
+    m_header.numEpochs = m_epochTable.size();
+    m_file.write(reinterpret_cast<const char*>(m_epochTable.data()), sizeof(uint32_t) * m_epochTable.size());
+    m_file.seekp(0);
+    m_file.write(reinterpret_cast<const char*>(&m_header), sizeof(m_header));
+    bool ok = static_cast<bool>(m_file);
+    m_file.close();
+    NS_LOG_INFO("Wrote route archive: " << m_header.numEpochs << " epochs, " << m_header.numTables << " tables");
+    return ok && !m_file.fail();
+}
+
+uint32_t
+SatelliteRouteArchiveWriter::GetNTables() const
+{
+    return m_header.numTables;
+}
+
+} // namespace ns3
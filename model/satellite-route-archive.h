@@ -0,0 +1,185 @@
+#ifndef SATELLITE_ROUTE_ARCHIVE_H
+#define SATELLITE_ROUTE_ARCHIVE_H
+
+#include "ns3/nstime.h"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/*
+ * Route archive file layout, native byte order:
+ *
+ *   SatelliteRouteArchiveHeader, padded to 64 bytes
+ *   numTables route tables of GetTableSize() bytes each:
+ *     numSatellites x numSatellites next-hop slots, one byte each, row = source
+ *     padding to 4 bytes
+ *     numGroundStations egress satellite indices, uint32 each
+ *     padding to 8 bytes
+ *   numEpochs uint32 table numbers, one per epoch
+ *
+ * A next-hop slot is the position of the next hop in the adjacency list of the
+ * source in SatelliteRouteGraph, or NO_ROUTE. Epoch e covers the times
+ * [start + e * interval, start + (e + 1) * interval).
+ */
+
+/// Fixed-size head of a route archive file.
+struct SatelliteRouteArchiveHeader
+{
+    char magic[8];              //!< "SATROUTE"
+    uint32_t version;
+    uint32_t numSatellites;
+    uint32_t numGroundStations;
+    uint32_t numTables;
+    int64_t start;              //!< Start of epoch 0, in nanoseconds
+    int64_t interval;           //!< Epoch length, in nanoseconds
+    uint64_t numEpochs;
+    uint64_t fingerprint;       //!< Topology the routes were computed for
+};
+
+/**
+ * @ingroup satellite
+ * @brief Precomputed constellation routes over a time horizon, read from a memory-mapped file.
+ *
+ * The file is mapped read-only and shared, so every simulation process that
+ * replays the same archive shares one copy in the page cache, and pages are
+ * only read when a table is first touched. Lookups are plain loads.
+ *
+ * Consecutive epochs with identical routes share one table, so a long horizon
+ * costs little more than the route changes it contains.
+ */
+class SatelliteRouteArchive
+{
+public:
+    /// Next-hop slot of an unreachable pair.
+    static constexpr uint8_t NO_ROUTE = 0xff;
+    /// Returned by FindEpoch() outside the archived horizon.
+    static constexpr uint64_t INVALID_EPOCH = 0xffffffffffffffffULL;
+    static constexpr uint32_t VERSION = 1;
+
+    SatelliteRouteArchive();
+    ~SatelliteRouteArchive();
+
+    SatelliteRouteArchive(const SatelliteRouteArchive&) = delete;
+    SatelliteRouteArchive& operator=(const SatelliteRouteArchive&) = delete;
+
+    /**
+     * @brief Map an archive file, closing any previous one.
+     * @param path The file.
+     * @return Whether the file exists and is a well-formed archive.
+     */
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const;
+
+    uint32_t GetNSatellites() const;
+    uint32_t GetNGroundStations() const;
+    uint32_t GetNTables() const;
+    uint64_t GetNEpochs() const;
+    Time GetStart() const;
+    Time GetInterval() const;
+    uint64_t GetFingerprint() const;
+
+    /**
+     * @param t A simulation time.
+     * @return The epoch t falls in, or INVALID_EPOCH if it is outside the horizon.
+     */
+    uint64_t FindEpoch(Time t) const;
+
+    /**
+     * @param epoch An epoch.
+     * @return The number of the route table of the epoch.
+     */
+    uint32_t GetTable(uint64_t epoch) const;
+
+    /**
+     * @param table A route table.
+     * @param src The source satellite index.
+     * @param dst The destination satellite index.
+     * @return The slot of the next hop in the adjacency list of src, or NO_ROUTE.
+     */
+    uint8_t GetNextHopSlot(uint32_t table, uint32_t src, uint32_t dst) const
+    {
+        return m_tables[static_cast<size_t>(table) * m_tableSize + static_cast<size_t>(src) * m_numSatellites + dst];
+    }
+
+    /**
+     * @param table A route table.
+     * @param groundStation A ground station index.
+     * @return The egress satellite of the ground station.
+     */
+    uint32_t GetEgress(uint32_t table, uint32_t groundStation) const;
+
+    /**
+     * @return Bytes of one route table of an archive of the given size.
+     */
+    static size_t GetTableSize(uint32_t numSatellites, uint32_t numGroundStations);
+
+    /**
+     * @return Offset of the first route table in the file.
+     */
+    static size_t GetTablesOffset();
+
+private:
+    const uint8_t* m_base;      //!< Start of the mapping, or nullptr
+    size_t m_size;              //!< Bytes mapped
+    SatelliteRouteArchiveHeader m_header;
+    const uint8_t* m_tables;    //!< First route table
+    const uint32_t* m_epochTable; //!< Table number, by epoch
+    size_t m_tableSize;
+    uint32_t m_numSatellites;
+};
+
+/**
+ * @ingroup satellite
+ * @brief Streams epochs of routes into a route archive file.
+ *
+ * Only the previous table and the epoch index are kept in memory, so horizons
+ * far larger than memory can be written.
+ */
+class SatelliteRouteArchiveWriter
+{
+public:
+    SatelliteRouteArchiveWriter();
+
+    /**
+     * @brief Create the file and write a provisional header.
+     * @return Whether the file could be created.
+     */
+    bool Open(const std::string& path,
+              uint32_t numSatellites,
+              uint32_t numGroundStations,
+              Time start,
+              Time interval,
+              uint64_t fingerprint);
+
+    /**
+     * @brief Append the next epoch.
+     * @param slots numSatellites x numSatellites next-hop slots, row = source.
+     * @param egress Egress satellite, by ground station index.
+     */
+    void AddEpoch(const uint8_t* slots, const uint32_t* egress);
+
+    /**
+     * @brief Write the epoch index and the final header, and close the file.
+     * @return Whether every write succeeded.
+     */
+    bool Close();
+
+    /**
+     * @return The number of distinct tables written so far.
+     */
+    uint32_t GetNTables() const;
+
+private:
+    std::ofstream m_file;
+    SatelliteRouteArchiveHeader m_header;
+    std::vector<uint8_t> m_table;      //!< Last written table
+    std::vector<uint32_t> m_epochTable; //!< Table number, by epoch
+};
+
+} // namespace ns3
+
+#endif /* SATELLITE_ROUTE_ARCHIVE_H */
@@ -0,0 +1,975 @@
+#include "satellite-route-engine.h"
+#include "satellite-circular-mobility-model.h"
+#include "satellite-ephemeris.h"
+#include "ns3/boolean.h"
+#include "ns3/channel.h"
+#include "ns3/double.h"
+#include "ns3/enum.h"
+#include "ns3/log.h"
+#include "ns3/loopback-net-device.h"
+#include "ns3/mobility-model.h"
+#include "ns3/net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE("SatelliteRouteEngine");
+
+NS_OBJECT_ENSURE_REGISTERED(SatelliteRouteEngine);
+
+TypeId
+SatelliteRouteEngine::GetTypeId(void)
+{
+    static TypeId tid = TypeId("ns3::SatelliteRouteEngine")
+        .SetParent<Object>()
+        .SetGroupName("Satellite")
+        .AddConstructor<SatelliteRouteEngine>()
+        .AddAttribute("NumThreads",
+                      "Number of threads computing routes each epoch. 1 computes on the "
+                      "simulator thread only, 0 uses all available hardware threads.",
+                      UintegerValue(1),
+                      MakeUintegerAccessor(&SatelliteRouteEngine::m_numThreads),
+                      MakeUintegerChecker<uint32_t>())
+        .AddAttribute("PriorityQueue",
+                      "Priority queue of the all-pairs shortest path searches. The integer "
+                      "queues order by link light-time quantized to nanoseconds.",
+                      EnumValue(SatelliteRouteEngine::BINARY_HEAP),
+                      MakeEnumAccessor<QueueType>(&SatelliteRouteEngine::m_queueType),
+                      MakeEnumChecker(SatelliteRouteEngine::BINARY_HEAP, "BinaryHeap",
+                                      SatelliteRouteEngine::RADIX_HEAP, "RadixHeap",
+                                      SatelliteRouteEngine::DIAL, "Dial"))
+        .AddAttribute("IncrementalRepair",
+                      "Keep the shortest path trees between epochs and repair them for the new "
+                      "link lengths instead of recomputing them. Needs three N x N tables.",
+                      BooleanValue(false),
+                      MakeBooleanAccessor(&SatelliteRouteEngine::m_incrementalRepair),
+                      MakeBooleanChecker())
+        .AddAttribute("RepairTolerance",
+                      "With IncrementalRepair, keep a path unless another one is shorter by more "
+                      "than this many meters. 0 keeps routes exactly shortest.",
+                      DoubleValue(0.0),
+                      MakeDoubleAccessor(&SatelliteRouteEngine::m_repairTolerance),
+                      MakeDoubleChecker<double>(0.0))
+        .AddAttribute("GridRouting",
+                      "Compute next hops in closed form on the +Grid link torus, without a "
+                      "next-hop matrix. Needs SetOrbitalPlanes(); falls back to graph search "
+                      "while links are failed.",
+                      BooleanValue(false),
+                      MakeBooleanAccessor(&SatelliteRouteEngine::m_gridRouting),
+                      MakeBooleanChecker())
+        .AddAttribute("OnDemand",
+                      "Resolve a satellite pair with a bidirectional A* search the first time it "
+                      "is used in an epoch instead of computing all pairs up front. Results are "
+                      "memoized until the next epoch.",
+                      BooleanValue(false),
+                      MakeBooleanAccessor(&SatelliteRouteEngine::m_onDemand),
+                      MakeBooleanChecker())
+        .AddAttribute("GroundToGround",
+                      "Choose the ingress satellite, inter-satellite path and egress satellite "
+                      "between two ground stations together for the shortest total path, instead "
+                      "of the closest satellite at either end.",
+                      BooleanValue(false),
+                      MakeBooleanAccessor(&SatelliteRouteEngine::m_groundToGround),
+                      MakeBooleanChecker())
+        .AddAttribute("GroundMinElevation",
+                      "With GroundToGround and no contact plan, the elevation in degrees above "
+                      "which a ground station sees a satellite.",
+                      DoubleValue(10.0),
+                      MakeDoubleAccessor(&SatelliteRouteEngine::m_groundMinElevation),
+                      MakeDoubleChecker<double>(0.0, 90.0))
+        .AddAttribute("PolarLatitude",
+                      "Latitude in degrees above which links between satellites of different "
+                      "orbital planes are down. 90 keeps them up. While any is down, GridRouting "
+                      "falls back to graph search.",
+                      DoubleValue(90.0),
+                      MakeDoubleAccessor(&SatelliteRouteEngine::m_polarLatitude),
+                      MakeDoubleChecker<double>(0.0, 90.0))
+        .AddAttribute("RouteArchive",
+                      "Route archive written by WriteArchive() to replay instead of computing "
+                      "routes. Must match the constellation; empty computes every epoch.",
+                      StringValue(""),
+                      MakeStringAccessor(&SatelliteRouteEngine::m_archivePath),
+                      MakeStringChecker())
+        .AddTraceSource("RouteRepair",
+                        "Number of repaired and total (source, vertex) pairs of an epoch.",
+                        MakeTraceSourceAccessor(&SatelliteRouteEngine::m_routeRepairTrace),
+                        "ns3::SatelliteRouteEngine::RouteRepairTracedCallback");
+    return tid;
+}
+
+SatelliteRouteEngine::SatelliteRouteEngine()
+    : m_numLinkFailed(0),
+      m_polarLatitude(90.0),
+      m_gridRouting(false),
+      m_onDemand(false),
+      m_groundToGround(false),
+      m_groundMinElevation(10.0),
+      m_maxOrbitRadius(0.0),
+      m_router(nullptr),
+      m_incrementalRepair(false),
+      m_repairTolerance(0.0),
+      m_numThreads(1),
+      m_queueType(BINARY_HEAP),
+      m_fingerprint(0),
+      m_routesChanged(true),
+      m_timeToHandover(Time::Max()),
+      m_epochValid(false),
+      m_epochNumber(0)
+{
+}
+
+SatelliteRouteEngine::~SatelliteRouteEngine()
+{
+}
+
+void
+SatelliteRouteEngine::AddNode(Ptr<Node> node)
+{
+    m_nodes.Add(node);
+}
+
+void
+SatelliteRouteEngine::InitializeTopology()
+{
+    NS_LOG_INFO("Building global satellite topology once.");
+
+    m_satellites.clear();
+    m_ephemerisSlot.clear();
+    m_groundStations.clear();
+    uint32_t maxId = 0;
+    for (uint32_t i = 0; i < m_nodes.GetN(); ++i)
+    {
+        maxId = std::max(maxId, m_nodes.Get(i)->GetId());
+    }
+    m_satelliteIndexById.assign(maxId + 1, INVALID_INDEX);
+    m_groundStationIndexById.assign(maxId + 1, INVALID_INDEX);
+    for (uint32_t i = 0; i < m_nodes.GetN(); ++i)
+    {
+        Ptr<Node> node = m_nodes.Get(i);
+        Ptr<SatelliteCircularMobilityModel> mobility = node->GetObject<SatelliteCircularMobilityModel>();
+        if (mobility)
+        {
+            m_satelliteIndexById[node->GetId()] = m_satellites.size();
+            m_satellites.push_back(node);
+            m_ephemerisSlot.push_back(mobility->GetEphemerisSlot());
+        }
+        else if (node->GetObject<MobilityModel>())
+        {
+            m_groundStationIndexById[node->GetId()] = m_groundStations.size();
+            m_groundStations.push_back(node);
+        }
+    }
+
+    uint32_t numSatellites = m_satellites.size();
+    std::vector<std::vector<uint32_t>> adjacency(numSatellites);
+    for (uint32_t i = 0; i < numSatellites; ++i)
+    {
+        Ptr<Node> node = m_satellites[i];
+        for (uint32_t j = 0; j < node->GetNDevices(); ++j)
+        {
+            Ptr<NetDevice> dev = node->GetDevice(j);
+            if (DynamicCast<LoopbackNetDevice>(dev))
+            {
+                continue;
+            }
+            Ptr<Channel> channel = dev->GetChannel();
+            if (channel && channel->GetNDevices() == 2)
+            {
+                Ptr<NetDevice> peerDev = (channel->GetDevice(0) == dev) ? channel->GetDevice(1) : channel->GetDevice(0);
+
+                // Only inter-satellite links (ISL) are part of the shortest path graph
+                uint32_t peerIndex = GetSatelliteIndex(peerDev->GetNode());
+                if (peerIndex != INVALID_INDEX)
+                {
+                    adjacency[i].push_back(peerIndex);
+                }
+            }
+        }
+    }
+
+    m_graph.Build(adjacency);
+    m_linkFailed.assign(m_graph.GetNEdges(), 0);
+    m_numLinkFailed = 0;
+
+    std::vector<std::vector<uint32_t>> planes(m_orbitalPlanes.size());
+    for (uint32_t p = 0; p < m_orbitalPlanes.size(); ++p)
+    {
+        for (uint32_t s = 0; s < m_orbitalPlanes[p].GetN(); ++s)
+        {
+            planes[p].push_back(GetSatelliteIndex(m_orbitalPlanes[p].Get(s)));
+        }
+    }
+    if (m_gridRouter.Build(m_graph, planes))
+    {
+        NS_LOG_INFO("Links form a " << m_gridRouter.GetNPlanes() << " x "
+                    << m_gridRouter.GetSatellitesPerPlane() << " +Grid.");
+    }
+    else if (m_gridRouting)
+    {
+        NS_LOG_WARN("GridRouting is enabled but the orbital planes are unknown or the links do "
+                    "not form a +Grid; using graph search.");
+    }
+    m_spatialIndex.SetSatellites(m_satellites);
+    m_egress.assign(m_groundStations.size(), INVALID_INDEX);
+    m_groundCandidates.assign(m_groundStations.size(), {});
+    m_groundCandidatesValid.assign(m_groundStations.size(), 0);
+    m_groundPaths.clear();
+    m_labelByPath.clear();
+    m_labelPaths.clear();
+    m_x.resize(numSatellites);
+    m_y.resize(numSatellites);
+    m_z.resize(numSatellites);
+    m_allPairsRouter.Clear();
+    m_onDemandRouter.Clear();
+    m_router = nullptr;
+    m_epochValid = false;
+
+    m_archiveRouter.Close();
+    if (!m_archivePath.empty())
+    {
+        if (!m_archiveRouter.Open(m_archivePath, m_graph))
+        {
+            NS_FATAL_ERROR("Cannot read route archive " << m_archivePath << ".");
+        }
+        const SatelliteRouteArchive& archive = m_archiveRouter.GetArchive();
+        if (archive.GetNSatellites() != numSatellites || archive.GetNGroundStations() != m_groundStations.size() ||
+            archive.GetFingerprint() != ComputeTopologyFingerprint(archive.GetStart(), archive.GetInterval()))
+        {
+            NS_FATAL_ERROR("Route archive " << m_archivePath << " was computed for another constellation.");
+        }
+        // Fingerprinting moved the position snapshot; take it again on first use
+        m_spatialIndex.SetSatellites(m_satellites);
+        NS_LOG_INFO("Replaying routes from " << m_archivePath << " for "
+                    << (archive.GetInterval() * static_cast<int64_t>(archive.GetNEpochs())).GetSeconds()
+                    << "s from " << archive.GetStart().GetSeconds() << "s");
+    }
+}
+
+void
+SatelliteRouteEngine::Update()
+{
+    Update(Simulator::Now());
+}
+
+void
+SatelliteRouteEngine::Update(Time epochTime)
+{
+    if (m_epochValid && m_epochTime == epochTime)
+    {
+        return;
+    }
+    if (ReplayArchive(epochTime))
+    {
+        m_epochTime = epochTime;
+        m_epochValid = true;
+        ++m_epochNumber;
+        return;
+    }
+
+    NS_LOG_DEBUG("Computing constellation routes for " << m_satellites.size()
+                 << " satellites at time " << epochTime.GetSeconds() << "s");
+    if (m_onDemandRouter.GetNSearches())
+    {
+        NS_LOG_DEBUG("Previous epoch resolved " << m_onDemandRouter.GetNSearches() << " pairs on demand");
+    }
+    m_onDemandRouter.Clear();
+
+    SnapshotPositions(epochTime);
+    if (IsGridRoutingActive())
+    {
+        // Next hops come straight from the grid; only the link lengths were needed
+        m_allPairsRouter.Clear();
+        m_router = &m_gridRouter;
+    }
+    else if (m_onDemand)
+    {
+        // Pairs are searched when asked for
+        m_allPairsRouter.Clear();
+        m_onDemandRouter.Reset(m_graph, m_x.data(), m_y.data(), m_z.data());
+        m_router = &m_onDemandRouter;
+    }
+    else
+    {
+        ComputeAllPairs();
+        m_router = &m_allPairsRouter;
+    }
+    FingerprintRoutes();
+    PredictHandover(epochTime);
+    m_epochTime = epochTime;
+    m_epochValid = true;
+    ++m_epochNumber;
+}
+
+bool
+SatelliteRouteEngine::ReplayArchive(Time epochTime)
+{
+    uint32_t previous = m_archiveRouter.GetTable();
+    if (!m_archiveRouter.GetArchive().IsOpen() || m_numLinkFailed != 0 || !m_archiveRouter.Select(epochTime))
+    {
+        m_archiveRouter.Deselect();
+        return false;
+    }
+
+    m_routesChanged = !m_epochValid || m_archiveRouter.GetTable() != previous;
+    Time change = m_archiveRouter.GetNextChange();
+    m_timeToHandover = (change != Time::Max()) ? change - epochTime : Time::Max();
+    for (uint32_t i = 0; i < m_groundStations.size(); ++i)
+    {
+        m_egress[i] = m_archiveRouter.GetEgress(i);
+    }
+    m_allPairsRouter.Clear();
+    m_onDemandRouter.Clear();
+    m_router = &m_archiveRouter;
+    return true;
+}
+
+bool
+SatelliteRouteEngine::WriteArchive(const std::string& path, Time start, Time interval, uint64_t numEpochs)
+{
+    NS_ASSERT_MSG(m_numLinkFailed == 0, "Route archives hold routes of the intact constellation.");
+    const uint32_t numSatellites = m_satellites.size();
+    const std::vector<uint32_t>& offsets = m_graph.GetOffsets();
+    const std::vector<uint32_t>& targets = m_graph.GetTargets();
+    for (uint32_t i = 0; i < numSatellites; ++i)
+    {
+        NS_ASSERT_MSG(offsets[i + 1] - offsets[i] < SatelliteRouteArchive::NO_ROUTE,
+                      "Satellite " << m_satellites[i]->GetId() << " has too many links for a route archive.");
+    }
+
+    SatelliteRouteArchiveWriter writer;
+    if (!writer.Open(path, numSatellites, m_groundStations.size(), start, interval,
+                     ComputeTopologyFingerprint(start, interval)))
+    {
+        return false;
+    }
+
+    std::vector<uint8_t> slots(static_cast<size_t>(numSatellites) * numSatellites);
+    m_router = nullptr;
+    for (uint64_t e = 0; e < numEpochs; ++e)
+    {
+        SnapshotPositions(start + interval * static_cast<int64_t>(e));
+        ComputeAllPairs();
+        const std::vector<uint32_t>& nextHops = m_allPairsRouter.GetMatrix();
+
+        // Next hops are always neighbours; store their adjacency slot
+        for (uint32_t src = 0; src < numSatellites; ++src)
+        {
+            size_t row = static_cast<size_t>(src) * numSatellites;
+            for (uint32_t dst = 0; dst < numSatellites; ++dst)
+            {
+                uint32_t nextHop = nextHops[row + dst];
+                uint8_t slot = SatelliteRouteArchive::NO_ROUTE;
+                for (uint32_t k = offsets[src]; nextHop != INVALID_INDEX && k < offsets[src + 1]; ++k)
+                {
+                    if (targets[k] == nextHop)
+                    {
+                        slot = k - offsets[src];
+                        break;
+                    }
+                }
+                slots[row + dst] = slot;
+            }
+        }
+        writer.AddEpoch(slots.data(), m_egress.data());
+        NS_LOG_DEBUG("Archived epoch " << e << " of " << numEpochs << ", " << writer.GetNTables() << " distinct tables");
+    }
+
+    // The matrix holds the last archived epoch, not a simulation epoch
+    m_allPairsRouter.Clear();
+    m_epochValid = false;
+    NS_LOG_INFO("Archived " << numEpochs << " epochs of routes in " << writer.GetNTables() << " tables.");
+    return writer.Close();
+}
+
+uint64_t
+SatelliteRouteEngine::ComputeTopologyFingerprint(Time start, Time interval)
+{
+    // FNV-1a over the link graph, the satellite positions at the first two
+    // epochs and the ground station positions, all rounded to the meter
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](uint64_t value) { hash = (hash ^ value) * 1099511628211ULL; };
+    auto mixPosition = [&mix](double x, double y, double z) {
+        mix(static_cast<uint64_t>(std::llround(x)));
+        mix(static_cast<uint64_t>(std::llround(y)));
+        mix(static_cast<uint64_t>(std::llround(z)));
+    };
+
+    mix(m_satellites.size());
+    mix(m_groundStations.size());
+    if (m_polarLatitude < 90.0)
+    {
+        // Polar links are part of the archived routes
+        mix(static_cast<uint64_t>(std::llround(m_polarLatitude * 1e6)));
+    }
+    for (uint32_t offset : m_graph.GetOffsets())
+    {
+        mix(offset);
+    }
+    for (uint32_t target : m_graph.GetTargets())
+    {
+        mix(target);
+    }
+    for (Time t : {start, start + interval})
+    {
+        SnapshotPositions(t);
+        for (uint32_t i = 0; i < m_satellites.size(); ++i)
+        {
+            mixPosition(m_x[i], m_y[i], m_z[i]);
+        }
+    }
+    for (const Ptr<Node>& groundStation : m_groundStations)
+    {
+        Vector position = groundStation->GetObject<MobilityModel>()->GetPosition();
+        mixPosition(position.x, position.y, position.z);
+    }
+    return hash;
+}
+
+void
+SatelliteRouteEngine::SetOrbitalPlanes(const std::vector<NodeContainer>& orbitalPlanes)
+{
+    m_orbitalPlanes = orbitalPlanes;
+}
+
+bool
+SatelliteRouteEngine::IsGridRoutingActive() const
+{
+    return m_gridRouting && m_gridRouter.IsValid() && m_graph.GetNFailedEdges() == 0;
+}
+
+void
+SatelliteRouteEngine::SetContactPlan(Ptr<SatelliteContactPlan> plan)
+{
+    m_contactPlan = plan;
+    m_epochValid = false;
+}
+
+Ptr<SatelliteContactPlan>
+SatelliteRouteEngine::GetContactPlan() const
+{
+    return m_contactPlan;
+}
+
+bool
+SatelliteRouteEngine::IsArchiveActive() const
+{
+    return m_router == &m_archiveRouter;
+}
+
+bool
+SatelliteRouteEngine::HasNextHopMatrix() const
+{
+    return m_router == &m_allPairsRouter;
+}
+
+void
+SatelliteRouteEngine::SetLinkFailed(Ptr<Node> a, Ptr<Node> b, bool failed)
+{
+    uint32_t u = GetSatelliteIndex(a);
+    uint32_t v = GetSatelliteIndex(b);
+    NS_ASSERT_MSG(u != INVALID_INDEX && v != INVALID_INDEX, "Both ends of an inter-satellite link must be satellites.");
+    uint32_t forward = m_graph.FindEdge(u, v);
+    uint32_t backward = m_graph.FindEdge(v, u);
+    NS_ASSERT_MSG(forward != INVALID_INDEX || backward != INVALID_INDEX,
+                  "No link between nodes " << a->GetId() << " and " << b->GetId() << ".");
+    NS_LOG_INFO("Link " << a->GetId() << " - " << b->GetId() << (failed ? " failed." : " repaired."));
+    for (uint32_t e : {forward, backward})
+    {
+        if (e == INVALID_INDEX || m_linkFailed[e] == failed)
+        {
+            continue;
+        }
+        m_linkFailed[e] = failed;
+        if (failed)
+        {
+            ++m_numLinkFailed;
+        }
+        else
+        {
+            --m_numLinkFailed;
+        }
+        // Polar links are taken down again by the next snapshot
+        m_graph.SetEdgeFailed(e, failed);
+    }
+    m_groundPaths.clear();
+
+    if (m_epochValid)
+    {
+        m_epochValid = false;
+        Update(m_epochTime);
+    }
+}
+
+void
+SatelliteRouteEngine::SnapshotPositions(Time t)
+{
+    // One batch propagation of the whole constellation, then a gather into
+    // satellite index order.
+    SatelliteEphemeris& ephemeris = SatelliteEphemeris::Get();
+    ephemeris.Refresh(t);
+    const double* x = ephemeris.GetX();
+    const double* y = ephemeris.GetY();
+    const double* z = ephemeris.GetZ();
+    for (uint32_t i = 0; i < m_satellites.size(); ++i)
+    {
+        uint32_t slot = m_ephemerisSlot[i];
+        m_x[i] = x[slot];
+        m_y[i] = y[slot];
+        m_z[i] = z[slot];
+    }
+    UpdatePolarLinks();
+    m_graph.UpdateWeights(m_x.data(), m_y.data(), m_z.data());
+    m_spatialIndex.Update(t);
+    m_maxOrbitRadius = 0;
+    for (uint32_t i = 0; i < m_satellites.size(); ++i)
+    {
+        m_maxOrbitRadius = std::max(m_maxOrbitRadius, std::sqrt(m_x[i] * m_x[i] + m_y[i] * m_y[i] + m_z[i] * m_z[i]));
+    }
+    m_groundPaths.clear();
+    std::fill(m_groundCandidatesValid.begin(), m_groundCandidatesValid.end(), 0);
+    ComputeEgress(t);
+}
+
+void
+SatelliteRouteEngine::UpdatePolarLinks()
+{
+    // Only polar links make the graph differ from the failed links
+    bool enabled = m_polarLatitude < 90.0;
+    if (!enabled && m_graph.GetNFailedEdges() == m_numLinkFailed)
+    {
+        return;
+    }
+    SatelliteOrbitPropagator::Elements elements = SatelliteEphemeris::Get().GetElements();
+    double sinLimit = std::sin(m_polarLatitude * M_PI / 180.0);
+    m_polar.resize(m_satellites.size());
+    for (uint32_t i = 0; i < m_satellites.size(); ++i)
+    {
+        m_polar[i] = enabled && std::abs(m_z[i]) > sinLimit * elements.radius[m_ephemerisSlot[i]];
+    }
+
+    const std::vector<uint32_t>& offsets = m_graph.GetOffsets();
+    const std::vector<uint32_t>& targets = m_graph.GetTargets();
+    for (uint32_t u = 0; u < m_satellites.size(); ++u)
+    {
+        uint32_t a = m_ephemerisSlot[u];
+        for (uint32_t e = offsets[u]; e < offsets[u + 1]; ++e)
+        {
+            uint32_t v = targets[e];
+            uint32_t b = m_ephemerisSlot[v];
+            bool crossPlane = std::abs(elements.cosRaan[a] - elements.cosRaan[b]) > 1e-9 ||
+                              std::abs(elements.sinRaan[a] - elements.sinRaan[b]) > 1e-9 ||
+                              std::abs(elements.cosInclination[a] - elements.cosInclination[b]) > 1e-9;
+            bool down = crossPlane && (m_polar[u] || m_polar[v]);
+            m_graph.SetEdgeFailed(e, m_linkFailed[e] || down);
+        }
+    }
+}
+
+void
+SatelliteRouteEngine::ComputeEgress(Time t)
+{
+    for (uint32_t i = 0; i < m_groundStations.size(); ++i)
+    {
+        Vector position = m_groundStations[i]->GetObject<MobilityModel>()->GetPosition();
+        if (!m_contactPlan)
+        {
+            m_egress[i] = m_spatialIndex.FindNearest(position);
+            continue;
+        }
+
+        // Closest of the satellites the plan says are above the mask
+        m_contactPlan->GetVisibleSatellites(m_groundStations[i], t, m_visible);
+        m_egress[i] = INVALID_INDEX;
+        double bestDistSq = std::numeric_limits<double>::max();
+        for (uint32_t id : m_visible)
+        {
+            uint32_t sat = (id < m_satelliteIndexById.size()) ? m_satelliteIndexById[id] : INVALID_INDEX;
+            if (sat == INVALID_INDEX)
+            {
+                continue;
+            }
+            double dx = m_x[sat] - position.x;
+            double dy = m_y[sat] - position.y;
+            double dz = m_z[sat] - position.z;
+            double distSq = dx * dx + dy * dy + dz * dz;
+            if (distSq < bestDistSq)
+            {
+                bestDistSq = distSq;
+                m_egress[i] = sat;
+            }
+        }
+    }
+}
+
+void
+SatelliteRouteEngine::FingerprintRoutes()
+{
+    // FNV-1a over the next hops, the failed links and the egress table. Only
+    // the all-pairs router has a matrix; for the others a fixed sample of
+    // pairs stands for the routes, which costs OnDemand a few searches.
+    uint64_t hash = 14695981039346656037ULL;
+    if (m_router == &m_allPairsRouter)
+    {
+        for (uint32_t nextHop : m_allPairsRouter.GetMatrix())
+        {
+            hash = (hash ^ nextHop) * 1099511628211ULL;
+        }
+    }
+    else if (!m_satellites.empty())
+    {
+        // Multiplicative hashing spreads the destinations, so that the sample
+        // does not alias with the plane size
+        uint64_t n = m_satellites.size();
+        for (uint64_t k = 0; k < FINGERPRINT_SAMPLES; ++k)
+        {
+            uint32_t src = k * n / FINGERPRINT_SAMPLES;
+            uint32_t dst = (k * 2654435761ULL) % n;
+            hash = (hash ^ m_router->GetNextHop(src, dst)) * 1099511628211ULL;
+        }
+    }
+    if (m_graph.GetNFailedEdges() != 0)
+    {
+        for (uint32_t e = 0; e < m_graph.GetNEdges(); ++e)
+        {
+            if (m_graph.IsEdgeFailed(e))
+            {
+                hash = (hash ^ e) * 1099511628211ULL;
+            }
+        }
+    }
+    for (uint32_t egress : m_egress)
+    {
+        hash = (hash ^ egress) * 1099511628211ULL;
+    }
+    m_routesChanged = !m_epochValid || hash != m_fingerprint;
+    m_fingerprint = hash;
+}
+
+void
+SatelliteRouteEngine::PredictHandover(Time t)
+{
+    SatelliteEphemeris& ephemeris = SatelliteEphemeris::Get();
+    const double* vx = ephemeris.GetVx();
+    const double* vy = ephemeris.GetVy();
+    const double* vz = ephemeris.GetVz();
+    auto rangeAndRate = [&](uint32_t sat, const Vector& position, double& range, double& rate) {
+        uint32_t slot = m_ephemerisSlot[sat];
+        double dx = m_x[sat] - position.x;
+        double dy = m_y[sat] - position.y;
+        double dz = m_z[sat] - position.z;
+        range = std::sqrt(dx * dx + dy * dy + dz * dz);
+        rate = (range > 0) ? (dx * vx[slot] + dy * vy[slot] + dz * vz[slot]) / range : 0.0;
+    };
+
+    double earliest = std::numeric_limits<double>::infinity();
+    for (uint32_t i = 0; i < m_groundStations.size(); ++i)
+    {
+        uint32_t egress = m_egress[i];
+        if (egress == INVALID_INDEX)
+        {
+            continue;
+        }
+        Vector position = m_groundStations[i]->GetObject<MobilityModel>()->GetPosition();
+        double range;
+        double rate;
+        rangeAndRate(egress, position, range, rate);
+
+        // Any satellite that can overtake the egress satellite soon is nearby.
+        // With a contact plan or ground-to-ground selection the egress need
+        // not be the nearest satellite; those already closer did not make it
+        // the egress and cannot overtake it, so they predict nothing.
+        m_spatialIndex.FindWithinRange(position, 2.0 * range, m_nearby);
+        for (uint32_t other : m_nearby)
+        {
+            double otherRange;
+            double otherRate;
+            rangeAndRate(other, position, otherRange, otherRate);
+            if (other != egress && otherRange >= range && otherRate < rate)
+            {
+                earliest = std::min(earliest, (otherRange - range) / (rate - otherRate));
+            }
+        }
+    }
+
+    if (m_polarLatitude < 90.0)
+    {
+        // Latitude follows sin(lat) = sin(i) sin(u) with the argument of
+        // latitude u = u0 + w t; the next crossing is the next u at which
+        // |sin(u)| reaches sin(limit) / sin(i)
+        SatelliteOrbitPropagator::Elements elements = ephemeris.GetElements();
+        double sinLimit = std::sin(m_polarLatitude * M_PI / 180.0);
+        for (uint32_t i = 0; i < m_satellites.size(); ++i)
+        {
+            uint32_t slot = m_ephemerisSlot[i];
+            double w = elements.angularVelocity[slot];
+            if (elements.sinInclination[slot] <= sinLimit || w <= 0)
+            {
+                continue;
+            }
+            double a = std::asin(sinLimit / elements.sinInclination[slot]);
+            double u = std::fmod(elements.initialAngle[slot] + w * t.GetSeconds(), 2 * M_PI);
+            if (u < 0)
+            {
+                u += 2 * M_PI;
+            }
+            for (double crossing : {a, M_PI - a, M_PI + a, 2 * M_PI - a})
+            {
+                double angle = crossing - u;
+                while (angle <= 0)
+                {
+                    angle += 2 * M_PI;
+                }
+                // A microsecond late, so that the epoch sees the link changed
+                earliest = std::min(earliest, angle / w + 1e-6);
+            }
+        }
+    }
+    m_timeToHandover = std::isinf(earliest) ? Time::Max() : Seconds(earliest);
+}
+
+void
+SatelliteRouteEngine::ComputeAllPairs()
+{
+    m_allPairsRouter.SetNThreads(m_numThreads);
+    m_allPairsRouter.SetQueueType(static_cast<SatelliteAllPairsRouter::QueueType>(m_queueType));
+    m_allPairsRouter.SetIncrementalRepair(m_incrementalRepair, m_repairTolerance);
+    m_allPairsRouter.Compute(m_graph);
+    uint64_t numSatellites = m_satellites.size();
+    m_routeRepairTrace(m_allPairsRouter.GetLastRepairedVertices(), numSatellites * numSatellites);
+}
+
+const NodeContainer&
+SatelliteRouteEngine::GetNodes() const
+{
+    return m_nodes;
+}
+
+uint32_t
+SatelliteRouteEngine::GetNSatellites() const
+{
+    return m_satellites.size();
+}
+
+Ptr<Node>
+SatelliteRouteEngine::GetSatellite(uint32_t index) const
+{
+    NS_ASSERT_MSG(index < m_satellites.size(), "Satellite index " << index << " out of range.");
+    return m_satellites[index];
+}
+
+uint32_t
+SatelliteRouteEngine::GetSatelliteIndex(Ptr<Node> node) const
+{
+    uint32_t id = node->GetId();
+    return (id < m_satelliteIndexById.size()) ? m_satelliteIndexById[id] : INVALID_INDEX;
+}
+
+uint32_t
+SatelliteRouteEngine::GetNextHop(uint32_t src, uint32_t dst)
+{
+    return m_router ? m_router->GetNextHop(src, dst) : INVALID_INDEX;
+}
+
+uint32_t
+SatelliteRouteEngine::GetNGroundStations() const
+{
+    return m_groundStations.size();
+}
+
+Ptr<Node>
+SatelliteRouteEngine::GetGroundStation(uint32_t index) const
+{
+    NS_ASSERT_MSG(index < m_groundStations.size(), "Ground station index " << index << " out of range.");
+    return m_groundStations[index];
+}
+
+uint32_t
+SatelliteRouteEngine::GetGroundStationIndex(Ptr<Node> node) const
+{
+    uint32_t id = node->GetId();
+    return (id < m_groundStationIndexById.size()) ? m_groundStationIndexById[id] : INVALID_INDEX;
+}
+
+uint32_t
+SatelliteRouteEngine::GetEgressSatellite(uint32_t groundStation)
+{
+    NS_ASSERT_MSG(groundStation < m_groundStations.size(), "Ground station index " << groundStation << " out of range.");
+    if (!m_epochValid && !m_spatialIndex.IsValid())
+    {
+        SnapshotPositions(Simulator::Now());
+    }
+    return m_egress[groundStation];
+}
+
+bool
+SatelliteRouteEngine::IsGroundToGround() const
+{
+    return m_groundToGround;
+}
+
+const std::vector<std::pair<uint32_t, double>>&
+SatelliteRouteEngine::GetGroundCandidates(uint32_t groundStation)
+{
+    std::vector<std::pair<uint32_t, double>>& candidates = m_groundCandidates[groundStation];
+    if (m_groundCandidatesValid[groundStation])
+    {
+        return candidates;
+    }
+    m_groundCandidatesValid[groundStation] = 1;
+    candidates.clear();
+
+    Vector position = m_groundStations[groundStation]->GetObject<MobilityModel>()->GetPosition();
+    auto range = [&](uint32_t sat) {
+        double dx = m_x[sat] - position.x;
+        double dy = m_y[sat] - position.y;
+        double dz = m_z[sat] - position.z;
+        return std::sqrt(dx * dx + dy * dy + dz * dz);
+    };
+
+    if (m_contactPlan)
+    {
+        m_contactPlan->GetVisibleSatellites(m_groundStations[groundStation], m_spatialIndex.GetEpochTime(), m_visible);
+        for (uint32_t id : m_visible)
+        {
+            uint32_t sat = (id < m_satelliteIndexById.size()) ? m_satelliteIndexById[id] : INVALID_INDEX;
+            if (sat != INVALID_INDEX)
+            {
+                candidates.push_back({sat, range(sat)});
+            }
+        }
+        return candidates;
+    }
+
+    // No satellite above the mask is farther than the slant range of the
+    // highest orbit at the mask elevation
+    double radius = std::sqrt(position.x * position.x + position.y * position.y + position.z * position.z);
+    if (radius == 0 || m_maxOrbitRadius <= radius)
+    {
+        return candidates;
+    }
+    double sinMask = std::sin(m_groundMinElevation * M_PI / 180.0);
+    double cosMask = std::cos(m_groundMinElevation * M_PI / 180.0);
+    double maxRange = std::sqrt(m_maxOrbitRadius * m_maxOrbitRadius - radius * radius * cosMask * cosMask) - radius * sinMask;
+    m_spatialIndex.FindWithinRange(position, maxRange, m_visible);
+    for (uint32_t sat : m_visible)
+    {
+        double dx = m_x[sat] - position.x;
+        double dy = m_y[sat] - position.y;
+        double dz = m_z[sat] - position.z;
+        double r = range(sat);
+        if ((dx * position.x + dy * position.y + dz * position.z) / radius >= sinMask * r)
+        {
+            candidates.push_back({sat, r});
+        }
+    }
+    return candidates;
+}
+
+bool
+SatelliteRouteEngine::GetGroundPath(uint32_t srcGroundStation, uint32_t dstGroundStation, uint32_t& ingress, uint32_t& egress)
+{
+    NS_ASSERT_MSG(srcGroundStation < m_groundStations.size() && dstGroundStation < m_groundStations.size(),
+                  "Ground station index out of range.");
+    // Replayed epochs only take a position snapshot when asked for one
+    GetSpatialIndex();
+
+    uint64_t key = static_cast<uint64_t>(srcGroundStation) * m_groundStations.size() + dstGroundStation;
+    auto it = m_groundPaths.find(key);
+    if (it == m_groundPaths.end())
+    {
+        double length = FindShortestPathBetweenSets(m_graph,
+                                                    GetGroundCandidates(srcGroundStation),
+                                                    GetGroundCandidates(dstGroundStation),
+                                                    m_groundScratch,
+                                                    ingress,
+                                                    egress);
+        NS_LOG_DEBUG("Ground path " << srcGroundStation << " -> " << dstGroundStation << ": ingress " << ingress
+                     << ", egress " << egress << ", " << length / 1000.0 << " km");
+        it = m_groundPaths.emplace(key, std::make_pair(ingress, egress)).first;
+    }
+    ingress = it->second.first;
+    egress = it->second.second;
+    return ingress != INVALID_INDEX;
+}
+
+uint32_t
+SatelliteRouteEngine::GetLabel(uint32_t egress, uint32_t groundStation)
+{
+    NS_ASSERT_MSG(egress < m_satellites.size() && groundStation < m_groundStations.size(),
+                  "Label path out of range.");
+    uint64_t key = static_cast<uint64_t>(egress) * m_groundStations.size() + groundStation;
+    auto it = m_labelByPath.find(key);
+    if (it == m_labelByPath.end())
+    {
+        it = m_labelByPath.emplace(key, m_labelPaths.size()).first;
+        m_labelPaths.push_back({egress, groundStation});
+    }
+    return it->second;
+}
+
+uint32_t
+SatelliteRouteEngine::GetNLabels() const
+{
+    return m_labelPaths.size();
+}
+
+std::pair<uint32_t, uint32_t>
+SatelliteRouteEngine::GetLabelPath(uint32_t label) const
+{
+    NS_ASSERT_MSG(label < m_labelPaths.size(), "Label " << label << " was never allocated.");
+    return m_labelPaths[label];
+}
+
+const SatelliteSpatialIndex&
+SatelliteRouteEngine::GetSpatialIndex()
+{
+    if (!m_spatialIndex.IsValid())
+    {
+        SnapshotPositions(IsArchiveActive() ? m_archiveRouter.GetEpochStart() : Simulator::Now());
+    }
+    else if (IsArchiveActive() && m_spatialIndex.GetEpochTime() != m_archiveRouter.GetEpochStart())
+    {
+        // Replayed epochs take no snapshot until positions are asked for;
+        // at the archived time the egress table comes out the same
+        SnapshotPositions(m_archiveRouter.GetEpochStart());
+    }
+    return m_spatialIndex;
+}
+
+Time
+SatelliteRouteEngine::GetEpochTime() const
+{
+    return m_epochTime;
+}
+
+uint64_t
+SatelliteRouteEngine::GetEpochNumber() const
+{
+    return m_epochNumber;
+}
+
+bool
+SatelliteRouteEngine::DidRoutesChange() const
+{
+    return m_routesChanged;
+}
+
+Time
+SatelliteRouteEngine::GetTimeToNextHandover() const
+{
+    return m_timeToHandover;
+}
+
+uint64_t
+SatelliteRouteEngine::GetLastRepairedVertices() const
+{
+    return m_allPairsRouter.GetLastRepairedVertices();
+}
+
+} // namespace ns3
@@ -0,0 +1,416 @@
+#ifndef SATELLITE_ROUTE_ENGINE_H
+#define SATELLITE_ROUTE_ENGINE_H
+
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/traced-callback.h"
+#include "satellite-all-pairs-router.h"
+#include "satellite-archive-router.h"
+#include "satellite-contact-plan.h"
+#include "satellite-grid-router.h"
+#include "satellite-on-demand-router.h"
+#include "satellite-route-graph.h"
+#include "satellite-spatial-index.h"
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * @ingroup satellite
+ * @brief Constellation-wide shortest path engine shared by all SatelliteSpRoutingProtocol instances.
+ *
+ * The engine owns the inter-satellite link graph. Once per epoch (i.e. once per
+ * distinct simulation time at which routes are requested) it snapshots every
+ * satellite position, runs a single-source shortest path search from every
+ * satellite and stores the resulting first hops in a dense next-hop matrix.
+ * Protocol instances then only read their own row of that matrix.
+ *
+ * Each way of finding next hops below is a SatelliteNextHopProvider of its
+ * own (SatelliteAllPairsRouter, SatelliteGridRouter, SatelliteOnDemandRouter,
+ * SatelliteArchiveRouter); the engine picks one per epoch and answers
+ * GetNextHop() from it.
+ *
+ * With the same snapshot it fills a ground station to egress satellite table,
+ * so every hop of a path towards a ground station agrees on where the path
+ * leaves the constellation for the whole epoch.
+ *
+ * The single-source searches are independent and only read the immutable
+ * position snapshot, so with NumThreads > 1 they are spread over a worker pool
+ * while the simulator thread waits at the end of the epoch. The result does not
+ * depend on the number of threads.
+ *
+ * With IncrementalRepair the engine keeps every shortest path tree between
+ * epochs and only repairs it for the new link lengths instead of searching from
+ * scratch. Link lengths change little from one epoch to the next, so most trees
+ * stay as they are; the number of repaired vertices is reported through the
+ * RouteRepair trace source.
+ *
+ * With GridRouting and the orbital planes known (SetOrbitalPlanes()), next hops
+ * on the +Grid torus built by InterSatelliteLinkHelper are computed in constant
+ * time from the grid coordinates instead; the engine then keeps no next-hop
+ * matrix at all. Links marked failed with SetLinkFailed() break the grid
+ * assumption, and while any is down the engine falls back to graph search.
+ *
+ * Below a PolarLatitude of 90 degrees, links between satellites of different
+ * orbital planes go down while either end is above that latitude, as their
+ * antennas cannot track the neighbouring plane across the pole. The crossings
+ * follow from the orbital elements, so every epoch also predicts when the next
+ * such link changes state.
+ *
+ * With OnDemand the engine does not search from every satellite either. A
+ * (source, destination) pair is resolved with a bidirectional A* search the
+ * first time it is asked for in an epoch, and the whole path is memoized until
+ * the next epoch, so satellites that carry no traffic cost nothing.
+ *
+ * Every epoch also records whether the routes differ from the previous epoch
+ * and how soon the next ground station handover is expected, which lets the
+ * update scheduler adapt its interval.
+ *
+ * With a contact plan (SetContactPlan()) a ground station only leaves the
+ * constellation through satellites the plan marks visible, the closest of
+ * them; the elevation geometry is not evaluated at run time.
+ *
+ * With GroundToGround, a path between two ground stations is not stitched
+ * from the closest satellite at either end. The ingress satellite, the
+ * inter-satellite path and the egress satellite are chosen together, among all
+ * satellites each ground station sees, to minimize the total length and thus
+ * the propagation delay. The pair is found with one multi-source search per
+ * (source, destination) ground station pair and memoized until the next epoch.
+ *
+ * For label switching the engine also numbers the (egress satellite,
+ * destination ground station) pairs packets are sent along. Labels are
+ * allocated on first use and never change meaning, so a satellite's label
+ * table only needs updating where its next hop towards an egress changed.
+ *
+ * Orbits are deterministic, so the routes of a constellation over a horizon
+ * can be computed once with WriteArchive() and replayed by any number of runs:
+ * with RouteArchive set the engine maps the archive and answers next hops and
+ * egress satellites from it with no route computation at all. Epochs outside
+ * the archived horizon, or with failed links, are computed as usual.
+ */
+class SatelliteRouteEngine : public Object
+{
+public:
+    static TypeId GetTypeId(void);
+    SatelliteRouteEngine();
+    ~SatelliteRouteEngine() override;
+
+    /// Priority queue used by the all-pairs searches.
+    enum QueueType
+    {
+        BINARY_HEAP = SatelliteAllPairsRouter::BINARY_HEAP, //!< Binary heap on distances in meters
+        RADIX_HEAP = SatelliteAllPairsRouter::RADIX_HEAP,   //!< Radix heap on link delays in integer nanoseconds
+        DIAL = SatelliteAllPairsRouter::DIAL                //!< Dial bucket queue on link delays, bucketed to bound memory
+    };
+
+    /// Marks a missing route or a node that is not a satellite.
+    static constexpr uint32_t INVALID_INDEX = SatelliteRouteGraph::INVALID_INDEX;
+
+    /**
+     * @brief Register a node the SP routing protocol is installed on.
+     * @param node The node (satellite or ground station).
+     */
+    void AddNode(Ptr<Node> node);
+
+    /**
+     * @brief Build the inter-satellite link graph from the installed devices.
+     *
+     * Must be called once after all links have been installed.
+     */
+    void InitializeTopology();
+
+    /**
+     * @brief Tell the engine the grid coordinates of the satellites, for GridRouting.
+     *
+     * Must be called before InitializeTopology().
+     * @param orbitalPlanes The satellites of every plane, in the order given to
+     *        InterSatelliteLinkHelper::Install().
+     */
+    void SetOrbitalPlanes(const std::vector<NodeContainer>& orbitalPlanes);
+
+    /**
+     * @return Whether next hops currently come from the closed-form +Grid router.
+     */
+    bool IsGridRoutingActive() const;
+
+    /**
+     * @brief Restrict egress satellites to those visible in a contact plan.
+     * @param plan The contact plan, or nullptr to use the closest satellite.
+     */
+    void SetContactPlan(Ptr<SatelliteContactPlan> plan);
+
+    /**
+     * @return The contact plan, or nullptr.
+     */
+    Ptr<SatelliteContactPlan> GetContactPlan() const;
+
+    /**
+     * @return Whether the current epoch filled the dense next-hop matrix, as
+     *         opposed to answering GetNextHop() per pair.
+     */
+    bool HasNextHopMatrix() const;
+
+    /**
+     * @brief Mark the inter-satellite link between two satellites failed or repaired.
+     *
+     * Routes of the current epoch are recomputed at once and GetEpochNumber()
+     * advances, so protocol instances pick up the new routes on their next
+     * lookup rather than at the next epoch.
+     * @param a One end of the link.
+     * @param b The other end.
+     * @param failed Whether the link is down.
+     */
+    void SetLinkFailed(Ptr<Node> a, Ptr<Node> b, bool failed);
+
+    /**
+     * @brief Compute the routes of a time horizon and write them to a route archive.
+     *
+     * Must be called after InitializeTopology() and before the simulation
+     * uses the engine; the current epoch is discarded.
+     * @param path The archive file, overwritten.
+     * @param start Start of the first epoch.
+     * @param interval Epoch length.
+     * @param numEpochs Number of epochs.
+     * @return Whether the file was written.
+     */
+    bool WriteArchive(const std::string& path, Time start, Time interval, uint64_t numEpochs);
+
+    /**
+     * @return Whether the current epoch is replayed from the RouteArchive.
+     */
+    bool IsArchiveActive() const;
+
+    /**
+     * @brief Recompute the next-hop matrix if the simulation time moved since the last epoch.
+     */
+    void Update();
+
+    /**
+     * @brief Recompute routes for positions at a given epoch time, unless already done.
+     * @param epochTime The epoch time, normally the current time or the start of
+     *        the scheduler epoch the current time falls in.
+     */
+    void Update(Time epochTime);
+
+    /**
+     * @return All registered nodes, satellites and ground stations alike.
+     */
+    const NodeContainer& GetNodes() const;
+
+    /**
+     * @return The number of satellites in the link graph.
+     */
+    uint32_t GetNSatellites() const;
+
+    /**
+     * @param index A satellite index.
+     * @return The satellite node with that index.
+     */
+    Ptr<Node> GetSatellite(uint32_t index) const;
+
+    /**
+     * @param node A node.
+     * @return The satellite index of the node, or INVALID_INDEX if it is not a satellite.
+     */
+    uint32_t GetSatelliteIndex(Ptr<Node> node) const;
+
+    /**
+     * @brief Get the first hop on the shortest path between two satellites.
+     * @param src The source satellite index.
+     * @param dst The destination satellite index.
+     * @return The satellite index of the next hop, or INVALID_INDEX if dst is unreachable
+     *         or no epoch has been computed yet.
+     */
+    uint32_t GetNextHop(uint32_t src, uint32_t dst);
+
+    /**
+     * @return The number of registered ground stations (non-satellite nodes).
+     */
+    uint32_t GetNGroundStations() const;
+
+    /**
+     * @param index A ground station index.
+     * @return The ground station node with that index.
+     */
+    Ptr<Node> GetGroundStation(uint32_t index) const;
+
+    /**
+     * @param node A node.
+     * @return The ground station index of the node, or INVALID_INDEX if it is not a ground station.
+     */
+    uint32_t GetGroundStationIndex(Ptr<Node> node) const;
+
+    /**
+     * @brief Get the satellite closest to a ground station at the current epoch.
+     *
+     * With a contact plan, only satellites visible from the ground station count.
+     * @param groundStation A ground station index.
+     * @return The satellite index, or INVALID_INDEX if there is no such satellite.
+     */
+    uint32_t GetEgressSatellite(uint32_t groundStation);
+
+    /**
+     * @return Whether ground-to-ground paths are chosen end to end (GroundToGround).
+     */
+    bool IsGroundToGround() const;
+
+    /**
+     * @brief Get the shortest path between two ground stations at the current epoch.
+     *
+     * Candidates at either end are the satellites visible from the ground
+     * station: those the contact plan lists, or those above GroundMinElevation
+     * without a plan. Between ingress and egress the path follows the shortest
+     * inter-satellite path, so every satellite on the way only needs to know the
+     * egress.
+     * @param srcGroundStation The source ground station index.
+     * @param dstGroundStation The destination ground station index.
+     * @param ingress Output, the satellite index to uplink to.
+     * @param egress Output, the satellite index to leave the constellation from.
+     * @return Whether any path exists; ingress and egress are INVALID_INDEX otherwise.
+     */
+    bool GetGroundPath(uint32_t srcGroundStation, uint32_t dstGroundStation, uint32_t& ingress, uint32_t& egress);
+
+    /**
+     * @brief Get the label of the path leaving the constellation at a satellite
+     *        towards a ground station, allocating it on first use.
+     * @param egress The egress satellite index.
+     * @param groundStation The destination ground station index.
+     * @return The label, valid for the rest of the simulation.
+     */
+    uint32_t GetLabel(uint32_t egress, uint32_t groundStation);
+
+    /**
+     * @return The number of labels allocated so far; labels are 0 to GetNLabels() - 1.
+     */
+    uint32_t GetNLabels() const;
+
+    /**
+     * @param label A label.
+     * @return The egress satellite index and destination ground station index of the label.
+     */
+    std::pair<uint32_t, uint32_t> GetLabelPath(uint32_t label) const;
+
+    /**
+     * @brief Spatial index over the satellites, rebuilt with every epoch.
+     *
+     * Items are satellite indices. If no epoch has been computed yet, positions
+     * are snapshotted at the current time.
+     * @return The index.
+     */
+    const SatelliteSpatialIndex& GetSpatialIndex();
+
+    /**
+     * @return The simulation time of the last computed epoch.
+     */
+    Time GetEpochTime() const;
+
+    /**
+     * @return The number of route computations so far. Unlike GetEpochTime() it
+     *         also changes when SetLinkFailed() recomputes the current epoch, so
+     *         caches of engine results are keyed on it.
+     */
+    uint64_t GetEpochNumber() const;
+
+    /**
+     * @return Whether the routes or the egress table of the last epoch differ
+     *         from the epoch before. Without a next-hop matrix the routes are
+     *         compared on a fixed sample of pairs and the set of failed links.
+     */
+    bool DidRoutesChange() const;
+
+    /**
+     * @brief Predicted time from the last epoch to the next egress handover
+     *        or polar link change.
+     *
+     * Ranges from every ground station to the satellites around it are
+     * extrapolated linearly; the handover happens when another satellite's
+     * range drops below that of the current egress satellite. With a
+     * PolarLatitude below 90 degrees, the next time a satellite crosses it is
+     * solved from its orbital elements. Replayed epochs report the time to the
+     * next change of archived routes instead.
+     * @return The time, or Time::Max() if no handover is predicted.
+     */
+    Time GetTimeToNextHandover() const;
+
+    /**
+     * @return The number of (source, vertex) pairs the last epoch repaired with
+     *         IncrementalRepair, or N x N after a full computation.
+     */
+    uint64_t GetLastRepairedVertices() const;
+
+    /**
+     * TracedCallback signature for route repair events.
+     * @param [in] repaired Number of repaired (source, vertex) pairs.
+     * @param [in] total Number of (source, vertex) pairs in the epoch.
+     */
+    typedef void (*RouteRepairTracedCallback)(uint64_t repaired, uint64_t total);
+
+private:
+    static constexpr uint64_t FINGERPRINT_SAMPLES = 64; //!< Pairs fingerprinted without a next-hop matrix
+
+    void SnapshotPositions(Time t);
+    void ComputeEgress(Time t);
+    void UpdatePolarLinks();
+    void PredictHandover(Time t);
+    void FingerprintRoutes();
+    void ComputeAllPairs();
+    const std::vector<std::pair<uint32_t, double>>& GetGroundCandidates(uint32_t groundStation);
+    uint64_t ComputeTopologyFingerprint(Time start, Time interval);
+    bool ReplayArchive(Time epochTime);
+
+    NodeContainer m_nodes;                        //!< All nodes registered with the engine
+    std::vector<Ptr<Node>> m_satellites;          //!< Satellites, by satellite index
+    std::vector<uint32_t> m_satelliteIndexById;   //!< Satellite index, by node id
+    std::vector<uint32_t> m_ephemerisSlot;        //!< SatelliteEphemeris slot, by satellite index
+    std::vector<Ptr<Node>> m_groundStations;      //!< Ground stations, by ground station index
+    std::vector<uint32_t> m_groundStationIndexById; //!< Ground station index, by node id
+    std::vector<uint32_t> m_egress;               //!< Egress satellite, by ground station index
+    Ptr<SatelliteContactPlan> m_contactPlan;      //!< Visibility windows for egress, may be null
+    std::vector<uint32_t> m_visible;              //!< Scratch for contact plan lookups
+    SatelliteRouteGraph m_graph;                  //!< ISL graph, by satellite index
+    std::vector<NodeContainer> m_orbitalPlanes;   //!< Grid layout for GridRouting, may be empty
+    std::vector<uint8_t> m_linkFailed;            //!< Whether SetLinkFailed() took the edge down, by edge
+    uint32_t m_numLinkFailed;                     //!< Number of set entries in m_linkFailed
+    double m_polarLatitude;                       //!< Latitude above which cross-plane links are down, in degrees
+    std::vector<uint8_t> m_polar;                 //!< Whether the satellite is above m_polarLatitude
+    SatelliteGridRouter m_gridRouter;             //!< Closed-form router, valid if the graph is a +Grid
+    bool m_gridRouting;                           //!< Whether to use m_gridRouter when possible
+    bool m_onDemand;                              //!< Whether to resolve pairs lazily
+    bool m_groundToGround;                        //!< Whether to choose ingress and egress together
+    double m_groundMinElevation;                  //!< Elevation mask without a contact plan, in degrees
+    std::unordered_map<uint64_t, std::pair<uint32_t, uint32_t>> m_groundPaths; //!< Memoized (ingress, egress), key src * G + dst
+    SatellitePairSearchScratch m_groundScratch;   //!< Buffers of the ground-to-ground search
+    std::vector<std::vector<std::pair<uint32_t, double>>> m_groundCandidates; //!< Visible satellites and ranges, by ground station
+    std::vector<uint8_t> m_groundCandidatesValid; //!< Whether m_groundCandidates is filled, by ground station
+    double m_maxOrbitRadius;                      //!< Largest satellite radius at the current epoch
+    std::unordered_map<uint64_t, uint32_t> m_labelByPath; //!< Label, key egress * G + ground station
+    std::vector<std::pair<uint32_t, uint32_t>> m_labelPaths; //!< (egress, ground station), by label
+    SatelliteSpatialIndex m_spatialIndex;         //!< Position index, items are satellite indices
+    std::vector<double> m_x;                      //!< Satellite x at the current epoch
+    std::vector<double> m_y;                      //!< Satellite y at the current epoch
+    std::vector<double> m_z;                      //!< Satellite z at the current epoch
+    SatelliteAllPairsRouter m_allPairsRouter;     //!< Next-hop matrix of all-pairs epochs
+    SatelliteOnDemandRouter m_onDemandRouter;     //!< Per-pair searches of OnDemand epochs
+    SatelliteArchiveRouter m_archiveRouter;       //!< Replayed routes of RouteArchive epochs
+    SatelliteNextHopProvider* m_router;           //!< Provider of the current epoch, or nullptr
+    bool m_incrementalRepair;                     //!< Whether to repair the previous trees
+    double m_repairTolerance;                     //!< Ignored path improvements, in meters
+    TracedCallback<uint64_t, uint64_t> m_routeRepairTrace; //!< Fired after every epoch
+    uint32_t m_numThreads;                        //!< Configured route computation threads
+    QueueType m_queueType;                        //!< Priority queue of the all-pairs searches
+    std::string m_archivePath;                    //!< Route archive to replay, empty for none
+    uint64_t m_fingerprint;                       //!< Hash of the routes of the last epoch
+    bool m_routesChanged;                         //!< Whether the fingerprint changed in the last epoch
+    Time m_timeToHandover;                        //!< Prediction of the last epoch
+    std::vector<uint32_t> m_nearby;               //!< Scratch for the handover prediction
+    Time m_epochTime;                             //!< Time of the last computed epoch
+    bool m_epochValid;                            //!< Whether m_router holds a computed epoch
+    uint64_t m_epochNumber;                       //!< Number of computed epochs
+};
+
+} // namespace ns3
+
+#endif /* SATELLITE_ROUTE_ENGINE_H */
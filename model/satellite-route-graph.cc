@@ -0,0 +1,649 @@
+#include "satellite-route-graph.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+namespace ns3 {
+
+SatelliteRouteGraph::SatelliteRouteGraph()
+    : m_offsets(1, 0),
+      m_maxDelay(0),
+      m_numFailed(0)
+{
+}
+
+void
+SatelliteRouteGraph::Build(const std::vector<std::vector<uint32_t>>& adjacency)
+{
+    m_offsets.assign(adjacency.size() + 1, 0);
+    m_targets.clear();
+    for (uint32_t u = 0; u < adjacency.size(); ++u)
+    {
+        m_targets.insert(m_targets.end(), adjacency[u].begin(), adjacency[u].end());
+        m_offsets[u + 1] = m_targets.size();
+    }
+    m_weights.assign(m_targets.size(), 0.0);
+    m_delays.assign(m_targets.size(), 0);
+    m_maxDelay = 0;
+    m_failed.assign(m_targets.size(), 0);
+    m_numFailed = 0;
+}
+
+void
+SatelliteRouteGraph::UpdateWeights(const double* x, const double* y, const double* z)
+{
+    uint32_t numVertices = GetNVertices();
+    for (uint32_t u = 0; u < numVertices; ++u)
+    {
+        for (uint32_t e = m_offsets[u]; e < m_offsets[u + 1]; ++e)
+        {
+            uint32_t v = m_targets[e];
+            double dx = x[v] - x[u];
+            double dy = y[v] - y[u];
+            double dz = z[v] - z[u];
+            m_weights[e] = m_failed[e] ? std::numeric_limits<double>::infinity()
+                                       : std::sqrt(dx * dx + dy * dy + dz * dz);
+        }
+    }
+    UpdateDelays();
+}
+
+void
+SatelliteRouteGraph::UpdateDelays()
+{
+    m_maxDelay = 0;
+    for (uint32_t e = 0; e < m_weights.size(); ++e)
+    {
+        if (m_failed[e])
+        {
+            m_delays[e] = std::numeric_limits<uint64_t>::max();
+            continue;
+        }
+        m_delays[e] = std::llround(m_weights[e] / SPEED_OF_LIGHT * 1e9);
+        m_maxDelay = std::max(m_maxDelay, m_delays[e]);
+    }
+}
+
+uint32_t
+SatelliteRouteGraph::FindEdge(uint32_t u, uint32_t v) const
+{
+    for (uint32_t e = m_offsets[u]; e < m_offsets[u + 1]; ++e)
+    {
+        if (m_targets[e] == v)
+        {
+            return e;
+        }
+    }
+    return INVALID_INDEX;
+}
+
+void
+SatelliteRouteGraph::SetEdgeFailed(uint32_t e, bool failed)
+{
+    if (m_failed[e] == failed)
+    {
+        return;
+    }
+    m_failed[e] = failed;
+    if (failed)
+    {
+        ++m_numFailed;
+        m_weights[e] = std::numeric_limits<double>::infinity();
+        m_delays[e] = std::numeric_limits<uint64_t>::max();
+    }
+    else
+    {
+        --m_numFailed;
+    }
+}
+
+bool
+SatelliteRouteGraph::IsEdgeFailed(uint32_t e) const
+{
+    return m_failed[e];
+}
+
+uint32_t
+SatelliteRouteGraph::GetNFailedEdges() const
+{
+    return m_numFailed;
+}
+
+uint32_t
+SatelliteRouteGraph::GetNVertices() const
+{
+    return m_offsets.size() - 1;
+}
+
+uint32_t
+SatelliteRouteGraph::GetNEdges() const
+{
+    return m_targets.size();
+}
+
+const std::vector<uint32_t>&
+SatelliteRouteGraph::GetOffsets() const
+{
+    return m_offsets;
+}
+
+const std::vector<uint32_t>&
+SatelliteRouteGraph::GetTargets() const
+{
+    return m_targets;
+}
+
+const std::vector<double>&
+SatelliteRouteGraph::GetWeights() const
+{
+    return m_weights;
+}
+
+const std::vector<uint64_t>&
+SatelliteRouteGraph::GetDelays() const
+{
+    return m_delays;
+}
+
+uint64_t
+SatelliteRouteGraph::GetMaxDelay() const
+{
+    return m_maxDelay;
+}
+
+void
+ComputeShortestPathFirstHops(const SatelliteRouteGraph& graph,
+                             uint32_t src,
+                             SatelliteShortestPathScratch& scratch,
+                             uint32_t* nextHopRow)
+{
+    const uint32_t numVertices = graph.GetNVertices();
+    const uint32_t* offsets = graph.GetOffsets().data();
+    const uint32_t* targets = graph.GetTargets().data();
+    const double* weights = graph.GetWeights().data();
+
+    scratch.dist.assign(numVertices, std::numeric_limits<double>::max());
+    scratch.firstHop.assign(numVertices, SatelliteRouteGraph::INVALID_INDEX);
+    double* dist = scratch.dist.data();
+    uint32_t* firstHop = scratch.firstHop.data();
+
+    using HeapElement = std::pair<double, uint32_t>;
+    auto& heap = scratch.heap;
+    const std::greater<HeapElement> cmp;
+    heap.clear();
+
+    dist[src] = 0;
+    heap.push_back({0.0, src});
+
+    while (!heap.empty())
+    {
+        std::pop_heap(heap.begin(), heap.end(), cmp);
+        double d = heap.back().first;
+        uint32_t u = heap.back().second;
+        heap.pop_back();
+
+        if (d > dist[u]) continue;
+
+        for (uint32_t e = offsets[u]; e < offsets[u + 1]; ++e)
+        {
+            uint32_t v = targets[e];
+            double candidate = dist[u] + weights[e];
+            if (candidate < dist[v])
+            {
+                dist[v] = candidate;
+                firstHop[v] = (u == src) ? v : firstHop[u];
+                heap.push_back({candidate, v});
+                std::push_heap(heap.begin(), heap.end(), cmp);
+            }
+        }
+    }
+
+    std::copy(firstHop, firstHop + numVertices, nextHopRow);
+}
+
+namespace {
+
+using HeapElement = std::pair<double, uint32_t>;
+
+/**
+ * Dijkstra main loop over whatever the heap was seeded with. Only improvements
+ * by more than tolerance are taken. If touched is given, vertices improved for
+ * the first time are marked there and counted.
+ */
+uint32_t
+RelaxTree(const SatelliteRouteGraph& graph,
+          double tolerance,
+          SatelliteShortestPathScratch& scratch,
+          double* dist,
+          uint32_t* parent,
+          uint32_t* parentEdge,
+          uint8_t* touched)
+{
+    const uint32_t* offsets = graph.GetOffsets().data();
+    const uint32_t* targets = graph.GetTargets().data();
+    const double* weights = graph.GetWeights().data();
+    auto& heap = scratch.heap;
+    const std::greater<HeapElement> cmp;
+    uint32_t improved = 0;
+
+    while (!heap.empty())
+    {
+        std::pop_heap(heap.begin(), heap.end(), cmp);
+        double d = heap.back().first;
+        uint32_t u = heap.back().second;
+        heap.pop_back();
+
+        if (d > dist[u]) continue;
+
+        for (uint32_t e = offsets[u]; e < offsets[u + 1]; ++e)
+        {
+            uint32_t v = targets[e];
+            double candidate = d + weights[e];
+            if (candidate < dist[v] - tolerance)
+            {
+                dist[v] = candidate;
+                parent[v] = u;
+                parentEdge[v] = e;
+                heap.push_back({candidate, v});
+                std::push_heap(heap.begin(), heap.end(), cmp);
+                if (touched && !touched[v])
+                {
+                    touched[v] = 1;
+                    ++improved;
+                }
+            }
+        }
+    }
+    return improved;
+}
+
+/**
+ * Write the first hop towards every vertex by walking up the parent pointers,
+ * memoizing each vertex once.
+ */
+void
+WriteFirstHops(uint32_t numVertices,
+               uint32_t src,
+               const uint32_t* parent,
+               SatelliteShortestPathScratch& scratch,
+               uint32_t* nextHopRow)
+{
+    scratch.flags.assign(numVertices, 0);
+    uint8_t* done = scratch.flags.data();
+    auto& stack = scratch.stack;
+
+    nextHopRow[src] = SatelliteRouteGraph::INVALID_INDEX;
+    done[src] = 1;
+    for (uint32_t v = 0; v < numVertices; ++v)
+    {
+        uint32_t u = v;
+        stack.clear();
+        while (!done[u] && parent[u] != SatelliteRouteGraph::INVALID_INDEX)
+        {
+            stack.push_back(u);
+            u = parent[u];
+        }
+        if (!done[u])
+        {
+            // Unreachable: no parent and not the source
+            nextHopRow[u] = SatelliteRouteGraph::INVALID_INDEX;
+            done[u] = 1;
+        }
+        while (!stack.empty())
+        {
+            uint32_t w = stack.back();
+            stack.pop_back();
+            nextHopRow[w] = (parent[w] == src) ? w : nextHopRow[parent[w]];
+            done[w] = 1;
+        }
+    }
+}
+
+} // namespace
+
+uint32_t
+FindShortestPath(const SatelliteRouteGraph& graph,
+                 const double* x,
+                 const double* y,
+                 const double* z,
+                 uint32_t src,
+                 uint32_t dst,
+                 SatellitePairSearchScratch& scratch,
+                 std::vector<uint32_t>& path)
+{
+    const uint32_t numVertices = graph.GetNVertices();
+    const uint32_t* offsets = graph.GetOffsets().data();
+    const uint32_t* targets = graph.GetTargets().data();
+    const double* weights = graph.GetWeights().data();
+    const double inf = std::numeric_limits<double>::infinity();
+
+    path.clear();
+    for (uint32_t side = 0; side < 2; ++side)
+    {
+        if (scratch.dist[side].size() != numVertices)
+        {
+            scratch.dist[side].assign(numVertices, inf);
+            scratch.parent[side].assign(numVertices, SatelliteRouteGraph::INVALID_INDEX);
+        }
+        scratch.heap[side].clear();
+    }
+    if (src == dst)
+    {
+        path.push_back(src);
+        return 0;
+    }
+
+    // Average of the forward and backward heuristics. Reduced edge costs stay
+    // non-negative in both directions, and the key of a vertex is its distance
+    // plus its potential (negated for the backward side).
+    auto straightLine = [x, y, z](uint32_t a, uint32_t b) {
+        double dx = x[a] - x[b];
+        double dy = y[a] - y[b];
+        double dz = z[a] - z[b];
+        return std::sqrt(dx * dx + dy * dy + dz * dz);
+    };
+    auto potential = [&](uint32_t v) { return 0.5 * (straightLine(v, dst) - straightLine(v, src)); };
+
+    double* dist[2] = {scratch.dist[0].data(), scratch.dist[1].data()};
+    uint32_t* parent[2] = {scratch.parent[0].data(), scratch.parent[1].data()};
+    const std::greater<HeapElement> cmp;
+    auto& touched = scratch.touched;
+    touched.clear();
+
+    const uint32_t origin[2] = {src, dst};
+    for (uint32_t side = 0; side < 2; ++side)
+    {
+        dist[side][origin[side]] = 0;
+        double sign = side ? -1.0 : 1.0;
+        scratch.heap[side].push_back({sign * potential(origin[side]), origin[side]});
+        touched.push_back(origin[side]);
+    }
+
+    double best = inf;
+    uint32_t meet = SatelliteRouteGraph::INVALID_INDEX;
+    uint32_t settled = 0;
+    while (!scratch.heap[0].empty() && !scratch.heap[1].empty())
+    {
+        if (scratch.heap[0].front().first + scratch.heap[1].front().first >= best)
+        {
+            break;
+        }
+
+        // Advance the side with the smaller frontier
+        uint32_t side = (scratch.heap[0].size() <= scratch.heap[1].size()) ? 0 : 1;
+        double sign = side ? -1.0 : 1.0;
+        auto& heap = scratch.heap[side];
+        std::pop_heap(heap.begin(), heap.end(), cmp);
+        double key = heap.back().first;
+        uint32_t u = heap.back().second;
+        heap.pop_back();
+        if (key > dist[side][u] + sign * potential(u)) continue;
+        ++settled;
+
+        for (uint32_t e = offsets[u]; e < offsets[u + 1]; ++e)
+        {
+            uint32_t v = targets[e];
+            double candidate = dist[side][u] + weights[e];
+            if (candidate < dist[side][v])
+            {
+                if (dist[0][v] == inf && dist[1][v] == inf)
+                {
+                    touched.push_back(v);
+                }
+                dist[side][v] = candidate;
+                parent[side][v] = u;
+                heap.push_back({candidate + sign * potential(v), v});
+                std::push_heap(heap.begin(), heap.end(), cmp);
+                if (candidate + dist[1 - side][v] < best)
+                {
+                    best = candidate + dist[1 - side][v];
+                    meet = v;
+                }
+            }
+        }
+    }
+
+    if (meet != SatelliteRouteGraph::INVALID_INDEX)
+    {
+        for (uint32_t v = meet; v != src; v = parent[0][v])
+        {
+            path.push_back(v);
+        }
+        path.push_back(src);
+        std::reverse(path.begin(), path.end());
+        for (uint32_t v = meet; v != dst;)
+        {
+            v = parent[1][v];
+            path.push_back(v);
+        }
+    }
+
+    for (uint32_t v : touched)
+    {
+        dist[0][v] = dist[1][v] = inf;
+        parent[0][v] = parent[1][v] = SatelliteRouteGraph::INVALID_INDEX;
+    }
+    return settled;
+}
+
+double
+FindShortestPathBetweenSets(const SatelliteRouteGraph& graph,
+                            const std::vector<std::pair<uint32_t, double>>& sources,
+                            const std::vector<std::pair<uint32_t, double>>& targets,
+                            SatellitePairSearchScratch& scratch,
+                            uint32_t& ingress,
+                            uint32_t& egress)
+{
+    const uint32_t numVertices = graph.GetNVertices();
+    const uint32_t* offsets = graph.GetOffsets().data();
+    const uint32_t* edgeTargets = graph.GetTargets().data();
+    const double* weights = graph.GetWeights().data();
+    const double inf = std::numeric_limits<double>::infinity();
+
+    if (scratch.dist[0].size() != numVertices)
+    {
+        scratch.dist[0].assign(numVertices, inf);
+        scratch.parent[0].assign(numVertices, SatelliteRouteGraph::INVALID_INDEX);
+    }
+    // parent[0] holds the source each vertex was reached from, not its tree parent
+    double* dist = scratch.dist[0].data();
+    uint32_t* origin = scratch.parent[0].data();
+    auto& heap = scratch.heap[0];
+    auto& touched = scratch.touched;
+    const std::greater<HeapElement> cmp;
+    heap.clear();
+    touched.clear();
+
+    for (const auto& source : sources)
+    {
+        uint32_t s = source.first;
+        if (dist[s] == inf)
+        {
+            touched.push_back(s);
+        }
+        if (source.second < dist[s])
+        {
+            dist[s] = source.second;
+            origin[s] = s;
+            heap.push_back({source.second, s});
+            std::push_heap(heap.begin(), heap.end(), cmp);
+        }
+    }
+
+    // Exit cost of the targets, looked up while settling. There are only the
+    // few satellites a ground station sees, so a linear scan is enough.
+    auto exitCost = [&targets](uint32_t v) {
+        double cost = std::numeric_limits<double>::infinity();
+        for (const auto& target : targets)
+        {
+            if (target.first == v)
+            {
+                cost = std::min(cost, target.second);
+            }
+        }
+        return cost;
+    };
+
+    double best = inf;
+    ingress = SatelliteRouteGraph::INVALID_INDEX;
+    egress = SatelliteRouteGraph::INVALID_INDEX;
+    while (!heap.empty() && heap.front().first < best)
+    {
+        std::pop_heap(heap.begin(), heap.end(), cmp);
+        double d = heap.back().first;
+        uint32_t u = heap.back().second;
+        heap.pop_back();
+        if (d > dist[u]) continue;
+
+        double total = d + exitCost(u);
+        if (total < best)
+        {
+            best = total;
+            ingress = origin[u];
+            egress = u;
+        }
+
+        for (uint32_t e = offsets[u]; e < offsets[u + 1]; ++e)
+        {
+            uint32_t v = edgeTargets[e];
+            double candidate = d + weights[e];
+            if (candidate < dist[v])
+            {
+                if (dist[v] == inf)
+                {
+                    touched.push_back(v);
+                }
+                dist[v] = candidate;
+                origin[v] = origin[u];
+                heap.push_back({candidate, v});
+                std::push_heap(heap.begin(), heap.end(), cmp);
+            }
+        }
+    }
+
+    for (uint32_t v : touched)
+    {
+        dist[v] = inf;
+        origin[v] = SatelliteRouteGraph::INVALID_INDEX;
+    }
+    return best;
+}
+
+void
+ComputeShortestPathTree(const SatelliteRouteGraph& graph,
+                        uint32_t src,
+                        SatelliteShortestPathScratch& scratch,
+                        double* dist,
+                        uint32_t* parent,
+                        uint32_t* parentEdge,
+                        uint32_t* nextHopRow)
+{
+    const uint32_t numVertices = graph.GetNVertices();
+    std::fill(dist, dist + numVertices, std::numeric_limits<double>::max());
+    std::fill(parent, parent + numVertices, SatelliteRouteGraph::INVALID_INDEX);
+    std::fill(parentEdge, parentEdge + numVertices, SatelliteRouteGraph::INVALID_INDEX);
+
+    dist[src] = 0;
+    scratch.heap.clear();
+    scratch.heap.push_back({0.0, src});
+    RelaxTree(graph, 0.0, scratch, dist, parent, parentEdge, nullptr);
+    WriteFirstHops(numVertices, src, parent, scratch, nextHopRow);
+}
+
+uint32_t
+RepairShortestPathTree(const SatelliteRouteGraph& graph,
+                       uint32_t src,
+                       double tolerance,
+                       SatelliteShortestPathScratch& scratch,
+                       double* dist,
+                       uint32_t* parent,
+                       uint32_t* parentEdge,
+                       uint32_t* nextHopRow)
+{
+    const uint32_t numVertices = graph.GetNVertices();
+    const uint32_t* offsets = graph.GetOffsets().data();
+    const uint32_t* targets = graph.GetTargets().data();
+    const double* weights = graph.GetWeights().data();
+
+    // 1. Re-evaluate the old tree with the new weights, parents first. Every
+    //    distance is then the length of an existing path, i.e. an upper bound.
+    //    Subtrees hanging off a failed edge are cut loose.
+    scratch.flags.assign(numVertices, 0);
+    uint8_t* done = scratch.flags.data();
+    auto& stack = scratch.stack;
+    dist[src] = 0;
+    done[src] = 1;
+    for (uint32_t v = 0; v < numVertices; ++v)
+    {
+        uint32_t u = v;
+        stack.clear();
+        while (!done[u] && parent[u] != SatelliteRouteGraph::INVALID_INDEX)
+        {
+            stack.push_back(u);
+            u = parent[u];
+        }
+        if (!done[u])
+        {
+            dist[u] = std::numeric_limits<double>::max();
+            done[u] = 1;
+        }
+        while (!stack.empty())
+        {
+            uint32_t w = stack.back();
+            stack.pop_back();
+            if (dist[parent[w]] == std::numeric_limits<double>::max() || std::isinf(weights[parentEdge[w]]))
+            {
+                dist[w] = std::numeric_limits<double>::max();
+                parent[w] = SatelliteRouteGraph::INVALID_INDEX;
+                parentEdge[w] = SatelliteRouteGraph::INVALID_INDEX;
+            }
+            else
+            {
+                dist[w] = dist[parent[w]] + weights[parentEdge[w]];
+            }
+            done[w] = 1;
+        }
+    }
+
+    // 2. Seed the relaxation with every vertex some edge now improves. Edges out
+    //    of vertices that are not improved later are never looked at again.
+    std::fill(done, done + numVertices, 0);
+    uint8_t* touched = done;
+    auto& heap = scratch.heap;
+    heap.clear();
+    uint32_t repaired = 0;
+    for (uint32_t u = 0; u < numVertices; ++u)
+    {
+        if (dist[u] == std::numeric_limits<double>::max())
+        {
+            continue;
+        }
+        for (uint32_t e = offsets[u]; e < offsets[u + 1]; ++e)
+        {
+            uint32_t v = targets[e];
+            double candidate = dist[u] + weights[e];
+            if (candidate < dist[v] - tolerance)
+            {
+                dist[v] = candidate;
+                parent[v] = u;
+                parentEdge[v] = e;
+                heap.push_back({candidate, v});
+                if (!touched[v])
+                {
+                    touched[v] = 1;
+                    ++repaired;
+                }
+            }
+        }
+    }
+    std::make_heap(heap.begin(), heap.end(), std::greater<HeapElement>());
+
+    // 3. Propagate the improvements, then refresh the first hops from the tree.
+    repaired += RelaxTree(graph, tolerance, scratch, dist, parent, parentEdge, touched);
+    WriteFirstHops(numVertices, src, parent, scratch, nextHopRow);
+    return repaired;
+}
+
+} // namespace ns3
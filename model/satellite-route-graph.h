@@ -0,0 +1,330 @@
+#ifndef SATELLITE_ROUTE_GRAPH_H
+#define SATELLITE_ROUTE_GRAPH_H
+
+#include "satellite-priority-queue.h"
+
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * @ingroup satellite
+ * @brief Inter-satellite link graph in compressed sparse row form.
+ *
+ * The out-edges of vertex u are targets[offsets[u]] .. targets[offsets[u + 1] - 1],
+ * and weights[] runs parallel to targets[]. The topology is built once; only the
+ * weight array is rewritten every epoch, so the shortest path loop touches
+ * nothing but these flat arrays.
+ *
+ * Edges can be marked failed; a failed edge keeps its slot but has an infinite
+ * weight, so no search relaxes it.
+ *
+ * Next to the weights in meters the graph keeps the light-time delay of every
+ * edge in integer nanoseconds, for the integer-key priority queues.
+ */
+class SatelliteRouteGraph
+{
+public:
+    /// Marks a missing vertex or an unreachable destination.
+    static constexpr uint32_t INVALID_INDEX = 0xffffffff;
+
+    SatelliteRouteGraph();
+
+    /**
+     * @brief Build the CSR arrays from adjacency lists.
+     * @param adjacency Out-neighbours of every vertex.
+     */
+    void Build(const std::vector<std::vector<uint32_t>>& adjacency);
+
+    /// Speed of light in vacuum, m/s, used for the edge delays.
+    static constexpr double SPEED_OF_LIGHT = 299792458.0;
+
+    /**
+     * @brief Set every edge weight to the Euclidean distance between its end points.
+     * @param x X coordinates, by vertex.
+     * @param y Y coordinates, by vertex.
+     * @param z Z coordinates, by vertex.
+     */
+    void UpdateWeights(const double* x, const double* y, const double* z);
+
+    /**
+     * @param u The tail vertex.
+     * @param v The head vertex.
+     * @return The index of the edge u -> v, or INVALID_INDEX if there is none.
+     */
+    uint32_t FindEdge(uint32_t u, uint32_t v) const;
+
+    /**
+     * @brief Mark an edge failed or repaired. Takes effect on the weights at once.
+     *
+     * The weight of a repaired edge is restored by the next UpdateWeights().
+     * @param e An edge index.
+     * @param failed Whether the edge is failed.
+     */
+    void SetEdgeFailed(uint32_t e, bool failed);
+
+    bool IsEdgeFailed(uint32_t e) const;
+
+    /**
+     * @return The number of edges currently marked failed.
+     */
+    uint32_t GetNFailedEdges() const;
+
+    uint32_t GetNVertices() const;
+    uint32_t GetNEdges() const;
+
+    const std::vector<uint32_t>& GetOffsets() const;
+    const std::vector<uint32_t>& GetTargets() const;
+    const std::vector<double>& GetWeights() const;
+
+    /**
+     * @return Light-time delay of every edge in nanoseconds, parallel to the
+     *         weights. Failed edges have the maximum uint64_t value.
+     */
+    const std::vector<uint64_t>& GetDelays() const;
+
+    /**
+     * @return The largest delay of an edge that is not failed.
+     */
+    uint64_t GetMaxDelay() const;
+
+private:
+    void UpdateDelays();
+
+    std::vector<uint32_t> m_offsets; //!< Size V + 1
+    std::vector<uint32_t> m_targets; //!< Size E
+    std::vector<double> m_weights;   //!< Size E, parallel to m_targets
+    std::vector<uint64_t> m_delays;  //!< Size E, parallel to m_targets, in ns
+    uint64_t m_maxDelay;
+    std::vector<uint8_t> m_failed;   //!< Size E, parallel to m_targets
+    uint32_t m_numFailed;            //!< Number of set entries in m_failed
+};
+
+/**
+ * @ingroup satellite
+ * @brief Reusable buffers for one single-source shortest path search.
+ *
+ * Keep one instance per thread; after the first search on a graph of a given
+ * size, further searches do not allocate.
+ */
+struct SatelliteShortestPathScratch
+{
+    std::vector<double> dist;                         //!< Tentative distances
+    std::vector<uint32_t> firstHop;                   //!< First hop from the source
+    std::vector<std::pair<double, uint32_t>> heap;    //!< Binary min-heap storage
+    std::vector<uint8_t> flags;                       //!< Per-vertex marks for tree repair
+    std::vector<uint32_t> stack;                      //!< Path stack for tree walks
+    std::vector<uint64_t> delay;                      //!< Tentative delays, integer-key queues
+    SatelliteRadixHeap radixHeap;                     //!< Queue for the radix heap policy
+    SatelliteDialQueue dialQueue;                     //!< Queue for the Dial policy
+};
+
+/**
+ * @ingroup satellite
+ * @brief Reusable buffers for single-pair searches with FindShortestPath().
+ *
+ * Only the vertices a search touched are reset afterwards, so the cost of a
+ * query does not depend on the size of the graph.
+ */
+struct SatellitePairSearchScratch
+{
+    std::vector<double> dist[2];                      //!< Forward and backward distances
+    std::vector<uint32_t> parent[2];                  //!< Forward and backward search trees
+    std::vector<std::pair<double, uint32_t>> heap[2]; //!< Forward and backward heaps
+    std::vector<uint32_t> touched;                    //!< Vertices to reset after the search
+};
+
+/**
+ * @brief Find one shortest path between two vertices with bidirectional A*.
+ *
+ * Both searches are guided by the straight-line distance to their target,
+ * which never overestimates since every edge weight is the straight-line
+ * length of the link. The two heuristics are averaged into one consistent
+ * potential, so the searches can stop as soon as their frontiers meet.
+ *
+ * Links are assumed bidirectional with the same weight both ways, as for
+ * inter-satellite links: the backward search walks the out-edges.
+ * @param graph The graph, with weights of the current epoch.
+ * @param x X coordinates of the vertices, as given to UpdateWeights().
+ * @param y Y coordinates.
+ * @param z Z coordinates.
+ * @param src The source vertex.
+ * @param dst The destination vertex.
+ * @param scratch Search buffers.
+ * @param path Output, the vertices from src to dst inclusive; empty if dst is unreachable.
+ * @return The number of vertices settled by both searches together.
+ */
+uint32_t FindShortestPath(const SatelliteRouteGraph& graph,
+                          const double* x,
+                          const double* y,
+                          const double* z,
+                          uint32_t src,
+                          uint32_t dst,
+                          SatellitePairSearchScratch& scratch,
+                          std::vector<uint32_t>& path);
+
+/**
+ * @brief Find the cheapest path from any of several sources to any of several targets.
+ *
+ * Every source enters the search with its own start cost and every target adds
+ * its own exit cost, e.g. the uplink and downlink lengths between two ground
+ * stations and the satellites they see. The search is one Dijkstra seeded with
+ * all the sources, which stops as soon as no unsettled vertex can beat the best
+ * total found so far.
+ * @param graph The graph, with weights of the current epoch.
+ * @param sources Source vertices with their start costs.
+ * @param targets Target vertices with their exit costs.
+ * @param scratch Search buffers. Only the forward side is used.
+ * @param ingress Output, the source the best path starts from.
+ * @param egress Output, the target the best path ends at.
+ * @return The total cost of the best path including start and exit costs, or
+ *         infinity if no target is reachable; ingress and egress are then
+ *         INVALID_INDEX.
+ */
+double FindShortestPathBetweenSets(const SatelliteRouteGraph& graph,
+                                   const std::vector<std::pair<uint32_t, double>>& sources,
+                                   const std::vector<std::pair<uint32_t, double>>& targets,
+                                   SatellitePairSearchScratch& scratch,
+                                   uint32_t& ingress,
+                                   uint32_t& egress);
+
+/**
+ * @brief Run Dijkstra from one source and write the first hop towards every vertex.
+ * @param graph The graph, with weights of the current epoch.
+ * @param src The source vertex.
+ * @param scratch Per-thread buffers.
+ * @param nextHopRow Output, GetNVertices() entries. INVALID_INDEX for the source
+ *        itself and for unreachable vertices.
+ */
+void ComputeShortestPathFirstHops(const SatelliteRouteGraph& graph,
+                                  uint32_t src,
+                                  SatelliteShortestPathScratch& scratch,
+                                  uint32_t* nextHopRow);
+
+/**
+ * @brief Run Dijkstra from one source with a given priority queue policy.
+ *
+ * See satellite-priority-queue.h for the policies. Double-keyed queues search
+ * on the weights in meters, integer-keyed ones on the delays in nanoseconds.
+ * @param graph The graph, with weights of the current epoch.
+ * @param src The source vertex.
+ * @param queue The queue, reset by the search.
+ * @param dist Buffer for the distances, resized by the search.
+ * @param firstHop Buffer for the first hops, resized by the search.
+ * @param nextHopRow Output, GetNVertices() entries. INVALID_INDEX for the source
+ *        itself and for unreachable vertices.
+ */
+template <typename Queue>
+void
+ComputeShortestPathFirstHops(const SatelliteRouteGraph& graph,
+                             uint32_t src,
+                             Queue& queue,
+                             std::vector<typename Queue::Key>& dist,
+                             std::vector<uint32_t>& firstHop,
+                             uint32_t* nextHopRow)
+{
+    typedef typename Queue::Key Key;
+    const uint32_t numVertices = graph.GetNVertices();
+    const uint32_t* offsets = graph.GetOffsets().data();
+    const uint32_t* targets = graph.GetTargets().data();
+    const Key* weights;
+    Key maxEdge;
+    if constexpr (std::is_integral<Key>::value)
+    {
+        weights = graph.GetDelays().data();
+        maxEdge = graph.GetMaxDelay();
+    }
+    else
+    {
+        weights = graph.GetWeights().data();
+        maxEdge = 0;
+    }
+
+    dist.assign(numVertices, Queue::INFINITE_KEY);
+    firstHop.assign(numVertices, SatelliteRouteGraph::INVALID_INDEX);
+    queue.Reset(numVertices, maxEdge);
+
+    dist[src] = 0;
+    queue.Update(src, 0);
+    while (!queue.Empty())
+    {
+        Key d;
+        uint32_t u = queue.Pop(d);
+        if (d > dist[u]) continue;
+
+        for (uint32_t e = offsets[u]; e < offsets[u + 1]; ++e)
+        {
+            if (weights[e] == Queue::INFINITE_KEY) continue;
+            uint32_t v = targets[e];
+            Key candidate = d + weights[e];
+            if (candidate < dist[v])
+            {
+                dist[v] = candidate;
+                firstHop[v] = (u == src) ? v : firstHop[u];
+                queue.Update(v, candidate);
+            }
+        }
+    }
+
+    std::copy(firstHop.begin(), firstHop.end(), nextHopRow);
+}
+
+/**
+ * @brief Run Dijkstra from one source and keep the shortest path tree.
+ *
+ * Same first hops as ComputeShortestPathFirstHops(), plus the tree needed by
+ * RepairShortestPathTree() in the next epoch.
+ * @param graph The graph, with weights of the current epoch.
+ * @param src The source vertex.
+ * @param scratch Per-thread buffers.
+ * @param dist Output, distance of every vertex from src.
+ * @param parent Output, tree parent of every vertex, INVALID_INDEX for the source
+ *        and unreachable vertices.
+ * @param parentEdge Output, edge index of the tree edge into every vertex.
+ * @param nextHopRow Output, first hop towards every vertex.
+ */
+void ComputeShortestPathTree(const SatelliteRouteGraph& graph,
+                             uint32_t src,
+                             SatelliteShortestPathScratch& scratch,
+                             double* dist,
+                             uint32_t* parent,
+                             uint32_t* parentEdge,
+                             uint32_t* nextHopRow);
+
+/**
+ * @brief Bring the previous epoch's shortest path tree up to date with new weights.
+ *
+ * Distances are first re-evaluated along the old tree, which gives valid upper
+ * bounds. Every vertex with an incoming edge that improves on its bound by more
+ * than the tolerance seeds a Dijkstra-ordered relaxation, which only visits the
+ * part of the tree that actually changes. With a tolerance of 0 the
+ * distances are exact, although ties may resolve differently than in a fresh
+ * search; otherwise a path is only replaced when the new one is shorter by more
+ * than the tolerance.
+ * @param graph The graph, with weights of the current epoch. Same topology as
+ *        when the tree was built.
+ * @param src The source vertex.
+ * @param tolerance Improvements of at most this much are ignored.
+ * @param scratch Per-thread buffers.
+ * @param dist In/out, distances of the previous epoch, updated.
+ * @param parent In/out, tree of the previous epoch, updated.
+ * @param parentEdge In/out, tree edges of the previous epoch, updated.
+ * @param nextHopRow Output, first hop towards every vertex.
+ * @return The number of repaired vertices, i.e. vertices whose distance had to be
+ *         lowered by the relaxation and which may have moved in the tree.
+ */
+uint32_t RepairShortestPathTree(const SatelliteRouteGraph& graph,
+                                uint32_t src,
+                                double tolerance,
+                                SatelliteShortestPathScratch& scratch,
+                                double* dist,
+                                uint32_t* parent,
+                                uint32_t* parentEdge,
+                                uint32_t* nextHopRow);
+
+} // namespace ns3
+
+#endif /* SATELLITE_ROUTE_GRAPH_H */
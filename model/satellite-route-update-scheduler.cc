@@ -0,0 +1,273 @@
+#include "satellite-route-update-scheduler.h"
+#include "ns3/boolean.h"
+#include "ns3/log.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE("SatelliteRouteUpdateScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED(SatelliteRouteUpdateScheduler);
+
+Ptr<SatelliteRouteUpdateScheduler> SatelliteRouteUpdateScheduler::m_instance;
+
+TypeId
+SatelliteRouteUpdateScheduler::GetTypeId(void)
+{
+    static TypeId tid = TypeId("ns3::SatelliteRouteUpdateScheduler")
+        .SetParent<Object>()
+        .SetGroupName("Satellite")
+        .AddConstructor<SatelliteRouteUpdateScheduler>()
+        .AddAttribute("Interval",
+                      "Time between route update epochs.",
+                      TimeValue(Seconds(1.0)),
+                      MakeTimeAccessor(&SatelliteRouteUpdateScheduler::m_interval),
+                      MakeTimeChecker(Seconds(0)))
+        .AddAttribute("StartDelay",
+                      "Delay from the first registration to the first epoch.",
+                      TimeValue(Seconds(0.1)),
+                      MakeTimeAccessor(&SatelliteRouteUpdateScheduler::m_startDelay),
+                      MakeTimeChecker(Seconds(0)))
+        .AddAttribute("AdaptiveInterval",
+                      "Stretch the interval while epochs produce unchanged routes and shrink "
+                      "it when they change or a topology event is predicted. Interval is the "
+                      "first choice.",
+                      BooleanValue(false),
+                      MakeBooleanAccessor(&SatelliteRouteUpdateScheduler::m_adaptive),
+                      MakeBooleanChecker())
+        .AddAttribute("MinInterval",
+                      "Shortest interval AdaptiveInterval may choose.",
+                      TimeValue(Seconds(0.1)),
+                      MakeTimeAccessor(&SatelliteRouteUpdateScheduler::m_minInterval),
+                      MakeTimeChecker(Seconds(0)))
+        .AddAttribute("MaxInterval",
+                      "Longest interval AdaptiveInterval may choose.",
+                      TimeValue(Seconds(10.0)),
+                      MakeTimeAccessor(&SatelliteRouteUpdateScheduler::m_maxInterval),
+                      MakeTimeChecker(Seconds(0)))
+        .AddTraceSource("CurrentInterval",
+                        "Time from the last epoch to the next one.",
+                        MakeTraceSourceAccessor(&SatelliteRouteUpdateScheduler::m_currentInterval),
+                        "ns3::TracedValueCallback::Time");
+    return tid;
+}
+
+SatelliteRouteUpdateScheduler::SatelliteRouteUpdateScheduler()
+    : m_nextId(0),
+      m_nRemoved(0),
+      m_firing(false),
+      m_interval(Seconds(1.0)),
+      m_startDelay(Seconds(0.1)),
+      m_scheduled(false),
+      m_adaptive(false),
+      m_minInterval(Seconds(0.1)),
+      m_maxInterval(Seconds(10.0)),
+      m_currentInterval(Seconds(1.0)),
+      m_reported(false),
+      m_routesChanged(false),
+      m_nextEvent(Time::Max()),
+      m_started(false)
+{
+}
+
+SatelliteRouteUpdateScheduler::~SatelliteRouteUpdateScheduler()
+{
+}
+
+Ptr<SatelliteRouteUpdateScheduler>
+SatelliteRouteUpdateScheduler::Get()
+{
+    if (!m_instance)
+    {
+        m_instance = CreateObject<SatelliteRouteUpdateScheduler>();
+        Simulator::ScheduleDestroy(&SatelliteRouteUpdateScheduler::DestroyInstance);
+    }
+    return m_instance;
+}
+
+void
+SatelliteRouteUpdateScheduler::DestroyInstance()
+{
+    // Drop the epoch grid and the callbacks of the finished simulation
+    if (m_instance)
+    {
+        m_instance->Dispose();
+        m_instance = nullptr;
+    }
+}
+
+void
+SatelliteRouteUpdateScheduler::DoDispose()
+{
+    m_event.Cancel();
+    m_scheduled = false;
+    m_clients.clear();
+    Object::DoDispose();
+}
+
+uint32_t
+SatelliteRouteUpdateScheduler::Add(UpdateCallback update)
+{
+    uint32_t id = m_nextId++;
+    m_clients.push_back({id, update});
+    if (!m_scheduled)
+    {
+        m_event = Simulator::Schedule(m_startDelay, &SatelliteRouteUpdateScheduler::Fire, this);
+        m_scheduled = true;
+        m_currentInterval = m_interval;
+        if (!m_started)
+        {
+            m_firstEpoch = Simulator::Now() + m_startDelay;
+            m_started = true;
+        }
+    }
+    return id;
+}
+
+void
+SatelliteRouteUpdateScheduler::Remove(uint32_t id)
+{
+    auto it = std::find_if(m_clients.begin(), m_clients.end(),
+                           [id](const std::pair<uint32_t, UpdateCallback>& c) { return c.first == id; });
+    if (it == m_clients.end() || it->second.IsNull())
+    {
+        return;
+    }
+
+    if (m_firing)
+    {
+        // Keep indices stable for the running loop
+        it->second = UpdateCallback();
+        ++m_nRemoved;
+        return;
+    }
+    m_clients.erase(it);
+    if (m_clients.empty() && m_scheduled)
+    {
+        m_event.Cancel();
+        m_scheduled = false;
+    }
+}
+
+void
+SatelliteRouteUpdateScheduler::Fire()
+{
+    NS_LOG_DEBUG("Route update epoch at " << Simulator::Now().GetSeconds() << "s for "
+                 << m_clients.size() << " instances");
+
+    m_lastEpoch = Simulator::Now();
+
+    m_firing = true;
+    // Updates may register new clients; those run from the next epoch on.
+    size_t numClients = m_clients.size();
+    for (size_t i = 0; i < numClients; ++i)
+    {
+        // A copy, so that an update may remove itself
+        UpdateCallback update = m_clients[i].second;
+        if (!update.IsNull())
+        {
+            update();
+        }
+    }
+    m_firing = false;
+
+    if (m_nRemoved)
+    {
+        m_clients.erase(std::remove_if(m_clients.begin(), m_clients.end(),
+                                       [](const std::pair<uint32_t, UpdateCallback>& c) { return c.second.IsNull(); }),
+                        m_clients.end());
+        m_nRemoved = 0;
+    }
+
+    // Reports from here on, lazy clients' between epochs included, count
+    // towards the next choice
+    Time interval = ChooseInterval();
+    m_reported = false;
+    m_routesChanged = false;
+    m_nextEvent = Time::Max();
+
+    if (m_clients.empty())
+    {
+        m_scheduled = false;
+        return;
+    }
+    m_currentInterval = interval;
+    m_event = Simulator::Schedule(m_currentInterval, &SatelliteRouteUpdateScheduler::Fire, this);
+}
+
+Time
+SatelliteRouteUpdateScheduler::ChooseInterval() const
+{
+    if (!m_adaptive)
+    {
+        return m_interval;
+    }
+    if (!m_reported)
+    {
+        return m_currentInterval;
+    }
+
+    Time next = m_routesChanged ? m_currentInterval.Get() / 2 : m_currentInterval.Get() * 2;
+    if (m_nextEvent != Time::Max() && m_nextEvent - m_lastEpoch < next)
+    {
+        // Land the next epoch just after the predicted event
+        next = m_nextEvent - m_lastEpoch;
+    }
+    next = std::max(m_minInterval, std::min(m_maxInterval, next));
+    NS_LOG_LOGIC("Routes " << (m_routesChanged ? "changed" : "unchanged") << ", next event in "
+                 << (m_nextEvent - m_lastEpoch).GetSeconds() << "s, next epoch in " << next.GetSeconds() << "s");
+    return next;
+}
+
+void
+SatelliteRouteUpdateScheduler::ReportEpoch(bool routesChanged, Time timeToNextEvent)
+{
+    m_reported = true;
+    m_routesChanged = m_routesChanged || routesChanged;
+    if (timeToNextEvent != Time::Max())
+    {
+        m_nextEvent = std::min(m_nextEvent, m_lastEpoch + timeToNextEvent);
+    }
+}
+
+Time
+SatelliteRouteUpdateScheduler::GetInterval() const
+{
+    return m_interval;
+}
+
+uint32_t
+SatelliteRouteUpdateScheduler::GetNClients() const
+{
+    return m_clients.size();
+}
+
+Time
+SatelliteRouteUpdateScheduler::GetCurrentInterval() const
+{
+    return m_currentInterval;
+}
+
+Time
+SatelliteRouteUpdateScheduler::GetEpochStart(Time now) const
+{
+    if (m_adaptive && m_scheduled && now >= m_lastEpoch && m_lastEpoch >= m_firstEpoch)
+    {
+        return m_lastEpoch;
+    }
+    Time first = m_started ? m_firstEpoch : m_startDelay;
+    if (now < first)
+    {
+        return Time(0);
+    }
+    if (m_interval.IsZero())
+    {
+        return now;
+    }
+    return now - Rem(now - first, m_interval);
+}
+
+} // namespace ns3
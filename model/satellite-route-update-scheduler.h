@@ -0,0 +1,135 @@
+#ifndef SATELLITE_ROUTE_UPDATE_SCHEDULER_H
+#define SATELLITE_ROUTE_UPDATE_SCHEDULER_H
+
+#include "ns3/callback.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/traced-value.h"
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * @ingroup satellite
+ * @brief Constellation-wide route update clock.
+ *
+ * Routing protocol instances register an update callback instead of running
+ * their own timers. One simulator event per epoch then runs every callback in
+ * registration order, so the scheduler holds a single pending event no matter
+ * how many satellites there are.
+ *
+ * With AdaptiveInterval the time to the next epoch is chosen after every epoch
+ * from what the clients report through ReportEpoch(): it doubles while epochs
+ * keep producing the same routes, halves when they change, and is cut short so
+ * that an epoch falls on the next predicted topology event. It always stays
+ * within [MinInterval, MaxInterval], and the CurrentInterval trace source
+ * shows every choice.
+ */
+class SatelliteRouteUpdateScheduler : public Object
+{
+public:
+    static TypeId GetTypeId(void);
+    SatelliteRouteUpdateScheduler();
+    ~SatelliteRouteUpdateScheduler() override;
+
+    /// Per-instance update function.
+    typedef Callback<void> UpdateCallback;
+
+    /**
+     * @return The process-wide scheduler, created on first use.
+     *
+     * The instance is disposed by Simulator::Destroy(), so a later simulation
+     * in the same process gets a fresh clock with no registered callbacks.
+     */
+    static Ptr<SatelliteRouteUpdateScheduler> Get();
+
+    /**
+     * @brief Register an update callback. Starts the clock on the first registration.
+     * @param update Called once per epoch.
+     * @return An id for Remove().
+     */
+    uint32_t Add(UpdateCallback update);
+
+    /**
+     * @brief Unregister an update callback. Safe to call from inside an update.
+     * @param id The id returned by Add().
+     */
+    void Remove(uint32_t id);
+
+    /**
+     * @return The configured time between epochs.
+     */
+    Time GetInterval() const;
+
+    /**
+     * @return The time from the last epoch to the next one. Equal to
+     *         GetInterval() unless AdaptiveInterval is set.
+     */
+    Time GetCurrentInterval() const;
+
+    /**
+     * @brief Report the outcome of the last epoch.
+     *
+     * Reports made from the update callbacks of an epoch decide the interval
+     * after it. Clients that update outside the callbacks (lazy updates)
+     * report when they do; those reports count towards the interval chosen at
+     * the next epoch. Changes are or-ed and the earliest event counts.
+     * @param routesChanged Whether the routes differ from the previous epoch.
+     * @param timeToNextEvent Predicted time from the start of the last epoch to
+     *        the next topology change, or Time::Max() if none is known.
+     */
+    void ReportEpoch(bool routesChanged, Time timeToNextEvent);
+
+    /**
+     * @return The number of registered callbacks.
+     */
+    uint32_t GetNClients() const;
+
+    /**
+     * @brief Map a time to the start of the epoch it falls in.
+     *
+     * Epochs are StartDelay after the first registration and then every
+     * Interval; without any registration the clock is taken to start at time 0.
+     * This lets instances that do not register (lazy updates) agree with the
+     * epoch grid. Times before the first epoch map to time 0. While an adaptive
+     * clock is running, the start of the last epoch is returned instead.
+     * @param now A simulation time.
+     * @return The epoch start.
+     */
+    Time GetEpochStart(Time now) const;
+
+protected:
+    void DoDispose() override;
+
+private:
+    static void DestroyInstance();
+    void Fire();
+    Time ChooseInterval() const;
+
+    std::vector<std::pair<uint32_t, UpdateCallback>> m_clients; //!< Registration order
+    uint32_t m_nextId;
+    uint32_t m_nRemoved;      //!< Entries removed while firing, compacted afterwards
+    bool m_firing;
+    Time m_interval;
+    Time m_startDelay;
+    EventId m_event;
+    bool m_scheduled;
+    bool m_adaptive;
+    Time m_minInterval;
+    Time m_maxInterval;
+    TracedValue<Time> m_currentInterval; //!< Time to the next epoch
+    Time m_lastEpoch;         //!< Time of the last epoch
+    bool m_reported;          //!< Whether a client reported since the interval was last chosen
+    bool m_routesChanged;     //!< Or of those reports
+    Time m_nextEvent;         //!< Earliest event of those reports, or Time::Max()
+    Time m_firstEpoch;        //!< Time of the first epoch
+    bool m_started;           //!< Whether m_firstEpoch has been fixed by a registration
+
+    static Ptr<SatelliteRouteUpdateScheduler> m_instance;
+};
+
+} // namespace ns3
+
+#endif /* SATELLITE_ROUTE_UPDATE_SCHEDULER_H */
@@ -4,12 +4,15 @@
 #include "ns3/ipv4-header.h"
 #include "ns3/mobility-model.h"
 #include "satellite-circular-mobility-model.h"
+#include "satellite-route-update-scheduler.h"
 #include "ns3/constant-position-mobility-model.h"
 #include "ns3/point-to-point-net-device.h"
 #include "ns3/simulator.h"
 #include "ns3/channel.h"
 #include "ns3/core-module.h"
 
+#include <algorithm>
+
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE("SatelliteRoutingProtocol");
@@ -24,7 +27,8 @@ CrossProduct(const Vector& a, const Vector& b) {
 }
 
 // Initialize the static map
-std::map<Ipv4Address, Ptr<Node>> SatelliteRoutingProtocol::m_ipToNodeMap;
+SatelliteAddressTable SatelliteRoutingProtocol::m_ipToNode;
+SatelliteSpatialIndex SatelliteRoutingProtocol::m_spatialIndex;
 
 TypeId
 SatelliteRoutingProtocol::GetTypeId(void)
@@ -37,14 +41,11 @@ SatelliteRoutingProtocol::GetTypeId(void)
 }
 
 SatelliteRoutingProtocol::SatelliteRoutingProtocol() 
-    : m_updateInterval(Seconds(1.0)), m_maxNeighbors(6)
+    : m_maxNeighbors(6), m_updateId(0), m_updateRegistered(false)
 {
-    // Set the callback function for our timer. This is done only once.
-    m_updateTimer.SetFunction(&SatelliteRoutingProtocol::UpdateActiveNeighbors, this);
 }
 
 SatelliteRoutingProtocol::~SatelliteRoutingProtocol() {
-    m_updateTimer.Cancel();
 }
 
 void
@@ -60,7 +61,13 @@ SatelliteRoutingProtocol::DoInitialize()
     }
     else
     {
-        // This is a ground station, do not start the timer
+        // This is a ground station, do not register for updates; a link
+        // change (e.g. an on-demand ground link) invalidates its uplink
+        for (uint32_t i = 1; i < m_ipv4->GetNInterfaces(); ++i)
+        {
+            m_ipv4->GetNetDevice(i)->AddLinkChangeCallback(
+                MakeCallback(&SatelliteRoutingProtocol::InvalidateUplink, this));
+        }
         Ipv4RoutingProtocol::DoInitialize();
     }
 }
@@ -68,6 +75,11 @@ SatelliteRoutingProtocol::DoInitialize()
 void
 SatelliteRoutingProtocol::DoDispose()
 {
+    if (m_updateRegistered)
+    {
+        SatelliteRouteUpdateScheduler::Get()->Remove(m_updateId);
+        m_updateRegistered = false;
+    }
     m_orbitalPlanes.reset();
     Ipv4RoutingProtocol::DoDispose();
 }
@@ -75,14 +87,17 @@ SatelliteRoutingProtocol::DoDispose()
 void
 SatelliteRoutingProtocol::Start()
 {
-    m_updateTimer.Schedule(Seconds(0.1));
+    // Neighbors are refreshed by the shared per-epoch update event
+    m_updateId = SatelliteRouteUpdateScheduler::Get()->Add(
+        MakeCallback(&SatelliteRoutingProtocol::UpdateActiveNeighbors, this));
+    m_updateRegistered = true;
 }
 
 
 void
 SatelliteRoutingProtocol::AddIpToNodeMapping(Ipv4Address ip, Ptr<Node> node)
 {
-    m_ipToNodeMap[ip] = node;
+    m_ipToNode.Insert(ip, node);
 }
 
 void
@@ -101,13 +116,8 @@ SatelliteRoutingProtocol::AddIpToNodeMapping(const NodeContainer& allSatellites)
 void
 SatelliteRoutingProtocol::ClearIpToNodeMapping()
 {
-    m_ipToNodeMap.clear();
-}
-
-const std::map<Ipv4Address, Ptr<Node>>&
-SatelliteRoutingProtocol::GetIpToNodeMap()
-{
-    return m_ipToNodeMap;
+    m_ipToNode.Clear();
+    m_spatialIndex.SetSatellites({});
 }
 
 void
@@ -123,6 +133,106 @@ SatelliteRoutingProtocol::SetOrbitalPlanes(
     m_orbitalPlanes = orbitalPlanes;
 }
 
+const SatelliteSpatialIndex&
+SatelliteRoutingProtocol::GetSpatialIndex()
+{
+    if (m_spatialIndex.GetN() == 0)
+    {
+        // Index the constellation as given by the orbital planes, or every
+        // satellite node of the simulation when no planes were set.
+        std::vector<Ptr<Node>> satellites;
+        if (m_orbitalPlanes)
+        {
+            for (const NodeContainer& plane : *m_orbitalPlanes)
+            {
+                satellites.insert(satellites.end(), plane.Begin(), plane.End());
+            }
+        }
+        else
+        {
+            NodeContainer nodes = NodeContainer::GetGlobal();
+            for (auto it = nodes.Begin(); it != nodes.End(); ++it)
+            {
+                if ((*it)->GetObject<SatelliteCircularMobilityModel>())
+                {
+                    satellites.push_back(*it);
+                }
+            }
+        }
+        m_spatialIndex.SetSatellites(satellites);
+    }
+
+    // Positions are refreshed at most once per update interval.
+    Time now = Simulator::Now();
+    if (!m_spatialIndex.IsValid() || now - m_spatialIndex.GetEpochTime() >= SatelliteRouteUpdateScheduler::Get()->GetInterval())
+    {
+        m_spatialIndex.Update(now);
+    }
+    return m_spatialIndex;
+}
+
+void
+SatelliteRoutingProtocol::BuildUplinkDevices()
+{
+    m_uplinkDevice.assign(m_spatialIndex.GetN(), nullptr);
+    for (uint32_t i = 1; i < m_ipv4->GetNInterfaces(); ++i)
+    {
+        Ptr<NetDevice> dev = m_ipv4->GetNetDevice(i);
+        Ptr<Channel> ch = dev->GetChannel();
+        if (ch && ch->GetNDevices() == 2)
+        {
+            Ptr<NetDevice> peerDev = (ch->GetDevice(0) == dev) ? ch->GetDevice(1) : ch->GetDevice(0);
+            uint32_t item = peerDev ? m_spatialIndex.GetItem(peerDev->GetNode()) : SatelliteSpatialIndex::INVALID_INDEX;
+            if (item != SatelliteSpatialIndex::INVALID_INDEX)
+            {
+                m_uplinkDevice[item] = dev;
+            }
+        }
+    }
+}
+
+void
+SatelliteRoutingProtocol::InvalidateUplink()
+{
+    m_uplinkDevice.clear();
+    m_uplinkCache = nullptr;
+}
+
+Ptr<Ipv4Route>
+SatelliteRoutingProtocol::SelectUplink()
+{
+    // Find the satellite neighbor that is closest to this ground station
+    const SatelliteSpatialIndex& index = GetSpatialIndex();
+    if (m_uplinkDevice.size() != index.GetN())
+    {
+        BuildUplinkDevices();
+    }
+    Vector position = m_ipv4->GetObject<MobilityModel>()->GetPosition();
+    uint32_t item = index.FindNearest(position, [this](uint32_t i) { return m_uplinkDevice[i] != nullptr; });
+    Ptr<NetDevice> bestDevice = (item != SatelliteSpatialIndex::INVALID_INDEX) ? m_uplinkDevice[item] : nullptr;
+    if (!bestDevice)
+    {
+        return nullptr;
+    }
+
+    // The gateway is the IP of the peer satellite, which handles the packet from there.
+    Ptr<Channel> ch = bestDevice->GetChannel();
+    Ptr<NetDevice> peerDev = (ch->GetDevice(0) == bestDevice) ? ch->GetDevice(1) : ch->GetDevice(0);
+    NS_LOG_INFO("  -> Closest satellite is Node " << peerDev->GetNode()->GetId() << " at distance "
+                << CalculateDistance(position, index.GetPosition(item)));
+
+    Ptr<Ipv4> peerIpv4 = peerDev->GetNode()->GetObject<Ipv4>();
+    int32_t peerIfIndex = peerIpv4->GetInterfaceForDevice(peerDev);
+    Ipv4Address gateway = peerIpv4->GetAddress(peerIfIndex, 0).GetLocal();
+
+    Ptr<Ipv4Route> route = Create<Ipv4Route>();
+    route->SetDestination(gateway);
+    route->SetSource(m_ipv4->GetAddress(m_ipv4->GetInterfaceForDevice(bestDevice), 0).GetLocal());
+    route->SetGateway(gateway);
+    route->SetOutputDevice(bestDevice);
+    return route;
+}
+
 void
 SatelliteRoutingProtocol::PrintRoutingTable(Ptr<OutputStreamWrapper> stream, Time::Unit unit) const
 {
@@ -138,9 +248,15 @@ SatelliteRoutingProtocol::PrintRoutingTable(Ptr<OutputStreamWrapper> stream, Tim
 }
 
 void
-SatelliteRoutingProtocol::NotifyInterfaceUp(uint32_t i) { }
+SatelliteRoutingProtocol::NotifyInterfaceUp(uint32_t i)
+{
+    InvalidateUplink();
+}
 void
-SatelliteRoutingProtocol::NotifyInterfaceDown(uint32_t i) { }
+SatelliteRoutingProtocol::NotifyInterfaceDown(uint32_t i)
+{
+    InvalidateUplink();
+}
 void
 SatelliteRoutingProtocol::NotifyAddAddress(uint32_t i, Ipv4InterfaceAddress a) { }
 void
@@ -318,59 +434,29 @@ SatelliteRoutingProtocol::RouteOutput(Ptr<Packet> p, const Ipv4Header &header, P
                 << ": Packet from " << header.GetSource() 
                 << " to " << header.GetDestination());
 
-    auto it = m_ipToNodeMap.find(header.GetDestination());
-    if (it == m_ipToNodeMap.end()) {
+    Ptr<Node> destNode = m_ipToNode.Find(header.GetDestination());
+    if (!destNode) {
         NS_LOG_WARN("  -> Destination " << header.GetDestination() << " not found in IP-to-Node map.");
         sockerr = Socket::ERROR_NOROUTETOHOST;
         return nullptr;
     }
-    Ptr<Node> destNode = it->second;
     NS_LOG_INFO("  -> Destination Node ID: " << destNode->GetId());
     
     // Case 1: Current node is a Ground Station
     if (thisNode->GetObject<ConstantPositionMobilityModel>()) {
         NS_LOG_INFO("  -> Current node is a Ground Station. Finding closest satellite to forward to.");
 
-        double minDistance = -1.0;
-        Ptr<NetDevice> bestDevice = nullptr;
-        
-        // Find the satellite neighbor that is closest to this ground station
-        for (uint32_t i = 1; i < m_ipv4->GetNInterfaces(); ++i) {
-            Ptr<NetDevice> dev = m_ipv4->GetNetDevice(i);
-            Ptr<Channel> ch = dev->GetChannel();
-            if (ch && ch->GetNDevices() == 2) {
-                Ptr<NetDevice> peerDev = (ch->GetDevice(0) == dev) ? ch->GetDevice(1) : ch->GetDevice(0);
-                Ptr<Node> peerNode = peerDev->GetNode();
-
-                // Ensure the peer is a satellite
-                if (peerNode && peerNode->GetObject<SatelliteCircularMobilityModel>()) {
-                    double dist = thisNode->GetObject<MobilityModel>()->GetDistanceFrom(peerNode->GetObject<MobilityModel>());
-                    if (minDistance < 0 || dist < minDistance) {
-                        minDistance = dist;
-                        bestDevice = dev;
-                    }
-                }
-            }
+        // The uplink only changes when the satellite positions are refreshed
+        // or a link changes, not with every packet
+        const SatelliteSpatialIndex& index = GetSpatialIndex();
+        if (!m_uplinkCache || m_uplinkEpoch != index.GetEpochTime())
+        {
+            m_uplinkCache = SelectUplink();
+            m_uplinkEpoch = index.GetEpochTime();
         }
-
-        if (bestDevice) {
-            // The gateway is the destination itself since we assume the satellite can handle it from there.
-            // Or more correctly, the IP of the peer satellite.
-            Ptr<Channel> ch = bestDevice->GetChannel();
-            Ptr<NetDevice> peerDev = (ch->GetDevice(0) == bestDevice) ? ch->GetDevice(1) : ch->GetDevice(0);
-            NS_LOG_INFO("  -> Closest satellite is Node " << peerDev->GetNode()->GetId() << " at distance " << minDistance);
-            
-            Ptr<Ipv4Route> route = Create<Ipv4Route>();
-            route->SetDestination(header.GetDestination());
-            route->SetSource(m_ipv4->GetAddress(m_ipv4->GetInterfaceForDevice(bestDevice), 0).GetLocal());
-            
-            Ptr<Ipv4> peerIpv4 = peerDev->GetNode()->GetObject<Ipv4>();
-            int32_t peerIfIndex = peerIpv4->GetInterfaceForDevice(peerDev);
-            Ipv4Address gateway = peerIpv4->GetAddress(peerIfIndex, 0).GetLocal();
-
-            route->SetGateway(gateway);
-            route->SetOutputDevice(bestDevice);
-            return route;
+        if (m_uplinkCache)
+        {
+            return m_uplinkCache;
         }
 
         NS_LOG_WARN("  -> Ground station has no satellite links to forward packet.");
@@ -6,8 +6,8 @@
 #include "ns3/node.h"
 #include "ns3/node-container.h"
 #include "ns3/output-stream-wrapper.h"
-#include "ns3/timer.h"
-#include <map>
+#include "satellite-address-table.h"
+#include "satellite-spatial-index.h"
 #include <vector>
 #include <memory>
 
@@ -39,7 +39,6 @@ public:
     static void AddIpToNodeMapping(Ipv4Address ip, Ptr<Node> node);
     static void AddIpToNodeMapping(const NodeContainer& allSatellites);
     static void ClearIpToNodeMapping();
-    static const std::map<Ipv4Address, Ptr<Node>>& GetIpToNodeMap();
 
     void SetIpv4(Ptr<Ipv4> ipv4) override;
     /**
@@ -60,15 +59,30 @@ private:
     void Start();
     void UpdateActiveNeighbors();
     uint32_t GetInterfaceToPeer(Ptr<Node> peer) const;
+    const SatelliteSpatialIndex& GetSpatialIndex();
+    void BuildUplinkDevices();
+    void InvalidateUplink();
+    /**
+     * @brief Choose the uplink towards the closest linked satellite.
+     * @return The route, or nullptr if the ground station has no link.
+     */
+    Ptr<Ipv4Route> SelectUplink();
 
     Ptr<Ipv4> m_ipv4;
-    Timer m_updateTimer;
-    Time m_updateInterval;
     uint32_t m_maxNeighbors;
+    uint32_t m_updateId;       //!< SatelliteRouteUpdateScheduler registration
+    bool m_updateRegistered;
     std::vector<NeighborInfo> m_activeNeighbors;
+    // Ground stations only: local device towards each satellite, by spatial index item
+    std::vector<Ptr<NetDevice>> m_uplinkDevice;
+    // Ground stations only: uplink chosen by SelectUplink() for the positions
+    // of m_uplinkEpoch
+    Ptr<Ipv4Route> m_uplinkCache;
+    Time m_uplinkEpoch;
 
     // Static data, shared across all instances
-    static std::map<Ipv4Address, Ptr<Node>> m_ipToNodeMap;
+    static SatelliteAddressTable m_ipToNode; //!< Node owning each address
+    static SatelliteSpatialIndex m_spatialIndex;
     /// The collection of orbital planes, which defines the satellite constellation.
     std::shared_ptr<const std::vector<NodeContainer>> m_orbitalPlanes; 
 };
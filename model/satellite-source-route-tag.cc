@@ -0,0 +1,129 @@
+#include "satellite-source-route-tag.h"
+
+#include "ns3/log.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SatelliteSourceRouteTag");
+
+NS_OBJECT_ENSURE_REGISTERED(SatelliteSourceRouteTag);
+
+SatelliteSourceRouteTag::SatelliteSourceRouteTag()
+    : m_destination(0),
+      m_cursor(0)
+{
+}
+
+TypeId
+SatelliteSourceRouteTag::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::SatelliteSourceRouteTag")
+                            .SetParent<Tag>()
+                            .SetGroupName("Satellite")
+                            .AddConstructor<SatelliteSourceRouteTag>();
+    return tid;
+}
+
+TypeId
+SatelliteSourceRouteTag::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+uint32_t
+SatelliteSourceRouteTag::GetSerializedSize() const
+{
+    return sizeof(m_destination) + sizeof(m_cursor) + sizeof(uint16_t) + m_hops.size() * sizeof(uint16_t);
+}
+
+void
+SatelliteSourceRouteTag::Serialize(TagBuffer i) const
+{
+    i.WriteU16(m_destination);
+    i.WriteU16(m_cursor);
+    i.WriteU16(m_hops.size());
+    for (uint16_t hop : m_hops)
+    {
+        i.WriteU16(hop);
+    }
+}
+
+void
+SatelliteSourceRouteTag::Deserialize(TagBuffer i)
+{
+    m_destination = i.ReadU16();
+    m_cursor = i.ReadU16();
+    m_hops.resize(i.ReadU16());
+    for (uint16_t& hop : m_hops)
+    {
+        hop = i.ReadU16();
+    }
+}
+
+void
+SatelliteSourceRouteTag::Print(std::ostream& os) const
+{
+    os << "SatelliteSourceRouteTag(Hops=";
+    for (uint32_t i = 0; i < m_hops.size(); ++i)
+    {
+        os << (i ? " " : "") << m_hops[i];
+    }
+    os << ", Cursor=" << m_cursor << ", Destination=" << m_destination << ")";
+}
+
+void
+SatelliteSourceRouteTag::Clear()
+{
+    m_hops.clear();
+    m_cursor = 0;
+}
+
+void
+SatelliteSourceRouteTag::AddHop(uint32_t satellite)
+{
+    NS_ASSERT_MSG(satellite < 0xffff, "Satellite index " << satellite << " does not fit a source route.");
+    NS_ASSERT_MSG(m_hops.size() < 0xffff, "Source route too long.");
+    m_hops.push_back(satellite);
+}
+
+uint32_t
+SatelliteSourceRouteTag::GetNHops() const
+{
+    return m_hops.size();
+}
+
+uint32_t
+SatelliteSourceRouteTag::GetHop(uint32_t i) const
+{
+    NS_ASSERT_MSG(i < m_hops.size(), "Hop " << i << " out of range.");
+    return m_hops[i];
+}
+
+uint32_t
+SatelliteSourceRouteTag::GetCursor() const
+{
+    return m_cursor;
+}
+
+void
+SatelliteSourceRouteTag::Advance()
+{
+    NS_ASSERT_MSG(m_cursor + 1u < m_hops.size(), "Cursor at the end of the source route.");
+    ++m_cursor;
+}
+
+void
+SatelliteSourceRouteTag::SetDestination(uint32_t groundStation)
+{
+    NS_ASSERT_MSG(groundStation < 0xffff, "Ground station index " << groundStation << " does not fit a source route.");
+    m_destination = groundStation;
+}
+
+uint32_t
+SatelliteSourceRouteTag::GetDestination() const
+{
+    return m_destination;
+}
+
+} // namespace ns3
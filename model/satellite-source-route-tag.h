@@ -0,0 +1,80 @@
+#ifndef SATELLITE_SOURCE_ROUTE_TAG_H
+#define SATELLITE_SOURCE_ROUTE_TAG_H
+
+#include "ns3/tag.h"
+
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @ingroup satellite
+ * @brief The satellites a packet crosses, chosen once by the ground station it enters from.
+ *
+ * With SourceRouting, the sending ground station lists the satellite indices
+ * of the whole path, ingress to egress, and the ground station it leaves
+ * to. A cursor marks the satellite the packet is at. Every transit satellite
+ * checks that it is under the cursor, advances it and forwards to the next
+ * entry, or down to the destination if it is the last one, without looking
+ * up the destination, its own routing table or its place on the path.
+ *
+ * Indices are stored in 16 bits, which is plenty for any constellation.
+ */
+class SatelliteSourceRouteTag : public Tag
+{
+public:
+    SatelliteSourceRouteTag();
+
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+    uint32_t GetSerializedSize() const override;
+    void Serialize(TagBuffer i) const override;
+    void Deserialize(TagBuffer i) override;
+    void Print(std::ostream& os) const override;
+
+    /**
+     * @brief Remove every hop and reset the cursor to the ingress satellite.
+     */
+    void Clear();
+
+    /**
+     * @brief Append a satellite to the path.
+     * @param satellite The satellite index.
+     */
+    void AddHop(uint32_t satellite);
+
+    uint32_t GetNHops() const;
+
+    /**
+     * @param i The position on the path, 0 for the ingress satellite.
+     * @return The satellite index at that position.
+     */
+    uint32_t GetHop(uint32_t i) const;
+
+    /**
+     * @return The position on the path of the satellite the packet is at.
+     */
+    uint32_t GetCursor() const;
+
+    /**
+     * @brief Move the cursor to the next satellite of the path.
+     */
+    void Advance();
+
+    void SetDestination(uint32_t groundStation);
+
+    /**
+     * @return The ground station index the path ends at.
+     */
+    uint32_t GetDestination() const;
+
+private:
+    uint16_t m_destination;       //!< Ground station index
+    uint16_t m_cursor;            //!< Position of the current satellite
+    std::vector<uint16_t> m_hops; //!< Satellite indices, ingress first
+};
+
+} // namespace ns3
+
+#endif /* SATELLITE_SOURCE_ROUTE_TAG_H */
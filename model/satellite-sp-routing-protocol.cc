@@ -4,16 +4,18 @@
 #include "ns3/ipv4-header.h"
 #include "ns3/mobility-model.h"
 #include "satellite-circular-mobility-model.h"
+#include "satellite-route-update-scheduler.h"
 #include "ns3/constant-position-mobility-model.h"
 #include "ns3/point-to-point-net-device.h"
 #include "ns3/simulator.h"
 #include "ns3/channel.h"
 #include "ns3/core-module.h"
 #include "ns3/loopback-net-device.h"
+#include "ns3/boolean.h"
 
+#include <algorithm>
 #include <limits>
 #include <queue>
-#include <map>
 #include <vector>
 
 namespace ns3 {
@@ -23,10 +25,10 @@ NS_LOG_COMPONENT_DEFINE("SatelliteSpRoutingProtocol");
 NS_OBJECT_ENSURE_REGISTERED(SatelliteSpRoutingProtocol);
 
 // Initialization of static members
-std::map<Ipv4Address, Ptr<Node>> SatelliteSpRoutingProtocol::m_ipToNodeMap;
-std::vector<std::vector<uint32_t>> SatelliteSpRoutingProtocol::m_adj;
-std::map<Ptr<Node>, uint32_t> SatelliteSpRoutingProtocol::m_nodeToIndex;
-NodeContainer SatelliteSpRoutingProtocol::m_allSatellites;
+SatelliteAddressTable SatelliteSpRoutingProtocol::m_ipToNode;
+SatellitePrefixTable SatelliteSpRoutingProtocol::m_prefixToNode;
+Ptr<SatelliteRouteEngine> SatelliteSpRoutingProtocol::m_routeEngine;
+uint32_t SatelliteSpRoutingProtocol::m_numActiveSatellites = 0;
 
 TypeId
 SatelliteSpRoutingProtocol::GetTypeId(void)
@@ -34,24 +36,57 @@ SatelliteSpRoutingProtocol::GetTypeId(void)
     static TypeId tid = TypeId("ns3::SatelliteSpRoutingProtocol")
         .SetParent<Ipv4RoutingProtocol>()
         .SetGroupName("Satellite")
-        .AddConstructor<SatelliteSpRoutingProtocol>();
+        .AddConstructor<SatelliteSpRoutingProtocol>()
+        .AddAttribute("LazyUpdate",
+                      "Compute routes on the first packet a satellite handles in an epoch "
+                      "instead of on every epoch. Idle satellites then never compute routes "
+                      "or hold a routing table, and the shared route engine is switched to "
+                      "OnDemand so that it only resolves the pairs packets ask for.",
+                      BooleanValue(false),
+                      MakeBooleanAccessor(&SatelliteSpRoutingProtocol::m_lazyUpdate),
+                      MakeBooleanChecker())
+        .AddAttribute("SourceRouting",
+                      "Have ground stations tag every packet to another ground station with "
+                      "the satellites of its whole path. Satellites forward tagged packets "
+                      "along the tag without any route lookup.",
+                      BooleanValue(false),
+                      MakeBooleanAccessor(&SatelliteSpRoutingProtocol::m_sourceRouting),
+                      MakeBooleanChecker())
+        .AddAttribute("LabelSwitching",
+                      "Have ground stations label every packet to another ground station with "
+                      "its path, and satellites forward labelled packets with one index into a "
+                      "label table kept per epoch. SourceRouting takes precedence.",
+                      BooleanValue(false),
+                      MakeBooleanAccessor(&SatelliteSpRoutingProtocol::m_labelSwitching),
+                      MakeBooleanChecker());
     return tid;
 }
 
 SatelliteSpRoutingProtocol::SatelliteSpRoutingProtocol() 
-    : m_updateInterval(Seconds(1.0))
+    : m_updateId(0),
+      m_updateRegistered(false),
+      m_lazyUpdate(false),
+      m_routesValid(false),
+      m_tableEpochNumber(0),
+      m_numRoutes(0),
+      m_sourceRouting(false),
+      m_labelSwitching(false)
 {
-    m_updateTimer.SetFunction(&SatelliteSpRoutingProtocol::UpdateRoutes, this);
 }
 
 SatelliteSpRoutingProtocol::~SatelliteSpRoutingProtocol() {
-    m_updateTimer.Cancel();
 }
 
 void
 SatelliteSpRoutingProtocol::DoInitialize()
 {
     Ptr<Node> thisNode = m_ipv4->GetObject<Node>();
+    // Ground links bound on demand change peers during the simulation
+    for (uint32_t i = 1; i < m_ipv4->GetNInterfaces(); ++i)
+    {
+        m_ipv4->GetNetDevice(i)->AddLinkChangeCallback(
+            MakeCallback(&SatelliteSpRoutingProtocol::InvalidateGroundLinks, this));
+    }
     if (thisNode->GetObject<SatelliteCircularMobilityModel>())
     {
         Ipv4RoutingProtocol::DoInitialize();
@@ -66,98 +101,122 @@ SatelliteSpRoutingProtocol::DoInitialize()
 void
 SatelliteSpRoutingProtocol::DoDispose()
 {
+    if (m_updateRegistered)
+    {
+        SatelliteRouteUpdateScheduler::Get()->Remove(m_updateId);
+        m_updateRegistered = false;
+    }
     Ipv4RoutingProtocol::DoDispose();
 }
 
 void
 SatelliteSpRoutingProtocol::Start()
 {
-    m_updateTimer.Schedule(Seconds(0.1)); 
+    if (m_lazyUpdate)
+    {
+        // Routes are brought up to date by the first packet of each epoch. An
+        // all-pairs update would have that packet pay for every idle satellite.
+        GetRouteEngine()->SetAttribute("OnDemand", BooleanValue(true));
+        return;
+    }
+
+    // All instances are updated back to back by one shared event per epoch;
+    // the first one computes the constellation routes.
+    m_updateId = SatelliteRouteUpdateScheduler::Get()->Add(
+        MakeCallback(&SatelliteSpRoutingProtocol::UpdateRoutes, this));
+    m_updateRegistered = true;
+}
+
+Ptr<SatelliteRouteEngine>
+SatelliteSpRoutingProtocol::GetRouteEngine()
+{
+    if (!m_routeEngine)
+    {
+        m_routeEngine = CreateObject<SatelliteRouteEngine>();
+    }
+    return m_routeEngine;
+}
+
+uint32_t
+SatelliteSpRoutingProtocol::GetNActiveSatellites()
+{
+    return m_numActiveSatellites;
 }
 
 void
 SatelliteSpRoutingProtocol::AddNode(Ptr<Node> node)
 {
-    m_allSatellites.Add(node);
+    GetRouteEngine()->AddNode(node);
 }
 
 void
 SatelliteSpRoutingProtocol::AddIpToNodeMapping(Ipv4Address ip, Ptr<Node> node)
 {
-    m_ipToNodeMap[ip] = node;
+    m_ipToNode.Insert(ip, node);
 }
 
 void
 SatelliteSpRoutingProtocol::AddIpToNodeMapping()
 {
-    ClearIpToNodeMapping();
-    for (uint32_t i = 0; i < m_allSatellites.GetN(); ++i)
+    // Prefixes stay; only addresses they do not already resolve get an entry
+    m_ipToNode.Clear();
+    const NodeContainer& allNodes = GetRouteEngine()->GetNodes();
+    for (uint32_t i = 0; i < allNodes.GetN(); ++i)
     {
-        Ptr<Node> node = m_allSatellites.Get(i);
+        Ptr<Node> node = allNodes.Get(i);
         Ptr<Ipv4> ipv4Node = node->GetObject<Ipv4>();
         for (uint32_t j = 1; j < ipv4Node->GetNInterfaces(); ++j) {
-            m_ipToNodeMap[ipv4Node->GetAddress(j, 0).GetLocal()] = node;
+            Ipv4Address ip = ipv4Node->GetAddress(j, 0).GetLocal();
+            if (m_prefixToNode.Find(ip) != node)
+            {
+                AddIpToNodeMapping(ip, node);
+            }
         }
     }
+    NS_LOG_INFO("Node lookup holds " << m_prefixToNode.GetSize() << " prefixes and "
+                << m_ipToNode.GetSize() << " addresses");
 }
 
 void
-SatelliteSpRoutingProtocol::ClearIpToNodeMapping()
+SatelliteSpRoutingProtocol::AddPrefixToNodeMapping(Ipv4Address prefix, uint8_t length, Ptr<Node> node)
+{
+    m_prefixToNode.Insert(prefix, length, node);
+}
+
+Ptr<Node>
+SatelliteSpRoutingProtocol::FindNode(Ipv4Address address)
 {
-    m_ipToNodeMap.clear();
+    // Exact addresses are the more specific ones
+    Ptr<Node> node = m_ipToNode.GetSize() ? m_ipToNode.Find(address) : nullptr;
+    return node ? node : m_prefixToNode.Find(address);
 }
 
-const std::map<Ipv4Address, Ptr<Node>>&
-SatelliteSpRoutingProtocol::GetIpToNodeMap()
+void
+SatelliteSpRoutingProtocol::ClearIpToNodeMapping()
 {
-    return m_ipToNodeMap;
+    m_ipToNode.Clear();
+    m_prefixToNode.Clear();
+    // The mapping is cleared between simulations, and so is the count
+    m_numActiveSatellites = 0;
 }
 
 void
 SatelliteSpRoutingProtocol::SetIpv4(Ptr<Ipv4> ipv4)
 {
     m_ipv4 = ipv4;
+    m_links.Setup(ipv4, GetRouteEngine());
 }
 
 void
 SatelliteSpRoutingProtocol::InitializeTopology()
 {
-    NS_LOG_INFO("Building global satellite topology once.");
-    
-    for (uint32_t i=0; i < m_allSatellites.GetN(); ++i)
-    {
-        m_nodeToIndex[m_allSatellites.Get(i)] = i;
-    }
+    GetRouteEngine()->InitializeTopology();
+}
 
-    m_adj.resize(m_allSatellites.GetN());
-    for (uint32_t i=0; i < m_allSatellites.GetN(); ++i)
-    {
-        Ptr<Node> node = m_allSatellites.Get(i);
-        for(uint32_t j=0; j < node->GetNDevices(); ++j)
-        {
-            Ptr<NetDevice> dev = node->GetDevice(j);
-            if (DynamicCast<LoopbackNetDevice>(dev))
-            {
-                continue;
-            }
-            Ptr<Channel> channel = dev->GetChannel();
-            if(channel && channel->GetNDevices() == 2)
-            {
-                Ptr<NetDevice> peerDev = (channel->GetDevice(0) == dev) ? channel->GetDevice(1) : channel->GetDevice(0);
-                Ptr<Node> peerNode = peerDev->GetNode();
-                
-                // Only add inter-satellite links (ISL) to the shortest path graph
-                // Check if both nodes are satellites (have SatelliteCircularMobilityModel)
-                bool currentIsSatellite = node->GetObject<SatelliteCircularMobilityModel>() != nullptr;
-                bool peerIsSatellite = peerNode->GetObject<SatelliteCircularMobilityModel>() != nullptr;
-                
-                if(m_nodeToIndex.count(peerNode) && currentIsSatellite && peerIsSatellite)
-                {
-                    m_adj[i].push_back(m_nodeToIndex[peerNode]);
-                }
-            }
-        }
-    }
+void
+SatelliteSpRoutingProtocol::SetOrbitalPlanes(const std::vector<NodeContainer>& orbitalPlanes)
+{
+    GetRouteEngine()->SetOrbitalPlanes(orbitalPlanes);
 }
 
 void
@@ -166,19 +225,25 @@ SatelliteSpRoutingProtocol::PrintRoutingTable(Ptr<OutputStreamWrapper> stream, T
     *stream->GetStream() << "SatelliteSpRoutingProtocol: Routing table for Node " << m_ipv4->GetObject<Node>()->GetId() 
                        << " at time " << Simulator::Now().As(unit) << std::endl;
     *stream->GetStream() << "  Destination Node ID\tNext Hop Node ID\tInterface" << std::endl;
-    for (const auto& entry : m_routingTable)
+    for (uint32_t i = 0; i < m_routingTable.size(); ++i)
     {
-        Ptr<Node> destNode = entry.first;
-        Ptr<Node> nextHop = entry.second.nextHopNode;
-        uint32_t iface = entry.second.interface;
-        *stream->GetStream() << "  " << destNode->GetId() << "\t\t\t" << (nextHop ? nextHop->GetId() : -1) << "\t\t\t" << iface << std::endl;
+        const RouteEntry& entry = m_routingTable[i];
+        if (!entry.route) continue;
+        Ptr<Node> destNode = m_routeEngine->GetSatellite(i);
+        *stream->GetStream() << "  " << destNode->GetId() << "\t\t\t" << entry.nextHopNode->GetId() << "\t\t\t" << entry.interface << std::endl;
     }
 }
 
 void
-SatelliteSpRoutingProtocol::NotifyInterfaceUp(uint32_t i) { }
+SatelliteSpRoutingProtocol::NotifyInterfaceUp(uint32_t i)
+{
+    InvalidateGroundLinks();
+}
 void
-SatelliteSpRoutingProtocol::NotifyInterfaceDown(uint32_t i) { }
+SatelliteSpRoutingProtocol::NotifyInterfaceDown(uint32_t i)
+{
+    InvalidateGroundLinks();
+}
 void
 SatelliteSpRoutingProtocol::NotifyAddAddress(uint32_t i, Ipv4InterfaceAddress a) { }
 void
@@ -189,11 +254,68 @@ SatelliteSpRoutingProtocol::UpdateRoutes()
 {  
     Ptr<Node> thisNode = m_ipv4->GetObject<Node>();
     NS_LOG_DEBUG("Updating routes for node " << thisNode->GetId() << " at time " << Simulator::Now().GetSeconds() << "s");
-    m_routingTable.clear();
     ComputeRoutes();
-    NS_LOG_DEBUG("Node " << thisNode->GetId() << " computed " << m_routingTable.size() << " routes");
-    
-    m_updateTimer.Schedule(m_updateInterval);
+    NS_LOG_DEBUG("Node " << thisNode->GetId() << " computed " << m_numRoutes << " routes");
+
+    // Lazy instances report too; without them an adaptive clock driven by
+    // ground stations alone would never see an epoch
+    Ptr<SatelliteRouteEngine> engine = GetRouteEngine();
+    if (engine->GetSatelliteIndex(thisNode) != SatelliteRouteEngine::INVALID_INDEX)
+    {
+        SatelliteRouteUpdateScheduler::Get()->ReportEpoch(engine->DidRoutesChange(),
+                                                          engine->GetTimeToNextHandover());
+    }
+}
+
+void
+SatelliteSpRoutingProtocol::UpdateRoutesIfStale()
+{
+    Time epoch = SatelliteRouteUpdateScheduler::Get()->GetEpochStart(Simulator::Now());
+    if (m_routesValid && m_routesEpoch == epoch)
+    {
+        return;
+    }
+    m_routesEpoch = epoch;
+    UpdateRoutes();
+}
+
+void
+SatelliteSpRoutingProtocol::InvalidateGroundLinks()
+{
+    // Rebuilt on the next packet that needs them
+    m_links.ClearGroundLinks();
+    m_groundCache.Clear();
+    // Downlink entries of the label table held the dropped routes
+    m_labelTable.Clear();
+}
+
+Ptr<Ipv4Route>
+SatelliteSpRoutingProtocol::LookupRoute(uint32_t destIndex)
+{
+    Ptr<SatelliteRouteEngine> engine = GetRouteEngine();
+    if (m_routesValid && m_tableEpochNumber != engine->GetEpochNumber())
+    {
+        // The engine recomputed the epoch, e.g. after a link failure
+        FillRoutingTable();
+    }
+    if (!m_routingTable.empty())
+    {
+        return (destIndex < m_routingTable.size()) ? m_routingTable[destIndex].route : nullptr;
+    }
+
+    // No table this epoch: ask the engine, which answers +Grid next hops in
+    // O(1) and searches other pairs on demand
+    uint32_t srcIndex = engine->GetSatelliteIndex(m_ipv4->GetObject<Node>());
+    if (srcIndex == SatelliteRouteEngine::INVALID_INDEX || destIndex == SatelliteRouteEngine::INVALID_INDEX)
+    {
+        return nullptr;
+    }
+    uint32_t nextHopIdx = engine->GetNextHop(srcIndex, destIndex);
+    if (nextHopIdx == SatelliteRouteEngine::INVALID_INDEX)
+    {
+        return nullptr;
+    }
+    return m_links.GetNeighbourRoute(nextHopIdx);
 }
 
 uint32_t SatelliteSpRoutingProtocol::GetInterfaceToPeer(Ptr<Node> peer) const
@@ -202,7 +324,7 @@ uint32_t SatelliteSpRoutingProtocol::GetInterfaceToPeer(Ptr<Node> peer) const
     {
         Ptr<NetDevice> dev = m_ipv4->GetNetDevice(i);
         Ptr<Channel> ch = dev->GetChannel();
-        if (ch && ch->GetNDevices() == 2)
+        if (ch && dev->IsPointToPoint() && ch->GetNDevices() == 2)
         {
             Ptr<NetDevice> peerDev = (ch->GetDevice(0) == dev) ? ch->GetDevice(1) : ch->GetDevice(0);
             if (peerDev && peerDev->GetNode() == peer)
@@ -218,64 +340,79 @@ void
 SatelliteSpRoutingProtocol::ComputeRoutes()
 {
     Ptr<Node> thisNode = m_ipv4->GetObject<Node>();
-    if (m_nodeToIndex.find(thisNode) == m_nodeToIndex.end())
+    Ptr<SatelliteRouteEngine> engine = GetRouteEngine();
+    uint32_t srcIndex = engine->GetSatelliteIndex(thisNode);
+    if (srcIndex == SatelliteRouteEngine::INVALID_INDEX)
     {
         return; 
     }
-    uint32_t numNodes = m_allSatellites.GetN();
-    uint32_t srcIndex = m_nodeToIndex[thisNode];
 
-    std::vector<double> dist(numNodes, std::numeric_limits<double>::max());
-    std::vector<int> from(numNodes, -1);
-    dist[srcIndex] = 0;
-
-    using PQElement = std::pair<double, uint32_t>;
-    std::priority_queue<PQElement, std::vector<PQElement>, std::greater<PQElement>> pq;
-    pq.push({0.0, srcIndex});
-
-    while (!pq.empty())
+    // The first instance to fire in an epoch computes routes for the whole
+    // constellation; every other instance just reads its row. Lazy instances
+    // run at arbitrary times and ask for the epoch they fall in.
+    if (m_lazyUpdate)
     {
-        double d = pq.top().first;
-        uint32_t u_idx = pq.top().second;
-        pq.pop();
-
-        if (d > dist[u_idx]) continue;
-
-        Ptr<Node> u_node = m_allSatellites.Get(u_idx);
-        for(const auto& v_idx : m_adj[u_idx])
-        {
-            Ptr<Node> v_node = m_allSatellites.Get(v_idx);
-            double weight = u_node->GetObject<MobilityModel>()->GetDistanceFrom(v_node->GetObject<MobilityModel>());
-            
-            if(dist[u_idx] + weight < dist[v_idx])
-            {
-                dist[v_idx] = dist[u_idx] + weight;
-                if (u_idx == srcIndex)
-                {
-                    from[v_idx] = v_idx;
-                } else
-                {
-                    from[v_idx] = from[u_idx];
-                }
-                pq.push({dist[v_idx], v_idx});
-            }
-        }
+        engine->Update(m_routesEpoch);
+    }
+    else
+    {
+        engine->Update();
     }
+    if (!m_routesValid)
+    {
+        m_routesValid = true;
+        ++m_numActiveSatellites;
+    }
+    FillRoutingTable();
+}
 
-    for(uint32_t i=0; i < numNodes; ++i)
+void
+SatelliteSpRoutingProtocol::FillRoutingTable()
+{
+    Ptr<SatelliteRouteEngine> engine = GetRouteEngine();
+    uint32_t srcIndex = engine->GetSatelliteIndex(m_ipv4->GetObject<Node>());
+    m_tableEpochNumber = engine->GetEpochNumber();
+    if (!engine->HasNextHopMatrix())
     {
-        if(i == srcIndex || from[i] == -1) continue;
+        // Next hops are resolved per packet in LookupRoute(), keep no table
+        m_routingTable.clear();
+        m_numRoutes = 0;
+        return;
+    }
 
-        Ptr<Node> destNode = m_allSatellites.Get(i);
-        
-        int nextHopIdx = from[i];
+    // Next hops are always direct neighbours: resolve each interface and
+    // build its route object once, then share it between all destinations.
+    // The table is rewritten in place, one entry per destination satellite.
+    uint32_t numSatellites = engine->GetNSatellites();
+    m_routingTable.resize(numSatellites);
+    m_numRoutes = 0;
+    std::vector<std::pair<uint32_t, RouteEntry>> entryByNextHop;
+    for (uint32_t i = 0; i < numSatellites; ++i)
+    {
+        RouteEntry& entry = m_routingTable[i];
+        uint32_t nextHopIdx = engine->GetNextHop(srcIndex, i);
+        if (nextHopIdx == SatelliteRouteEngine::INVALID_INDEX)
+        {
+            entry = RouteEntry();
+            continue;
+        }
 
-        Ptr<Node> nextHopNode = m_allSatellites.Get(nextHopIdx);
-        uint32_t iface = GetInterfaceToPeer(nextHopNode);
+        // A satellite has a handful of neighbours, a linear search beats a map
+        auto it = std::find_if(entryByNextHop.begin(), entryByNextHop.end(),
+                               [nextHopIdx](const std::pair<uint32_t, RouteEntry>& e) { return e.first == nextHopIdx; });
+        if (it == entryByNextHop.end())
+        {
+            Ptr<Node> nextHopNode = engine->GetSatellite(nextHopIdx);
+            uint32_t iface = GetInterfaceToPeer(nextHopNode);
+            Ptr<Ipv4Route> route = (iface != (uint32_t)-1) ? m_links.CreateRouteVia(m_ipv4->GetNetDevice(iface)) : nullptr;
+            entryByNextHop.push_back({nextHopIdx, {nextHopNode, iface, route}});
+            it = entryByNextHop.end() - 1;
+        }
 
-        if (iface != (uint32_t)-1)
+        entry = it->second;
+        if (entry.route)
         {
-            m_routingTable[destNode] = {nextHopNode, iface};
+            ++m_numRoutes;
         }
     }
 }
@@ -299,7 +436,15 @@ SatelliteSpRoutingProtocol::RouteInput(Ptr<const Packet> p, const Ipv4Header &he
 
     Socket::SocketErrno sockerr;
     Ptr<Packet> packet = p->Copy(); 
-    Ptr<Ipv4Route> route = RouteOutput(packet, header, nullptr, sockerr);
+    Ptr<Ipv4Route> route = RouteBySourceRoute(packet);
+    if (!route)
+    {
+        route = RouteByLabel(p);
+    }
+    if (!route)
+    {
+        route = RouteOutput(packet, header, nullptr, sockerr);
+    }
 
     if (route)
     {
@@ -315,6 +460,273 @@ SatelliteSpRoutingProtocol::RouteInput(Ptr<const Packet> p, const Ipv4Header &he
     }
 }
 
+Ptr<Ipv4Route>
+SatelliteSpRoutingProtocol::SelectUplink(uint32_t& satellite)
+{
+    Ptr<Node> thisNode = m_ipv4->GetObject<Node>();
+    Ptr<SatelliteRouteEngine> engine = GetRouteEngine();
+
+    bool beam = m_links.HasBeamDevice();
+    if (beam || engine->IsArchiveActive() || engine->GetContactPlan())
+    {
+        // The egress satellite is the closest one (the closest visible one
+        // with a contact plan); if this ground station links to it, it is
+        // also the closest linked one, with no geometry to evaluate
+        uint32_t gsIndex = engine->GetGroundStationIndex(thisNode);
+        uint32_t egress = (gsIndex != SatelliteRouteEngine::INVALID_INDEX) ? engine->GetEgressSatellite(gsIndex)
+                                                                          : SatelliteRouteEngine::INVALID_INDEX;
+        if (egress != SatelliteRouteEngine::INVALID_INDEX && beam)
+        {
+            // The terminal follows the egress satellite from beam to beam
+            Ptr<Ipv4Route> route = m_links.GetBeamRoute(egress, engine->GetSatellite(egress), engine->GetNSatellites());
+            if (route)
+            {
+                NS_LOG_INFO("  -> Selected egress satellite " << engine->GetSatellite(egress)->GetId() << " by beam");
+                satellite = egress;
+                return route;
+            }
+        }
+        Ptr<Ipv4Route> route = (egress != SatelliteRouteEngine::INVALID_INDEX) ? m_links.GetUplinkRoute(egress) : nullptr;
+        if (route)
+        {
+            NS_LOG_INFO("  -> Selected egress satellite " << engine->GetSatellite(egress)->GetId());
+            satellite = egress;
+            return route;
+        }
+    }
+
+    // Closest satellite this ground station has a link to
+    const SatelliteSpatialIndex& index = engine->GetSpatialIndex();
+    Vector position = thisNode->GetObject<MobilityModel>()->GetPosition();
+    uint32_t item = index.FindNearest(position, [this](uint32_t i) { return m_links.GetUplinkDevice(i) != nullptr; });
+    Ptr<NetDevice> bestDevice = (item != SatelliteSpatialIndex::INVALID_INDEX) ? m_links.GetUplinkDevice(item) : nullptr;
+    Ptr<Node> selectedSatellite = (item != SatelliteSpatialIndex::INVALID_INDEX) ? index.GetSatellite(item) : nullptr;
+
+    if (bestDevice)
+    {
+        NS_LOG_INFO("  -> Selected satellite " << selectedSatellite->GetId() << " at distance "
+                    << CalculateDistance(position, index.GetPosition(item)));
+        Ptr<Ipv4Route> route = m_links.GetUplinkRoute(item);
+        NS_LOG_INFO("  -> Route: src=" << route->GetSource() << " gw=" << route->GetGateway() << " dev=" << bestDevice->GetIfIndex());
+        satellite = item;
+        return route;
+    }
+    return nullptr;
+}
+
+Ptr<Ipv4Route>
+SatelliteSpRoutingProtocol::SelectGroundIngress(Ipv4Address destAddr, uint32_t& ingress)
+{
+    Ptr<SatelliteRouteEngine> engine = GetRouteEngine();
+    Ptr<Node> destNode = FindNode(destAddr);
+    uint32_t src = engine->GetGroundStationIndex(m_ipv4->GetObject<Node>());
+    uint32_t dst = destNode ? engine->GetGroundStationIndex(destNode) : SatelliteRouteEngine::INVALID_INDEX;
+    uint32_t egress;
+    if (src == SatelliteRouteEngine::INVALID_INDEX || dst == SatelliteRouteEngine::INVALID_INDEX ||
+        !engine->GetGroundPath(src, dst, ingress, egress))
+    {
+        return nullptr;
+    }
+    Ptr<Ipv4Route> route = m_links.GetUplinkRoute(ingress);
+    if (route)
+    {
+        NS_LOG_INFO("  -> Selected ingress satellite " << engine->GetSatellite(ingress)->GetId() << " towards egress "
+                    << engine->GetSatellite(egress)->GetId());
+    }
+    return route;
+}
+
+uint32_t
+SatelliteSpRoutingProtocol::SelectEgress(uint32_t gsIndex, Ipv4Address source)
+{
+    Ptr<SatelliteRouteEngine> engine = GetRouteEngine();
+    if (gsIndex == SatelliteRouteEngine::INVALID_INDEX)
+    {
+        return SatelliteRouteEngine::INVALID_INDEX;
+    }
+    if (engine->IsGroundToGround() && !m_links.HasBeamDevice())
+    {
+        // Every hop derives the same egress from the same (source, destination)
+        // pair, so the packet stays on the path the source uplinked to
+        Ptr<Node> srcNode = FindNode(source);
+        uint32_t src = srcNode ? engine->GetGroundStationIndex(srcNode) : SatelliteRouteEngine::INVALID_INDEX;
+        uint32_t ingress;
+        uint32_t egress;
+        if (src != SatelliteRouteEngine::INVALID_INDEX && engine->GetGroundPath(src, gsIndex, ingress, egress))
+        {
+            return egress;
+        }
+    }
+    return engine->GetEgressSatellite(gsIndex);
+}
+
+void
+SatelliteSpRoutingProtocol::AddSourceRoute(Ptr<Packet> p, Ipv4Address destAddr, uint32_t ingress)
+{
+    Ptr<SatelliteRouteEngine> engine = GetRouteEngine();
+    Ptr<Node> destNode = FindNode(destAddr);
+    uint32_t dst = destNode ? engine->GetGroundStationIndex(destNode) : SatelliteRouteEngine::INVALID_INDEX;
+    if (dst == SatelliteRouteEngine::INVALID_INDEX || ingress == SatelliteRouteEngine::INVALID_INDEX)
+    {
+        return;
+    }
+    m_groundCache.SetPathEpoch(engine->GetEpochNumber());
+
+    SatelliteSourceRouteTag& tag = m_groundCache.GetSourceRoute(dst);
+    if (tag.GetNHops() == 0 || tag.GetHop(0) != ingress)
+    {
+        uint32_t egress = SelectPathEgress(dst, ingress);
+        tag.Clear();
+        tag.SetDestination(dst);
+        uint32_t hop = ingress;
+        tag.AddHop(hop);
+        while (hop != egress && hop != SatelliteRouteEngine::INVALID_INDEX && egress != SatelliteRouteEngine::INVALID_INDEX &&
+               tag.GetNHops() <= engine->GetNSatellites())
+        {
+            hop = engine->GetNextHop(hop, egress);
+            if (hop != SatelliteRouteEngine::INVALID_INDEX)
+            {
+                tag.AddHop(hop);
+            }
+        }
+        if (hop != egress)
+        {
+            // No path this epoch; the packet is routed hop by hop instead
+            NS_LOG_DEBUG("  -> No source route to ground station " << dst);
+            tag.Clear();
+            return;
+        }
+    }
+    if (tag.GetNHops() && !p->ReplacePacketTag(tag))
+    {
+        p->AddPacketTag(tag);
+    }
+}
+
+uint32_t
+SatelliteSpRoutingProtocol::SelectPathEgress(uint32_t dst, uint32_t ingress)
+{
+    Ptr<SatelliteRouteEngine> engine = GetRouteEngine();
+    uint32_t src = engine->GetGroundStationIndex(m_ipv4->GetObject<Node>());
+    uint32_t pathIngress;
+    uint32_t egress;
+    if (engine->IsGroundToGround() && src != SatelliteRouteEngine::INVALID_INDEX &&
+        engine->GetGroundPath(src, dst, pathIngress, egress) && pathIngress == ingress)
+    {
+        return egress;
+    }
+    return engine->GetEgressSatellite(dst);
+}
+
+void
+SatelliteSpRoutingProtocol::AddLabel(Ptr<Packet> p, Ipv4Address destAddr, uint32_t ingress)
+{
+    Ptr<SatelliteRouteEngine> engine = GetRouteEngine();
+    Ptr<Node> destNode = FindNode(destAddr);
+    uint32_t dst = destNode ? engine->GetGroundStationIndex(destNode) : SatelliteRouteEngine::INVALID_INDEX;
+    if (dst == SatelliteRouteEngine::INVALID_INDEX || ingress == SatelliteRouteEngine::INVALID_INDEX)
+    {
+        return;
+    }
+    m_groundCache.SetPathEpoch(engine->GetEpochNumber());
+
+    uint32_t label;
+    if (!m_groundCache.FindLabel(dst, ingress, label))
+    {
+        uint32_t egress = SelectPathEgress(dst, ingress);
+        if (egress == SatelliteRouteEngine::INVALID_INDEX)
+        {
+            return;
+        }
+        label = engine->GetLabel(egress, dst);
+        m_groundCache.SetLabel(dst, ingress, label);
+    }
+    SatelliteLabelTag tag(label);
+    if (!p->ReplacePacketTag(tag))
+    {
+        p->AddPacketTag(tag);
+    }
+}
+
+Ptr<Ipv4Route>
+SatelliteSpRoutingProtocol::RouteByLabel(Ptr<const Packet> p)
+{
+    SatelliteLabelTag tag;
+    if (!p->PeekPacketTag(tag))
+    {
+        return nullptr;
+    }
+    uint32_t label = tag.GetLabel();
+    Ptr<SatelliteRouteEngine> engine = GetRouteEngine();
+    if (m_lazyUpdate)
+    {
+        engine->Update(SatelliteRouteUpdateScheduler::Get()->GetEpochStart(Simulator::Now()));
+    }
+    if (!m_labelTable.IsCurrent(label, engine->GetEpochNumber()))
+    {
+        uint32_t self = engine->GetSatelliteIndex(m_ipv4->GetObject<Node>());
+        if (label >= engine->GetNLabels() || self == SatelliteRouteEngine::INVALID_INDEX)
+        {
+            return nullptr;
+        }
+        uint32_t changed = m_labelTable.Update(engine, self, m_links);
+        NS_LOG_DEBUG("Label table of node " << m_ipv4->GetObject<Node>()->GetId() << ": " << changed << " of "
+                     << engine->GetNLabels() << " entries changed");
+    }
+
+    Ptr<Ipv4Route> route = m_labelTable.GetRoute(label);
+    if (route && route->GetOutputDevice()->IsLinkUp())
+    {
+        return route;
+    }
+    return nullptr;
+}
+
+Ptr<Ipv4Route>
+SatelliteSpRoutingProtocol::RouteBySourceRoute(Ptr<Packet> p)
+{
+    SatelliteSourceRouteTag tag;
+    if (!p->PeekPacketTag(tag))
+    {
+        return nullptr;
+    }
+    Ptr<SatelliteRouteEngine> engine = GetRouteEngine();
+    Ptr<Node> thisNode = m_ipv4->GetObject<Node>();
+    uint32_t position = tag.GetCursor();
+    if (position >= tag.GetNHops() || tag.GetHop(position) != engine->GetSatelliteIndex(thisNode))
+    {
+        // The packet left its path
+        return nullptr;
+    }
+
+    if (position + 1 < tag.GetNHops())
+    {
+        uint32_t next = tag.GetHop(position + 1);
+        Ptr<Ipv4Route> route = m_links.GetNeighbourRoute(next);
+        if (route && route->GetOutputDevice()->IsLinkUp())
+        {
+            NS_LOG_INFO("  -> Source route to satellite " << engine->GetSatellite(next)->GetId());
+            tag.Advance();
+            p->ReplacePacketTag(tag);
+            return route;
+        }
+        return nullptr;
+    }
+
+    // Last satellite of the path: down to the destination ground station
+    uint32_t gsIndex = tag.GetDestination();
+    if (gsIndex >= engine->GetNGroundStations())
+    {
+        return nullptr;
+    }
+    Ptr<Ipv4Route> route = m_links.GetDownlinkRoute(gsIndex);
+    if (route)
+    {
+        return route;
+    }
+    return m_links.GetBeamRoute(gsIndex, engine->GetGroundStation(gsIndex), engine->GetNGroundStations());
+}
+
 Ptr<Ipv4Route>
 SatelliteSpRoutingProtocol::RouteOutput(Ptr<Packet> p, const Ipv4Header &header, Ptr<NetDevice> oif, Socket::SocketErrno &sockerr)
 {
@@ -331,45 +743,42 @@ SatelliteSpRoutingProtocol::RouteOutput(Ptr<Packet> p, const Ipv4Header &header,
     if (thisNode->GetObject<ConstantPositionMobilityModel>())
     {
         NS_LOG_INFO("  -> Current node is a Ground Station. Finding closest satellite. Time: " << Simulator::Now().GetSeconds() << "s");
-        double minDistance = -1.0;
-        Ptr<NetDevice> bestDevice = nullptr;
-        Ptr<Node> selectedSatellite = nullptr;
-        
-        NS_LOG_INFO("  -> Ground station has " << m_ipv4->GetNInterfaces() << " interfaces, checking all satellites:");
-        for (uint32_t i = 1; i < m_ipv4->GetNInterfaces(); ++i)
+        Ptr<SatelliteRouteEngine> engine = GetRouteEngine();
+        if (m_lazyUpdate)
         {
-            Ptr<NetDevice> dev = m_ipv4->GetNetDevice(i);
-            Ptr<Channel> ch = dev->GetChannel();
-            if (ch && ch->GetNDevices() == 2)
+            // No clock drives the engine; move it to the current epoch
+            engine->Update(SatelliteRouteUpdateScheduler::Get()->GetEpochStart(Simulator::Now()));
+        }
+        // A beam terminal serves one satellite at a time, so it keeps a single
+        // uplink rather than one per destination
+        Ptr<Ipv4Route> route;
+        uint32_t ingress = SatelliteRouteEngine::INVALID_INDEX;
+        if (engine->IsGroundToGround() && !m_links.HasBeamDevice())
+        {
+            route = SelectGroundIngress(destAddr, ingress);
+        }
+        if (!route)
+        {
+            // The uplink only changes with the epoch or with a link change
+            Time epoch = SatelliteRouteUpdateScheduler::Get()->GetEpochStart(Simulator::Now());
+            route = m_groundCache.GetUplink(epoch, engine->GetEpochNumber());
+            if (!route)
             {
-                Ptr<NetDevice> peerDev = (ch->GetDevice(0) == dev) ? ch->GetDevice(1) : ch->GetDevice(0);
-                if (peerDev && peerDev->GetNode()->GetObject<SatelliteCircularMobilityModel>())
-                {
-                    double dist = thisNode->GetObject<MobilityModel>()->GetDistanceFrom(peerDev->GetNode()->GetObject<MobilityModel>());
-                    if (minDistance < 0 || dist < minDistance)
-                    {
-                        minDistance = dist;
-                        bestDevice = dev;
-                        selectedSatellite = peerDev->GetNode();
-                    }
-                }
+                route = SelectUplink(ingress);
+                m_groundCache.SetUplink(epoch, engine->GetEpochNumber(), route, ingress);
             }
+            ingress = m_groundCache.GetUplinkSatellite();
         }
-
-        if (bestDevice)
+        if (route)
         {
-            NS_LOG_INFO("  -> Selected satellite " << selectedSatellite->GetId() << " at distance " << minDistance);
-            Ptr<Channel> ch = bestDevice->GetChannel();
-            Ptr<NetDevice> peerDev = (ch->GetDevice(0) == bestDevice) ? ch->GetDevice(1) : ch->GetDevice(0);
-            Ptr<Ipv4> peerIpv4 = peerDev->GetNode()->GetObject<Ipv4>();
-            Ipv4Address gateway = peerIpv4->GetAddress(peerIpv4->GetInterfaceForDevice(peerDev), 0).GetLocal();
-            
-            Ptr<Ipv4Route> route = Create<Ipv4Route>();
-            route->SetDestination(destAddr);
-            route->SetSource(m_ipv4->GetAddress(m_ipv4->GetInterfaceForDevice(bestDevice), 0).GetLocal());
-            route->SetGateway(gateway);
-            route->SetOutputDevice(bestDevice);
-            NS_LOG_INFO("  -> Route created: src=" << route->GetSource() << " gw=" << gateway << " dev=" << bestDevice->GetIfIndex());
+            if (m_sourceRouting)
+            {
+                AddSourceRoute(p, destAddr, ingress);
+            }
+            else if (m_labelSwitching)
+            {
+                AddLabel(p, destAddr, ingress);
+            }
             return route;
         }
 
@@ -378,19 +787,20 @@ SatelliteSpRoutingProtocol::RouteOutput(Ptr<Packet> p, const Ipv4Header &header,
         return nullptr;
     }
     
+    if (m_lazyUpdate)
+    {
+        UpdateRoutesIfStale();
+    }
+
     // IP to Node lookup
-    auto it_map = m_ipToNodeMap.find(destAddr);
-    if (it_map == m_ipToNodeMap.end())
+    Ptr<Node> destNode = FindNode(destAddr);
+    if (!destNode)
     {
-        NS_LOG_WARN("  -> Destination " << destAddr << " not found in IP-to-Node map. Available IPs:");
-        for (const auto& entry : m_ipToNodeMap)
-        {
-            NS_LOG_WARN("    " << entry.first << " -> Node " << entry.second->GetId());
-        }
+        NS_LOG_WARN("  -> Destination " << destAddr << " not found among " << m_ipToNode.GetSize()
+                    << " addresses and " << m_prefixToNode.GetSize() << " prefixes.");
         sockerr = Socket::ERROR_NOROUTETOHOST;
         return nullptr;
     }
-    Ptr<Node> destNode = it_map->second;
     NS_LOG_DEBUG("  -> Found destination node " << destNode->GetId() << " for IP " << destAddr);
 
     // Check if destination is a ground station
@@ -398,23 +808,12 @@ SatelliteSpRoutingProtocol::RouteOutput(Ptr<Packet> p, const Ipv4Header &header,
     {
         NS_LOG_INFO("  -> Destination is a ground station. Finding closest satellite to destination.");
         
-        // Find the satellite closest to the destination ground station
-        double minDistance = -1.0;
-        Ptr<Node> closestSatellite = nullptr;
-        
-        for (uint32_t i = 0; i < m_allSatellites.GetN(); ++i)
-        {
-            Ptr<Node> satellite = m_allSatellites.Get(i);
-            if (satellite->GetObject<SatelliteCircularMobilityModel>())
-            {
-                double dist = destNode->GetObject<MobilityModel>()->GetDistanceFrom(satellite->GetObject<MobilityModel>());
-                if (minDistance < 0 || dist < minDistance)
-                {
-                    minDistance = dist;
-                    closestSatellite = satellite;
-                }
-            }
-        }
+        // The satellite closest to the destination ground station (or the egress of
+        // the shortest ground-to-ground path), fixed for the epoch
+        Ptr<SatelliteRouteEngine> engine = GetRouteEngine();
+        uint32_t gsIndex = engine->GetGroundStationIndex(destNode);
+        uint32_t egress = SelectEgress(gsIndex, header.GetSource());
+        Ptr<Node> closestSatellite = (egress != SatelliteRouteEngine::INVALID_INDEX) ? engine->GetSatellite(egress) : nullptr;
         
         if (!closestSatellite)
         {
@@ -428,26 +827,18 @@ SatelliteSpRoutingProtocol::RouteOutput(Ptr<Packet> p, const Ipv4Header &header,
         {
             NS_LOG_INFO("  -> Current satellite is closest to destination ground station. Forwarding directly.");
             
-            // Find the interface connected to the destination ground station
-            for (uint32_t i = 1; i < m_ipv4->GetNInterfaces(); ++i)
+            Ptr<Ipv4Route> route = m_links.GetDownlinkRoute(gsIndex);
+            if (route)
             {
-                Ptr<NetDevice> dev = m_ipv4->GetNetDevice(i);
-                Ptr<Channel> ch = dev->GetChannel();
-                if (ch && ch->GetNDevices() == 2)
-                {
-                    Ptr<NetDevice> peerDev = (ch->GetDevice(0) == dev) ? ch->GetDevice(1) : ch->GetDevice(0);
-                    if (peerDev && peerDev->GetNode() == destNode)
-                    {
-                        Ptr<Ipv4Route> route = Create<Ipv4Route>();
-                        route->SetDestination(destAddr);
-                        route->SetSource(m_ipv4->GetAddress(i, 0).GetLocal());
-                        route->SetGateway(destAddr); // Direct connection
-                        route->SetOutputDevice(dev);
-                        
-                        NS_LOG_INFO("  -> Direct route found to ground station via interface " << i);
-                        return route;
-                    }
-                }
+                NS_LOG_INFO("  -> Direct route found to ground station via interface "
+                            << route->GetOutputDevice()->GetIfIndex());
+                return route;
+            }
+            route = m_links.GetBeamRoute(gsIndex, destNode, engine->GetNGroundStations());
+            if (route)
+            {
+                NS_LOG_INFO("  -> Direct route found to ground station in the beam");
+                return route;
             }
             
             NS_LOG_WARN("  -> Current satellite should be closest but no direct link found to ground station.");
@@ -459,26 +850,10 @@ SatelliteSpRoutingProtocol::RouteOutput(Ptr<Packet> p, const Ipv4Header &header,
             NS_LOG_INFO("  -> Routing to closest satellite " << closestSatellite->GetId() << " to reach ground station.");
             
             // Route to the closest satellite using the routing table
-            auto it_closest = m_routingTable.find(closestSatellite);
-            if (it_closest != m_routingTable.end())
+            Ptr<Ipv4Route> route = LookupRoute(egress);
+            if (route)
             {
-                const RouteEntry& entry = it_closest->second;
-                Ptr<NetDevice> outDev = m_ipv4->GetNetDevice(entry.interface);
-                
-                Ptr<Ipv4Route> route = Create<Ipv4Route>();
-                route->SetDestination(destAddr); // Keep original destination
-                route->SetSource(m_ipv4->GetAddress(entry.interface, 0).GetLocal());
-                
-                Ptr<Ipv4> peerIpv4 = entry.nextHopNode->GetObject<Ipv4>();
-                Ptr<Channel> ch = outDev->GetChannel();
-                Ptr<NetDevice> peerDev = (ch->GetDevice(0) == outDev) ? ch->GetDevice(1) : ch->GetDevice(0);
-                int32_t peerIfIndex = peerIpv4->GetInterfaceForDevice(peerDev);
-                Ipv4Address gateway = peerIpv4->GetAddress(peerIfIndex, 0).GetLocal();
-                
-                route->SetGateway(gateway);
-                route->SetOutputDevice(outDev);
-                
-                NS_LOG_INFO("  -> Route to closest satellite found. Gateway: " << gateway);
+                NS_LOG_INFO("  -> Route to closest satellite found. Gateway: " << route->GetGateway());
                 return route;
             }
             else
@@ -490,36 +865,23 @@ SatelliteSpRoutingProtocol::RouteOutput(Ptr<Packet> p, const Ipv4Header &header,
         }
     }
 
-    auto it = m_routingTable.find(destNode);
-    if (it != m_routingTable.end())
+    uint32_t destIndex = GetRouteEngine()->GetSatelliteIndex(destNode);
+    Ptr<Ipv4Route> route = LookupRoute(destIndex);
+    if (route)
     {
-        const RouteEntry& entry = it->second;
-        Ptr<NetDevice> outDev = m_ipv4->GetNetDevice(entry.interface);
-        
-        Ptr<Ipv4Route> route = Create<Ipv4Route>();
-        route->SetDestination(destAddr);
-        route->SetSource(m_ipv4->GetAddress(entry.interface, 0).GetLocal());
-
-        Ptr<Ipv4> peerIpv4 = entry.nextHopNode->GetObject<Ipv4>();
-        Ptr<Channel> ch = outDev->GetChannel();
-        Ptr<NetDevice> peerDev = (ch->GetDevice(0) == outDev) ? ch->GetDevice(1) : ch->GetDevice(0);
-        int32_t peerIfIndex = peerIpv4->GetInterfaceForDevice(peerDev);
-        Ipv4Address gateway = peerIpv4->GetAddress(peerIfIndex, 0).GetLocal();
-        
-        route->SetGateway(gateway);
-        route->SetOutputDevice(outDev);
-
         NS_LOG_INFO("  -> Found a route. Forwarding to gateway " << route->GetGateway() 
                     << " via interface " << route->GetOutputDevice()->GetIfIndex());
-
         return route;
     }
 
     NS_LOG_WARN("  -> No route found to Node " << destNode->GetId() << " (IP: " << destAddr << ") in SP routing table.");
-    NS_LOG_WARN("  -> Current routing table has " << m_routingTable.size() << " entries:");
-    for (const auto& entry : m_routingTable)
+    NS_LOG_WARN("  -> Current routing table has " << m_numRoutes << " entries:");
+    for (uint32_t i = 0; i < m_routingTable.size(); ++i)
     {
-        NS_LOG_WARN("    To Node " << entry.first->GetId() << " via Node " << entry.second.nextHopNode->GetId());
+        if (m_routingTable[i].route)
+        {
+            NS_LOG_WARN("    To Node " << m_routeEngine->GetSatellite(i)->GetId() << " via Node " << m_routingTable[i].nextHopNode->GetId());
+        }
     }
     sockerr = Socket::ERROR_NOROUTETOHOST;
     return nullptr;
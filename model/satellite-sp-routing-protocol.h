@@ -5,9 +5,16 @@
 #include "ns3/ipv4.h"
 #include "ns3/node.h"
 #include "ns3/node-container.h"
+#include "ns3/nstime.h"
 #include "ns3/output-stream-wrapper.h"
-#include "ns3/timer.h"
-#include <map>
+#include "satellite-address-table.h"
+#include "satellite-ground-route-cache.h"
+#include "satellite-label-table.h"
+#include "satellite-label-tag.h"
+#include "satellite-link-routes.h"
+#include "satellite-prefix-table.h"
+#include "satellite-route-engine.h"
+#include "satellite-source-route-tag.h"
 #include <vector>
 
 namespace ns3 {
@@ -29,10 +36,26 @@ public:
     // Static helpers for setup
     static void AddNode(Ptr<Node> node);
     static void InitializeTopology();
+    static void SetOrbitalPlanes(const std::vector<NodeContainer>& orbitalPlanes);
     static void AddIpToNodeMapping();
     static void AddIpToNodeMapping(Ipv4Address, Ptr<Node>);
+    /**
+     * @brief Map every address under a prefix to a node, e.g. all interfaces of
+     *        a satellite addressed by SatelliteAddressHelper.
+     * @param prefix The prefix.
+     * @param length The prefix length.
+     * @param node The node.
+     */
+    static void AddPrefixToNodeMapping(Ipv4Address prefix, uint8_t length, Ptr<Node> node);
+    /**
+     * @param address An address.
+     * @return The node owning the address, by exact address first and then by
+     *         longest prefix, or nullptr.
+     */
+    static Ptr<Node> FindNode(Ipv4Address address);
     static void ClearIpToNodeMapping();
-    static const std::map<Ipv4Address, Ptr<Node>>& GetIpToNodeMap();
+    static Ptr<SatelliteRouteEngine> GetRouteEngine();
+    static uint32_t GetNActiveSatellites(); //!< Satellites that computed routes at least once
 
     void SetIpv4(Ptr<Ipv4> ipv4) override;
     void PrintRoutingTable(Ptr<OutputStreamWrapper> stream, Time::Unit unit = Time::S) const override;
@@ -43,25 +66,104 @@ private:
     struct RouteEntry {
         Ptr<Node> nextHopNode;
         uint32_t interface;
+        Ptr<Ipv4Route> route; //!< Shared by every destination with this next hop
     };
 
     void Start();
     void UpdateRoutes();
+    void UpdateRoutesIfStale();
     void ComputeRoutes(); 
+    void FillRoutingTable();
     uint32_t GetInterfaceToPeer(Ptr<Node> peer) const;
+    void InvalidateGroundLinks();
+    Ptr<Ipv4Route> LookupRoute(uint32_t destIndex);
+    /**
+     * @brief Choose the uplink of a ground station: towards the egress
+     *        satellite if known, else towards the closest linked satellite.
+     * @param satellite Output, the satellite index the uplink leads to.
+     * @return The route, or nullptr if the ground station has no link.
+     */
+    Ptr<Ipv4Route> SelectUplink(uint32_t& satellite);
+    /**
+     * @brief With GroundToGround, the uplink of a ground station towards the
+     *        ingress satellite of the shortest path to a destination ground station.
+     * @param destAddr The destination address.
+     * @param ingress Output, the ingress satellite index.
+     * @return The route, or nullptr if the destination is not a ground station
+     *         or this ground station has no link to the ingress satellite.
+     */
+    Ptr<Ipv4Route> SelectGroundIngress(Ipv4Address destAddr, uint32_t& ingress);
+    /**
+     * @brief Choose where a packet leaves the constellation towards a ground station.
+     * @param gsIndex The destination ground station index.
+     * @param source The source address of the packet; with GroundToGround, a
+     *        ground station source selects the egress of the shortest path from it.
+     * @return The satellite index, or INVALID_INDEX.
+     */
+    uint32_t SelectEgress(uint32_t gsIndex, Ipv4Address source);
+    /**
+     * @brief With SourceRouting, tag a packet leaving a ground station with the
+     *        satellites of its whole path. Paths are kept per destination for the epoch.
+     * @param p The packet.
+     * @param destAddr The destination address; only ground stations are tagged.
+     * @param ingress The satellite index the packet is uplinked to.
+     */
+    void AddSourceRoute(Ptr<Packet> p, Ipv4Address destAddr, uint32_t ingress);
+    /**
+     * @brief Egress satellite of the path from an ingress satellite to a ground station:
+     *        that of the jointly chosen path if it starts at the ingress, else the
+     *        egress every satellite would pick.
+     */
+    uint32_t SelectPathEgress(uint32_t dst, uint32_t ingress);
+    /**
+     * @brief With LabelSwitching, push the label of the path to a destination
+     *        ground station onto a packet leaving a ground station.
+     * @param p The packet.
+     * @param destAddr The destination address; only ground stations are labelled.
+     * @param ingress The satellite index the packet is uplinked to.
+     */
+    void AddLabel(Ptr<Packet> p, Ipv4Address destAddr, uint32_t ingress);
+    /**
+     * @brief Forward a labelled packet with the label table.
+     * @param p The packet.
+     * @return The route, or nullptr to fall back to routing by destination.
+     */
+    Ptr<Ipv4Route> RouteByLabel(Ptr<const Packet> p);
+    /**
+     * @brief Forward a packet along its source route, if it carries one whose
+     *        cursor is at this satellite, and advance the cursor.
+     * @param p The packet to forward.
+     * @return The route, or nullptr to fall back to routing by destination.
+     */
+    Ptr<Ipv4Route> RouteBySourceRoute(Ptr<Packet> p);
 
     // Instance-specific members
     Ptr<Ipv4> m_ipv4;
-    Timer m_updateTimer;
-    Time m_updateInterval;
-    // Routing table: maps DESTINATION node to the next hop information
-    std::map<Ptr<Node>, RouteEntry> m_routingTable;
+    uint32_t m_updateId;       //!< SatelliteRouteUpdateScheduler registration
+    bool m_updateRegistered;
+    bool m_lazyUpdate;         //!< Compute routes on first use in an epoch instead of on the clock
+    Time m_routesEpoch;        //!< Epoch the routes were last computed for
+    bool m_routesValid;        //!< Whether routes were computed at all
+    uint64_t m_tableEpochNumber; //!< Engine epoch number m_routingTable was filled in
+    // Routing table: next hop information, by DESTINATION satellite index.
+    // Entries without a route have a null route.
+    std::vector<RouteEntry> m_routingTable;
+    uint32_t m_numRoutes;
+    bool m_sourceRouting;
+    bool m_labelSwitching;
+    // Routes over this node's own links, point-to-point and beam
+    SatelliteLinkRoutes m_links;
+    // Ground stations only: uplink, and with SourceRouting or LabelSwitching
+    // the path or label to each destination ground station
+    SatelliteGroundRouteCache m_groundCache;
+    // Satellites only, with LabelSwitching: route of every label
+    SatelliteLabelTable m_labelTable;
 
     // Static shared data
-    static std::vector<std::vector<uint32_t>> m_adj;
-    static std::map<Ptr<Node>, uint32_t> m_nodeToIndex;
-    static NodeContainer m_allSatellites;
-    static std::map<Ipv4Address, Ptr<Node>> m_ipToNodeMap;
+    static Ptr<SatelliteRouteEngine> m_routeEngine;
+    static SatelliteAddressTable m_ipToNode; //!< Node owning each address
+    static SatellitePrefixTable m_prefixToNode; //!< Node prefixes, for hierarchical addresses
+    static uint32_t m_numActiveSatellites;
 };
 
 } 
@@ -0,0 +1,284 @@
+#include "satellite-spatial-index.h"
+#include "satellite-circular-mobility-model.h"
+#include "satellite-ephemeris.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE("SatelliteSpatialIndex");
+
+SatelliteSpatialIndex::SatelliteSpatialIndex()
+    : m_valid(false)
+{
+}
+
+void
+SatelliteSpatialIndex::SetSatellites(const std::vector<Ptr<Node>>& satellites)
+{
+    m_satellites = satellites;
+    m_ephemerisSlot.clear();
+    uint32_t maxId = 0;
+    for (const Ptr<Node>& node : m_satellites)
+    {
+        maxId = std::max(maxId, node->GetId());
+    }
+    m_itemById.assign(m_satellites.empty() ? 0 : maxId + 1, INVALID_INDEX);
+    for (uint32_t i = 0; i < m_satellites.size(); ++i)
+    {
+        Ptr<SatelliteCircularMobilityModel> mobility = m_satellites[i]->GetObject<SatelliteCircularMobilityModel>();
+        NS_ASSERT_MSG(mobility, "Node " << m_satellites[i]->GetId() << " is not a satellite.");
+        m_ephemerisSlot.push_back(mobility->GetEphemerisSlot());
+        m_itemById[m_satellites[i]->GetId()] = i;
+    }
+    m_position.assign(3 * m_satellites.size(), 0.0);
+    m_tree.resize(m_satellites.size());
+    m_axis.resize(m_satellites.size());
+    m_valid = false;
+}
+
+void
+SatelliteSpatialIndex::Update(Time now)
+{
+    if (m_valid && m_epochTime == now)
+    {
+        return;
+    }
+
+    SatelliteEphemeris& ephemeris = SatelliteEphemeris::Get();
+    ephemeris.Refresh(now);
+    const double* x = ephemeris.GetX();
+    const double* y = ephemeris.GetY();
+    const double* z = ephemeris.GetZ();
+    for (uint32_t i = 0; i < m_satellites.size(); ++i)
+    {
+        uint32_t slot = m_ephemerisSlot[i];
+        m_position[3 * i] = x[slot];
+        m_position[3 * i + 1] = y[slot];
+        m_position[3 * i + 2] = z[slot];
+        m_tree[i] = i;
+    }
+    Build(0, m_tree.size());
+
+    m_epochTime = now;
+    m_valid = true;
+    NS_LOG_DEBUG("Rebuilt spatial index over " << m_satellites.size() << " satellites at "
+                 << now.GetSeconds() << "s");
+}
+
+void
+SatelliteSpatialIndex::Build(uint32_t begin, uint32_t end)
+{
+    if (end - begin <= 1)
+    {
+        if (begin < end)
+        {
+            m_axis[begin] = 0;
+        }
+        return;
+    }
+
+    // Split on the axis with the largest extent; a shell is a thin sphere, so
+    // cycling the axes by depth would give poorly shaped cells.
+    double lo[3] = {std::numeric_limits<double>::max(), std::numeric_limits<double>::max(),
+                    std::numeric_limits<double>::max()};
+    double hi[3] = {std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest(),
+                    std::numeric_limits<double>::lowest()};
+    for (uint32_t i = begin; i < end; ++i)
+    {
+        const double* p = &m_position[3 * m_tree[i]];
+        for (uint32_t a = 0; a < 3; ++a)
+        {
+            lo[a] = std::min(lo[a], p[a]);
+            hi[a] = std::max(hi[a], p[a]);
+        }
+    }
+    uint8_t axis = 0;
+    for (uint8_t a = 1; a < 3; ++a)
+    {
+        if (hi[a] - lo[a] > hi[axis] - lo[axis])
+        {
+            axis = a;
+        }
+    }
+
+    uint32_t mid = begin + (end - begin) / 2;
+    std::nth_element(m_tree.begin() + begin, m_tree.begin() + mid, m_tree.begin() + end,
+                     [this, axis](uint32_t a, uint32_t b) {
+                         return m_position[3 * a + axis] < m_position[3 * b + axis];
+                     });
+    m_axis[mid] = axis;
+    Build(begin, mid);
+    Build(mid + 1, end);
+}
+
+double
+SatelliteSpatialIndex::DistanceSquared(uint32_t item, const double* p) const
+{
+    const double* q = &m_position[3 * item];
+    double dx = q[0] - p[0];
+    double dy = q[1] - p[1];
+    double dz = q[2] - p[2];
+    return dx * dx + dy * dy + dz * dz;
+}
+
+void
+SatelliteSpatialIndex::SearchNearest(uint32_t begin,
+                                     uint32_t end,
+                                     const double* p,
+                                     const Filter& filter,
+                                     uint32_t& best,
+                                     double& bestDistSq) const
+{
+    if (begin >= end)
+    {
+        return;
+    }
+
+    uint32_t mid = begin + (end - begin) / 2;
+    uint32_t item = m_tree[mid];
+    double d = DistanceSquared(item, p);
+    if (d < bestDistSq && (!filter || filter(item)))
+    {
+        bestDistSq = d;
+        best = item;
+    }
+
+    uint8_t axis = m_axis[mid];
+    double delta = p[axis] - m_position[3 * item + axis];
+    bool leftFirst = delta < 0;
+    if (leftFirst)
+    {
+        SearchNearest(begin, mid, p, filter, best, bestDistSq);
+    }
+    else
+    {
+        SearchNearest(mid + 1, end, p, filter, best, bestDistSq);
+    }
+    if (delta * delta < bestDistSq)
+    {
+        if (leftFirst)
+        {
+            SearchNearest(mid + 1, end, p, filter, best, bestDistSq);
+        }
+        else
+        {
+            SearchNearest(begin, mid, p, filter, best, bestDistSq);
+        }
+    }
+}
+
+void
+SatelliteSpatialIndex::SearchRange(uint32_t begin,
+                                   uint32_t end,
+                                   const double* p,
+                                   double rangeSq,
+                                   std::vector<uint32_t>& items) const
+{
+    if (begin >= end)
+    {
+        return;
+    }
+
+    uint32_t mid = begin + (end - begin) / 2;
+    uint32_t item = m_tree[mid];
+    if (DistanceSquared(item, p) <= rangeSq)
+    {
+        items.push_back(item);
+    }
+
+    uint8_t axis = m_axis[mid];
+    double delta = p[axis] - m_position[3 * item + axis];
+    if (delta < 0 || delta * delta <= rangeSq)
+    {
+        SearchRange(begin, mid, p, rangeSq, items);
+    }
+    if (delta >= 0 || delta * delta <= rangeSq)
+    {
+        SearchRange(mid + 1, end, p, rangeSq, items);
+    }
+}
+
+uint32_t
+SatelliteSpatialIndex::FindNearest(const Vector& position, const Filter& filter) const
+{
+    NS_ASSERT_MSG(m_valid, "Spatial index queried before Update().");
+    const double p[3] = {position.x, position.y, position.z};
+    uint32_t best = INVALID_INDEX;
+    double bestDistSq = std::numeric_limits<double>::max();
+    SearchNearest(0, m_tree.size(), p, filter, best, bestDistSq);
+    return best;
+}
+
+uint32_t
+SatelliteSpatialIndex::FindNearestVisible(const Vector& position, double minElevationDegrees) const
+{
+    double norm = std::sqrt(position.x * position.x + position.y * position.y + position.z * position.z);
+    if (norm == 0)
+    {
+        return FindNearest(position);
+    }
+    const double up[3] = {position.x / norm, position.y / norm, position.z / norm};
+    const double sinMask = std::sin(minElevationDegrees * M_PI / 180.0);
+
+    return FindNearest(position, [&](uint32_t item) {
+        const double* q = &m_position[3 * item];
+        double dx = q[0] - position.x;
+        double dy = q[1] - position.y;
+        double dz = q[2] - position.z;
+        double range = std::sqrt(dx * dx + dy * dy + dz * dz);
+        return dx * up[0] + dy * up[1] + dz * up[2] >= sinMask * range;
+    });
+}
+
+void
+SatelliteSpatialIndex::FindWithinRange(const Vector& position, double range, std::vector<uint32_t>& items) const
+{
+    NS_ASSERT_MSG(m_valid, "Spatial index queried before Update().");
+    items.clear();
+    const double p[3] = {position.x, position.y, position.z};
+    SearchRange(0, m_tree.size(), p, range * range, items);
+}
+
+bool
+SatelliteSpatialIndex::IsValid() const
+{
+    return m_valid;
+}
+
+Time
+SatelliteSpatialIndex::GetEpochTime() const
+{
+    return m_epochTime;
+}
+
+uint32_t
+SatelliteSpatialIndex::GetN() const
+{
+    return m_satellites.size();
+}
+
+Ptr<Node>
+SatelliteSpatialIndex::GetSatellite(uint32_t item) const
+{
+    NS_ASSERT_MSG(item < m_satellites.size(), "Spatial index item " << item << " out of range.");
+    return m_satellites[item];
+}
+
+uint32_t
+SatelliteSpatialIndex::GetItem(Ptr<Node> node) const
+{
+    uint32_t id = node->GetId();
+    return (id < m_itemById.size()) ? m_itemById[id] : INVALID_INDEX;
+}
+
+Vector
+SatelliteSpatialIndex::GetPosition(uint32_t item) const
+{
+    return Vector(m_position[3 * item], m_position[3 * item + 1], m_position[3 * item + 2]);
+}
+
+} // namespace ns3
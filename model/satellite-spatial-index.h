@@ -0,0 +1,127 @@
+#ifndef SATELLITE_SPATIAL_INDEX_H
+#define SATELLITE_SPATIAL_INDEX_H
+
+#include "ns3/node.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * @ingroup satellite
+ * @brief k-d tree over satellite positions, rebuilt once per epoch.
+ *
+ * Answers "closest satellite to point P" and "satellites within range of P" in
+ * logarithmic expected time instead of a scan over the constellation. Positions
+ * come from one batch SatelliteEphemeris refresh at Update() time; queries in
+ * between see that snapshot, so the owner decides the epoch length.
+ *
+ * Items are numbered in the order the satellites were given to SetSatellites().
+ */
+class SatelliteSpatialIndex
+{
+public:
+    /// Returned when no satellite matches.
+    static constexpr uint32_t INVALID_INDEX = 0xffffffff;
+
+    /// Optional item filter for queries; return false to skip an item.
+    typedef std::function<bool(uint32_t item)> Filter;
+
+    SatelliteSpatialIndex();
+
+    /**
+     * @brief Set the indexed satellites. Invalidates the tree.
+     * @param satellites Nodes carrying a SatelliteCircularMobilityModel.
+     */
+    void SetSatellites(const std::vector<Ptr<Node>>& satellites);
+
+    /**
+     * @brief Snapshot positions and rebuild the tree, unless already done for this time.
+     * @param now The simulation time.
+     */
+    void Update(Time now);
+
+    /**
+     * @return Whether Update() has been called since the satellites were set.
+     */
+    bool IsValid() const;
+
+    /**
+     * @return The time of the last Update().
+     */
+    Time GetEpochTime() const;
+
+    /**
+     * @brief Find the satellite closest to a point.
+     * @param position The query point.
+     * @param filter Optional filter; only accepted items are considered.
+     * @return The item, or INVALID_INDEX if none was accepted.
+     */
+    uint32_t FindNearest(const Vector& position, const Filter& filter = Filter()) const;
+
+    /**
+     * @brief Find the closest satellite that is at least minElevation above the horizon of a point.
+     * @param position The query point, e.g. a ground station.
+     * @param minElevationDegrees Elevation mask in degrees.
+     * @return The item, or INVALID_INDEX if no satellite is visible.
+     */
+    uint32_t FindNearestVisible(const Vector& position, double minElevationDegrees) const;
+
+    /**
+     * @brief Collect every satellite within a distance of a point.
+     * @param position The query point.
+     * @param range The distance in meters.
+     * @param items Output, cleared first. Not sorted.
+     */
+    void FindWithinRange(const Vector& position, double range, std::vector<uint32_t>& items) const;
+
+    uint32_t GetN() const;
+    Ptr<Node> GetSatellite(uint32_t item) const;
+
+    /**
+     * @param node A node.
+     * @return The item of the node, or INVALID_INDEX if it is not indexed.
+     */
+    uint32_t GetItem(Ptr<Node> node) const;
+
+    /**
+     * @param item An item.
+     * @return The item position at the last Update().
+     */
+    Vector GetPosition(uint32_t item) const;
+
+private:
+    void Build(uint32_t begin, uint32_t end);
+    void SearchNearest(uint32_t begin,
+                       uint32_t end,
+                       const double* p,
+                       const Filter& filter,
+                       uint32_t& best,
+                       double& bestDistSq) const;
+    void SearchRange(uint32_t begin,
+                     uint32_t end,
+                     const double* p,
+                     double rangeSq,
+                     std::vector<uint32_t>& items) const;
+    double DistanceSquared(uint32_t item, const double* p) const;
+
+    std::vector<Ptr<Node>> m_satellites;         //!< Satellites, by item
+    std::vector<uint32_t> m_ephemerisSlot;       //!< SatelliteEphemeris slot, by item
+    std::vector<uint32_t> m_itemById;            //!< Item, by node id
+    std::vector<double> m_position;              //!< x, y, z interleaved, by item
+
+    // Implicit tree: the node of range [begin, end) is tree[(begin + end) / 2],
+    // its children are the ranges on either side of it.
+    std::vector<uint32_t> m_tree;                //!< Items in tree order
+    std::vector<uint8_t> m_axis;                 //!< Split axis, parallel to m_tree
+
+    Time m_epochTime;
+    bool m_valid;
+};
+
+} // namespace ns3
+
+#endif /* SATELLITE_SPATIAL_INDEX_H */
@@ -0,0 +1,124 @@
+#include "satellite-worker-pool.h"
+
+#include <algorithm>
+
+namespace ns3 {
+
+namespace {
+    // Indices handed out per lock acquisition
+    constexpr uint32_t CHUNK_SIZE = 8;
+}
+
+SatelliteWorkerPool::SatelliteWorkerPool(uint32_t nThreads)
+    : m_task(nullptr),
+      m_n(0),
+      m_next(0),
+      m_busy(0),
+      m_generation(0),
+      m_stop(false)
+{
+    for (uint32_t i = 1; i < std::max<uint32_t>(nThreads, 1); ++i)
+    {
+        m_threads.emplace_back(&SatelliteWorkerPool::WorkerLoop, this, i);
+    }
+}
+
+SatelliteWorkerPool::~SatelliteWorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wakeCv.notify_all();
+    for (auto& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+uint32_t
+SatelliteWorkerPool::GetNThreads() const
+{
+    return m_threads.size() + 1;
+}
+
+void
+SatelliteWorkerPool::ParallelFor(uint32_t n, const Task& task)
+{
+    if (m_threads.empty())
+    {
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            task(i, 0);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_task = &task;
+        m_n = n;
+        m_next = 0;
+        m_busy = m_threads.size();
+        ++m_generation;
+    }
+    m_wakeCv.notify_all();
+
+    RunChunks(0);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_doneCv.wait(lock, [this] { return m_busy == 0; });
+    m_task = nullptr;
+}
+
+void
+SatelliteWorkerPool::RunChunks(uint32_t worker)
+{
+    while (true)
+    {
+        uint32_t begin;
+        uint32_t end;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_next >= m_n)
+            {
+                return;
+            }
+            begin = m_next;
+            end = std::min(m_n, begin + CHUNK_SIZE);
+            m_next = end;
+        }
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            (*m_task)(i, worker);
+        }
+    }
+}
+
+void
+SatelliteWorkerPool::WorkerLoop(uint32_t worker)
+{
+    uint64_t seen = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wakeCv.wait(lock, [this, seen] { return m_stop || m_generation != seen; });
+            if (m_stop)
+            {
+                return;
+            }
+            seen = m_generation;
+        }
+
+        RunChunks(worker);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_busy;
+        }
+        m_doneCv.notify_one();
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,72 @@
+#ifndef SATELLITE_WORKER_POOL_H
+#define SATELLITE_WORKER_POOL_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * @ingroup satellite
+ * @brief A small fixed-size thread pool used for constellation-wide batch computations.
+ *
+ * The calling (simulator) thread takes part in the work and blocks in
+ * ParallelFor() until every index has been processed, so each call acts as an
+ * epoch barrier. Tasks must not touch ns-3 objects: reference counting, logging
+ * and the scheduler are not thread safe.
+ */
+class SatelliteWorkerPool
+{
+public:
+    /**
+     * @brief Task run for one index.
+     *
+     * The second argument is the worker slot in [0, GetNThreads()), which can
+     * be used to pick per-thread scratch storage.
+     */
+    using Task = std::function<void(uint32_t index, uint32_t worker)>;
+
+    /**
+     * @param nThreads Total number of threads, including the calling thread.
+     */
+    explicit SatelliteWorkerPool(uint32_t nThreads);
+    ~SatelliteWorkerPool();
+
+    SatelliteWorkerPool(const SatelliteWorkerPool&) = delete;
+    SatelliteWorkerPool& operator=(const SatelliteWorkerPool&) = delete;
+
+    /**
+     * @brief Run task for every index in [0, n) and wait for completion.
+     * @param n The number of indices.
+     * @param task The task to run.
+     */
+    void ParallelFor(uint32_t n, const Task& task);
+
+    /**
+     * @return The total number of threads, including the calling thread.
+     */
+    uint32_t GetNThreads() const;
+
+private:
+    void WorkerLoop(uint32_t worker);
+    void RunChunks(uint32_t worker);
+
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_wakeCv;
+    std::condition_variable m_doneCv;
+    const Task* m_task;       //!< Task of the current batch
+    uint32_t m_n;             //!< Number of indices of the current batch
+    uint32_t m_next;          //!< Next index to hand out
+    uint32_t m_busy;          //!< Helper threads still working on the current batch
+    uint64_t m_generation;    //!< Incremented for every batch
+    bool m_stop;
+};
+
+} // namespace ns3
+
+#endif /* SATELLITE_WORKER_POOL_H */
@@ -0,0 +1,227 @@
+#include "ns3/channel.h"
+#include "ns3/ground-satellite-link-helper.h"
+#include "ns3/ground-satellite-link-manager.h"
+#include "ns3/ground-satellite-net-device.h"
+#include "ns3/satellite-contact-plan.h"
+#include "ns3/satellite-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * @ingroup satellite
+ * @brief Windowed ground links are bound exactly while the contact plan has
+ *        the pair in contact, from pools sized for the busiest instant.
+ */
+class GroundSatelliteLinkManagerTestCase : public TestCase
+{
+public:
+    GroundSatelliteLinkManagerTestCase();
+
+private:
+    void DoSetup() override;
+    void DoRun() override;
+    void DoTeardown() override;
+
+    /**
+     * @param node A node.
+     * @return Its ground link devices.
+     */
+    std::vector<Ptr<GroundSatelliteNetDevice>> GetDevices(Ptr<Node> node) const;
+
+    /**
+     * @param contacts Contacts of one node, as (start, end) pairs.
+     * @return The most of them in progress at the same time.
+     */
+    static uint32_t GetPeak(const std::vector<std::pair<int64_t, int64_t>>& contacts);
+
+    /**
+     * @brief Compare the pools of every node with the contacts of the plan.
+     */
+    void CheckPoolSizes();
+
+    /**
+     * @brief Compare the bound links with the contacts in progress now.
+     */
+    void CheckLinks();
+
+    NodeContainer m_satellites;
+    NodeContainer m_groundStations;
+    Ptr<SatelliteContactPlan> m_plan;
+    Ptr<GroundSatelliteLinkManager> m_manager;
+    std::string m_path;
+    uint32_t m_numChecks;
+};
+
+GroundSatelliteLinkManagerTestCase::GroundSatelliteLinkManagerTestCase()
+    : TestCase("Ground links follow the contact plan"),
+      m_numChecks(0)
+{
+}
+
+void
+GroundSatelliteLinkManagerTestCase::DoSetup()
+{
+    SatelliteHelper satelliteHelper;
+    for (const NodeContainer& plane : satelliteHelper.CreateShell(550e3, 53.0, 6, 8))
+    {
+        m_satellites.Add(plane);
+    }
+    for (double latitude : {0.0, 40.0, -30.0})
+    {
+        m_groundStations.Add(satelliteHelper.CreateGroundStation(latitude, latitude * 3.0));
+    }
+
+    m_path = CreateTempDirFilename("satellite-link-contacts.bin");
+    SatelliteContactPlan::Generate(m_path, m_groundStations, m_satellites, Seconds(0), Seconds(1200), Seconds(10), 20.0);
+    m_plan = Create<SatelliteContactPlan>();
+    m_plan->Open(m_path);
+
+    GroundSatelliteLinkHelper gslHelper;
+    gslHelper.SetContactPlan(m_plan);
+    gslHelper.InstallWindowed(m_satellites, m_groundStations);
+    m_manager = gslHelper.GetLinkManager();
+}
+
+void
+GroundSatelliteLinkManagerTestCase::DoTeardown()
+{
+    m_manager = nullptr;
+    m_plan->Close();
+    std::remove(m_path.c_str());
+    Simulator::Destroy();
+}
+
+std::vector<Ptr<GroundSatelliteNetDevice>>
+GroundSatelliteLinkManagerTestCase::GetDevices(Ptr<Node> node) const
+{
+    std::vector<Ptr<GroundSatelliteNetDevice>> devices;
+    for (uint32_t i = 0; i < node->GetNDevices(); ++i)
+    {
+        Ptr<GroundSatelliteNetDevice> device = DynamicCast<GroundSatelliteNetDevice>(node->GetDevice(i));
+        if (device)
+        {
+            devices.push_back(device);
+        }
+    }
+    return devices;
+}
+
+uint32_t
+GroundSatelliteLinkManagerTestCase::GetPeak(const std::vector<std::pair<int64_t, int64_t>>& contacts)
+{
+    // A contact ending when another starts does not overlap it
+    uint32_t peak = 0;
+    for (const auto& contact : contacts)
+    {
+        uint32_t overlapping = 0;
+        for (const auto& other : contacts)
+        {
+            if (other.first <= contact.first && contact.first < other.second)
+            {
+                ++overlapping;
+            }
+        }
+        peak = std::max(peak, overlapping);
+    }
+    return peak;
+}
+
+void
+GroundSatelliteLinkManagerTestCase::CheckPoolSizes()
+{
+    std::vector<std::vector<std::pair<int64_t, int64_t>>> byGroundStation(m_groundStations.GetN());
+    std::vector<std::vector<std::pair<int64_t, int64_t>>> bySatellite(m_satellites.GetN());
+    for (uint32_t i = 0; i < m_plan->GetNContacts(); ++i)
+    {
+        const SatelliteContact& contact = m_plan->GetContact(i);
+        byGroundStation[contact.groundStation].push_back({contact.start, contact.end});
+        bySatellite[contact.satellite].push_back({contact.start, contact.end});
+    }
+    for (uint32_t g = 0; g < m_groundStations.GetN(); ++g)
+    {
+        NS_TEST_EXPECT_MSG_EQ(GetDevices(m_groundStations.Get(g)).size(), GetPeak(byGroundStation[g]),
+                              "Pool of ground station " << g << " not sized for its busiest instant");
+    }
+    for (uint32_t s = 0; s < m_satellites.GetN(); ++s)
+    {
+        NS_TEST_EXPECT_MSG_EQ(GetDevices(m_satellites.Get(s)).size(), GetPeak(bySatellite[s]),
+                              "Pool of satellite " << s << " not sized for its busiest instant");
+    }
+}
+
+void
+GroundSatelliteLinkManagerTestCase::CheckLinks()
+{
+    Time now = Simulator::Now();
+    uint32_t expectedLinks = 0;
+    for (uint32_t g = 0; g < m_groundStations.GetN(); ++g)
+    {
+        Ptr<Node> groundStation = m_groundStations.Get(g);
+        std::vector<uint32_t> expected;
+        m_plan->GetVisibleSatellites(groundStation, now, expected);
+        expectedLinks += expected.size();
+
+        // Every device that is up is attached to a satellite device that is up
+        std::vector<uint32_t> bound;
+        for (Ptr<GroundSatelliteNetDevice> device : GetDevices(groundStation))
+        {
+            if (!device->IsLinkUp())
+            {
+                continue;
+            }
+            Ptr<Channel> channel = device->GetChannel();
+            NS_TEST_ASSERT_MSG_EQ(channel->GetNDevices(), 2, "Bound link without a satellite end");
+            Ptr<NetDevice> peer = (channel->GetDevice(0) == device) ? channel->GetDevice(1) : channel->GetDevice(0);
+            NS_TEST_EXPECT_MSG_EQ(peer->IsLinkUp(), true, "Satellite end of a bound link is down");
+            bound.push_back(peer->GetNode()->GetId());
+        }
+        std::sort(bound.begin(), bound.end());
+        std::sort(expected.begin(), expected.end());
+        NS_TEST_EXPECT_MSG_EQ((bound == expected), true,
+                              "Ground station " << g << " has " << bound.size() << " links at " << now.GetSeconds()
+                                                << "s, the plan " << expected.size() << " contacts");
+    }
+    NS_TEST_EXPECT_MSG_EQ(m_manager->GetNActiveLinks(), expectedLinks, "Wrong number of active links");
+    ++m_numChecks;
+}
+
+void
+GroundSatelliteLinkManagerTestCase::DoRun()
+{
+    NS_TEST_ASSERT_MSG_NE(m_manager, nullptr, "No link manager");
+    NS_TEST_ASSERT_MSG_GT(m_plan->GetNContacts(), 0, "No contacts to bind");
+    CheckPoolSizes();
+
+    // Between the samples of the plan, where no contact starts or ends
+    for (Time t = Seconds(5); t < Seconds(1200); t += Seconds(10))
+    {
+        Simulator::Schedule(t, &GroundSatelliteLinkManagerTestCase::CheckLinks, this);
+    }
+    Simulator::Stop(Seconds(1200));
+    Simulator::Run();
+    NS_TEST_EXPECT_MSG_EQ(m_numChecks, 120, "Not every check ran");
+}
+
+/**
+ * @ingroup satellite
+ * @brief TestSuite for contact-plan driven ground links.
+ */
+class GroundSatelliteLinkManagerTestSuite : public TestSuite
+{
+public:
+    GroundSatelliteLinkManagerTestSuite();
+};
+
+GroundSatelliteLinkManagerTestSuite::GroundSatelliteLinkManagerTestSuite()
+    : TestSuite("ground-satellite-link-manager", Type::UNIT)
+{
+    AddTestCase(new GroundSatelliteLinkManagerTestCase, TestCase::Duration::QUICK);
+}
+
+static GroundSatelliteLinkManagerTestSuite g_groundSatelliteLinkManagerTestSuite; //!< Static variable for test initialization
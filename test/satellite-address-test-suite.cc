@@ -0,0 +1,158 @@
+#include "ns3/ipv4-address.h"
+#include "ns3/node.h"
+#include "ns3/satellite-address-table.h"
+#include "ns3/satellite-prefix-table.h"
+#include "ns3/test.h"
+
+#include <random>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * @ingroup satellite
+ * @brief The flat address table finds every inserted address and nothing else,
+ *        across growth, overwrites and Clear().
+ */
+class SatelliteAddressTableTestCase : public TestCase
+{
+public:
+    SatelliteAddressTableTestCase();
+
+private:
+    void DoRun() override;
+};
+
+SatelliteAddressTableTestCase::SatelliteAddressTableTestCase()
+    : TestCase("Address table exact lookups")
+{
+}
+
+void
+SatelliteAddressTableTestCase::DoRun()
+{
+    std::vector<Ptr<Node>> nodes;
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+        nodes.push_back(CreateObject<Node>());
+    }
+
+    // Enough addresses to grow the table several times, with keys that share
+    // their low bits
+    SatelliteAddressTable table;
+    const uint32_t numAddresses = 5000;
+    for (uint32_t i = 0; i < numAddresses; ++i)
+    {
+        table.Insert(Ipv4Address(0x0a000001 + (i << 8)), nodes[i % nodes.size()]);
+    }
+    NS_TEST_ASSERT_MSG_EQ(table.GetSize(), numAddresses, "Wrong number of addresses");
+    for (uint32_t i = 0; i < numAddresses; ++i)
+    {
+        NS_TEST_EXPECT_MSG_EQ(table.Find(Ipv4Address(0x0a000001 + (i << 8))), nodes[i % nodes.size()],
+                              "Wrong node of address " << i);
+        NS_TEST_EXPECT_MSG_EQ(table.Find(Ipv4Address(0x0a000002 + (i << 8))), nullptr,
+                              "Found an address that was never inserted");
+    }
+
+    table.Insert(Ipv4Address(0x0a000001), nodes[7]);
+    NS_TEST_EXPECT_MSG_EQ(table.GetSize(), numAddresses, "Overwrite added an address");
+    NS_TEST_EXPECT_MSG_EQ(table.Find(Ipv4Address(0x0a000001)), nodes[7], "Overwrite not applied");
+
+    table.Clear();
+    NS_TEST_EXPECT_MSG_EQ(table.GetSize(), 0, "Addresses left after Clear()");
+    NS_TEST_EXPECT_MSG_EQ(table.Find(Ipv4Address(0x0a000101)), nullptr, "Found an address after Clear()");
+}
+
+/**
+ * @ingroup satellite
+ * @brief The prefix trie returns the longest matching prefix, checked against
+ *        a linear scan over random prefixes of every length.
+ */
+class SatellitePrefixTableTestCase : public TestCase
+{
+public:
+    SatellitePrefixTableTestCase();
+
+private:
+    void DoRun() override;
+};
+
+SatellitePrefixTableTestCase::SatellitePrefixTableTestCase()
+    : TestCase("Prefix table longest prefix match")
+{
+}
+
+void
+SatellitePrefixTableTestCase::DoRun()
+{
+    struct Prefix
+    {
+        uint32_t address;
+        uint8_t length;
+        Ptr<Node> node;
+    };
+
+    auto mask = [](uint8_t length) { return length ? ~uint32_t(0) << (32 - length) : 0; };
+
+    // Nested prefixes under few top bytes, so that lengths compete for the
+    // same addresses; later inserts of the same prefix overwrite earlier ones
+    std::mt19937 rng(1);
+    std::vector<Prefix> prefixes;
+    SatellitePrefixTable table;
+    for (uint32_t i = 0; i < 400; ++i)
+    {
+        uint8_t length = rng() % 33;
+        uint32_t address = (0x0a000000 | (rng() & 0x0003ffff)) & mask(length);
+        Prefix prefix = {address, length, CreateObject<Node>()};
+        for (Prefix& other : prefixes)
+        {
+            if (other.address == address && other.length == length)
+            {
+                other.node = nullptr;
+            }
+        }
+        prefixes.push_back(prefix);
+        table.Insert(Ipv4Address(address), length, prefix.node);
+    }
+
+    for (uint32_t i = 0; i < 20000; ++i)
+    {
+        uint32_t address = (i % 2) ? prefixes[rng() % prefixes.size()].address | (rng() & 0xff)
+                                   : 0x0a000000 | (rng() & 0x0003ffff);
+        Ptr<Node> expected;
+        int32_t expectedLength = -1;
+        for (const Prefix& prefix : prefixes)
+        {
+            if (prefix.node && (address & mask(prefix.length)) == prefix.address && prefix.length > expectedLength)
+            {
+                expected = prefix.node;
+                expectedLength = prefix.length;
+            }
+        }
+        NS_TEST_EXPECT_MSG_EQ(table.Find(Ipv4Address(address)), expected,
+                              "Wrong match for " << Ipv4Address(address) << ", expected a /" << expectedLength);
+    }
+
+    table.Clear();
+    NS_TEST_EXPECT_MSG_EQ(table.GetSize(), 0, "Prefixes left after Clear()");
+    NS_TEST_EXPECT_MSG_EQ(table.Find(Ipv4Address(0x0a000001)), nullptr, "Found a prefix after Clear()");
+}
+
+/**
+ * @ingroup satellite
+ * @brief TestSuite for the node lookup tables of the SP routing protocol.
+ */
+class SatelliteAddressTestSuite : public TestSuite
+{
+public:
+    SatelliteAddressTestSuite();
+};
+
+SatelliteAddressTestSuite::SatelliteAddressTestSuite()
+    : TestSuite("satellite-address", Type::UNIT)
+{
+    AddTestCase(new SatelliteAddressTableTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new SatellitePrefixTableTestCase, TestCase::Duration::QUICK);
+}
+
+static SatelliteAddressTestSuite g_satelliteAddressTestSuite; //!< Static variable for test initialization
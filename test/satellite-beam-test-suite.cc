@@ -0,0 +1,306 @@
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/mac48-address.h"
+#include "ns3/satellite-beam-channel.h"
+#include "ns3/satellite-beam-helper.h"
+#include "ns3/satellite-beam-net-device.h"
+#include "ns3/satellite-helper.h"
+#include "ns3/satellite-link-routes.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <map>
+
+using namespace ns3;
+
+/**
+ * @ingroup satellite
+ * @brief Beams deliver uplinks to their satellite and downlinks to the
+ *        addressed terminals of the beam only.
+ */
+class SatelliteBeamDeliveryTestCase : public TestCase
+{
+public:
+    SatelliteBeamDeliveryTestCase();
+
+private:
+    void DoSetup() override;
+    void DoRun() override;
+    void DoTeardown() override;
+
+    /**
+     * @brief Send a frame of PACKET_SIZE bytes.
+     * @param sender The sending device.
+     * @param dest The destination MAC address.
+     */
+    void Send(Ptr<SatelliteBeamNetDevice> sender, Address dest);
+
+    /**
+     * @brief Count a received frame.
+     * @param device The receiving device.
+     * @param packet The frame.
+     * @param protocol The protocol number.
+     * @param from The source address.
+     * @return Always true.
+     */
+    bool Receive(Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address& from);
+
+    /**
+     * @param device A device.
+     * @return The frames it received so far.
+     */
+    uint32_t GetReceived(Ptr<SatelliteBeamNetDevice> device) const;
+
+    static constexpr uint32_t PACKET_SIZE = 1000;
+
+    NodeContainer m_satellites;
+    NodeContainer m_groundStations;
+    std::vector<Ptr<SatelliteBeamNetDevice>> m_beams;     //!< Satellite devices
+    std::vector<Ptr<SatelliteBeamNetDevice>> m_terminals; //!< Ground terminals
+    std::map<Ptr<NetDevice>, uint32_t> m_received;
+    Time m_sent;
+    Time m_firstArrival;
+};
+
+SatelliteBeamDeliveryTestCase::SatelliteBeamDeliveryTestCase()
+    : TestCase("Beams deliver to their satellite and addressed terminals")
+{
+}
+
+void
+SatelliteBeamDeliveryTestCase::DoSetup()
+{
+    SatelliteHelper satelliteHelper;
+    for (const NodeContainer& plane : satelliteHelper.CreateShell(550e3, 53.0, 2, 2))
+    {
+        m_satellites.Add(plane);
+    }
+    for (double latitude : {0.0, 10.0, -10.0})
+    {
+        m_groundStations.Add(satelliteHelper.CreateGroundStation(latitude, 0.0));
+    }
+
+    SatelliteBeamHelper beamHelper;
+    beamHelper.SetChannelAttribute("DownlinkDataRate", DataRateValue(DataRate("8Mbps")));
+    beamHelper.SetChannelAttribute("UplinkDataRate", DataRateValue(DataRate("2Mbps")));
+    NetDeviceContainer devices = beamHelper.Install(m_satellites, m_groundStations);
+    for (uint32_t i = 0; i < devices.GetN(); ++i)
+    {
+        Ptr<SatelliteBeamNetDevice> device = DynamicCast<SatelliteBeamNetDevice>(devices.Get(i));
+        (i < m_satellites.GetN() ? m_beams : m_terminals).push_back(device);
+        device->SetReceiveCallback(MakeCallback(&SatelliteBeamDeliveryTestCase::Receive, this));
+    }
+}
+
+void
+SatelliteBeamDeliveryTestCase::DoTeardown()
+{
+    m_beams.clear();
+    m_terminals.clear();
+    m_received.clear();
+    Simulator::Destroy();
+}
+
+void
+SatelliteBeamDeliveryTestCase::Send(Ptr<SatelliteBeamNetDevice> sender, Address dest)
+{
+    m_sent = Simulator::Now();
+    m_firstArrival = Time::Max();
+    NS_TEST_EXPECT_MSG_EQ(sender->Send(Create<Packet>(PACKET_SIZE), dest, 0x0800), true, "Frame not queued");
+}
+
+bool
+SatelliteBeamDeliveryTestCase::Receive(Ptr<NetDevice> device,
+                                       Ptr<const Packet> packet,
+                                       uint16_t protocol,
+                                       const Address& from)
+{
+    NS_TEST_EXPECT_MSG_EQ(packet->GetSize(), PACKET_SIZE, "Frame received with its header");
+    NS_TEST_EXPECT_MSG_EQ(protocol, 0x0800, "Wrong protocol number");
+    ++m_received[device];
+    m_firstArrival = std::min(m_firstArrival, Simulator::Now());
+    return true;
+}
+
+uint32_t
+SatelliteBeamDeliveryTestCase::GetReceived(Ptr<SatelliteBeamNetDevice> device) const
+{
+    auto it = m_received.find(device);
+    return it == m_received.end() ? 0 : it->second;
+}
+
+void
+SatelliteBeamDeliveryTestCase::DoRun()
+{
+    NS_TEST_ASSERT_MSG_EQ(m_beams.size(), m_satellites.GetN(), "One beam per satellite");
+    NS_TEST_ASSERT_MSG_EQ(m_terminals.size(), m_groundStations.GetN(), "One terminal per ground station");
+    for (Ptr<SatelliteBeamNetDevice> terminal : m_terminals)
+    {
+        NS_TEST_EXPECT_MSG_NE(terminal->GetBeam(), nullptr, "Terminal installed outside every beam");
+        NS_TEST_EXPECT_MSG_EQ(terminal->IsSatellite(), false, "Terminal flagged as a satellite");
+    }
+
+    // Two terminals in the first beam, one in the second
+    Ptr<SatelliteBeamNetDevice> sat0 = m_beams[0];
+    Ptr<SatelliteBeamNetDevice> sat1 = m_beams[1];
+    m_terminals[0]->Handover(sat0->GetBeam());
+    m_terminals[1]->Handover(sat0->GetBeam());
+    m_terminals[2]->Handover(sat1->GetBeam());
+    NS_TEST_EXPECT_MSG_EQ(sat0->GetBeam()->GetNTerminals(), 2, "Wrong terminals in the first beam");
+    NS_TEST_EXPECT_MSG_EQ(sat1->GetBeam()->GetNTerminals(), 1, "Wrong terminals in the second beam");
+    NS_TEST_EXPECT_MSG_EQ(sat0->GetBeam()->GetSatellite(), sat0, "Beam not served by its satellite");
+
+    // Uplink reaches the satellite of the beam only, after the frame is serialized
+    Simulator::Schedule(Seconds(1), &SatelliteBeamDeliveryTestCase::Send, this, m_terminals[0], sat0->GetAddress());
+    Simulator::Run();
+    NS_TEST_EXPECT_MSG_EQ(GetReceived(sat0), 1, "Uplink not delivered to the satellite");
+    NS_TEST_EXPECT_MSG_EQ(GetReceived(sat1), 0, "Uplink delivered to another beam");
+    NS_TEST_EXPECT_MSG_EQ(GetReceived(m_terminals[1]), 0, "Uplink delivered to a terminal");
+    Time uplinkTx = DataRate("2Mbps").CalculateBytesTxTime(PACKET_SIZE);
+    NS_TEST_EXPECT_MSG_GT_OR_EQ(m_firstArrival - m_sent, uplinkTx, "Uplink faster than its data rate");
+
+    // Unicast downlink reaches the addressed terminal only
+    Simulator::Schedule(Seconds(1), &SatelliteBeamDeliveryTestCase::Send, this, sat0, m_terminals[1]->GetAddress());
+    Simulator::Run();
+    NS_TEST_EXPECT_MSG_EQ(GetReceived(m_terminals[0]), 0, "Downlink delivered to another terminal");
+    NS_TEST_EXPECT_MSG_EQ(GetReceived(m_terminals[1]), 1, "Downlink not delivered to its terminal");
+    NS_TEST_EXPECT_MSG_EQ(GetReceived(m_terminals[2]), 0, "Downlink delivered to another beam");
+    Time downlinkTx = DataRate("8Mbps").CalculateBytesTxTime(PACKET_SIZE);
+    NS_TEST_EXPECT_MSG_GT_OR_EQ(m_firstArrival - m_sent, downlinkTx, "Downlink faster than its data rate");
+
+    // Broadcast reaches every terminal of the beam, none of the other beam
+    Simulator::Schedule(Seconds(1), &SatelliteBeamDeliveryTestCase::Send, this, sat0, sat0->GetBroadcast());
+    Simulator::Run();
+    NS_TEST_EXPECT_MSG_EQ(GetReceived(m_terminals[0]), 1, "Broadcast missed a terminal of the beam");
+    NS_TEST_EXPECT_MSG_EQ(GetReceived(m_terminals[1]), 2, "Broadcast missed a terminal of the beam");
+    NS_TEST_EXPECT_MSG_EQ(GetReceived(m_terminals[2]), 0, "Broadcast leaked into another beam");
+
+    // After a handover the terminal hears the new beam and is gone from the old one
+    m_terminals[2]->Handover(sat0->GetBeam());
+    NS_TEST_EXPECT_MSG_EQ(sat0->GetBeam()->GetNTerminals(), 3, "Handover did not join the beam");
+    NS_TEST_EXPECT_MSG_EQ(sat1->GetBeam()->GetNTerminals(), 0, "Handover did not leave the old beam");
+    Simulator::Schedule(Seconds(1), &SatelliteBeamDeliveryTestCase::Send, this, sat1, sat1->GetBroadcast());
+    Simulator::Schedule(Seconds(2), &SatelliteBeamDeliveryTestCase::Send, this, sat0, sat0->GetBroadcast());
+    Simulator::Run();
+    NS_TEST_EXPECT_MSG_EQ(GetReceived(m_terminals[0]), 2, "Broadcast missed a terminal of the beam");
+    NS_TEST_EXPECT_MSG_EQ(GetReceived(m_terminals[2]), 1, "Terminal still in its old beam");
+
+    // A terminal outside every beam is down and cannot send
+    m_terminals[0]->Handover(nullptr);
+    NS_TEST_EXPECT_MSG_EQ(m_terminals[0]->IsLinkUp(), false, "Terminal up outside every beam");
+    NS_TEST_EXPECT_MSG_EQ(m_terminals[0]->Send(Create<Packet>(PACKET_SIZE), sat0->GetAddress(), 0x0800),
+                          false,
+                          "Terminal sent outside every beam");
+}
+
+/**
+ * @ingroup satellite
+ * @brief Beam routes select the beam of the satellite at the other end.
+ *
+ * Routing over a beam names the satellite end of the hop; the terminal must be
+ * in that satellite's beam, whichever end builds the route.
+ */
+class SatelliteBeamSelectionTestCase : public TestCase
+{
+public:
+    SatelliteBeamSelectionTestCase();
+
+private:
+    void DoSetup() override;
+    void DoRun() override;
+    void DoTeardown() override;
+
+    NodeContainer m_satellites;
+    NodeContainer m_groundStations;
+};
+
+SatelliteBeamSelectionTestCase::SatelliteBeamSelectionTestCase()
+    : TestCase("Beam routes hand the terminal over to the satellite end")
+{
+}
+
+void
+SatelliteBeamSelectionTestCase::DoSetup()
+{
+    SatelliteHelper satelliteHelper;
+    for (const NodeContainer& plane : satelliteHelper.CreateShell(550e3, 53.0, 2, 3))
+    {
+        m_satellites.Add(plane);
+    }
+    m_groundStations.Add(satelliteHelper.CreateGroundStation(20.0, 20.0));
+    m_groundStations.Add(satelliteHelper.CreateGroundStation(-20.0, 100.0));
+
+    SatelliteBeamHelper beamHelper;
+    NetDeviceContainer devices = beamHelper.Install(m_satellites, m_groundStations);
+    InternetStackHelper internet;
+    internet.Install(m_satellites);
+    internet.Install(m_groundStations);
+    Ipv4AddressHelper addresses("10.0.0.0", "255.255.255.0");
+    addresses.Assign(devices);
+}
+
+void
+SatelliteBeamSelectionTestCase::DoTeardown()
+{
+    Simulator::Destroy();
+}
+
+void
+SatelliteBeamSelectionTestCase::DoRun()
+{
+    // Ground end: the route to each satellite selects its beam
+    Ptr<Node> groundStation = m_groundStations.Get(0);
+    Ptr<SatelliteBeamNetDevice> terminal = SatelliteBeamNetDevice::GetBeamDevice(groundStation);
+    SatelliteLinkRoutes groundRoutes;
+    groundRoutes.Setup(groundStation->GetObject<Ipv4>(), nullptr);
+    NS_TEST_ASSERT_MSG_EQ(groundRoutes.HasBeamDevice(), true, "Terminal not found");
+    for (uint32_t s = 0; s < m_satellites.GetN(); ++s)
+    {
+        Ptr<Node> satellite = m_satellites.Get(s);
+        Ptr<SatelliteBeamNetDevice> beam = SatelliteBeamNetDevice::GetBeamDevice(satellite);
+        Ptr<Ipv4Route> route = groundRoutes.GetBeamRoute(s, satellite, m_satellites.GetN());
+        NS_TEST_ASSERT_MSG_NE(route, nullptr, "No beam route to satellite " << s);
+        NS_TEST_EXPECT_MSG_EQ(route->GetOutputDevice(), terminal, "Route not over the terminal");
+        Ptr<Ipv4> satelliteIpv4 = satellite->GetObject<Ipv4>();
+        NS_TEST_EXPECT_MSG_EQ(route->GetGateway(),
+                              satelliteIpv4->GetAddress(satelliteIpv4->GetInterfaceForDevice(beam), 0).GetLocal(),
+                              "Route not through satellite " << s);
+        NS_TEST_EXPECT_MSG_EQ(terminal->GetBeam(), beam->GetBeam(), "Terminal not in the beam of satellite " << s);
+    }
+
+    // Satellite end: routing down to the terminal pulls it into the satellite's beam
+    Ptr<Node> satellite = m_satellites.Get(0);
+    Ptr<SatelliteBeamNetDevice> beam = SatelliteBeamNetDevice::GetBeamDevice(satellite);
+    SatelliteLinkRoutes satelliteRoutes;
+    satelliteRoutes.Setup(satellite->GetObject<Ipv4>(), nullptr);
+    NS_TEST_EXPECT_MSG_NE(terminal->GetBeam(), beam->GetBeam(), "Terminal already in the beam");
+    Ptr<Ipv4Route> route = satelliteRoutes.GetBeamRoute(0, groundStation, m_groundStations.GetN());
+    NS_TEST_ASSERT_MSG_NE(route, nullptr, "No beam route to the ground station");
+    NS_TEST_EXPECT_MSG_EQ(route->GetOutputDevice(), beam, "Route not over the satellite's beam");
+    NS_TEST_EXPECT_MSG_EQ(terminal->GetBeam(), beam->GetBeam(), "Terminal not handed over to the satellite");
+
+    // Reused routes still select the beam
+    groundRoutes.GetBeamRoute(1, m_satellites.Get(1), m_satellites.GetN());
+    NS_TEST_EXPECT_MSG_NE(terminal->GetBeam(), beam->GetBeam(), "Terminal did not leave the beam");
+    satelliteRoutes.GetBeamRoute(0, groundStation, m_groundStations.GetN());
+    NS_TEST_EXPECT_MSG_EQ(terminal->GetBeam(), beam->GetBeam(), "Cached route did not hand over");
+}
+
+/**
+ * @ingroup satellite
+ * @brief TestSuite for shared satellite beams.
+ */
+class SatelliteBeamTestSuite : public TestSuite
+{
+public:
+    SatelliteBeamTestSuite();
+};
+
+SatelliteBeamTestSuite::SatelliteBeamTestSuite()
+    : TestSuite("satellite-beam", Type::UNIT)
+{
+    AddTestCase(new SatelliteBeamDeliveryTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new SatelliteBeamSelectionTestCase, TestCase::Duration::QUICK);
+}
+
+static SatelliteBeamTestSuite g_satelliteBeamTestSuite; //!< Static variable for test initialization
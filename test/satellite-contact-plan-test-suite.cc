@@ -0,0 +1,179 @@
+#include "ns3/mobility-model.h"
+#include "ns3/satellite-contact-plan.h"
+#include "ns3/satellite-helper.h"
+#include "ns3/satellite-spatial-index.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * @ingroup satellite
+ * @brief Contact plan lookups agree with the elevation of every satellite.
+ *
+ * A plan is generated for a Walker shell and ground stations at several
+ * latitudes, then every sample of the horizon is checked against elevations
+ * computed from the satellite positions, both at the sample and halfway to
+ * the next one, where the plan still holds the sampled contacts.
+ */
+class SatelliteContactPlanTestCase : public TestCase
+{
+public:
+    SatelliteContactPlanTestCase();
+
+private:
+    void DoSetup() override;
+    void DoRun() override;
+    void DoTeardown() override;
+
+    /**
+     * @brief Compare the plan at a time with the geometry of a sample.
+     * @param t The time to look the plan up at.
+     * @param sample The sample time whose positions decide visibility.
+     */
+    void CheckContacts(Time t, Time sample);
+
+    static constexpr double MIN_ELEVATION = 25.0;
+
+    NodeContainer m_satellites;
+    NodeContainer m_groundStations;
+    SatelliteSpatialIndex m_index;
+    SatelliteContactPlan m_plan;
+    std::string m_path;
+};
+
+SatelliteContactPlanTestCase::SatelliteContactPlanTestCase()
+    : TestCase("Contact plan matches the elevation geometry")
+{
+}
+
+void
+SatelliteContactPlanTestCase::DoSetup()
+{
+    SatelliteHelper satelliteHelper;
+    for (const NodeContainer& plane : satelliteHelper.CreateShell(550e3, 53.0, 8, 10))
+    {
+        m_satellites.Add(plane);
+    }
+    for (double latitude : {0.0, 35.0, -50.0, 80.0})
+    {
+        m_groundStations.Add(satelliteHelper.CreateGroundStation(latitude, latitude * 2.0));
+    }
+    m_index.SetSatellites(std::vector<Ptr<Node>>(m_satellites.Begin(), m_satellites.End()));
+    m_path = CreateTempDirFilename("satellite-contacts.bin");
+}
+
+void
+SatelliteContactPlanTestCase::DoTeardown()
+{
+    m_plan.Close();
+    std::remove(m_path.c_str());
+    Simulator::Destroy();
+}
+
+void
+SatelliteContactPlanTestCase::CheckContacts(Time t, Time sample)
+{
+    const double sinMask = std::sin(MIN_ELEVATION * M_PI / 180.0);
+    m_index.Update(sample);
+    for (uint32_t g = 0; g < m_groundStations.GetN(); ++g)
+    {
+        Ptr<Node> groundStation = m_groundStations.Get(g);
+        Vector p = groundStation->GetObject<MobilityModel>()->GetPosition();
+        double r = std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
+
+        std::vector<uint32_t> expected;
+        for (uint32_t s = 0; s < m_satellites.GetN(); ++s)
+        {
+            Ptr<Node> satellite = m_satellites.Get(s);
+            Vector d = m_index.GetPosition(s) - p;
+            double range = std::sqrt(d.x * d.x + d.y * d.y + d.z * d.z);
+            bool visible = (d.x * p.x + d.y * p.y + d.z * p.z) / r >= sinMask * range;
+            if (visible)
+            {
+                expected.push_back(satellite->GetId());
+            }
+
+            NS_TEST_EXPECT_MSG_EQ(m_plan.IsInContact(groundStation, satellite, t), visible,
+                                  "Ground station " << g << ", satellite " << s << " at " << t.GetSeconds() << "s");
+            const SatelliteContact* contact = m_plan.FindContact(groundStation, satellite, t);
+            NS_TEST_ASSERT_MSG_EQ((contact != nullptr), visible, "FindContact() disagrees with IsInContact()");
+            if (contact)
+            {
+                NS_TEST_EXPECT_MSG_EQ((contact->start <= t.GetNanoSeconds() && t.GetNanoSeconds() < contact->end),
+                                      true,
+                                      "Contact does not cover " << t.GetSeconds() << "s");
+                NS_TEST_EXPECT_MSG_EQ((contact->minRange <= range + 1e-6 && range <= contact->maxRange + 1e-6),
+                                      true,
+                                      "Sampled range outside the contact's range");
+            }
+            else
+            {
+                const SatelliteContact* next = m_plan.FindNextContact(groundStation, satellite, t);
+                NS_TEST_EXPECT_MSG_EQ((!next || next->start > t.GetNanoSeconds()), true,
+                                      "Next contact of a pair out of contact already started");
+            }
+        }
+
+        std::vector<uint32_t> visible;
+        m_plan.GetVisibleSatellites(groundStation, t, visible);
+        std::sort(visible.begin(), visible.end());
+        std::sort(expected.begin(), expected.end());
+        NS_TEST_EXPECT_MSG_EQ((visible == expected), true,
+                              "Ground station " << g << " sees " << visible.size() << " satellites at "
+                                                << t.GetSeconds() << "s, the geometry " << expected.size());
+    }
+}
+
+void
+SatelliteContactPlanTestCase::DoRun()
+{
+    const Time start = Seconds(100);
+    const Time end = Seconds(1300);
+    const Time step = Seconds(20);
+    NS_TEST_ASSERT_MSG_EQ(
+        SatelliteContactPlan::Generate(m_path, m_groundStations, m_satellites, start, end, step, MIN_ELEVATION),
+        true,
+        "Cannot write the contact plan");
+    NS_TEST_ASSERT_MSG_EQ(m_plan.Open(m_path), true, "Cannot read the contact plan");
+    NS_TEST_EXPECT_MSG_EQ(m_plan.GetNGroundStations(), m_groundStations.GetN(), "Wrong number of ground stations");
+    NS_TEST_EXPECT_MSG_EQ(m_plan.GetNSatellites(), m_satellites.GetN(), "Wrong number of satellites");
+    NS_TEST_EXPECT_MSG_GT(m_plan.GetNContacts(), 0, "No contacts over the horizon");
+
+    for (Time sample = start; sample < end; sample += step)
+    {
+        CheckContacts(sample, sample);
+        CheckContacts(sample + step / 2, sample);
+    }
+
+    // Outside the horizon nothing is visible
+    std::vector<uint32_t> visible;
+    m_plan.GetVisibleSatellites(m_groundStations.Get(0), end + step, visible);
+    NS_TEST_EXPECT_MSG_EQ(visible.empty(), true, "Satellites visible after the horizon");
+    NS_TEST_EXPECT_MSG_EQ(m_plan.IsInContact(m_groundStations.Get(0), m_satellites.Get(0), start - step),
+                          false,
+                          "Contact before the horizon");
+}
+
+/**
+ * @ingroup satellite
+ * @brief TestSuite for the ground station contact plan.
+ */
+class SatelliteContactPlanTestSuite : public TestSuite
+{
+public:
+    SatelliteContactPlanTestSuite();
+};
+
+SatelliteContactPlanTestSuite::SatelliteContactPlanTestSuite()
+    : TestSuite("satellite-contact-plan", Type::UNIT)
+{
+    AddTestCase(new SatelliteContactPlanTestCase, TestCase::Duration::QUICK);
+}
+
+static SatelliteContactPlanTestSuite g_satelliteContactPlanTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,282 @@
+#include "ns3/nstime.h"
+#include "ns3/satellite-ephemeris.h"
+#include "ns3/satellite-orbit-propagator.h"
+#include "ns3/test.h"
+#include "ns3/vector.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * @ingroup satellite
+ * @brief Base of the ephemeris tests: a handful of slots on different orbits,
+ *        released again when the test case ends.
+ */
+class SatelliteEphemerisTestCase : public TestCase
+{
+public:
+    /**
+     * @param name The test case name.
+     */
+    SatelliteEphemerisTestCase(std::string name);
+
+protected:
+    /// Not a multiple of any vector width, so the kernels run their tails.
+    static constexpr uint32_t N_SLOTS = 37;
+
+    void DoSetup() override;
+    void DoTeardown() override;
+
+    /**
+     * @brief Elements of the i-th test orbit, in the units of SetElements().
+     */
+    static double GetAltitude(uint32_t i);
+    static double GetInclination(uint32_t i);
+    static double GetRaan(uint32_t i);
+    static double GetInitialAngle(uint32_t i);
+
+    std::vector<uint32_t> m_slots;
+};
+
+SatelliteEphemerisTestCase::SatelliteEphemerisTestCase(std::string name)
+    : TestCase(name)
+{
+}
+
+void
+SatelliteEphemerisTestCase::DoSetup()
+{
+    SatelliteEphemeris& ephemeris = SatelliteEphemeris::Get();
+    for (uint32_t i = 0; i < N_SLOTS; ++i)
+    {
+        uint32_t slot = ephemeris.Register();
+        ephemeris.SetElements(slot, GetAltitude(i), GetInclination(i), GetRaan(i), GetInitialAngle(i));
+        m_slots.push_back(slot);
+    }
+}
+
+void
+SatelliteEphemerisTestCase::DoTeardown()
+{
+    for (uint32_t slot : m_slots)
+    {
+        SatelliteEphemeris::Get().Unregister(slot);
+    }
+    m_slots.clear();
+}
+
+double
+SatelliteEphemerisTestCase::GetAltitude(uint32_t i)
+{
+    return 500e3 + 20e3 * (i % 5);
+}
+
+double
+SatelliteEphemerisTestCase::GetInclination(uint32_t i)
+{
+    return 10.0 * (i % 10);
+}
+
+double
+SatelliteEphemerisTestCase::GetRaan(uint32_t i)
+{
+    return 360.0 * i / N_SLOTS;
+}
+
+double
+SatelliteEphemerisTestCase::GetInitialAngle(uint32_t i)
+{
+    return 47.0 * i;
+}
+
+/**
+ * @ingroup satellite
+ * @brief Slot positions and velocities are those of the circular orbit the
+ *        mobility model computed on every call before the ephemeris.
+ */
+class SatelliteEphemerisOrbitTestCase : public SatelliteEphemerisTestCase
+{
+public:
+    SatelliteEphemerisOrbitTestCase();
+
+private:
+    void DoRun() override;
+};
+
+SatelliteEphemerisOrbitTestCase::SatelliteEphemerisOrbitTestCase()
+    : SatelliteEphemerisTestCase("Ephemeris slots follow circular orbits")
+{
+}
+
+void
+SatelliteEphemerisOrbitTestCase::DoRun()
+{
+    SatelliteEphemeris& ephemeris = SatelliteEphemeris::Get();
+    for (double t : {0.0, 1.0, 600.5, 86400.0})
+    {
+        for (uint32_t i = 0; i < N_SLOTS; ++i)
+        {
+            double radius = SatelliteEphemeris::EARTH_RADIUS + GetAltitude(i);
+            double speed = std::sqrt(SatelliteEphemeris::GM_EARTH / radius);
+            double angle = GetInitialAngle(i) * M_PI / 180.0 + speed / radius * t;
+            double cosI = std::cos(GetInclination(i) * M_PI / 180.0);
+            double sinI = std::sin(GetInclination(i) * M_PI / 180.0);
+            double cosRaan = std::cos(GetRaan(i) * M_PI / 180.0);
+            double sinRaan = std::sin(GetRaan(i) * M_PI / 180.0);
+            double x = radius * std::cos(angle);
+            double y = radius * std::sin(angle);
+            double vx = -speed * std::sin(angle);
+            double vy = speed * std::cos(angle);
+
+            Vector position = ephemeris.GetPosition(m_slots[i], Seconds(t));
+            Vector velocity = ephemeris.GetVelocity(m_slots[i], Seconds(t));
+            NS_TEST_EXPECT_MSG_EQ_TOL(position.x, x * cosRaan - y * cosI * sinRaan, 1e-6, "Wrong x of orbit " << i);
+            NS_TEST_EXPECT_MSG_EQ_TOL(position.y, x * sinRaan + y * cosI * cosRaan, 1e-6, "Wrong y of orbit " << i);
+            NS_TEST_EXPECT_MSG_EQ_TOL(position.z, y * sinI, 1e-6, "Wrong z of orbit " << i);
+            NS_TEST_EXPECT_MSG_EQ_TOL(velocity.x, vx * cosRaan - vy * cosI * sinRaan, 1e-9, "Wrong vx of orbit " << i);
+            NS_TEST_EXPECT_MSG_EQ_TOL(velocity.y, vx * sinRaan + vy * cosI * cosRaan, 1e-9, "Wrong vy of orbit " << i);
+            NS_TEST_EXPECT_MSG_EQ_TOL(velocity.z, vy * sinI, 1e-9, "Wrong vz of orbit " << i);
+        }
+    }
+}
+
+/**
+ * @ingroup satellite
+ * @brief Batch refreshes do not change what single slot queries return, and
+ *        every vector kernel agrees with the scalar one.
+ */
+class SatelliteEphemerisBatchTestCase : public SatelliteEphemerisTestCase
+{
+public:
+    SatelliteEphemerisBatchTestCase();
+
+private:
+    void DoRun() override;
+    void DoTeardown() override;
+};
+
+SatelliteEphemerisBatchTestCase::SatelliteEphemerisBatchTestCase()
+    : SatelliteEphemerisTestCase("Batch propagation is deterministic")
+{
+}
+
+void
+SatelliteEphemerisBatchTestCase::DoRun()
+{
+    SatelliteEphemeris& ephemeris = SatelliteEphemeris::Get();
+    SatelliteOrbitPropagator::Kernel kernel = SatelliteOrbitPropagator::GetKernel();
+    NS_TEST_EXPECT_MSG_NE(kernel, SatelliteOrbitPropagator::AUTO, "AUTO was not resolved to a kernel");
+    NS_TEST_EXPECT_MSG_EQ(SatelliteOrbitPropagator::IsSupported(kernel), true, "Selected an unsupported kernel");
+
+    // The scalar batch is bit-identical to the slot queries
+    SatelliteOrbitPropagator::SetKernel(SatelliteOrbitPropagator::SCALAR);
+    Time now = Seconds(1234.5);
+    ephemeris.Refresh(now);
+    for (uint32_t slot : m_slots)
+    {
+        Vector position = ephemeris.GetPosition(slot, now);
+        NS_TEST_EXPECT_MSG_EQ(ephemeris.GetX()[slot], position.x, "Batch x differs from slot " << slot);
+        NS_TEST_EXPECT_MSG_EQ(ephemeris.GetY()[slot], position.y, "Batch y differs from slot " << slot);
+        NS_TEST_EXPECT_MSG_EQ(ephemeris.GetZ()[slot], position.z, "Batch z differs from slot " << slot);
+    }
+
+    // A vector refresh at the time of earlier slot queries leaves their
+    // positions alone
+    Time later = now + Seconds(1);
+    std::vector<Vector> before;
+    for (uint32_t slot : m_slots)
+    {
+        before.push_back(ephemeris.GetPosition(slot, later));
+    }
+    SatelliteOrbitPropagator::SetKernel(SatelliteOrbitPropagator::AUTO);
+    ephemeris.Refresh(later);
+    for (uint32_t i = 0; i < N_SLOTS; ++i)
+    {
+        Vector position = ephemeris.GetPosition(m_slots[i], later);
+        NS_TEST_EXPECT_MSG_EQ((position.x == before[i].x && position.y == before[i].y && position.z == before[i].z),
+                              true,
+                              "Batch refresh changed the position of slot " << m_slots[i]);
+    }
+
+    // Every supported kernel against the scalar one, on the same elements
+    std::vector<double> radius(N_SLOTS);
+    std::vector<double> speed(N_SLOTS);
+    std::vector<double> angularVelocity(N_SLOTS);
+    std::vector<double> initialAngle(N_SLOTS);
+    std::vector<double> cosInclination(N_SLOTS);
+    std::vector<double> sinInclination(N_SLOTS);
+    std::vector<double> cosRaan(N_SLOTS);
+    std::vector<double> sinRaan(N_SLOTS);
+    for (uint32_t i = 0; i < N_SLOTS; ++i)
+    {
+        radius[i] = SatelliteEphemeris::EARTH_RADIUS + GetAltitude(i);
+        speed[i] = std::sqrt(SatelliteEphemeris::GM_EARTH / radius[i]);
+        angularVelocity[i] = speed[i] / radius[i];
+        initialAngle[i] = GetInitialAngle(i) * M_PI / 180.0;
+        cosInclination[i] = std::cos(GetInclination(i) * M_PI / 180.0);
+        sinInclination[i] = std::sin(GetInclination(i) * M_PI / 180.0);
+        cosRaan[i] = std::cos(GetRaan(i) * M_PI / 180.0);
+        sinRaan[i] = std::sin(GetRaan(i) * M_PI / 180.0);
+    }
+    SatelliteOrbitPropagator::Elements elements = {radius.data(), speed.data(), angularVelocity.data(),
+                                                   initialAngle.data(), cosInclination.data(),
+                                                   sinInclination.data(), cosRaan.data(), sinRaan.data()};
+    std::vector<std::vector<double>> reference(6, std::vector<double>(N_SLOTS));
+    SatelliteOrbitPropagator::State referenceState = {reference[0].data(), reference[1].data(),
+                                                      reference[2].data(), reference[3].data(),
+                                                      reference[4].data(), reference[5].data()};
+    double t = 5400.25;
+    SatelliteOrbitPropagator::Propagate(SatelliteOrbitPropagator::SCALAR, elements, referenceState, 0, N_SLOTS, t);
+
+    for (SatelliteOrbitPropagator::Kernel kernel : {SatelliteOrbitPropagator::AVX2, SatelliteOrbitPropagator::AVX512})
+    {
+        if (!SatelliteOrbitPropagator::IsSupported(kernel))
+        {
+            continue;
+        }
+        std::vector<std::vector<double>> result(6, std::vector<double>(N_SLOTS));
+        SatelliteOrbitPropagator::State state = {result[0].data(), result[1].data(), result[2].data(),
+                                                 result[3].data(), result[4].data(), result[5].data()};
+        SatelliteOrbitPropagator::Propagate(kernel, elements, state, 0, N_SLOTS, t);
+        for (uint32_t c = 0; c < 6; ++c)
+        {
+            // Meters for positions, meters per second for velocities
+            double tolerance = (c < 3) ? 1e-3 : 1e-6;
+            for (uint32_t i = 0; i < N_SLOTS; ++i)
+            {
+                NS_TEST_EXPECT_MSG_EQ_TOL(result[c][i], reference[c][i], tolerance,
+                                          SatelliteOrbitPropagator::GetKernelName(kernel)
+                                              << " differs from the scalar kernel, component " << c
+                                              << " of satellite " << i);
+            }
+        }
+    }
+}
+
+void
+SatelliteEphemerisBatchTestCase::DoTeardown()
+{
+    SatelliteOrbitPropagator::SetKernel(SatelliteOrbitPropagator::AUTO);
+    SatelliteEphemerisTestCase::DoTeardown();
+}
+
+/**
+ * @ingroup satellite
+ * @brief TestSuite for the constellation ephemeris and the batch propagator.
+ */
+class SatelliteEphemerisTestSuite : public TestSuite
+{
+public:
+    SatelliteEphemerisTestSuite();
+};
+
+SatelliteEphemerisTestSuite::SatelliteEphemerisTestSuite()
+    : TestSuite("satellite-ephemeris", Type::UNIT)
+{
+    AddTestCase(new SatelliteEphemerisOrbitTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new SatelliteEphemerisBatchTestCase, TestCase::Duration::QUICK);
+}
+
+static SatelliteEphemerisTestSuite g_satelliteEphemerisTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,828 @@
+#include "ns3/satellite-all-pairs-router.h"
+#include "ns3/satellite-archive-router.h"
+#include "ns3/satellite-grid-router.h"
+#include "ns3/satellite-on-demand-router.h"
+#include "ns3/satellite-route-graph.h"
+#include "ns3/test.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * @ingroup satellite
+ * @brief Base of the route engine tests: a small Walker-like constellation
+ *        with four inter-satellite links per satellite.
+ *
+ * Positions move a little with every step, so that the searches see new
+ * link lengths each epoch. Next-hop providers are checked against shortest
+ * path lengths found by Floyd-Warshall.
+ */
+class SatelliteTorusTestCase : public TestCase
+{
+public:
+    /**
+     * @param name The test case name.
+     */
+    SatelliteTorusTestCase(std::string name);
+
+protected:
+    static constexpr uint32_t N_PLANES = 6;
+    static constexpr uint32_t N_PER_PLANE = 8;
+    static constexpr uint32_t N_STEPS = 4;
+
+    /**
+     * @brief Build the graph and the positions of the first step.
+     */
+    void DoSetup() override;
+
+    /**
+     * @brief Move every satellite to a step and update the edge weights.
+     * @param step The step.
+     */
+    void MoveTo(uint32_t step);
+
+    /**
+     * @param u A satellite.
+     * @param v Another satellite.
+     * @return The weight of the edge from u to v, or infinity if there is none.
+     */
+    double GetLinkLength(uint32_t u, uint32_t v) const;
+
+    /**
+     * @brief Follow the next hops of a provider from one satellite to another.
+     * @param router The provider.
+     * @param src The source satellite.
+     * @param dst The destination satellite.
+     * @return The length of the path in meters, or -1 if it does not reach dst.
+     */
+    double GetPathLength(SatelliteNextHopProvider& router, uint32_t src, uint32_t dst) const;
+
+    /**
+     * @return Shortest path lengths between every pair by Floyd-Warshall,
+     *         row = source.
+     */
+    std::vector<double> GetAllPairsLengths() const;
+
+    /**
+     * @brief Check that a provider has no next hop from a satellite to itself
+     *        and that its paths between every other pair are shortest paths.
+     * @param router The provider, up to date for the current step.
+     * @param tolerance Allowed excess length, in meters.
+     * @param step The current step, for the messages.
+     */
+    void CheckShortestPaths(SatelliteNextHopProvider& router, double tolerance, uint32_t step);
+
+    uint32_t m_n;
+    std::vector<std::vector<uint32_t>> m_planes; //!< Satellites of every plane, in link order
+    SatelliteRouteGraph m_graph;
+    std::vector<double> m_x;
+    std::vector<double> m_y;
+    std::vector<double> m_z;
+};
+
+SatelliteTorusTestCase::SatelliteTorusTestCase(std::string name)
+    : TestCase(name),
+      m_n(N_PLANES * N_PER_PLANE)
+{
+}
+
+void
+SatelliteTorusTestCase::DoSetup()
+{
+    std::vector<std::vector<uint32_t>> adjacency(m_n);
+    m_planes.assign(N_PLANES, {});
+    for (uint32_t p = 0; p < N_PLANES; ++p)
+    {
+        for (uint32_t s = 0; s < N_PER_PLANE; ++s)
+        {
+            m_planes[p].push_back(p * N_PER_PLANE + s);
+            adjacency[p * N_PER_PLANE + s] = {p * N_PER_PLANE + (s + 1) % N_PER_PLANE,
+                                              p * N_PER_PLANE + (s + N_PER_PLANE - 1) % N_PER_PLANE,
+                                              ((p + 1) % N_PLANES) * N_PER_PLANE + s,
+                                              ((p + N_PLANES - 1) % N_PLANES) * N_PER_PLANE + s};
+        }
+    }
+    m_graph.Build(adjacency);
+    m_x.resize(m_n);
+    m_y.resize(m_n);
+    m_z.resize(m_n);
+    MoveTo(0);
+}
+
+void
+SatelliteTorusTestCase::MoveTo(uint32_t step)
+{
+    const double radius = 7e6;
+    const double inclination = 0.9;
+    for (uint32_t p = 0; p < N_PLANES; ++p)
+    {
+        for (uint32_t s = 0; s < N_PER_PLANE; ++s)
+        {
+            uint32_t v = p * N_PER_PLANE + s;
+            double raan = 2 * M_PI * p / N_PLANES;
+            double anomaly = 2 * M_PI * s / N_PER_PLANE + 0.3 * p + 0.01 * step;
+            m_x[v] = radius * (std::cos(raan) * std::cos(anomaly) -
+                               std::sin(raan) * std::sin(anomaly) * std::cos(inclination));
+            m_y[v] = radius * (std::sin(raan) * std::cos(anomaly) +
+                               std::cos(raan) * std::sin(anomaly) * std::cos(inclination));
+            m_z[v] = radius * std::sin(anomaly) * std::sin(inclination);
+        }
+    }
+    m_graph.UpdateWeights(m_x.data(), m_y.data(), m_z.data());
+}
+
+double
+SatelliteTorusTestCase::GetLinkLength(uint32_t u, uint32_t v) const
+{
+    for (uint32_t e = m_graph.GetOffsets()[u]; e < m_graph.GetOffsets()[u + 1]; ++e)
+    {
+        if (m_graph.GetTargets()[e] == v)
+        {
+            return m_graph.GetWeights()[e];
+        }
+    }
+    return std::numeric_limits<double>::infinity();
+}
+
+double
+SatelliteTorusTestCase::GetPathLength(SatelliteNextHopProvider& router, uint32_t src, uint32_t dst) const
+{
+    double length = 0;
+    uint32_t u = src;
+    for (uint32_t hops = 0; u != dst; ++hops)
+    {
+        uint32_t v = router.GetNextHop(u, dst);
+        if (v >= m_n || std::isinf(GetLinkLength(u, v)) || hops >= m_n)
+        {
+            return -1;
+        }
+        length += GetLinkLength(u, v);
+        u = v;
+    }
+    return length;
+}
+
+std::vector<double>
+SatelliteTorusTestCase::GetAllPairsLengths() const
+{
+    std::vector<double> dist(m_n * m_n, std::numeric_limits<double>::infinity());
+    for (uint32_t u = 0; u < m_n; ++u)
+    {
+        dist[u * m_n + u] = 0;
+        for (uint32_t e = m_graph.GetOffsets()[u]; e < m_graph.GetOffsets()[u + 1]; ++e)
+        {
+            dist[u * m_n + m_graph.GetTargets()[e]] = m_graph.GetWeights()[e];
+        }
+    }
+    for (uint32_t k = 0; k < m_n; ++k)
+    {
+        for (uint32_t i = 0; i < m_n; ++i)
+        {
+            for (uint32_t j = 0; j < m_n; ++j)
+            {
+                dist[i * m_n + j] = std::min(dist[i * m_n + j], dist[i * m_n + k] + dist[k * m_n + j]);
+            }
+        }
+    }
+    return dist;
+}
+
+void
+SatelliteTorusTestCase::CheckShortestPaths(SatelliteNextHopProvider& router, double tolerance, uint32_t step)
+{
+    std::vector<double> dist = GetAllPairsLengths();
+    for (uint32_t src = 0; src < m_n; ++src)
+    {
+        NS_TEST_EXPECT_MSG_EQ(router.GetNextHop(src, src), SatelliteRouteGraph::INVALID_INDEX,
+                              "Satellite " << src << " has a next hop to itself");
+        for (uint32_t dst = 0; dst < m_n; ++dst)
+        {
+            if (src != dst)
+            {
+                NS_TEST_EXPECT_MSG_EQ_TOL(GetPathLength(router, src, dst), dist[src * m_n + dst], tolerance,
+                                          "Path " << src << " -> " << dst << " at step " << step
+                                                  << " is not a shortest path");
+            }
+        }
+    }
+}
+
+/**
+ * @ingroup satellite
+ * @brief The baseline all-pairs next hops follow shortest paths.
+ */
+class SatelliteAllPairsBaselineTestCase : public SatelliteTorusTestCase
+{
+public:
+    SatelliteAllPairsBaselineTestCase();
+
+private:
+    void DoRun() override;
+};
+
+SatelliteAllPairsBaselineTestCase::SatelliteAllPairsBaselineTestCase()
+    : SatelliteTorusTestCase("All-pairs next hops follow shortest paths")
+{
+}
+
+void
+SatelliteAllPairsBaselineTestCase::DoRun()
+{
+    SatelliteAllPairsRouter router;
+    NS_TEST_EXPECT_MSG_EQ(router.GetNextHop(0, 1), SatelliteRouteGraph::INVALID_INDEX,
+                          "Next hop found before the first Compute()");
+    for (uint32_t step = 0; step < N_STEPS; ++step)
+    {
+        MoveTo(step);
+        router.Compute(m_graph);
+        NS_TEST_ASSERT_MSG_EQ(router.GetMatrix().size(), m_n * m_n, "Matrix is not N x N");
+        CheckShortestPaths(router, 1e-3, step);
+    }
+}
+
+/**
+ * @ingroup satellite
+ * @brief Searches spread over a worker pool give the same matrix as one thread.
+ */
+class SatelliteAllPairsThreadsTestCase : public SatelliteTorusTestCase
+{
+public:
+    SatelliteAllPairsThreadsTestCase();
+
+private:
+    void DoRun() override;
+};
+
+SatelliteAllPairsThreadsTestCase::SatelliteAllPairsThreadsTestCase()
+    : SatelliteTorusTestCase("All-pairs next hops do not depend on the number of threads")
+{
+}
+
+void
+SatelliteAllPairsThreadsTestCase::DoRun()
+{
+    SatelliteAllPairsRouter baseline;
+    SatelliteAllPairsRouter pooled;
+    pooled.SetNThreads(3);
+    for (uint32_t step = 0; step < N_STEPS; ++step)
+    {
+        MoveTo(step);
+        baseline.Compute(m_graph);
+        pooled.Compute(m_graph);
+        NS_TEST_ASSERT_MSG_EQ((pooled.GetMatrix() == baseline.GetMatrix()), true,
+                              "Matrix of 3 threads differs from the baseline at step " << step);
+    }
+}
+
+/**
+ * @ingroup satellite
+ * @brief The CSR graph holds every link once, weighted by its length.
+ */
+class SatelliteRouteGraphTestCase : public SatelliteTorusTestCase
+{
+public:
+    SatelliteRouteGraphTestCase();
+
+private:
+    void DoRun() override;
+};
+
+SatelliteRouteGraphTestCase::SatelliteRouteGraphTestCase()
+    : SatelliteTorusTestCase("CSR graph holds every link with its length")
+{
+}
+
+void
+SatelliteRouteGraphTestCase::DoRun()
+{
+    NS_TEST_ASSERT_MSG_EQ(m_graph.GetNVertices(), m_n, "Wrong number of vertices");
+    NS_TEST_ASSERT_MSG_EQ(m_graph.GetNEdges(), 4 * m_n, "Wrong number of edges");
+    for (uint32_t step = 0; step < N_STEPS; ++step)
+    {
+        MoveTo(step);
+        for (uint32_t u = 0; u < m_n; ++u)
+        {
+            for (uint32_t e = m_graph.GetOffsets()[u]; e < m_graph.GetOffsets()[u + 1]; ++e)
+            {
+                uint32_t v = m_graph.GetTargets()[e];
+                double length = std::sqrt((m_x[v] - m_x[u]) * (m_x[v] - m_x[u]) +
+                                          (m_y[v] - m_y[u]) * (m_y[v] - m_y[u]) +
+                                          (m_z[v] - m_z[u]) * (m_z[v] - m_z[u]));
+                NS_TEST_EXPECT_MSG_EQ_TOL(m_graph.GetWeights()[e], length, 1e-6,
+                                          "Wrong weight of edge " << u << " -> " << v << " at step " << step);
+                NS_TEST_EXPECT_MSG_EQ(std::isinf(GetLinkLength(v, u)), false,
+                                      "Link " << u << " - " << v << " is one-way");
+            }
+        }
+    }
+    NS_TEST_EXPECT_MSG_EQ(std::isinf(GetLinkLength(0, m_n / 2)), true,
+                          "Found an edge between satellites with no link");
+}
+
+/**
+ * @ingroup satellite
+ * @brief Shortest path trees repaired between epochs still give shortest paths.
+ */
+class SatelliteAllPairsRepairTestCase : public SatelliteTorusTestCase
+{
+public:
+    SatelliteAllPairsRepairTestCase();
+
+private:
+    void DoRun() override;
+};
+
+SatelliteAllPairsRepairTestCase::SatelliteAllPairsRepairTestCase()
+    : SatelliteTorusTestCase("Incremental repair keeps shortest paths")
+{
+}
+
+void
+SatelliteAllPairsRepairTestCase::DoRun()
+{
+    SatelliteAllPairsRouter router;
+    router.SetIncrementalRepair(true, 0);
+    for (uint32_t step = 0; step < N_STEPS; ++step)
+    {
+        MoveTo(step);
+        if (step == 2)
+        {
+            // A link failure between epochs cuts the subtrees behind it
+            m_graph.SetEdgeFailed(m_graph.FindEdge(0, N_PER_PLANE), true);
+            m_graph.SetEdgeFailed(m_graph.FindEdge(N_PER_PLANE, 0), true);
+            MoveTo(step);
+        }
+        router.Compute(m_graph);
+        if (step == 0)
+        {
+            NS_TEST_EXPECT_MSG_EQ(router.GetLastRepairedVertices(), uint64_t(m_n) * m_n,
+                                  "First epoch was not a full computation");
+        }
+        else
+        {
+            NS_TEST_EXPECT_MSG_LT(router.GetLastRepairedVertices(), uint64_t(m_n) * m_n,
+                                  "Step " << step << " was not repaired incrementally");
+        }
+        CheckShortestPaths(router, 1e-3, step);
+    }
+}
+
+/**
+ * @ingroup satellite
+ * @brief Failed links get an infinite weight and are routed around until
+ *        they are repaired.
+ */
+class SatelliteFailedLinkTestCase : public SatelliteTorusTestCase
+{
+public:
+    SatelliteFailedLinkTestCase();
+
+private:
+    void DoRun() override;
+};
+
+SatelliteFailedLinkTestCase::SatelliteFailedLinkTestCase()
+    : SatelliteTorusTestCase("Failed links are routed around")
+{
+}
+
+void
+SatelliteFailedLinkTestCase::DoRun()
+{
+    for (uint32_t u = 0; u < m_n; ++u)
+    {
+        for (uint32_t e = m_graph.GetOffsets()[u]; e < m_graph.GetOffsets()[u + 1]; ++e)
+        {
+            NS_TEST_EXPECT_MSG_EQ(m_graph.FindEdge(u, m_graph.GetTargets()[e]), e, "Edge " << e << " not found");
+        }
+    }
+    NS_TEST_EXPECT_MSG_EQ(m_graph.FindEdge(0, m_n / 2), SatelliteRouteGraph::INVALID_INDEX,
+                          "Found an edge between satellites with no link");
+
+    // Cut both directions of one link; the searches must go around it
+    uint32_t e = m_graph.FindEdge(0, 1);
+    m_graph.SetEdgeFailed(e, true);
+    m_graph.SetEdgeFailed(m_graph.FindEdge(1, 0), true);
+    NS_TEST_ASSERT_MSG_EQ(m_graph.GetNFailedEdges(), 2, "Wrong number of failed edges");
+    MoveTo(1);
+    NS_TEST_EXPECT_MSG_EQ(std::isinf(m_graph.GetWeights()[e]), true, "Failed edge kept a finite weight");
+
+    SatelliteAllPairsRouter router;
+    router.Compute(m_graph);
+    NS_TEST_EXPECT_MSG_NE(router.GetNextHop(0, 1), 1u, "Routed over a failed link");
+    CheckShortestPaths(router, 1e-3, 1);
+
+    m_graph.SetEdgeFailed(e, false);
+    m_graph.SetEdgeFailed(m_graph.FindEdge(1, 0), false);
+    NS_TEST_EXPECT_MSG_EQ(m_graph.GetNFailedEdges(), 0, "Repaired edges still failed");
+    MoveTo(1);
+    router.Compute(m_graph);
+    NS_TEST_EXPECT_MSG_EQ(router.GetNextHop(0, 1), 1u, "Repaired link not used again");
+}
+
+/**
+ * @ingroup satellite
+ * @brief +Grid next hops take a minimum-hop path between every pair.
+ */
+class SatelliteGridRouterTestCase : public SatelliteTorusTestCase
+{
+public:
+    SatelliteGridRouterTestCase();
+
+private:
+    void DoRun() override;
+};
+
+SatelliteGridRouterTestCase::SatelliteGridRouterTestCase()
+    : SatelliteTorusTestCase("+Grid next hops take minimum-hop paths")
+{
+}
+
+void
+SatelliteGridRouterTestCase::DoRun()
+{
+    SatelliteGridRouter router;
+    NS_TEST_ASSERT_MSG_EQ(router.Build(m_graph, m_planes), true, "Torus not recognised as a +Grid");
+    NS_TEST_ASSERT_MSG_EQ(router.GetNPlanes(), N_PLANES, "Wrong number of planes");
+    NS_TEST_ASSERT_MSG_EQ(router.GetSatellitesPerPlane(), N_PER_PLANE, "Wrong number of satellites per plane");
+
+    for (uint32_t step = 0; step < N_STEPS; ++step)
+    {
+        MoveTo(step);
+        for (uint32_t src = 0; src < m_n; ++src)
+        {
+            NS_TEST_EXPECT_MSG_EQ(router.GetNextHop(src, src), SatelliteGridRouter::INVALID_INDEX,
+                                  "Satellite " << src << " has a next hop to itself");
+            for (uint32_t dst = 0; dst < m_n; ++dst)
+            {
+                if (src == dst)
+                {
+                    continue;
+                }
+                uint32_t planes = (src / N_PER_PLANE + N_PLANES - dst / N_PER_PLANE) % N_PLANES;
+                uint32_t slots = (src % N_PER_PLANE + N_PER_PLANE - dst % N_PER_PLANE) % N_PER_PLANE;
+                uint32_t minHops = std::min(planes, N_PLANES - planes) + std::min(slots, N_PER_PLANE - slots);
+                NS_TEST_EXPECT_MSG_EQ(router.GetHopCount(src, dst), minHops,
+                                      "Wrong hop count " << src << " -> " << dst);
+
+                uint32_t hops = 0;
+                for (uint32_t u = src; u != dst && hops <= m_n; ++hops)
+                {
+                    u = router.GetNextHop(u, dst);
+                    if (u == SatelliteGridRouter::INVALID_INDEX)
+                    {
+                        break;
+                    }
+                }
+                NS_TEST_EXPECT_MSG_EQ(hops, minHops, "Path " << src << " -> " << dst << " is not minimum-hop");
+                NS_TEST_EXPECT_MSG_GT(GetPathLength(router, src, dst), 0, "Path " << src << " -> " << dst << " broken");
+            }
+        }
+    }
+
+    // Planes of different sizes are no +Grid
+    std::vector<std::vector<uint32_t>> planes = m_planes;
+    planes.back().pop_back();
+    SatelliteGridRouter uneven;
+    NS_TEST_EXPECT_MSG_EQ(uneven.Build(m_graph, planes), false, "Uneven planes accepted as a +Grid");
+    NS_TEST_EXPECT_MSG_EQ(uneven.IsValid(), false, "Router valid after a failed Build()");
+}
+
+/**
+ * @ingroup satellite
+ * @brief Pairs resolved on demand by bidirectional A* follow shortest paths,
+ *        and each is searched once per epoch.
+ */
+class SatelliteOnDemandRouterTestCase : public SatelliteTorusTestCase
+{
+public:
+    SatelliteOnDemandRouterTestCase();
+
+private:
+    void DoRun() override;
+};
+
+SatelliteOnDemandRouterTestCase::SatelliteOnDemandRouterTestCase()
+    : SatelliteTorusTestCase("On-demand A* paths are shortest paths")
+{
+}
+
+void
+SatelliteOnDemandRouterTestCase::DoRun()
+{
+    SatelliteOnDemandRouter router;
+    for (uint32_t step = 0; step < N_STEPS; ++step)
+    {
+        MoveTo(step);
+        router.Reset(m_graph, m_x.data(), m_y.data(), m_z.data());
+        NS_TEST_EXPECT_MSG_EQ(router.GetNSearches(), 0, "Searches left over from the previous epoch");
+        CheckShortestPaths(router, 1e-3, step);
+
+        // Every pair is memoized now
+        uint32_t searches = router.GetNSearches();
+        NS_TEST_EXPECT_MSG_LT(searches, m_n * m_n, "Hops of found paths were not memoized");
+        router.GetNextHop(0, m_n - 1);
+        NS_TEST_EXPECT_MSG_EQ(router.GetNSearches(), searches, "Memoized pair searched again");
+    }
+
+    router.Clear();
+    NS_TEST_EXPECT_MSG_EQ(router.GetNextHop(0, 1), SatelliteRouteGraph::INVALID_INDEX,
+                          "Next hop found after Clear()");
+}
+
+/**
+ * @ingroup satellite
+ * @brief The multi-source search finds the cheapest (ingress, egress) pair.
+ *
+ * Source and target sets stand for the satellites two ground stations see,
+ * with their uplink and downlink ranges as start and exit costs. Every search
+ * is compared with the minimum over all pairs of the sets by Floyd-Warshall.
+ */
+class SatelliteGroundPathTestCase : public SatelliteTorusTestCase
+{
+public:
+    SatelliteGroundPathTestCase();
+
+private:
+    void DoRun() override;
+};
+
+SatelliteGroundPathTestCase::SatelliteGroundPathTestCase()
+    : SatelliteTorusTestCase("Ground-to-ground searches find the cheapest pair")
+{
+}
+
+void
+SatelliteGroundPathTestCase::DoRun()
+{
+    const double inf = std::numeric_limits<double>::infinity();
+    uint32_t seed = 1;
+    auto next = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return seed >> 8;
+    };
+    auto randomSet = [&](uint32_t size) {
+        std::vector<std::pair<uint32_t, double>> set;
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            set.push_back({next() % m_n, 5e5 + (next() % 1500) * 1e3});
+        }
+        return set;
+    };
+
+    // One scratch for every search, as the engine keeps it
+    SatellitePairSearchScratch scratch;
+    for (uint32_t step = 0; step < N_STEPS; ++step)
+    {
+        MoveTo(step);
+        std::vector<double> dist = GetAllPairsLengths();
+        for (uint32_t trial = 0; trial < 50; ++trial)
+        {
+            // Sets may share satellites, and a set may list one twice
+            std::vector<std::pair<uint32_t, double>> sources = randomSet(1 + trial % 6);
+            std::vector<std::pair<uint32_t, double>> targets = randomSet(1 + trial % 5);
+
+            double expected = inf;
+            for (const auto& source : sources)
+            {
+                for (const auto& target : targets)
+                {
+                    expected = std::min(expected, source.second + dist[source.first * m_n + target.first] + target.second);
+                }
+            }
+
+            uint32_t ingress;
+            uint32_t egress;
+            double length = FindShortestPathBetweenSets(m_graph, sources, targets, scratch, ingress, egress);
+            NS_TEST_EXPECT_MSG_EQ_TOL(length, expected, 1e-3, "Not the cheapest pair at step " << step << ", trial " << trial);
+            NS_TEST_ASSERT_MSG_LT(ingress, m_n, "No ingress at step " << step << ", trial " << trial);
+            NS_TEST_ASSERT_MSG_LT(egress, m_n, "No egress at step " << step << ", trial " << trial);
+
+            // The returned pair achieves the total
+            double start = inf;
+            for (const auto& source : sources)
+            {
+                if (source.first == ingress)
+                {
+                    start = std::min(start, source.second);
+                }
+            }
+            double exit = inf;
+            for (const auto& target : targets)
+            {
+                if (target.first == egress)
+                {
+                    exit = std::min(exit, target.second);
+                }
+            }
+            NS_TEST_EXPECT_MSG_EQ_TOL(start + dist[ingress * m_n + egress] + exit, length, 1e-3,
+                                      "Ingress " << ingress << " and egress " << egress << " do not give the total");
+        }
+    }
+
+    // Nothing to reach
+    uint32_t ingress;
+    uint32_t egress;
+    double length = FindShortestPathBetweenSets(m_graph, {{0, 1.0}}, {}, scratch, ingress, egress);
+    NS_TEST_EXPECT_MSG_EQ(std::isinf(length), true, "Path found without targets");
+    NS_TEST_EXPECT_MSG_EQ(ingress, SatelliteRouteGraph::INVALID_INDEX, "Ingress without a path");
+    NS_TEST_EXPECT_MSG_EQ(egress, SatelliteRouteGraph::INVALID_INDEX, "Egress without a path");
+}
+
+/**
+ * @ingroup satellite
+ * @brief Searches on integer-key queues follow shortest paths.
+ *
+ * The radix heap and Dial queue search on link delays rounded to nanoseconds,
+ * so paths within a few rounding steps of each other may swap; lengths are
+ * compared with a tolerance of a meter.
+ */
+class SatelliteAllPairsQueueTestCase : public SatelliteTorusTestCase
+{
+public:
+    SatelliteAllPairsQueueTestCase();
+
+private:
+    void DoRun() override;
+};
+
+SatelliteAllPairsQueueTestCase::SatelliteAllPairsQueueTestCase()
+    : SatelliteTorusTestCase("Radix heap and Dial searches follow shortest paths")
+{
+}
+
+void
+SatelliteAllPairsQueueTestCase::DoRun()
+{
+    SatelliteAllPairsRouter radix;
+    radix.SetQueueType(SatelliteAllPairsRouter::RADIX_HEAP);
+    SatelliteAllPairsRouter dial;
+    dial.SetQueueType(SatelliteAllPairsRouter::DIAL);
+    for (uint32_t step = 0; step < N_STEPS; ++step)
+    {
+        MoveTo(step);
+        radix.Compute(m_graph);
+        CheckShortestPaths(radix, 1.0, step);
+        dial.Compute(m_graph);
+        CheckShortestPaths(dial, 1.0, step);
+    }
+}
+
+/**
+ * @ingroup satellite
+ * @brief Routes written to an archive are replayed unchanged.
+ *
+ * The first two epochs are written with the same routes and must share one
+ * table. The archive is then mapped again and every epoch replayed against
+ * the all-pairs next hops; times outside the horizon and files that are not
+ * archives are rejected.
+ */
+class SatelliteArchiveRouterTestCase : public SatelliteTorusTestCase
+{
+public:
+    SatelliteArchiveRouterTestCase();
+
+private:
+    void DoRun() override;
+
+    /**
+     * @brief Convert next hops to the adjacency slots the archive stores.
+     */
+    std::vector<uint8_t> GetSlots(const std::vector<uint32_t>& nextHops) const;
+};
+
+SatelliteArchiveRouterTestCase::SatelliteArchiveRouterTestCase()
+    : SatelliteTorusTestCase("Archived routes replay the computed next hops")
+{
+}
+
+std::vector<uint8_t>
+SatelliteArchiveRouterTestCase::GetSlots(const std::vector<uint32_t>& nextHops) const
+{
+    const std::vector<uint32_t>& offsets = m_graph.GetOffsets();
+    const std::vector<uint32_t>& targets = m_graph.GetTargets();
+    std::vector<uint8_t> slots(nextHops.size(), SatelliteRouteArchive::NO_ROUTE);
+    for (uint32_t src = 0; src < m_n; ++src)
+    {
+        for (uint32_t dst = 0; dst < m_n; ++dst)
+        {
+            for (uint32_t k = offsets[src]; k < offsets[src + 1]; ++k)
+            {
+                if (targets[k] == nextHops[src * m_n + dst])
+                {
+                    slots[src * m_n + dst] = k - offsets[src];
+                }
+            }
+        }
+    }
+    return slots;
+}
+
+void
+SatelliteArchiveRouterTestCase::DoRun()
+{
+    const std::string path = CreateTempDirFilename("satellite-routes.bin");
+    const Time start = Seconds(10);
+    const Time interval = Seconds(1);
+    const uint64_t fingerprint = 0x5a7e111e;
+    const uint32_t numEpochs = N_STEPS + 1;
+
+    // Epoch e holds the routes of step max(e - 1, 0); egress satellites are
+    // arbitrary, but part of the table, so they follow the step too
+    SatelliteAllPairsRouter allPairs;
+    std::vector<std::vector<uint32_t>> matrices;
+    SatelliteRouteArchiveWriter writer;
+    NS_TEST_ASSERT_MSG_EQ(writer.Open(path, m_n, 2, start, interval, fingerprint), true, "Cannot create archive");
+    for (uint32_t e = 0; e < numEpochs; ++e)
+    {
+        uint32_t step = e ? e - 1 : 0;
+        MoveTo(step);
+        allPairs.Compute(m_graph);
+        matrices.push_back(allPairs.GetMatrix());
+        uint32_t egress[2] = {step, m_n - 1 - step};
+        writer.AddEpoch(GetSlots(allPairs.GetMatrix()).data(), egress);
+    }
+    NS_TEST_ASSERT_MSG_EQ(writer.Close(), true, "Cannot write archive");
+
+    SatelliteArchiveRouter router;
+    NS_TEST_ASSERT_MSG_EQ(router.Open(path, m_graph), true, "Cannot read archive");
+    const SatelliteRouteArchive& archive = router.GetArchive();
+    NS_TEST_EXPECT_MSG_EQ(archive.GetNSatellites(), m_n, "Wrong number of satellites");
+    NS_TEST_EXPECT_MSG_EQ(archive.GetNEpochs(), numEpochs, "Wrong number of epochs");
+    NS_TEST_EXPECT_MSG_EQ(archive.GetFingerprint(), fingerprint, "Fingerprint did not survive the round trip");
+    NS_TEST_EXPECT_MSG_EQ(archive.GetTable(0), archive.GetTable(1), "Identical epochs did not share a table");
+    NS_TEST_EXPECT_MSG_LT(archive.GetNTables(), numEpochs, "Identical epochs were stored twice");
+
+    for (uint32_t e = 0; e < numEpochs; ++e)
+    {
+        uint32_t step = e ? e - 1 : 0;
+        MoveTo(step);
+        NS_TEST_ASSERT_MSG_EQ(router.Select(start + interval * e + MilliSeconds(500)), true,
+                              "Archived epoch " << e << " not found");
+        NS_TEST_EXPECT_MSG_EQ(router.GetEpochStart(), start + interval * e, "Wrong start of epoch " << e);
+        NS_TEST_EXPECT_MSG_EQ(router.GetEgress(0), step, "Wrong egress at epoch " << e);
+        NS_TEST_EXPECT_MSG_EQ(router.GetEgress(1), m_n - 1 - step, "Wrong egress at epoch " << e);
+        for (uint32_t src = 0; src < m_n; ++src)
+        {
+            for (uint32_t dst = 0; dst < m_n; ++dst)
+            {
+                NS_TEST_ASSERT_MSG_EQ(router.GetNextHop(src, dst), matrices[e][src * m_n + dst],
+                                      "Replayed next hop " << src << " -> " << dst << " differs at epoch " << e);
+            }
+        }
+        CheckShortestPaths(router, 1e-3, step);
+
+        Time change = router.GetNextChange();
+        if (change != Time::Max())
+        {
+            uint64_t next = archive.FindEpoch(change);
+            NS_TEST_EXPECT_MSG_EQ((archive.GetTable(next) != router.GetTable()), true,
+                                  "Next change of epoch " << e << " keeps the table");
+        }
+    }
+
+    NS_TEST_EXPECT_MSG_EQ(router.Select(start - interval), false, "Time before the archive replayed");
+    NS_TEST_EXPECT_MSG_EQ(router.Select(start + interval * numEpochs), false, "Time after the archive replayed");
+    NS_TEST_EXPECT_MSG_EQ(router.GetNextHop(0, 1), SatelliteRouteGraph::INVALID_INDEX,
+                          "Next hop found outside the archive");
+    router.Close();
+
+    // A file that is not an archive, or is cut short, is rejected
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << "SATROUTE but not an archive";
+    NS_TEST_EXPECT_MSG_EQ(router.Open(path, m_graph), false, "Truncated archive accepted");
+    std::remove(path.c_str());
+    NS_TEST_EXPECT_MSG_EQ(router.Open(path, m_graph), false, "Missing archive accepted");
+}
+
+/**
+ * @ingroup satellite
+ * @brief Route engine TestSuite.
+ */
+class SatelliteRouteEngineTestSuite : public TestSuite
+{
+public:
+    SatelliteRouteEngineTestSuite();
+};
+
+SatelliteRouteEngineTestSuite::SatelliteRouteEngineTestSuite()
+    : TestSuite("satellite-route-engine", Type::UNIT)
+{
+    AddTestCase(new SatelliteAllPairsBaselineTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new SatelliteAllPairsThreadsTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new SatelliteRouteGraphTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new SatelliteAllPairsRepairTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new SatelliteFailedLinkTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new SatelliteGridRouterTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new SatelliteOnDemandRouterTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new SatelliteAllPairsQueueTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new SatelliteArchiveRouterTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new SatelliteGroundPathTestCase, TestCase::Duration::QUICK);
+}
+
+static SatelliteRouteEngineTestSuite g_satelliteRouteEngineTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,307 @@
+#include "ns3/boolean.h"
+#include "ns3/nstime.h"
+#include "ns3/satellite-route-update-scheduler.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * @ingroup satellite
+ * @brief Registered updates run once per epoch, in registration order, from a
+ *        single simulator event however many clients there are.
+ */
+class SatelliteRouteUpdateEpochTestCase : public TestCase
+{
+public:
+    SatelliteRouteUpdateEpochTestCase();
+
+private:
+    void DoRun() override;
+
+    /**
+     * @brief Run a scheduler with some clients until a stop time.
+     * @param numClients The number of clients.
+     * @param stop The stop time.
+     * @return The number of simulator events executed.
+     */
+    uint64_t RunClients(uint32_t numClients, Time stop);
+
+    /**
+     * @brief Update callback of a client.
+     * @param test The test case.
+     * @param client The client.
+     */
+    static void Update(SatelliteRouteUpdateEpochTestCase* test, uint32_t client);
+
+    Ptr<SatelliteRouteUpdateScheduler> m_scheduler;
+    std::vector<uint32_t> m_ids;        //!< Scheduler ids, by client
+    std::vector<uint32_t> m_order;      //!< Clients in the order they ran
+    std::vector<Time> m_times;          //!< Time of every entry of m_order
+    uint32_t m_removeAt;                //!< Update count at which client 0 removes every client
+};
+
+SatelliteRouteUpdateEpochTestCase::SatelliteRouteUpdateEpochTestCase()
+    : TestCase("One scheduler event per route update epoch"),
+      m_removeAt(0)
+{
+}
+
+void
+SatelliteRouteUpdateEpochTestCase::Update(SatelliteRouteUpdateEpochTestCase* test, uint32_t client)
+{
+    test->m_order.push_back(client);
+    test->m_times.push_back(Simulator::Now());
+    if (client == 0 && test->m_order.size() == test->m_removeAt)
+    {
+        for (uint32_t id : test->m_ids)
+        {
+            test->m_scheduler->Remove(id);
+        }
+    }
+}
+
+uint64_t
+SatelliteRouteUpdateEpochTestCase::RunClients(uint32_t numClients, Time stop)
+{
+    m_scheduler = CreateObject<SatelliteRouteUpdateScheduler>();
+    m_scheduler->SetAttribute("Interval", TimeValue(Seconds(1.0)));
+    m_scheduler->SetAttribute("StartDelay", TimeValue(Seconds(0.1)));
+    m_ids.clear();
+    m_order.clear();
+    m_times.clear();
+    for (uint32_t i = 0; i < numClients; ++i)
+    {
+        m_ids.push_back(m_scheduler->Add(MakeBoundCallback(&SatelliteRouteUpdateEpochTestCase::Update, this, i)));
+    }
+
+    uint64_t events = Simulator::GetEventCount();
+    Simulator::Stop(stop);
+    Simulator::Run();
+    events = Simulator::GetEventCount() - events;
+    m_scheduler->Dispose();
+    m_scheduler = nullptr;
+    Simulator::Destroy();
+    return events;
+}
+
+void
+SatelliteRouteUpdateEpochTestCase::DoRun()
+{
+    const uint32_t numClients = 40;
+    const uint32_t numEpochs = 3;
+    uint64_t single = RunClients(1, Seconds(2.5));
+    uint64_t many = RunClients(numClients, Seconds(2.5));
+    NS_TEST_EXPECT_MSG_EQ(many, single, "Events per epoch grow with the number of clients");
+
+    NS_TEST_ASSERT_MSG_EQ(m_order.size(), numClients * numEpochs, "Clients did not run once per epoch");
+    for (uint32_t i = 0; i < m_order.size(); ++i)
+    {
+        uint32_t epoch = i / numClients;
+        NS_TEST_EXPECT_MSG_EQ(m_order[i], i % numClients, "Clients ran out of registration order");
+        NS_TEST_EXPECT_MSG_EQ(m_times[i], Seconds(0.1 + epoch), "Epoch " << epoch << " ran at the wrong time");
+    }
+
+    // Removing every client from inside an update, the running one included,
+    // skips the rest of the epoch and stops the clock
+    m_removeAt = numClients + 1;
+    RunClients(numClients, Seconds(100.0));
+    NS_TEST_EXPECT_MSG_EQ(m_order.size(), numClients + 1, "Removed clients still ran");
+    NS_TEST_EXPECT_MSG_EQ(m_times.back(), Seconds(1.1), "Clock kept running without clients");
+}
+
+/**
+ * @ingroup satellite
+ * @brief With AdaptiveInterval the time between epochs follows the reported
+ *        route changes and predicted events, within [MinInterval, MaxInterval].
+ */
+class SatelliteRouteUpdateAdaptiveTestCase : public TestCase
+{
+public:
+    SatelliteRouteUpdateAdaptiveTestCase();
+
+private:
+    void DoRun() override;
+
+    /**
+     * @brief Update callback: report the outcome of the epoch from the plan.
+     * @param test The test case.
+     */
+    static void Update(SatelliteRouteUpdateAdaptiveTestCase* test);
+
+    static constexpr uint32_t N_UNCHANGED = 6; //!< Epochs with unchanged routes first
+    static constexpr uint32_t N_CHANGED = 6;   //!< Then epochs with changed routes
+    static constexpr uint32_t N_EPOCHS = 15;   //!< Epochs in total
+
+    Ptr<SatelliteRouteUpdateScheduler> m_scheduler;
+    uint32_t m_id;              //!< Scheduler id of the client
+    std::vector<Time> m_times;  //!< Time of every epoch
+};
+
+SatelliteRouteUpdateAdaptiveTestCase::SatelliteRouteUpdateAdaptiveTestCase()
+    : TestCase("Adaptive interval stays within its bounds"),
+      m_id(0)
+{
+}
+
+void
+SatelliteRouteUpdateAdaptiveTestCase::Update(SatelliteRouteUpdateAdaptiveTestCase* test)
+{
+    uint32_t epoch = test->m_times.size();
+    test->m_times.push_back(Simulator::Now());
+    if (epoch + 1 == N_EPOCHS)
+    {
+        test->m_scheduler->Remove(test->m_id);
+    }
+    else if (epoch < N_UNCHANGED)
+    {
+        test->m_scheduler->ReportEpoch(false, Time::Max());
+    }
+    else if (epoch < N_UNCHANGED + N_CHANGED)
+    {
+        test->m_scheduler->ReportEpoch(true, Time::Max());
+    }
+    else if (epoch == N_UNCHANGED + N_CHANGED)
+    {
+        // An event before the doubled interval
+        test->m_scheduler->ReportEpoch(false, Seconds(0.3));
+    }
+    else
+    {
+        // An event sooner than MinInterval
+        test->m_scheduler->ReportEpoch(false, Seconds(0.01));
+    }
+}
+
+void
+SatelliteRouteUpdateAdaptiveTestCase::DoRun()
+{
+    const Time minInterval = Seconds(0.25);
+    const Time maxInterval = Seconds(4.0);
+    m_scheduler = CreateObject<SatelliteRouteUpdateScheduler>();
+    m_scheduler->SetAttribute("Interval", TimeValue(Seconds(1.0)));
+    m_scheduler->SetAttribute("AdaptiveInterval", BooleanValue(true));
+    m_scheduler->SetAttribute("MinInterval", TimeValue(minInterval));
+    m_scheduler->SetAttribute("MaxInterval", TimeValue(maxInterval));
+    m_id = m_scheduler->Add(MakeBoundCallback(&SatelliteRouteUpdateAdaptiveTestCase::Update, this));
+    Simulator::Run();
+    m_scheduler->Dispose();
+    m_scheduler = nullptr;
+    Simulator::Destroy();
+
+    NS_TEST_ASSERT_MSG_EQ(m_times.size(), N_EPOCHS, "Wrong number of epochs");
+    for (uint32_t i = 1; i < m_times.size(); ++i)
+    {
+        Time interval = m_times[i] - m_times[i - 1];
+        NS_TEST_EXPECT_MSG_GT_OR_EQ(interval, minInterval, "Interval before epoch " << i << " below MinInterval");
+        NS_TEST_EXPECT_MSG_LT_OR_EQ(interval, maxInterval, "Interval before epoch " << i << " above MaxInterval");
+    }
+    NS_TEST_EXPECT_MSG_EQ(m_times[N_UNCHANGED] - m_times[N_UNCHANGED - 1], maxInterval,
+                          "Unchanged routes did not stretch the interval to MaxInterval");
+    NS_TEST_EXPECT_MSG_EQ(m_times[N_UNCHANGED + N_CHANGED] - m_times[N_UNCHANGED + N_CHANGED - 1], minInterval,
+                          "Changed routes did not shrink the interval to MinInterval");
+    NS_TEST_EXPECT_MSG_EQ(m_times[N_UNCHANGED + N_CHANGED + 1] - m_times[N_UNCHANGED + N_CHANGED], Seconds(0.3),
+                          "Epoch did not fall on the predicted event");
+    NS_TEST_EXPECT_MSG_EQ(m_times[N_UNCHANGED + N_CHANGED + 2] - m_times[N_UNCHANGED + N_CHANGED + 1], minInterval,
+                          "Predicted event pulled the interval below MinInterval");
+}
+
+/**
+ * @ingroup satellite
+ * @brief Reports made between epochs, as lazy clients make them, decide the
+ *        interval chosen at the next epoch.
+ */
+class SatelliteRouteUpdateLazyReportTestCase : public TestCase
+{
+public:
+    SatelliteRouteUpdateLazyReportTestCase();
+
+private:
+    void DoRun() override;
+
+    /**
+     * @brief Update callback: record the epoch without reporting.
+     * @param test The test case.
+     */
+    static void Update(SatelliteRouteUpdateLazyReportTestCase* test);
+
+    static constexpr uint32_t N_EPOCHS = 5; //!< Epochs in total
+
+    Ptr<SatelliteRouteUpdateScheduler> m_scheduler;
+    uint32_t m_id;              //!< Scheduler id of the client
+    std::vector<Time> m_times;  //!< Time of every epoch
+};
+
+SatelliteRouteUpdateLazyReportTestCase::SatelliteRouteUpdateLazyReportTestCase()
+    : TestCase("Reports between epochs adapt the next interval"),
+      m_id(0)
+{
+}
+
+void
+SatelliteRouteUpdateLazyReportTestCase::Update(SatelliteRouteUpdateLazyReportTestCase* test)
+{
+    test->m_times.push_back(Simulator::Now());
+    if (test->m_times.size() == N_EPOCHS)
+    {
+        test->m_scheduler->Remove(test->m_id);
+    }
+}
+
+void
+SatelliteRouteUpdateLazyReportTestCase::DoRun()
+{
+    m_scheduler = CreateObject<SatelliteRouteUpdateScheduler>();
+    m_scheduler->SetAttribute("Interval", TimeValue(Seconds(1.0)));
+    m_scheduler->SetAttribute("AdaptiveInterval", BooleanValue(true));
+    m_scheduler->SetAttribute("MinInterval", TimeValue(Seconds(0.25)));
+    m_scheduler->SetAttribute("MaxInterval", TimeValue(Seconds(4.0)));
+    m_id = m_scheduler->Add(MakeBoundCallback(&SatelliteRouteUpdateLazyReportTestCase::Update, this));
+
+    // Epochs at 0.1s and 1.1s; changed routes reported in between halve the interval
+    Simulator::Schedule(Seconds(0.6),
+                        &SatelliteRouteUpdateScheduler::ReportEpoch,
+                        m_scheduler,
+                        true,
+                        Time::Max());
+    // Epochs at 1.6s and 2.1s; an event 0.9s after the epoch of 1.6s cuts the
+    // doubled interval short
+    Simulator::Schedule(Seconds(1.7),
+                        &SatelliteRouteUpdateScheduler::ReportEpoch,
+                        m_scheduler,
+                        false,
+                        Seconds(0.9));
+    Simulator::Run();
+    m_scheduler->Dispose();
+    m_scheduler = nullptr;
+    Simulator::Destroy();
+
+    NS_TEST_ASSERT_MSG_EQ(m_times.size(), N_EPOCHS, "Wrong number of epochs");
+    const Time expected[N_EPOCHS] = {Seconds(0.1), Seconds(1.1), Seconds(1.6), Seconds(2.1), Seconds(2.5)};
+    for (uint32_t i = 0; i < N_EPOCHS; ++i)
+    {
+        NS_TEST_EXPECT_MSG_EQ(m_times[i], expected[i], "Epoch " << i << " ran at the wrong time");
+    }
+}
+
+/**
+ * @ingroup satellite
+ * @brief TestSuite for the shared route update scheduler.
+ */
+class SatelliteRouteUpdateSchedulerTestSuite : public TestSuite
+{
+public:
+    SatelliteRouteUpdateSchedulerTestSuite();
+};
+
+SatelliteRouteUpdateSchedulerTestSuite::SatelliteRouteUpdateSchedulerTestSuite()
+    : TestSuite("satellite-route-update-scheduler", Type::UNIT)
+{
+    AddTestCase(new SatelliteRouteUpdateEpochTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new SatelliteRouteUpdateAdaptiveTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new SatelliteRouteUpdateLazyReportTestCase, TestCase::Duration::QUICK);
+}
+
+static SatelliteRouteUpdateSchedulerTestSuite g_satelliteRouteUpdateSchedulerTestSuite; //!< Static variable for test initialization
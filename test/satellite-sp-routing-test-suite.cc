@@ -0,0 +1,436 @@
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/ground-satellite-link-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/inter-satellite-link-helper.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-list-routing.h"
+#include "ns3/packet.h"
+#include "ns3/satellite-address-helper.h"
+#include "ns3/satellite-circular-mobility-model.h"
+#include "ns3/satellite-ephemeris.h"
+#include "ns3/satellite-helper.h"
+#include "ns3/satellite-label-tag.h"
+#include "ns3/satellite-source-route-tag.h"
+#include "ns3/satellite-sp-routing-helper.h"
+#include "ns3/satellite-sp-routing-protocol.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <cmath>
+#include <set>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * @ingroup satellite
+ * @brief Packets between two ground stations, forwarded satellite by satellite
+ *        through SatelliteSpRoutingProtocol::RouteInput().
+ *
+ * The route engine is shared by the whole process, so one test case builds
+ * one constellation and checks every forwarding mode on it.
+ */
+class SatelliteSpForwardingTestCase : public TestCase
+{
+public:
+    SatelliteSpForwardingTestCase();
+
+private:
+    void DoSetup() override;
+    void DoRun() override;
+    void DoTeardown() override;
+
+    /**
+     * @param node A node with the SP routing protocol installed.
+     * @return Its SP routing protocol.
+     */
+    Ptr<SatelliteSpRoutingProtocol> GetProtocol(Ptr<Node> node) const;
+
+    /**
+     * @brief Set an attribute on the SP routing protocol of every node.
+     */
+    void SetProtocolAttribute(std::string name, const AttributeValue& value);
+
+    /**
+     * @brief Send a packet from the first ground station to the second one.
+     * @param p The packet; the first ground station may tag it.
+     * @return The satellite indices the packet crossed, or an empty path if it
+     *         did not reach the second ground station.
+     */
+    std::vector<uint32_t> Forward(Ptr<Packet> p);
+
+    /// UnicastForwardCallback of RouteInput().
+    void ForwardPacket(Ptr<Ipv4Route> route, Ptr<const Packet> p, const Ipv4Header& header);
+    /// ErrorCallback of RouteInput().
+    void DropPacket(Ptr<const Packet> p, const Ipv4Header& header, Socket::SocketErrno err);
+
+    /**
+     * @brief Check that a path follows the engine's next hops to its last satellite.
+     */
+    void CheckPath(const std::vector<uint32_t>& path);
+
+    void CheckSourceRouting();
+    void CheckLabelSwitching();
+    void CheckRouteChanges();
+    void CheckPolarLinks();
+
+    /**
+     * @param satellite A satellite index of the route engine.
+     * @param t A time.
+     * @return Whether the satellite is above 45 degrees of latitude at t.
+     */
+    bool IsPolar(uint32_t satellite, Time t) const;
+    void CheckLazyUpdate();
+
+    std::vector<NodeContainer> m_shell;
+    NodeContainer m_satellites;
+    NodeContainer m_groundStations;
+    Ipv4Header m_header;
+    Ptr<Ipv4Route> m_forwarded; //!< Route of the last RouteInput() call
+    Ptr<const Packet> m_forwardedPacket; //!< Packet forwarded by the last RouteInput() call
+};
+
+SatelliteSpForwardingTestCase::SatelliteSpForwardingTestCase()
+    : TestCase("Forwarding between ground stations")
+{
+}
+
+void
+SatelliteSpForwardingTestCase::DoSetup()
+{
+    SatelliteHelper satelliteHelper;
+    m_shell = satelliteHelper.CreateShell(550e3, 53.0, 4, 6);
+    for (const NodeContainer& plane : m_shell)
+    {
+        m_satellites.Add(plane);
+    }
+    m_groundStations.Add(satelliteHelper.CreateGroundStation(0.0, 0.0));
+    m_groundStations.Add(satelliteHelper.CreateGroundStation(30.0, 100.0));
+
+    InterSatelliteLinkHelper islHelper;
+    islHelper.Install(m_shell);
+    GroundSatelliteLinkHelper gslHelper;
+    gslHelper.Install(m_satellites, m_groundStations);
+
+    InternetStackHelper internet;
+    SatelliteSpRoutingHelper routing;
+    internet.SetRoutingHelper(routing);
+    internet.Install(m_satellites);
+    internet.Install(m_groundStations);
+
+    SatelliteAddressHelper addresses;
+    addresses.Assign(0, m_shell);
+    addresses.AssignGroundStations(m_groundStations);
+    SatelliteSpRoutingHelper::PopulateIpToNodeMap(addresses);
+    SatelliteSpRoutingProtocol::InitializeTopology();
+    SatelliteSpRoutingProtocol::GetRouteEngine()->Update();
+
+    Ptr<Ipv4> source = m_groundStations.Get(0)->GetObject<Ipv4>();
+    Ptr<Ipv4> destination = m_groundStations.Get(1)->GetObject<Ipv4>();
+    m_header.SetSource(source->GetAddress(1, 0).GetLocal());
+    m_header.SetDestination(destination->GetAddress(1, 0).GetLocal());
+    m_header.SetTtl(64);
+}
+
+void
+SatelliteSpForwardingTestCase::DoTeardown()
+{
+    SatelliteSpRoutingProtocol::ClearIpToNodeMapping();
+    Simulator::Destroy();
+}
+
+Ptr<SatelliteSpRoutingProtocol>
+SatelliteSpForwardingTestCase::GetProtocol(Ptr<Node> node) const
+{
+    Ptr<Ipv4ListRouting> list = DynamicCast<Ipv4ListRouting>(node->GetObject<Ipv4>()->GetRoutingProtocol());
+    int16_t priority;
+    return DynamicCast<SatelliteSpRoutingProtocol>(list->GetRoutingProtocol(0, priority));
+}
+
+void
+SatelliteSpForwardingTestCase::SetProtocolAttribute(std::string name, const AttributeValue& value)
+{
+    for (uint32_t i = 0; i < m_satellites.GetN(); ++i)
+    {
+        GetProtocol(m_satellites.Get(i))->SetAttribute(name, value);
+    }
+    for (uint32_t i = 0; i < m_groundStations.GetN(); ++i)
+    {
+        GetProtocol(m_groundStations.Get(i))->SetAttribute(name, value);
+    }
+}
+
+void
+SatelliteSpForwardingTestCase::ForwardPacket(Ptr<Ipv4Route> route, Ptr<const Packet> p, const Ipv4Header& header)
+{
+    m_forwarded = route;
+    m_forwardedPacket = p;
+}
+
+void
+SatelliteSpForwardingTestCase::DropPacket(Ptr<const Packet> p, const Ipv4Header& header, Socket::SocketErrno err)
+{
+    m_forwarded = nullptr;
+}
+
+std::vector<uint32_t>
+SatelliteSpForwardingTestCase::Forward(Ptr<Packet> p)
+{
+    Ptr<SatelliteRouteEngine> engine = SatelliteSpRoutingProtocol::GetRouteEngine();
+    Socket::SocketErrno err;
+    Ptr<Ipv4Route> route = GetProtocol(m_groundStations.Get(0))->RouteOutput(p, m_header, nullptr, err);
+    m_forwardedPacket = p;
+    std::vector<uint32_t> path;
+    while (route && path.size() <= m_satellites.GetN())
+    {
+        Ptr<Node> next = SatelliteSpRoutingProtocol::FindNode(route->GetGateway());
+        if (next == m_groundStations.Get(1))
+        {
+            return path;
+        }
+        uint32_t satellite = next ? engine->GetSatelliteIndex(next) : SatelliteRouteEngine::INVALID_INDEX;
+        if (satellite == SatelliteRouteEngine::INVALID_INDEX)
+        {
+            break;
+        }
+        path.push_back(satellite);
+
+        // Every satellite forwards the copy the previous one handed on
+        m_forwarded = nullptr;
+        GetProtocol(next)->RouteInput(m_forwardedPacket,
+                                      m_header,
+                                      next->GetObject<Ipv4>()->GetNetDevice(1),
+                                      MakeCallback(&SatelliteSpForwardingTestCase::ForwardPacket, this),
+                                      Ipv4RoutingProtocol::MulticastForwardCallback(),
+                                      Ipv4RoutingProtocol::LocalDeliverCallback(),
+                                      MakeCallback(&SatelliteSpForwardingTestCase::DropPacket, this));
+        route = m_forwarded;
+    }
+    return std::vector<uint32_t>();
+}
+
+void
+SatelliteSpForwardingTestCase::CheckPath(const std::vector<uint32_t>& path)
+{
+    Ptr<SatelliteRouteEngine> engine = SatelliteSpRoutingProtocol::GetRouteEngine();
+    for (uint32_t i = 0; i + 1 < path.size(); ++i)
+    {
+        NS_TEST_EXPECT_MSG_EQ(path[i + 1], engine->GetNextHop(path[i], path.back()),
+                              "Hop " << i << " left the shortest path to the egress satellite");
+    }
+}
+
+void
+SatelliteSpForwardingTestCase::CheckSourceRouting()
+{
+    SetProtocolAttribute("SourceRouting", BooleanValue(true));
+    Ptr<SatelliteRouteEngine> engine = SatelliteSpRoutingProtocol::GetRouteEngine();
+    Ptr<Packet> p = Create<Packet>(100);
+    std::vector<uint32_t> path = Forward(p);
+    NS_TEST_ASSERT_MSG_EQ(path.empty(), false, "Source-routed packet did not reach the ground station");
+
+    SatelliteSourceRouteTag tag;
+    NS_TEST_ASSERT_MSG_EQ(p->PeekPacketTag(tag), true, "Ground station did not add a source route");
+    NS_TEST_EXPECT_MSG_EQ(tag.GetDestination(), engine->GetGroundStationIndex(m_groundStations.Get(1)),
+                          "Source route to the wrong ground station");
+    NS_TEST_ASSERT_MSG_EQ(tag.GetNHops(), path.size(), "Packet left its source route");
+    for (uint32_t i = 0; i < path.size(); ++i)
+    {
+        NS_TEST_EXPECT_MSG_EQ(path[i], tag.GetHop(i), "Packet left its source route at hop " << i);
+    }
+    NS_TEST_EXPECT_MSG_EQ(tag.GetCursor(), 0, "Ground station sent the packet past the ingress satellite");
+    NS_TEST_ASSERT_MSG_EQ(m_forwardedPacket->PeekPacketTag(tag), true, "Satellites dropped the source route");
+    NS_TEST_EXPECT_MSG_EQ(tag.GetCursor(), path.size() - 1, "Cursor did not follow the packet to the egress satellite");
+    CheckPath(path);
+    SetProtocolAttribute("SourceRouting", BooleanValue(false));
+}
+
+void
+SatelliteSpForwardingTestCase::CheckLabelSwitching()
+{
+    SetProtocolAttribute("LabelSwitching", BooleanValue(true));
+    Ptr<SatelliteRouteEngine> engine = SatelliteSpRoutingProtocol::GetRouteEngine();
+    Ptr<Packet> p = Create<Packet>(100);
+    std::vector<uint32_t> path = Forward(p);
+    NS_TEST_ASSERT_MSG_EQ(path.empty(), false, "Label-switched packet did not reach the ground station");
+
+    SatelliteLabelTag tag;
+    NS_TEST_ASSERT_MSG_EQ(p->PeekPacketTag(tag), true, "Ground station did not add a label");
+    std::pair<uint32_t, uint32_t> labelPath = engine->GetLabelPath(tag.GetLabel());
+    NS_TEST_EXPECT_MSG_EQ(labelPath.first, path.back(), "Packet left the satellites of its label");
+    NS_TEST_EXPECT_MSG_EQ(labelPath.second, engine->GetGroundStationIndex(m_groundStations.Get(1)),
+                          "Label of the wrong ground station");
+    CheckPath(path);
+
+    // A second packet of the same flow uses the label tables built by the first
+    NS_TEST_EXPECT_MSG_EQ((Forward(Create<Packet>(100)) == path), true, "Label tables changed the path");
+    SetProtocolAttribute("LabelSwitching", BooleanValue(false));
+}
+
+void
+SatelliteSpForwardingTestCase::CheckRouteChanges()
+{
+    // Neither the +Grid nor the on-demand router has a next-hop matrix
+    Ptr<SatelliteRouteEngine> engine = SatelliteSpRoutingProtocol::GetRouteEngine();
+    SatelliteSpRoutingHelper::SetOrbitalPlanes(m_shell);
+    engine->SetAttribute("GridRouting", BooleanValue(true));
+    SatelliteSpRoutingProtocol::InitializeTopology();
+    engine->Update(Seconds(10));
+    NS_TEST_ASSERT_MSG_EQ(engine->IsGridRoutingActive(), true, "Shell not routed as a +Grid");
+    NS_TEST_EXPECT_MSG_EQ(engine->DidRoutesChange(), true, "First epoch reported unchanged routes");
+    engine->Update(MilliSeconds(10001));
+    NS_TEST_EXPECT_MSG_EQ(engine->DidRoutesChange(), false, "Unchanged +Grid routes reported as changed");
+
+    Ptr<Node> a = m_shell[0].Get(0);
+    Ptr<Node> b = m_shell[0].Get(1);
+    engine->SetLinkFailed(a, b, true);
+    NS_TEST_EXPECT_MSG_EQ(engine->IsGridRoutingActive(), false, "Failed link kept the +Grid router");
+    NS_TEST_EXPECT_MSG_EQ(engine->DidRoutesChange(), true, "Failed link did not change the routes");
+
+    engine->SetAttribute("OnDemand", BooleanValue(true));
+    engine->Update(MilliSeconds(10002));
+    NS_TEST_EXPECT_MSG_EQ(engine->HasNextHopMatrix(), false, "OnDemand epoch computed a next-hop matrix");
+    engine->Update(MilliSeconds(10003));
+    NS_TEST_EXPECT_MSG_EQ(engine->DidRoutesChange(), false, "Unchanged on-demand routes reported as changed");
+    engine->SetLinkFailed(a, b, false);
+    NS_TEST_EXPECT_MSG_EQ(engine->DidRoutesChange(), true, "Repaired link did not change the routes");
+
+    engine->SetAttribute("OnDemand", BooleanValue(false));
+    engine->SetAttribute("GridRouting", BooleanValue(false));
+    SatelliteSpRoutingHelper::SetOrbitalPlanes(std::vector<NodeContainer>());
+    SatelliteSpRoutingProtocol::InitializeTopology();
+}
+
+bool
+SatelliteSpForwardingTestCase::IsPolar(uint32_t satellite, Time t) const
+{
+    Ptr<Node> node = SatelliteSpRoutingProtocol::GetRouteEngine()->GetSatellite(satellite);
+    uint32_t slot = node->GetObject<SatelliteCircularMobilityModel>()->GetEphemerisSlot();
+    Vector p = SatelliteEphemeris::Get().GetPosition(slot, t);
+    return std::abs(p.z) > std::sin(M_PI / 4) * std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
+}
+
+void
+SatelliteSpForwardingTestCase::CheckPolarLinks()
+{
+    Ptr<SatelliteRouteEngine> engine = SatelliteSpRoutingProtocol::GetRouteEngine();
+    const Time t = Seconds(20);
+    engine->Update(t);
+    Time toHandover = engine->GetTimeToNextHandover();
+    // Topology initialization drops the epoch, so the same time is computed again
+    engine->SetAttribute("PolarLatitude", DoubleValue(45.0));
+    SatelliteSpRoutingProtocol::InitializeTopology();
+    engine->Update(t);
+    Time toCrossing = engine->GetTimeToNextHandover();
+
+    std::vector<uint32_t> plane(engine->GetNSatellites());
+    std::vector<uint8_t> polar(engine->GetNSatellites());
+    uint32_t numPolar = 0;
+    for (uint32_t p = 0; p < m_shell.size(); ++p)
+    {
+        for (uint32_t s = 0; s < m_shell[p].GetN(); ++s)
+        {
+            uint32_t satellite = engine->GetSatelliteIndex(m_shell[p].Get(s));
+            plane[satellite] = p;
+            polar[satellite] = IsPolar(satellite, t);
+            numPolar += polar[satellite];
+        }
+    }
+    NS_TEST_ASSERT_MSG_GT(numPolar, 0, "No satellite above 45 degrees to test with");
+
+    // No path crosses between planes at a polar satellite
+    for (uint32_t src = 0; src < plane.size(); ++src)
+    {
+        for (uint32_t dst = 0; dst < plane.size(); ++dst)
+        {
+            for (uint32_t u = src, hops = 0; u != dst && hops < plane.size(); ++hops)
+            {
+                uint32_t v = engine->GetNextHop(u, dst);
+                NS_TEST_ASSERT_MSG_NE(v, SatelliteRouteEngine::INVALID_INDEX, "No path " << src << " -> " << dst);
+                NS_TEST_EXPECT_MSG_EQ((plane[u] != plane[v] && (polar[u] || polar[v])), false,
+                                      "Path " << src << " -> " << dst << " crosses planes at a polar satellite");
+                u = v;
+            }
+        }
+    }
+
+    // The prediction is no later than the handover and the first crossing
+    NS_TEST_EXPECT_MSG_LT_OR_EQ(toCrossing, toHandover, "Polar prediction later than the handover");
+    for (uint32_t satellite = 0; satellite < plane.size(); ++satellite)
+    {
+        NS_TEST_EXPECT_MSG_EQ(IsPolar(satellite, t + toCrossing - MicroSeconds(2)), polar[satellite],
+                              "Satellite " << satellite << " crossed 45 degrees before the prediction");
+    }
+    if (toCrossing < toHandover)
+    {
+        uint32_t numChanged = 0;
+        for (uint32_t satellite = 0; satellite < plane.size(); ++satellite)
+        {
+            numChanged += IsPolar(satellite, t + toCrossing) != polar[satellite];
+        }
+        NS_TEST_EXPECT_MSG_GT(numChanged, 0, "No satellite crossed 45 degrees at the prediction");
+    }
+
+    engine->SetAttribute("PolarLatitude", DoubleValue(90.0));
+    engine->Update(Seconds(30));
+}
+
+void
+SatelliteSpForwardingTestCase::CheckLazyUpdate()
+{
+    // LazyUpdate is read when a satellite's protocol starts
+    Ptr<SatelliteRouteEngine> engine = SatelliteSpRoutingProtocol::GetRouteEngine();
+    for (uint32_t i = 0; i < m_satellites.GetN(); ++i)
+    {
+        Ptr<SatelliteSpRoutingProtocol> protocol = GetProtocol(m_satellites.Get(i));
+        protocol->SetAttribute("LazyUpdate", BooleanValue(true));
+        protocol->Initialize();
+    }
+    SatelliteSpRoutingProtocol::InitializeTopology();
+    NS_TEST_EXPECT_MSG_EQ(SatelliteSpRoutingHelper::GetNActiveSatellites(), 0,
+                          "Satellites computed routes before any packet");
+
+    std::vector<uint32_t> path = Forward(Create<Packet>(100));
+    NS_TEST_ASSERT_MSG_EQ(path.empty(), false, "Packet did not reach the ground station with LazyUpdate");
+    NS_TEST_EXPECT_MSG_EQ(engine->HasNextHopMatrix(), false, "The first packet computed routes from every satellite");
+    CheckPath(path);
+    std::set<uint32_t> onPath(path.begin(), path.end());
+    NS_TEST_EXPECT_MSG_EQ(SatelliteSpRoutingHelper::GetNActiveSatellites(), onPath.size(),
+                          "Satellites off the path computed routes");
+    engine->SetAttribute("OnDemand", BooleanValue(false));
+}
+
+void
+SatelliteSpForwardingTestCase::DoRun()
+{
+    // Hop by hop, as a reference for the path of every mode
+    std::vector<uint32_t> path = Forward(Create<Packet>(100));
+    NS_TEST_ASSERT_MSG_EQ(path.empty(), false, "Packet did not reach the ground station");
+    CheckPath(path);
+
+    CheckSourceRouting();
+    CheckLabelSwitching();
+    CheckRouteChanges();
+    CheckPolarLinks();
+    // Last, as it leaves the satellites lazy
+    CheckLazyUpdate();
+}
+
+/**
+ * @ingroup satellite
+ * @brief TestSuite for SatelliteSpRoutingProtocol.
+ */
+class SatelliteSpRoutingTestSuite : public TestSuite
+{
+public:
+    SatelliteSpRoutingTestSuite();
+};
+
+SatelliteSpRoutingTestSuite::SatelliteSpRoutingTestSuite()
+    : TestSuite("satellite-sp-routing", Type::UNIT)
+{
+    AddTestCase(new SatelliteSpForwardingTestCase, TestCase::Duration::QUICK);
+}
+
+static SatelliteSpRoutingTestSuite g_satelliteSpRoutingTestSuite; //!< Static variable for test initialization
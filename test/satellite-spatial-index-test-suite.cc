@@ -0,0 +1,156 @@
+#include "ns3/satellite-helper.h"
+#include "ns3/satellite-spatial-index.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * @ingroup satellite
+ * @brief k-d tree queries return what a linear scan over the snapshot returns.
+ *
+ * Query points are spread over the ground and over the orbit shell, and the
+ * tree is rebuilt at several times so that the split planes move.
+ */
+class SatelliteSpatialIndexTestCase : public TestCase
+{
+public:
+    SatelliteSpatialIndexTestCase();
+
+private:
+    void DoSetup() override;
+    void DoRun() override;
+    void DoTeardown() override;
+
+    /**
+     * @return Squared distance between an item and a point.
+     */
+    double DistanceSquared(uint32_t item, const Vector& position) const;
+
+    /**
+     * @brief Compare FindNearest() and FindWithinRange() at a point with a scan.
+     */
+    void CheckQueries(const Vector& position, double range);
+
+    SatelliteSpatialIndex m_index;
+};
+
+SatelliteSpatialIndexTestCase::SatelliteSpatialIndexTestCase()
+    : TestCase("k-d tree queries match a linear scan")
+{
+}
+
+void
+SatelliteSpatialIndexTestCase::DoSetup()
+{
+    SatelliteHelper satelliteHelper;
+    std::vector<Ptr<Node>> satellites;
+    for (const NodeContainer& plane : satelliteHelper.CreateShell(550e3, 53.0, 12, 11))
+    {
+        for (uint32_t i = 0; i < plane.GetN(); ++i)
+        {
+            satellites.push_back(plane.Get(i));
+        }
+    }
+    m_index.SetSatellites(satellites);
+}
+
+void
+SatelliteSpatialIndexTestCase::DoTeardown()
+{
+    Simulator::Destroy();
+}
+
+double
+SatelliteSpatialIndexTestCase::DistanceSquared(uint32_t item, const Vector& position) const
+{
+    Vector d = m_index.GetPosition(item) - position;
+    return d.x * d.x + d.y * d.y + d.z * d.z;
+}
+
+void
+SatelliteSpatialIndexTestCase::CheckQueries(const Vector& position, double range)
+{
+    double bestDistSq = std::numeric_limits<double>::max();
+    double bestEvenDistSq = std::numeric_limits<double>::max();
+    std::vector<uint32_t> expected;
+    for (uint32_t item = 0; item < m_index.GetN(); ++item)
+    {
+        double distSq = DistanceSquared(item, position);
+        bestDistSq = std::min(bestDistSq, distSq);
+        if (item % 2 == 0)
+        {
+            bestEvenDistSq = std::min(bestEvenDistSq, distSq);
+        }
+        if (distSq <= range * range)
+        {
+            expected.push_back(item);
+        }
+    }
+
+    // Ties may pick either item, so compare distances
+    uint32_t nearest = m_index.FindNearest(position);
+    NS_TEST_ASSERT_MSG_NE(nearest, SatelliteSpatialIndex::INVALID_INDEX, "No nearest satellite");
+    NS_TEST_EXPECT_MSG_EQ(DistanceSquared(nearest, position), bestDistSq, "FindNearest() missed the closest satellite");
+
+    uint32_t nearestEven = m_index.FindNearest(position, [](uint32_t item) { return item % 2 == 0; });
+    NS_TEST_ASSERT_MSG_EQ(nearestEven % 2, 0, "FindNearest() returned an item its filter rejected");
+    NS_TEST_EXPECT_MSG_EQ(DistanceSquared(nearestEven, position), bestEvenDistSq,
+                          "Filtered FindNearest() missed the closest accepted satellite");
+
+    std::vector<uint32_t> items;
+    m_index.FindWithinRange(position, range, items);
+    std::sort(items.begin(), items.end());
+    NS_TEST_EXPECT_MSG_EQ((items == expected), true,
+                          "FindWithinRange() found " << items.size() << " satellites, a scan " << expected.size());
+}
+
+void
+SatelliteSpatialIndexTestCase::DoRun()
+{
+    NS_TEST_ASSERT_MSG_EQ(m_index.IsValid(), false, "Index valid before the first Update()");
+
+    for (double t : {0.0, 123.4, 2000.0})
+    {
+        m_index.Update(Seconds(t));
+        NS_TEST_ASSERT_MSG_EQ(m_index.IsValid(), true, "Index not valid after Update()");
+        for (double latitude = -80.0; latitude <= 80.0; latitude += 20.0)
+        {
+            for (double longitude = -180.0; longitude < 180.0; longitude += 45.0)
+            {
+                double lat = latitude * M_PI / 180.0;
+                double lon = longitude * M_PI / 180.0;
+                for (double radius : {6371e3, 6371e3 + 550e3})
+                {
+                    Vector position(radius * std::cos(lat) * std::cos(lon),
+                                    radius * std::cos(lat) * std::sin(lon),
+                                    radius * std::sin(lat));
+                    CheckQueries(position, 2000e3);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @ingroup satellite
+ * @brief TestSuite for the satellite k-d tree.
+ */
+class SatelliteSpatialIndexTestSuite : public TestSuite
+{
+public:
+    SatelliteSpatialIndexTestSuite();
+};
+
+SatelliteSpatialIndexTestSuite::SatelliteSpatialIndexTestSuite()
+    : TestSuite("satellite-spatial-index", Type::UNIT)
+{
+    AddTestCase(new SatelliteSpatialIndexTestCase, TestCase::Duration::QUICK);
+}
+
+static SatelliteSpatialIndexTestSuite g_satelliteSpatialIndexTestSuite; //!< Static variable for test initialization